@@ -0,0 +1,748 @@
+/*
+ *  Copyright 2013 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#pragma once
+
+// Host execution backend for CudaDMA version 2.0.
+//
+// This header is included by cudaDMAv2.h whenever it is compiled by
+// a plain C++ compiler instead of nvcc (or whenever CUDADMA_HOST_BACKEND
+// is defined).  It provides just enough of the CUDA programming model
+// for CudaDMA kernels to run on a machine without a GPU:
+//  - the CUDA function and variable qualifiers
+//  - the built-in vector types and thread index variables
+//  - named barriers (bar.sync/bar.arrive) and __syncthreads
+//  - the subset of the CUDA runtime API used by the tests and examples
+//
+// Every warp of a CTA is emulated by a host thread so all the warps in
+// a CTA run concurrently across the host cores.  The lanes of a warp are
+// user-level contexts on that host thread which only switch at barriers
+// (see Warp below).  Define CUDADMA_HOST_THREAD_PER_LANE to give every
+// CUDA thread its own host thread instead, which is much slower but does
+// not depend on ucontext.  CTAs of a grid run one after the other on the
+// same set of host threads which allows statically allocated __shared__
+// variables to be mapped onto function-local statics.  Kernels have to be
+// launched with CUDADMA_LAUNCH instead of the triple chevron syntax and
+// dynamically sized shared memory has to be declared with
+// CUDADMA_EXTERN_SHARED.  Both macros are also defined by cudaDMAv2.h for
+// nvcc so the same source works for both.
+//
+// Note that this backend is for checking correctness only.  Cache
+// qualifiers are ignored and timing results say nothing about the GPU.
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cmath>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
+#include <atomic>
+#ifndef CUDADMA_HOST_THREAD_PER_LANE
+#include <ucontext.h>
+#endif
+
+#ifndef CUDADMA_HOST_BACKEND
+#define CUDADMA_HOST_BACKEND
+#endif
+
+/*****************************************************/
+/*           CUDA qualifiers                         */
+/*****************************************************/
+#define __host__
+#define __device__
+#define __global__
+#define __constant__
+#define __forceinline__ inline
+#define __launch_bounds__(...)
+// All the threads of a CTA share a function-local static
+#define __shared__ static
+
+/*****************************************************/
+/*           Built-in types                          */
+/*****************************************************/
+struct alignas(8) float2 { float x, y; };
+struct float3 { float x, y, z; };
+struct alignas(16) float4 { float x, y, z, w; };
+struct alignas(8) int2 { int x, y; };
+struct alignas(16) int4 { int x, y, z, w; };
+struct uint3 { unsigned x, y, z; };
+
+struct dim3 {
+  unsigned x, y, z;
+  dim3(unsigned vx = 1, unsigned vy = 1, unsigned vz = 1)
+    : x(vx), y(vy), z(vz) { }
+  dim3(const uint3 &v) : x(v.x), y(v.y), z(v.z) { }
+};
+
+inline float2 make_float2(float x, float y)
+{ float2 result = { x, y }; return result; }
+inline float3 make_float3(float x, float y, float z)
+{ float3 result = { x, y, z }; return result; }
+inline float4 make_float4(float x, float y, float z, float w)
+{ float4 result = { x, y, z, w }; return result; }
+inline int2 make_int2(int x, int y)
+{ int2 result = { x, y }; return result; }
+inline int4 make_int4(int x, int y, int z, int w)
+{ int4 result = { x, y, z, w }; return result; }
+
+namespace CudaDMAHost {
+
+  // Same number of named barriers as the hardware
+  static const int NUM_NAMED_BARRIERS = 16;
+
+  class CTA;
+  class Warp;
+
+  // The values of the CUDA built-in variables for a CUDA thread
+  struct ThreadContext {
+    uint3 thread_idx;
+    uint3 block_idx;
+    dim3 block_dim;
+    dim3 grid_dim;
+    CTA *cta;
+    // Only set when the lanes of a warp share a host thread
+    Warp *warp;
+    int lane;
+  };
+
+  // The CUDA thread currently running on this host thread
+  inline ThreadContext*& current_context(void)
+  {
+    static thread_local ThreadContext *ctx = NULL;
+    return ctx;
+  }
+
+  inline ThreadContext& context(void)
+  {
+    return *current_context();
+  }
+
+  // The state shared by all the threads of the currently executing CTA.
+  // Barriers count arriving threads.  Each barrier keeps a generation
+  // number so waiting threads can tell when their phase has completed
+  // even if faster threads have already started arriving for the next one.
+  class CTA {
+  public:
+    CTA(unsigned threads, size_t shared_bytes)
+      : num_threads(threads), live_threads(threads), exit_arrived(0),
+        exit_generation(0),
+        shared((shared_bytes > 0) ?
+               (shared_bytes+SHARED_ALIGNMENT+sizeof(float4)-1)/sizeof(float4) : 0)
+    {
+      reset_barriers();
+    }
+  public:
+    // Arrive on a barrier on behalf of 'threads' threads and return
+    // the generation that has to complete before they can continue
+    unsigned arrive(int name, int count, int threads)
+    {
+      if ((name < 0) || (name >= NUM_NAMED_BARRIERS))
+      {
+        fprintf(stderr,"CudaDMA host backend: invalid barrier name %d\n", name);
+        abort();
+      }
+      std::unique_lock<std::mutex> guard(lock);
+      NamedBarrier &bar = barriers[name];
+      // A count of zero means all the live threads in the CTA
+      bar.expected = (count > 0) ? count : -1;
+      const unsigned generation = bar.generation;
+      bar.arrived += threads;
+      try_complete(bar);
+      return generation;
+    }
+    void wait(int name, unsigned generation)
+    {
+      std::unique_lock<std::mutex> guard(lock);
+      while (barriers[name].generation == generation)
+        cond.wait(guard);
+    }
+    // Exited threads no longer count towards __syncthreads
+    void retire(int threads)
+    {
+      std::unique_lock<std::mutex> guard(lock);
+      live_threads -= threads;
+      try_complete(barriers[0]);
+    }
+    // Called once every thread has retired.  The last thread out resets
+    // the barriers so the next CTA starts from a clean state.
+    void finish(int threads)
+    {
+      std::unique_lock<std::mutex> guard(lock);
+      const unsigned generation = exit_generation;
+      exit_arrived += threads;
+      if (exit_arrived == num_threads)
+      {
+        exit_arrived = 0;
+        live_threads = num_threads;
+        reset_barriers();
+        exit_generation++;
+        cond.notify_all();
+      }
+      else
+      {
+        while (exit_generation == generation)
+          cond.wait(guard);
+      }
+    }
+    // Dynamic shared memory starts at the beginning of the shared memory of
+    // kernels without static shared memory, which swizzled tiles rely on
+    void* dynamic_shared(void)
+    {
+      if (shared.empty())
+        return NULL;
+      const size_t base = reinterpret_cast<size_t>(&shared[0]);
+      return reinterpret_cast<void*>((base + SHARED_ALIGNMENT - 1) &
+                                     ~(size_t(SHARED_ALIGNMENT) - 1));
+    }
+  private:
+    static const size_t SHARED_ALIGNMENT = 4096;
+    struct NamedBarrier {
+      int expected;
+      int arrived;
+      unsigned generation;
+    };
+    bool try_complete(NamedBarrier &bar)
+    {
+      const int expected = (bar.expected > 0) ? bar.expected : live_threads;
+      if ((bar.arrived == 0) || (bar.arrived < expected))
+        return false;
+      bar.arrived = 0;
+      bar.generation++;
+      cond.notify_all();
+      return true;
+    }
+    void reset_barriers(void)
+    {
+      for (int i = 0; i < NUM_NAMED_BARRIERS; i++)
+      {
+        barriers[i].expected = -1;
+        barriers[i].arrived = 0;
+        barriers[i].generation = 0;
+      }
+    }
+  private:
+    const int num_threads;
+    int live_threads;
+    int exit_arrived;
+    unsigned exit_generation;
+    NamedBarrier barriers[NUM_NAMED_BARRIERS];
+    std::mutex lock;
+    std::condition_variable cond;
+    std::vector<float4> shared;
+  };
+
+#ifndef CUDADMA_HOST_THREAD_PER_LANE
+  // Runs the lanes of one warp on a single host thread.  Each lane is a
+  // user-level context that runs until it reaches a barrier or exits and
+  // then hands control to the next lane.  Once every lane has stopped the
+  // warp arrives on each barrier once on behalf of all the lanes stopped
+  // there (the hardware also counts whole warps) and then waits for the
+  // blocking barriers to complete before resuming the lanes.  Switching
+  // only happens at barriers so a lane runs straight through the loads
+  // and stores between them.
+  class Warp {
+  public:
+    Warp(int lanes, size_t stack_bytes)
+      : num_lanes(lanes), stack_size(stack_bytes), lane_state(lanes),
+        lane_context(lanes), stacks(static_cast<char*>(malloc(lanes*stack_bytes))) { }
+    ~Warp(void) { free(stacks); }
+  public:
+    template<typename BODY>
+    void execute(CTA *cta, const BODY *body)
+    {
+      invoke = invoke_body<BODY>;
+      kernel = body;
+      for (int i = 0; i < num_lanes; i++)
+      {
+        LaneState &state = lane_state[i];
+        state.done = false;
+        getcontext(&state.context);
+        state.context.uc_stack.ss_sp = &stacks[i*stack_size];
+        state.context.uc_stack.ss_size = stack_size;
+        state.context.uc_link = &scheduler;
+        makecontext(&state.context, lane_entry, 0);
+      }
+      int retired = 0;
+      while (true)
+      {
+        // Run every lane until it stops
+        for (int i = 0; i < num_lanes; i++)
+        {
+          if (lane_state[i].done)
+            continue;
+          current_context() = &lane_context[i];
+          swapcontext(&scheduler, &lane_state[i].context);
+        }
+        current_context() = NULL;
+        int arrivals[NUM_NAMED_BARRIERS] = { 0 };
+        int counts[NUM_NAMED_BARRIERS] = { 0 };
+        bool blocking[NUM_NAMED_BARRIERS] = { false };
+        int done = 0;
+        for (int i = 0; i < num_lanes; i++)
+        {
+          const LaneState &state = lane_state[i];
+          if (state.done)
+          {
+            done++;
+            continue;
+          }
+          arrivals[state.barrier]++;
+          counts[state.barrier] = state.count;
+          blocking[state.barrier] = blocking[state.barrier] || state.blocking;
+        }
+        if (done > retired)
+        {
+          cta->retire(done - retired);
+          retired = done;
+        }
+        if (done == num_lanes)
+          break;
+        // Arrive on everything before waiting on anything
+        unsigned generations[NUM_NAMED_BARRIERS];
+        for (int b = 0; b < NUM_NAMED_BARRIERS; b++)
+        {
+          if (arrivals[b] > 0)
+            generations[b] = cta->arrive(b, counts[b], arrivals[b]);
+        }
+        for (int b = 0; b < NUM_NAMED_BARRIERS; b++)
+        {
+          if ((arrivals[b] > 0) && blocking[b])
+            cta->wait(b, generations[b]);
+        }
+      }
+      cta->finish(num_lanes);
+    }
+    // Called by a lane when it reaches a barrier
+    void stop(int lane, int name, int count, bool is_blocking)
+    {
+      if ((name < 0) || (name >= NUM_NAMED_BARRIERS))
+      {
+        fprintf(stderr,"CudaDMA host backend: invalid barrier name %d\n", name);
+        abort();
+      }
+      LaneState &state = lane_state[lane];
+      state.barrier = name;
+      state.count = count;
+      state.blocking = is_blocking;
+      swapcontext(&state.context, &scheduler);
+    }
+    ThreadContext& get_context(int lane) { return lane_context[lane]; }
+  private:
+    struct LaneState {
+      ucontext_t context;
+      int barrier;
+      int count;
+      bool blocking;
+      bool done;
+    };
+    template<typename BODY>
+    static void invoke_body(const void *body) { (*static_cast<const BODY*>(body))(); }
+    static void lane_entry(void)
+    {
+      ThreadContext &ctx = context();
+      ctx.warp->invoke(ctx.warp->kernel);
+      // Returning resumes the scheduler through uc_link
+      ctx.warp->lane_state[ctx.lane].done = true;
+    }
+  private:
+    const int num_lanes;
+    const size_t stack_size;
+    std::vector<LaneState> lane_state;
+    std::vector<ThreadContext> lane_context;
+    // Left uninitialized so untouched stack pages are never faulted in
+    char *const stacks;
+    ucontext_t scheduler;
+    void (*invoke)(const void*);
+    const void *kernel;
+  };
+#endif
+
+  inline void barrier_blocking(int name, int count)
+  {
+    ThreadContext &ctx = context();
+#ifndef CUDADMA_HOST_THREAD_PER_LANE
+    if (ctx.warp != NULL)
+    {
+      ctx.warp->stop(ctx.lane, name, count, true);
+      return;
+    }
+#endif
+    ctx.cta->wait(name, ctx.cta->arrive(name, count, 1));
+  }
+
+  inline void barrier_nonblocking(int name, int count)
+  {
+    ThreadContext &ctx = context();
+#ifndef CUDADMA_HOST_THREAD_PER_LANE
+    if (ctx.warp != NULL)
+    {
+      ctx.warp->stop(ctx.lane, name, count, false);
+      return;
+    }
+#endif
+    ctx.cta->arrive(name, count, 1);
+  }
+
+  inline void* dynamic_shared(void)
+  {
+    return context().cta->dynamic_shared();
+  }
+
+  // Every load, store and prefetch issued through ptx_cudaDMA_load and
+  // ptx_cudaDMA_store is reported to the trace hook when one is installed
+  // (see cudaDMATrace.h).  The hook is called from the host thread running
+  // the issuing CUDA thread.
+  enum TraceKind {
+    TRACE_LOAD,
+    TRACE_STORE,
+    TRACE_PREFETCH, // into L2 of the source of a load or the destination of a store
+  };
+
+  typedef void (*TraceHook)(TraceKind kind, const void *ptr, size_t bytes);
+
+  inline TraceHook& trace_hook(void)
+  {
+    static TraceHook hook = NULL;
+    return hook;
+  }
+
+  inline void trace_access(TraceKind kind, const void *ptr, size_t bytes)
+  {
+    TraceHook hook = trace_hook();
+    if (hook != NULL)
+      hook(kind, ptr, bytes);
+  }
+
+  inline void set_block_index(ThreadContext &ctx, const dim3 &grid, unsigned cid)
+  {
+    ctx.block_idx.x = cid % grid.x;
+    ctx.block_idx.y = (cid / grid.x) % grid.y;
+    ctx.block_idx.z = cid / (grid.x * grid.y);
+  }
+
+  inline void init_context(ThreadContext &ctx, CTA *cta, const dim3 &grid,
+                           const dim3 &block, unsigned tid)
+  {
+    ctx.cta = cta;
+    ctx.warp = NULL;
+    ctx.lane = tid % 32;
+    ctx.grid_dim = grid;
+    ctx.block_dim = block;
+    ctx.thread_idx.x = tid % block.x;
+    ctx.thread_idx.y = (tid / block.x) % block.y;
+    ctx.thread_idx.z = tid / (block.x * block.y);
+  }
+
+#ifdef CUDADMA_HOST_THREAD_PER_LANE
+  template<typename BODY>
+  void run_thread(CTA *cta, const dim3 grid, const dim3 block, unsigned tid, const BODY *body)
+  {
+    ThreadContext ctx;
+    init_context(ctx, cta, grid, block, tid);
+    current_context() = &ctx;
+    const unsigned num_ctas = grid.x * grid.y * grid.z;
+    for (unsigned cid = 0; cid < num_ctas; cid++)
+    {
+      set_block_index(ctx, grid, cid);
+      (*body)();
+      cta->retire(1);
+      cta->finish(1);
+    }
+    current_context() = NULL;
+  }
+#else
+#ifndef CUDADMA_HOST_LANE_STACK
+#define CUDADMA_HOST_LANE_STACK (256*1024)
+#endif
+  template<typename BODY>
+  void run_warp(CTA *cta, const dim3 grid, const dim3 block, unsigned wid, const BODY *body)
+  {
+    const unsigned num_threads = block.x * block.y * block.z;
+    const int lanes = ((num_threads - wid*32) < 32) ? (num_threads - wid*32) : 32;
+    Warp warp(lanes, CUDADMA_HOST_LANE_STACK);
+    for (int i = 0; i < lanes; i++)
+    {
+      init_context(warp.get_context(i), cta, grid, block, wid*32 + i);
+      warp.get_context(i).warp = &warp;
+    }
+    const unsigned num_ctas = grid.x * grid.y * grid.z;
+    for (unsigned cid = 0; cid < num_ctas; cid++)
+    {
+      for (int i = 0; i < lanes; i++)
+        set_block_index(warp.get_context(i), grid, cid);
+      warp.execute(cta, body);
+    }
+  }
+#endif
+
+  // Run a kernel body over a whole grid.  Returns once all CTAs are done
+  // so launches are always synchronous on the host.
+  template<typename BODY>
+  void launch(const dim3 &grid, const dim3 &block, size_t shared_bytes, const BODY &body)
+  {
+    const unsigned num_threads = block.x * block.y * block.z;
+    if ((num_threads == 0) || ((grid.x * grid.y * grid.z) == 0))
+      return;
+    CTA cta(num_threads, shared_bytes);
+    std::vector<std::thread> workers;
+#ifdef CUDADMA_HOST_THREAD_PER_LANE
+    for (unsigned tid = 0; tid < num_threads; tid++)
+      workers.push_back(std::thread(run_thread<BODY>, &cta, grid, block, tid, &body));
+#else
+    const unsigned num_warps = (num_threads + 31) / 32;
+    for (unsigned wid = 0; wid < num_warps; wid++)
+      workers.push_back(std::thread(run_warp<BODY>, &cta, grid, block, wid, &body));
+#endif
+    for (unsigned i = 0; i < workers.size(); i++)
+      workers[i].join();
+  }
+
+  template<typename... PARAMS>
+  class KernelLaunch {
+  public:
+    KernelLaunch(const dim3 &g, const dim3 &b, size_t s, void (*k)(PARAMS...))
+      : grid(g), block(b), shared_bytes(s), kernel(k) { }
+  public:
+    template<typename... ARGS>
+    void operator()(ARGS... args) const
+    {
+      void (*const func)(PARAMS...) = kernel;
+      launch(grid, block, shared_bytes, [=]() { func(args...); });
+    }
+  private:
+    const dim3 grid, block;
+    const size_t shared_bytes;
+    void (*const kernel)(PARAMS...);
+  };
+
+  template<typename... PARAMS>
+  KernelLaunch<PARAMS...> make_launch(const dim3 &grid, const dim3 &block, size_t shared_bytes,
+                                      void (*kernel)(PARAMS...))
+  {
+    return KernelLaunch<PARAMS...>(grid, block, shared_bytes, kernel);
+  }
+}; // namespace CudaDMAHost
+
+/*****************************************************/
+/*           Built-in variables                      */
+/*****************************************************/
+#define threadIdx (CudaDMAHost::context().thread_idx)
+#define blockIdx (CudaDMAHost::context().block_idx)
+#define blockDim (CudaDMAHost::context().block_dim)
+#define gridDim (CudaDMAHost::context().grid_dim)
+static const int warpSize = 32;
+
+inline void __syncthreads(void) { CudaDMAHost::barrier_blocking(0, 0); }
+// Every store on the host is already visible once the barriers order it
+inline void __threadfence_block(void) { std::atomic_thread_fence(std::memory_order_seq_cst); }
+inline void __threadfence(void) { std::atomic_thread_fence(std::memory_order_seq_cst); }
+
+inline int __float_as_int(float x)
+{
+  int result;
+  memcpy(&result, &x, sizeof(int));
+  return result;
+}
+inline float __int_as_float(int x)
+{
+  float result;
+  memcpy(&result, &x, sizeof(float));
+  return result;
+}
+
+// Atomics used by reducing stores.  Warps run on different host threads
+// so these have to be real atomics.
+inline int atomicCAS(int *address, int compare, int val)
+{
+  __atomic_compare_exchange_n(address, &compare, val, false,
+                              __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST);
+  return compare;
+}
+inline int atomicAdd(int *address, int val)
+{
+  return __atomic_fetch_add(address, val, __ATOMIC_SEQ_CST);
+}
+inline int atomicMin(int *address, int val)
+{
+  int old = __atomic_load_n(address, __ATOMIC_SEQ_CST);
+  while ((val < old) &&
+         !__atomic_compare_exchange_n(address, &old, val, false,
+                                      __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST)) { }
+  return old;
+}
+inline int atomicMax(int *address, int val)
+{
+  int old = __atomic_load_n(address, __ATOMIC_SEQ_CST);
+  while ((val > old) &&
+         !__atomic_compare_exchange_n(address, &old, val, false,
+                                      __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST)) { }
+  return old;
+}
+inline float atomicAdd(float *address, float val)
+{
+  int *bits = reinterpret_cast<int*>(address);
+  int old = __atomic_load_n(bits, __ATOMIC_SEQ_CST);
+  while (!__atomic_compare_exchange_n(bits, &old, __float_as_int(__int_as_float(old) + val), false,
+                                      __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST)) { }
+  return __int_as_float(old);
+}
+
+// Replacements for kernel<<<grid,block,shmem,stream>>>(args) and
+// extern __shared__ type name[]
+#define CUDADMA_LAUNCH(grid,block,shmem,stream,...) \
+  CudaDMAHost::make_launch(dim3(grid),dim3(block),(shmem),__VA_ARGS__)
+#define CUDADMA_EXTERN_SHARED(type,name) \
+  type *const name = reinterpret_cast<type*>(CudaDMAHost::dynamic_shared())
+
+/*****************************************************/
+/*           Runtime API                             */
+/*****************************************************/
+typedef enum cudaError {
+  cudaSuccess = 0,
+  cudaErrorMemoryAllocation = 2,
+  cudaErrorInvalidValue = 11,
+} cudaError_t;
+
+enum cudaMemcpyKind {
+  cudaMemcpyHostToHost = 0,
+  cudaMemcpyHostToDevice = 1,
+  cudaMemcpyDeviceToHost = 2,
+  cudaMemcpyDeviceToDevice = 3,
+  cudaMemcpyDefault = 4,
+};
+
+enum cudaSharedMemConfig {
+  cudaSharedMemBankSizeDefault = 0,
+  cudaSharedMemBankSizeFourByte = 1,
+  cudaSharedMemBankSizeEightByte = 2,
+};
+
+struct cudaDeviceProp {
+  char name[256];
+  size_t totalGlobalMem;
+  size_t sharedMemPerBlock;
+  int regsPerBlock;
+  int warpSize;
+  int maxThreadsPerBlock;
+  int major;
+  int minor;
+  int multiProcessorCount;
+};
+
+// Streams and events have nothing to order since launches are synchronous
+typedef struct CUstream_st *cudaStream_t;
+typedef std::chrono::steady_clock::time_point *cudaEvent_t;
+
+inline const char* cudaGetErrorString(cudaError_t error)
+{
+  switch (error)
+  {
+    case cudaSuccess:
+      return "no error";
+    case cudaErrorMemoryAllocation:
+      return "out of memory";
+    case cudaErrorInvalidValue:
+      return "invalid argument";
+  }
+  return "unknown error";
+}
+
+inline cudaError_t cudaGetLastError(void) { return cudaSuccess; }
+inline cudaError_t cudaDeviceSynchronize(void) { return cudaSuccess; }
+inline cudaError_t cudaThreadSynchronize(void) { return cudaSuccess; }
+inline cudaError_t cudaSetDevice(int device)
+{
+  return (device == 0) ? cudaSuccess : cudaErrorInvalidValue;
+}
+inline cudaError_t cudaDeviceSetSharedMemConfig(cudaSharedMemConfig) { return cudaSuccess; }
+
+inline cudaError_t cudaGetDeviceProperties(cudaDeviceProp *prop, int device)
+{
+  if ((prop == NULL) || (device != 0))
+    return cudaErrorInvalidValue;
+  memset(prop, 0, sizeof(*prop));
+  strncpy(prop->name, "CudaDMA host backend", sizeof(prop->name)-1);
+  prop->sharedMemPerBlock = 48*1024;
+  prop->regsPerBlock = 64*1024;
+  prop->warpSize = 32;
+  prop->maxThreadsPerBlock = 1024;
+  prop->major = 3;
+  prop->minor = 5;
+  prop->multiProcessorCount = std::thread::hardware_concurrency();
+  return cudaSuccess;
+}
+
+inline cudaError_t cudaMalloc(void **ptr, size_t size)
+{
+  // Match the 256-byte alignment of device allocations
+  if (posix_memalign(ptr, 256, (size > 0) ? size : 1) != 0)
+    return cudaErrorMemoryAllocation;
+  return cudaSuccess;
+}
+
+inline cudaError_t cudaFree(void *ptr)
+{
+  free(ptr);
+  return cudaSuccess;
+}
+
+inline cudaError_t cudaMemcpy(void *dst, const void *src, size_t count, cudaMemcpyKind)
+{
+  memcpy(dst, src, count);
+  return cudaSuccess;
+}
+
+inline cudaError_t cudaMemset(void *ptr, int value, size_t count)
+{
+  memset(ptr, value, count);
+  return cudaSuccess;
+}
+
+inline cudaError_t cudaStreamCreate(cudaStream_t *stream) { *stream = NULL; return cudaSuccess; }
+inline cudaError_t cudaStreamDestroy(cudaStream_t) { return cudaSuccess; }
+inline cudaError_t cudaStreamSynchronize(cudaStream_t) { return cudaSuccess; }
+
+inline cudaError_t cudaEventCreate(cudaEvent_t *event)
+{
+  *event = new std::chrono::steady_clock::time_point();
+  return cudaSuccess;
+}
+
+inline cudaError_t cudaEventDestroy(cudaEvent_t event)
+{
+  delete event;
+  return cudaSuccess;
+}
+
+inline cudaError_t cudaEventRecord(cudaEvent_t event, cudaStream_t = NULL)
+{
+  *event = std::chrono::steady_clock::now();
+  return cudaSuccess;
+}
+
+inline cudaError_t cudaEventSynchronize(cudaEvent_t) { return cudaSuccess; }
+
+inline cudaError_t cudaEventElapsedTime(float *ms, cudaEvent_t start, cudaEvent_t stop)
+{
+  *ms = std::chrono::duration<float,std::milli>(*stop - *start).count();
+  return cudaSuccess;
+}
+
+// EOF
+
@@ -0,0 +1,316 @@
+/*
+ *  Copyright 2013 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#pragma once
+
+// Host-side launch planner for warp-specialized CudaDMA kernels.
+//
+// Given the number of compute threads of a CTA and the CudaDMA transfers
+// (with the number of buffers of each) the planner lays out the threads
+// of the CTA, assigns dmaIDs, carves the shared memory for the buffers
+// and estimates how many CTAs fit on an SM.  The layout is the one used
+// by the examples: compute warps first, followed by the DMA warps of
+// every buffer in order.  Every buffer has its own dmaID, and so its own
+// pair of named barriers, starting at 1 since barrier 0 is used by
+// __syncthreads.
+
+#include "cudaDMAv2.h"
+
+#include <string.h>
+
+#include <string>
+#include <vector>
+
+namespace CudaDMALaunch {
+
+  // Default values are for a Kepler (compute capability 3.5) GPU
+  struct Device {
+    int max_threads_per_cta;
+    int max_threads_per_sm;
+    int max_ctas_per_sm;
+    int shared_per_cta; // bytes
+    int shared_per_sm; // bytes
+    int registers_per_sm;
+    int max_registers_per_thread;
+    int named_barriers;
+    Device(void)
+      : max_threads_per_cta(1024), max_threads_per_sm(2048), max_ctas_per_sm(16),
+        shared_per_cta(49152), shared_per_sm(49152), registers_per_sm(65536),
+        max_registers_per_thread(255), named_barriers(16) { }
+  };
+
+  static const int WARP_THREADS = 32;
+  // Alignment of the start of every buffer in shared memory
+  static const int BUFFER_ALIGNMENT = 16;
+
+  // A fully templated CudaDMA transfer with one instance per buffer
+  struct Transfer {
+    CudaDMADiagnosis diag;
+    int buffers;
+    int buffer_bytes; // shared memory per buffer
+    // All the buffers are handled by the same DMA warps, one after the
+    // other, instead of each buffer having its own warps
+    bool shared_warps;
+  };
+
+  static inline Transfer sequential(int alignment, int bytes_per_thread, int bytes_per_elmt,
+                                    int dma_threads, int buffers = 1)
+  {
+    Transfer result;
+    result.diag = CudaDMASequential<>::analyze(alignment, bytes_per_thread, bytes_per_elmt,
+                                               dma_threads, true);
+    result.buffers = buffers;
+    result.buffer_bytes = bytes_per_elmt;
+    result.shared_warps = false;
+    return result;
+  }
+
+  // dst_elmt_stride is the stride between elements in shared memory,
+  // zero for packed elements
+  static inline Transfer strided(int alignment, int bytes_per_thread, int bytes_per_elmt,
+                                 int dma_threads, int num_elmts, int buffers = 1,
+                                 int dst_elmt_stride = 0)
+  {
+    Transfer result;
+    result.diag = CudaDMAStrided<>::analyze(alignment, bytes_per_thread, bytes_per_elmt,
+                                            dma_threads, num_elmts, true);
+    result.buffers = buffers;
+    result.buffer_bytes = (num_elmts - 1) * ((dst_elmt_stride > 0) ? dst_elmt_stride : bytes_per_elmt) +
+                          bytes_per_elmt;
+    result.shared_warps = false;
+    return result;
+  }
+
+  // Gathers pack the elements in shared memory
+  static inline Transfer indirect(int alignment, int bytes_per_thread, int bytes_per_elmt,
+                                  int dma_threads, int num_elmts, int buffers = 1)
+  {
+    Transfer result;
+    result.diag = CudaDMAIndirect<>::analyze(alignment, bytes_per_thread, bytes_per_elmt,
+                                             dma_threads, num_elmts, true);
+    result.buffers = buffers;
+    result.buffer_bytes = num_elmts * bytes_per_elmt;
+    result.shared_warps = false;
+    return result;
+  }
+
+  // One CudaDMA instance of the kernel, with its constructor arguments
+  struct Instance {
+    int transfer; // index into the transfers passed to plan
+    int buffer;
+    int dmaID;
+    int dma_threads;
+    int dma_threadIdx_start;
+    int shared_offset; // bytes from the start of the dynamic shared memory
+  };
+
+  // What bounds the number of CTAs on an SM
+  enum Limiter {
+    THREADS_LIMIT,
+    REGISTERS_LIMIT,
+    SHARED_LIMIT,
+    CTAS_LIMIT,
+    INVALID_LAYOUT, // the CTA cannot be launched at all
+  };
+
+  static inline const char* limiter_name(Limiter limiter)
+  {
+    switch (limiter)
+    {
+      case THREADS_LIMIT:
+        return "threads";
+      case REGISTERS_LIMIT:
+        return "registers";
+      case SHARED_LIMIT:
+        return "shared memory";
+      case CTAS_LIMIT:
+        return "CTAs per SM";
+      case INVALID_LAYOUT:
+        return "invalid layout";
+    }
+    return "unknown";
+  }
+
+  struct Plan {
+    int compute_threads;
+    int dma_threads;
+    int threads_per_cta;
+    std::vector<Instance> instances;
+    int shared_bytes; // per CTA
+    int registers_per_thread;
+    int ctas_per_sm;
+    Limiter limiter;
+    double occupancy; // resident threads over the maximum for the SM
+    std::vector<std::string> errors;
+    std::vector<std::string> warnings;
+    bool valid(void) const { return errors.empty(); }
+  };
+
+  static inline std::string format(const char *fmt, int a, int b = 0, int c = 0)
+  {
+    char buffer[256];
+    snprintf(buffer, sizeof(buffer), fmt, a, b, c);
+    return std::string(buffer);
+  }
+
+  // compute_registers is the number of registers the compute code of the
+  // kernel needs per thread, zero to only account for the DMA instances.
+  // Every thread of a kernel gets the same number of registers so the
+  // kernel needs the most of either of them.  extra_shared is the shared
+  // memory used by the kernel besides the DMA buffers.
+  static inline Plan plan(int compute_threads, const std::vector<Transfer> &transfers,
+                          const Device &device = Device(), int compute_registers = 0,
+                          int extra_shared = 0)
+  {
+    Plan result;
+    result.compute_threads = compute_threads;
+    result.dma_threads = 0;
+    result.shared_bytes = extra_shared;
+    result.registers_per_thread = compute_registers;
+    if ((compute_threads <= 0) || ((compute_threads % WARP_THREADS) != 0))
+      result.errors.push_back(format("compute threads (%d) must be a positive multiple of the warp size",
+                                     compute_threads));
+    int next_thread = compute_threads;
+    int next_dmaID = 1;
+    for (unsigned t = 0; t < transfers.size(); t++)
+    {
+      const Transfer &transfer = transfers[t];
+      if ((transfer.diag.dma_threads % WARP_THREADS) != 0)
+        result.errors.push_back(format("transfer %d: DMA threads (%d) must be a multiple of the warp size",
+                                       t, transfer.diag.dma_threads));
+      if (!transfer.diag.optimized)
+        result.warnings.push_back(format("transfer %d needs %d steps, consider more DMA threads or "
+                                         "BYTES_PER_THREAD", t, transfer.diag.total_steps));
+      if (transfer.diag.registers > result.registers_per_thread)
+        result.registers_per_thread = transfer.diag.registers;
+      for (int b = 0; b < transfer.buffers; b++)
+      {
+        Instance instance;
+        instance.transfer = t;
+        instance.buffer = b;
+        instance.dmaID = next_dmaID++;
+        instance.dma_threads = transfer.diag.dma_threads;
+        if (transfer.shared_warps && (b > 0))
+          instance.dma_threadIdx_start = result.instances.back().dma_threadIdx_start;
+        else
+        {
+          instance.dma_threadIdx_start = next_thread;
+          next_thread += transfer.diag.dma_threads;
+        }
+        result.shared_bytes = (result.shared_bytes + BUFFER_ALIGNMENT - 1) & ~(BUFFER_ALIGNMENT - 1);
+        instance.shared_offset = result.shared_bytes;
+        result.shared_bytes += transfer.buffer_bytes;
+        result.instances.push_back(instance);
+      }
+    }
+    result.threads_per_cta = next_thread;
+    result.dma_threads = next_thread - compute_threads;
+    // Each dmaID uses named barriers 2*dmaID and 2*dmaID+1
+    if ((2*(next_dmaID - 1) + 1) >= device.named_barriers)
+      result.errors.push_back(format("%d instances need named barriers up to %d but only %d exist",
+                                     next_dmaID - 1, 2*(next_dmaID - 1) + 1, device.named_barriers));
+    if (result.threads_per_cta > device.max_threads_per_cta)
+      result.errors.push_back(format("%d threads per CTA exceed the maximum of %d",
+                                     result.threads_per_cta, device.max_threads_per_cta));
+    if (result.shared_bytes > device.shared_per_cta)
+      result.errors.push_back(format("%d bytes of shared memory per CTA exceed the maximum of %d",
+                                     result.shared_bytes, device.shared_per_cta));
+    // Registers are allocated in units of 8 per thread (256 per warp)
+    result.registers_per_thread = (result.registers_per_thread + 7) & ~7;
+    if (result.registers_per_thread > device.max_registers_per_thread)
+      result.warnings.push_back(format("%d registers per thread exceed the maximum of %d, expect spills",
+                                       result.registers_per_thread, device.max_registers_per_thread));
+    if (!result.valid())
+    {
+      result.ctas_per_sm = 0;
+      result.limiter = INVALID_LAYOUT;
+      result.occupancy = 0.0;
+      return result;
+    }
+    const int warps = (result.threads_per_cta + WARP_THREADS - 1)/WARP_THREADS;
+    result.ctas_per_sm = device.max_ctas_per_sm;
+    result.limiter = CTAS_LIMIT;
+    const int by_threads = device.max_threads_per_sm / (warps * WARP_THREADS);
+    if (by_threads < result.ctas_per_sm)
+    {
+      result.ctas_per_sm = by_threads;
+      result.limiter = THREADS_LIMIT;
+    }
+    const int regs = (result.registers_per_thread < device.max_registers_per_thread) ?
+                      result.registers_per_thread : device.max_registers_per_thread;
+    if (regs > 0)
+    {
+      const int by_registers = device.registers_per_sm / (warps * WARP_THREADS * regs);
+      if (by_registers < result.ctas_per_sm)
+      {
+        result.ctas_per_sm = by_registers;
+        result.limiter = REGISTERS_LIMIT;
+      }
+    }
+    if (result.shared_bytes > 0)
+    {
+      const int by_shared = device.shared_per_sm / result.shared_bytes;
+      if (by_shared < result.ctas_per_sm)
+      {
+        result.ctas_per_sm = by_shared;
+        result.limiter = SHARED_LIMIT;
+      }
+    }
+    result.occupancy = double(result.ctas_per_sm * warps * WARP_THREADS) / device.max_threads_per_sm;
+    if (result.ctas_per_sm == 0)
+      result.errors.push_back(std::string("the CTA does not fit on an SM (limited by ") +
+                              limiter_name(result.limiter) + ")");
+    else if (result.occupancy <= 0.5)
+      result.warnings.push_back(format("occupancy is only %d%%", int(100.0*result.occupancy + 0.5)));
+    return result;
+  }
+
+  // Print the plan along with the constructor arguments of every instance
+  static inline void print_plan(const Plan &plan, const std::vector<Transfer> &transfers,
+                                FILE *out = stdout)
+  {
+    fprintf(out,"  THREADS PER CTA:      %d (%d compute, %d DMA)\n", plan.threads_per_cta,
+            plan.compute_threads, plan.dma_threads);
+    fprintf(out,"  SHARED BYTES PER CTA: %d\n", plan.shared_bytes);
+    fprintf(out,"  REGISTERS PER THREAD: %d\n", plan.registers_per_thread);
+    if (plan.valid())
+      fprintf(out,"  CTAS PER SM:          %d (limited by %s, %.0f%% occupancy)\n", plan.ctas_per_sm,
+              limiter_name(plan.limiter), 100.0*plan.occupancy);
+    fprintf(out,"  INSTANCES:\n");
+    for (unsigned i = 0; i < plan.instances.size(); i++)
+    {
+      const Instance &instance = plan.instances[i];
+      const CudaDMADiagnosis &diag = transfers[instance.transfer].diag;
+      fprintf(out,"    - %s<%strue,%d,%d,%d,%d", diag.pattern,
+              (strcmp(diag.pattern,"CudaDMAIndirect") ? "" : "GATHER,"), diag.alignment,
+              diag.bytes_per_thread, diag.bytes_per_elmt, diag.dma_threads);
+      if (diag.transfer_case != SEQUENTIAL_CASE)
+        fprintf(out,",%d", diag.num_elmts);
+      fprintf(out,"> dma%d(%d, %d, %d, ...)  // threads %d-%d, shared offset %d\n", i,
+              instance.dmaID, plan.compute_threads, instance.dma_threadIdx_start,
+              instance.dma_threadIdx_start, instance.dma_threadIdx_start + instance.dma_threads - 1,
+              instance.shared_offset);
+    }
+    for (unsigned i = 0; i < plan.warnings.size(); i++)
+      fprintf(out,"  WARNING: %s\n", plan.warnings[i].c_str());
+    for (unsigned i = 0; i < plan.errors.size(); i++)
+      fprintf(out,"  ERROR: %s\n", plan.errors[i].c_str());
+    fflush(out);
+  }
+
+} // namespace CudaDMALaunch
+
+// EOF
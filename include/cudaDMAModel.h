@@ -0,0 +1,226 @@
+/*
+ *  Copyright 2013 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#pragma once
+
+// Analytical performance model for CudaDMA version 2.0 transfers.
+//
+// The model works from the layout that the analyze methods of the
+// diagnostic classes report (see CudaDMADiagnosis in cudaDMAv2.h)
+// so configurations can be compared without compiling them.  It only
+// captures first order effects:
+//  - every step is a round trip to memory, so a transfer takes at least
+//    total_steps memory latencies, unless the steps are pipelined and the
+//    loads of the next step are in flight while the current one streams
+//  - an SM can only keep a limited number of loads in flight, so a step
+//    that issues more loads than that pays the latency several times
+//  - the loads of a step share the memory bandwidth of the SM with the
+//    transfers of the other CTAs on the SM
+//  - misaligned and partially used 32 byte sectors waste bandwidth, even
+//    when the step is dominated by the latency
+// The absolute numbers are rough estimates.  Use them to rank candidates
+// and then measure the best few on the real hardware.
+
+#include "cudaDMAv2.h"
+
+#include <cmath>
+#include <vector>
+#include <algorithm>
+
+namespace CudaDMAModel {
+
+  // Default values are for a Kepler class GPU, per SM
+  struct Machine {
+    double latency; // cycles for a global load to return
+    double bandwidth; // bytes per cycle of global memory bandwidth
+    int max_loads_in_flight; // per thread loads the SM can have outstanding
+    Machine(void)
+      : latency(500.0), bandwidth(24.0), max_loads_in_flight(1024) { }
+  };
+
+  static const int SECTOR_BYTES = 32;
+  static const int WARP_THREADS = 32;
+
+  // Expected number of sectors touched by a contiguous run of bytes that
+  // starts at a multiple of alignment, averaged over where in a sector it starts
+  static inline double expected_sectors(int bytes, int alignment)
+  {
+    if (bytes <= 0)
+      return 0.0;
+    const int starts = (alignment < SECTOR_BYTES) ? (SECTOR_BYTES/alignment) : 1;
+    double total = 0.0;
+    for (int i = 0; i < starts; i++)
+    {
+      const int start = i * alignment;
+      total += double((start + bytes + SECTOR_BYTES - 1)/SECTOR_BYTES);
+    }
+    return (total/starts);
+  }
+
+  // Bytes moved from memory for all the elements of a transfer.  A warp
+  // wide load covers 32*ALIGNMENT contiguous bytes of an element (or all
+  // of it when a warp is split across elements) so each such chunk of
+  // an element is a separate request with its own partially used sectors.
+  static inline double transferred_bytes(const CudaDMADiagnosis &diag)
+  {
+    const int chunk = (diag.transfer_case == SPLIT_ELMTS_CASE) ? diag.bytes_per_elmt :
+                                                                 (WARP_THREADS*diag.alignment);
+    double sectors = 0.0;
+    for (int offset = 0; offset < diag.bytes_per_elmt; offset += chunk)
+    {
+      const int bytes = ((diag.bytes_per_elmt - offset) < chunk) ? (diag.bytes_per_elmt - offset) : chunk;
+      sectors += expected_sectors(bytes, diag.alignment);
+    }
+    return (sectors * SECTOR_BYTES * diag.num_elmts);
+  }
+
+  struct Estimate {
+    double cycles; // for one transfer of every CTA on the SM
+    double requested_bytes; // per CTA
+    double transferred_bytes; // per CTA
+    double bandwidth; // achieved bytes per cycle for the SM
+    int outstanding_loads; // per thread loads of one step of every CTA on the SM
+    double efficiency(void) const
+      { return (transferred_bytes > 0.0) ? requested_bytes/transferred_bytes : 1.0; }
+  };
+
+  // ctas is the number of CTAs on an SM that perform the transfer concurrently
+  static inline Estimate estimate(const CudaDMADiagnosis &diag, const Machine &machine, int ctas = 1)
+  {
+    Estimate result;
+    const int steps = (diag.total_steps > 0) ? diag.total_steps : 1;
+    result.requested_bytes = double(diag.bytes_per_elmt) * diag.num_elmts;
+    result.transferred_bytes = transferred_bytes(diag);
+    const double step_bytes = (ctas * result.transferred_bytes) / steps;
+    // The loads of a step are issued back to back, but only so many of
+    // them can be waiting on memory at once.  The rest wait for a slot,
+    // which costs another latency per batch of loads in flight.  Every
+    // byte of the step, wasted sectors included, then has to stream
+    // through the memory bandwidth of the SM behind the first one.
+    const int active_threads = diag.dma_threads - diag.idle_dma_threads;
+    result.outstanding_loads = ctas * diag.loads_per_thread *
+                               ((active_threads > 0) ? active_threads : diag.dma_threads);
+    const int in_flight = (machine.max_loads_in_flight > 0) ? machine.max_loads_in_flight : 1;
+    const double batches = std::max(1.0, double(result.outstanding_loads) / in_flight);
+    const double step_latency = batches * machine.latency;
+    const double step_transfer = step_bytes / machine.bandwidth;
+    // A pipelined transfer refills each half of the buffer with the next
+    // step as soon as it is stored, so only the first step exposes its
+    // whole latency and every later one costs the longer of the two
+    if (diag.pipelined_steps)
+      result.cycles = step_latency + step_transfer +
+                      (steps - 1) * std::max(step_latency, step_transfer);
+    else
+      result.cycles = steps * (step_latency + step_transfer);
+    result.bandwidth = (ctas * result.requested_bytes) / result.cycles;
+    return result;
+  }
+
+  struct Candidate {
+    CudaDMADiagnosis diag;
+    Estimate estimate;
+    int dma_registers; // staging registers of all DMA threads together
+  };
+
+  // Higher bandwidth first, then less wasted bandwidth, fewer steps and fewer,
+  // wider loads, then the cheapest in registers and threads
+  static inline bool better(const Candidate &one, const Candidate &two)
+  {
+    // Ignore differences below a tenth of a percent
+    const double scale = std::max(one.estimate.bandwidth, two.estimate.bandwidth);
+    if (fabs(one.estimate.bandwidth - two.estimate.bandwidth) > (scale * 1e-3))
+      return (one.estimate.bandwidth > two.estimate.bandwidth);
+    if (fabs(one.estimate.efficiency() - two.estimate.efficiency()) > 1e-3)
+      return (one.estimate.efficiency() > two.estimate.efficiency());
+    if (one.diag.total_steps != two.diag.total_steps)
+      return (one.diag.total_steps < two.diag.total_steps);
+    if (one.estimate.outstanding_loads != two.estimate.outstanding_loads)
+      return (one.estimate.outstanding_loads < two.estimate.outstanding_loads);
+    if (one.dma_registers != two.dma_registers)
+      return (one.dma_registers < two.dma_registers);
+    if (one.diag.dma_threads != two.diag.dma_threads)
+      return (one.diag.dma_threads < two.diag.dma_threads);
+    return (one.diag.bytes_per_thread < two.diag.bytes_per_thread);
+  }
+
+  // Which CudaDMA object a search is for
+  enum Pattern {
+    SEQUENTIAL_PATTERN,
+    STRIDED_PATTERN,
+    INDIRECT_PATTERN,
+  };
+
+  struct SearchSpace {
+    int max_alignment; // alignment guaranteed for the pointers and strides
+    int max_bytes_per_thread;
+    int max_dma_threads;
+    SearchSpace(void)
+      : max_alignment(16), max_bytes_per_thread(64), max_dma_threads(512) { }
+  };
+
+  // Evaluate every fully templated configuration in the search space
+  // and return them ranked from best to worst
+  static inline std::vector<Candidate> search(Pattern pattern, int bytes_per_elmt, int num_elmts,
+                                              const SearchSpace &space, const Machine &machine,
+                                              int ctas = 1)
+  {
+    std::vector<Candidate> candidates;
+    for (int alignment = 4; alignment <= 16; alignment *= 2)
+    {
+      if (alignment > space.max_alignment)
+        break;
+      // Elements have to be at least as large as the alignment and
+      // indirect transfers move whole aligned elements
+      if (bytes_per_elmt < alignment)
+        break;
+      if ((pattern == INDIRECT_PATTERN) && ((bytes_per_elmt % alignment) != 0))
+        continue;
+      for (int bytes_per_thread = alignment; bytes_per_thread <= space.max_bytes_per_thread;
+            bytes_per_thread += alignment)
+      {
+        for (int dma_threads = WARP_THREADS; dma_threads <= space.max_dma_threads;
+              dma_threads += WARP_THREADS)
+        {
+          Candidate candidate;
+          switch (pattern)
+          {
+            case SEQUENTIAL_PATTERN:
+              candidate.diag = CudaDMASequential<>::analyze(alignment, bytes_per_thread,
+                                                  bytes_per_elmt, dma_threads, true);
+              break;
+            case STRIDED_PATTERN:
+              candidate.diag = CudaDMAStrided<>::analyze(alignment, bytes_per_thread,
+                                                  bytes_per_elmt, dma_threads, num_elmts, true);
+              break;
+            case INDIRECT_PATTERN:
+              candidate.diag = CudaDMAIndirect<>::analyze(alignment, bytes_per_thread,
+                                                  bytes_per_elmt, dma_threads, num_elmts, true);
+              break;
+          }
+          candidate.estimate = estimate(candidate.diag, machine, ctas);
+          candidate.dma_registers = dma_threads *
+            (candidate.diag.bulk_registers + candidate.diag.across_registers);
+          candidates.push_back(candidate);
+        }
+      }
+    }
+    std::stable_sort(candidates.begin(), candidates.end(), better);
+    return candidates;
+  }
+
+} // namespace CudaDMAModel
+
+// EOF
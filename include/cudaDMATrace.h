@@ -0,0 +1,544 @@
+/*
+ *  Copyright 2013 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#pragma once
+
+// Per-lane address traces for CudaDMA version 2.0 instances.
+//
+// The trace functions run a fully templated, non-warp-specialized
+// instance on the host backend (see cudaDMAHost.h) and record every
+// load and store that its DMA threads issue.  Since the instance runs
+// the same code as on the GPU the addresses are exactly the ones the
+// constructors compute from dma_offset, dma_step_stride, etc.  The
+// warp-specialized version of an instance issues the same accesses.
+//
+// Source and destination buffers are allocated 256 byte aligned and
+// every access is reported as a byte offset from the start of its buffer.
+// The src_offset and dst_offset arguments shift the pointers handed to
+// the instance to model misaligned transfers.  For gathers and copies
+// into shared memory the destination offsets are shared memory addresses
+// of a buffer starting at zero.
+//
+// Steps are counted per lane from the data it moves: a lane starts a
+// new step when it issues a load after having stored data of its current
+// step, and every store belongs to the step of the loads it writes out
+// (lanes store their data in the order they loaded it).  Transfers whose
+// steps are software pipelined (Plan::pipelined_steps) refill one half of
+// the buffer while the other half still holds the previous step, so their
+// loads and stores interleave across steps but are still reported in the
+// same steps as analyze().  Loads of the indices of CudaDMAIndirect are
+// not traced.  Prefetches are traced as their own kind of access in the
+// current step of their lane, with offsets from whichever buffer they fall
+// in, and are left out of the coalescing and bank conflict statistics.
+
+#include "cudaDMAv2.h"
+
+#ifndef CUDADMA_HOST_BACKEND
+#error "cudaDMATrace.h needs the host backend and can't be compiled with nvcc"
+#endif
+
+#include <vector>
+#include <mutex>
+#include <algorithm>
+#include <map>
+#include <set>
+#include <deque>
+
+namespace CudaDMATrace {
+
+  struct Access {
+    int step;
+    int warp;
+    int lane;
+    CudaDMAHost::TraceKind kind;
+    long offset; // from the start of the source (loads) or destination (stores) buffer
+    int bytes;
+  };
+
+  // Collects the accesses of one traced launch
+  class Recorder {
+  public:
+    Recorder(const char *src, size_t src_bytes, const char *dst, size_t dst_bytes, int threads)
+      : src_base(src), src_size(src_bytes), dst_base(dst), dst_size(dst_bytes),
+        steps(threads, 0), stored_step(threads, false), pending(threads)
+    {
+      active() = this;
+      CudaDMAHost::trace_hook() = &Recorder::record;
+    }
+    ~Recorder(void)
+    {
+      CudaDMAHost::trace_hook() = NULL;
+      active() = NULL;
+    }
+  public:
+    // Accesses sorted by step, then warp, then lane, in issue order for each lane
+    std::vector<Access> finish(void)
+    {
+      std::stable_sort(accesses.begin(), accesses.end(), Recorder::before);
+      return accesses;
+    }
+  private:
+    static Recorder*& active(void)
+    {
+      static Recorder *recorder = NULL;
+      return recorder;
+    }
+    static bool before(const Access &one, const Access &two)
+    {
+      if (one.step != two.step)
+        return (one.step < two.step);
+      if (one.warp != two.warp)
+        return (one.warp < two.warp);
+      return (one.lane < two.lane);
+    }
+    static void record(CudaDMAHost::TraceKind kind, const void *ptr, size_t bytes)
+    {
+      Recorder *recorder = active();
+      if (recorder == NULL)
+        return;
+      const int tid = CudaDMAHost::context().thread_idx.x;
+      const char *addr = static_cast<const char*>(ptr);
+      // Prefetches warm either the source of a load or the destination of a store
+      const bool is_load = (kind == CudaDMAHost::TRACE_LOAD) ||
+                           ((kind == CudaDMAHost::TRACE_PREFETCH) && recorder->in_source(addr));
+      const char *base = is_load ? recorder->src_base : recorder->dst_base;
+      const size_t size = is_load ? recorder->src_size : recorder->dst_size;
+      if ((addr < base) || (addr >= (base + size)))
+      {
+        fprintf(stderr,"CudaDMA trace: %s outside of the %s buffer by thread %d\n",
+                ((kind == CudaDMAHost::TRACE_PREFETCH) ? "prefetch" : is_load ? "load" : "store"),
+                (is_load ? "source" : "destination"), tid);
+        exit(1);
+      }
+      std::lock_guard<std::mutex> guard(recorder->lock);
+      // Lanes only ever touch their own step state
+      Access access;
+      if (kind == CudaDMAHost::TRACE_PREFETCH)
+        access.step = recorder->steps[tid];
+      else if (is_load)
+      {
+        if (recorder->stored_step[tid])
+        {
+          recorder->steps[tid]++;
+          recorder->stored_step[tid] = false;
+        }
+        access.step = recorder->steps[tid];
+        recorder->pending[tid].push_back(std::make_pair(access.step, bytes));
+      }
+      else
+        access.step = recorder->retire(tid, bytes);
+      access.warp = tid/warpSize;
+      access.lane = tid%warpSize;
+      access.kind = kind;
+      access.offset = long(addr - base);
+      access.bytes = int(bytes);
+      recorder->accesses.push_back(access);
+    }
+    bool in_source(const char *addr) const
+    {
+      return ((addr >= src_base) && (addr < (src_base + src_size)));
+    }
+    // Consumes the oldest loaded bytes of a lane and returns their step
+    int retire(int tid, size_t bytes)
+    {
+      std::deque<std::pair<int,size_t> > &loaded = pending[tid];
+      if (loaded.empty())
+        return steps[tid];
+      const int step = loaded.front().first;
+      while ((bytes > 0) && !loaded.empty())
+      {
+        const size_t consumed = (bytes < loaded.front().second) ? bytes : loaded.front().second;
+        loaded.front().second -= consumed;
+        bytes -= consumed;
+        if (loaded.front().second == 0)
+          loaded.pop_front();
+      }
+      if (step == steps[tid])
+        stored_step[tid] = true;
+      return step;
+    }
+  private:
+    const char *const src_base;
+    const size_t src_size;
+    const char *const dst_base;
+    const size_t dst_size;
+    std::vector<int> steps;
+    // Whether the lane stored data of its current step since its last load
+    std::vector<bool> stored_step;
+    // Loaded bytes of each lane that have not been stored yet and their steps
+    std::vector<std::deque<std::pair<int,size_t> > > pending;
+    std::vector<Access> accesses;
+    std::mutex lock;
+  };
+
+  template<int ALIGNMENT, int BYTES_PER_THREAD, int BYTES_PER_ELMT, int DMA_THREADS>
+  __global__ void sequential_kernel(const char *src, char *dst)
+  {
+    CudaDMASequential<false,ALIGNMENT,BYTES_PER_THREAD,BYTES_PER_ELMT,DMA_THREADS> dma;
+    dma.execute_dma(src, dst);
+  }
+
+  template<int ALIGNMENT, int BYTES_PER_THREAD, int BYTES_PER_ELMT, int DMA_THREADS, int NUM_ELMTS>
+  __global__ void strided_kernel(const char *src, char *dst, int src_stride, int dst_stride)
+  {
+    CudaDMAStrided<false,ALIGNMENT,BYTES_PER_THREAD,BYTES_PER_ELMT,DMA_THREADS,NUM_ELMTS>
+      dma(src_stride, dst_stride);
+    dma.execute_dma(src, dst);
+  }
+
+  template<bool GATHER, int ALIGNMENT, int BYTES_PER_THREAD, int BYTES_PER_ELMT, int DMA_THREADS, int NUM_ELMTS>
+  __global__ void indirect_kernel(const int *indices, const char *src, char *dst, int alternate_stride)
+  {
+    CudaDMAIndirect<GATHER,false,ALIGNMENT,BYTES_PER_THREAD,BYTES_PER_ELMT,DMA_THREADS,NUM_ELMTS>
+      dma(alternate_stride);
+    dma.execute_dma(indices, src, dst);
+  }
+
+  // Buffers are padded so that misaligned pointers stay inside them
+  static const size_t BUFFER_PAD = 256;
+
+  static inline char* allocate_buffer(size_t bytes)
+  {
+    void *ptr = NULL;
+    cudaMalloc(&ptr, bytes + BUFFER_PAD);
+    memset(ptr, 0, bytes + BUFFER_PAD);
+    return static_cast<char*>(ptr);
+  }
+
+  // Pointers have to honor the ALIGNMENT the instance was declared with
+  static inline void check_offsets(int alignment, int src_offset, int dst_offset)
+  {
+    if (((src_offset % alignment) != 0) || ((dst_offset % alignment) != 0) ||
+        (src_offset < 0) || (dst_offset < 0) || (src_offset >= int(BUFFER_PAD)) || (dst_offset >= int(BUFFER_PAD)))
+    {
+      fprintf(stderr,"CudaDMA trace: offsets %d and %d must be multiples of the alignment %d "
+                     "between 0 and %d\n", src_offset, dst_offset, alignment, int(BUFFER_PAD));
+      exit(1);
+    }
+  }
+
+  template<int ALIGNMENT, int BYTES_PER_THREAD, int BYTES_PER_ELMT, int DMA_THREADS>
+  std::vector<Access> trace_sequential(int src_offset = 0, int dst_offset = 0)
+  {
+    check_offsets(ALIGNMENT, src_offset, dst_offset);
+    char *src = allocate_buffer(BYTES_PER_ELMT);
+    char *dst = allocate_buffer(BYTES_PER_ELMT);
+    std::vector<Access> result;
+    {
+      Recorder recorder(src, BYTES_PER_ELMT + BUFFER_PAD, dst, BYTES_PER_ELMT + BUFFER_PAD, DMA_THREADS);
+      CUDADMA_LAUNCH(1,DMA_THREADS,0,0,sequential_kernel<ALIGNMENT,BYTES_PER_THREAD,BYTES_PER_ELMT,DMA_THREADS>)
+        (src + src_offset, dst + dst_offset);
+      result = recorder.finish();
+    }
+    cudaFree(src);
+    cudaFree(dst);
+    return result;
+  }
+
+  template<int ALIGNMENT, int BYTES_PER_THREAD, int BYTES_PER_ELMT, int DMA_THREADS, int NUM_ELMTS>
+  std::vector<Access> trace_strided(int src_stride, int dst_stride, int src_offset = 0, int dst_offset = 0)
+  {
+    check_offsets(ALIGNMENT, src_offset, dst_offset);
+    const size_t src_bytes = size_t(NUM_ELMTS-1)*src_stride + BYTES_PER_ELMT;
+    const size_t dst_bytes = size_t(NUM_ELMTS-1)*dst_stride + BYTES_PER_ELMT;
+    char *src = allocate_buffer(src_bytes);
+    char *dst = allocate_buffer(dst_bytes);
+    std::vector<Access> result;
+    {
+      Recorder recorder(src, src_bytes + BUFFER_PAD, dst, dst_bytes + BUFFER_PAD, DMA_THREADS);
+      CUDADMA_LAUNCH(1,DMA_THREADS,0,0,strided_kernel<ALIGNMENT,BYTES_PER_THREAD,BYTES_PER_ELMT,DMA_THREADS,NUM_ELMTS>)
+        (src + src_offset, dst + dst_offset, src_stride, dst_stride);
+      result = recorder.finish();
+    }
+    cudaFree(src);
+    cudaFree(dst);
+    return result;
+  }
+
+  // For gathers the indices select source elements and the destination
+  // elements are alternate_stride bytes apart (at least BYTES_PER_ELMT),
+  // for scatters it is the other way around
+  template<bool GATHER, int ALIGNMENT, int BYTES_PER_THREAD, int BYTES_PER_ELMT, int DMA_THREADS, int NUM_ELMTS>
+  std::vector<Access> trace_indirect(const std::vector<int> &indices, int src_offset = 0, int dst_offset = 0,
+                                     int alternate_stride = 0)
+  {
+    check_offsets(ALIGNMENT, src_offset, dst_offset);
+    if (int(indices.size()) < NUM_ELMTS)
+    {
+      fprintf(stderr,"CudaDMA trace: %d indices needed but only %d given\n", NUM_ELMTS, int(indices.size()));
+      exit(1);
+    }
+    int max_index = 0;
+    for (int i = 0; i < NUM_ELMTS; i++)
+      max_index = (indices[i] > max_index) ? indices[i] : max_index;
+    const size_t indexed_bytes = size_t(max_index+1)*BYTES_PER_ELMT;
+    const size_t packed_bytes = size_t(NUM_ELMTS-1)*((alternate_stride > BYTES_PER_ELMT) ?
+                                  alternate_stride : BYTES_PER_ELMT) + BYTES_PER_ELMT;
+    const size_t src_bytes = GATHER ? indexed_bytes : packed_bytes;
+    const size_t dst_bytes = GATHER ? packed_bytes : indexed_bytes;
+    char *src = allocate_buffer(src_bytes);
+    char *dst = allocate_buffer(dst_bytes);
+    std::vector<Access> result;
+    {
+      Recorder recorder(src, src_bytes + BUFFER_PAD, dst, dst_bytes + BUFFER_PAD, DMA_THREADS);
+      CUDADMA_LAUNCH(1,DMA_THREADS,0,0,indirect_kernel<GATHER,ALIGNMENT,BYTES_PER_THREAD,BYTES_PER_ELMT,DMA_THREADS,NUM_ELMTS>)
+        (&indices[0], src + src_offset, dst + dst_offset, alternate_stride);
+      result = recorder.finish();
+    }
+    cudaFree(src);
+    cudaFree(dst);
+    return result;
+  }
+
+  static inline void print_csv(const std::vector<Access> &accesses, FILE *out = stdout)
+  {
+    fprintf(out,"step,warp,lane,kind,offset,bytes\n");
+    for (unsigned idx = 0; idx < accesses.size(); idx++)
+    {
+      const Access &access = accesses[idx];
+      fprintf(out,"%d,%d,%d,%s,%ld,%d\n", access.step, access.warp, access.lane,
+              ((access.kind == CudaDMAHost::TRACE_LOAD) ? "ld" :
+               (access.kind == CudaDMAHost::TRACE_STORE) ? "st" : "pf"), access.offset, access.bytes);
+    }
+    fflush(out);
+  }
+
+  // A request is one memory instruction executed by a warp.  The trace
+  // doesn't record instructions so the n-th access of a given size that
+  // a lane issues in a step is assumed to come from the same instruction
+  // as the n-th access of that size issued by the other lanes of its warp.
+  // This matches the unrolled loops of the transfer code, including the
+  // split warp case where the lanes of a warp work on different elements,
+  // and puts the narrower accesses of the partial-byte tails in separate requests.
+  //
+  // Requests are keyed by (step, warp) and (bytes, n).
+  typedef std::pair<std::pair<int,int>,std::pair<int,int> > RequestKey;
+  typedef std::map<RequestKey,std::vector<Access> > RequestMap;
+
+  static inline RequestMap group_requests(const std::vector<Access> &accesses, bool loads)
+  {
+    RequestMap requests;
+    std::map<int,int> issued; // accesses of each size by the current lane
+    int last_step = -1, last_warp = -1, last_lane = -1;
+    for (unsigned idx = 0; idx < accesses.size(); idx++)
+    {
+      const Access &access = accesses[idx];
+      if (access.kind != (loads ? CudaDMAHost::TRACE_LOAD : CudaDMAHost::TRACE_STORE))
+        continue;
+      if ((access.step != last_step) || (access.warp != last_warp) || (access.lane != last_lane))
+      {
+        issued.clear();
+        last_step = access.step;
+        last_warp = access.warp;
+        last_lane = access.lane;
+      }
+      RequestKey key(std::make_pair(access.step, access.warp),
+                     std::make_pair(access.bytes, issued[access.bytes]++));
+      requests[key].push_back(access);
+    }
+    return requests;
+  }
+
+  // Global memory coalescing of the loads (or stores) of a trace.
+  // Requests are serviced in 32 byte sectors of 128 byte cache lines.
+  static const int SECTOR_BYTES = 32;
+  static const int LINE_BYTES = 128;
+
+  struct CoalescingStats {
+    int step; // -1 for the totals of all steps
+    int requests;
+    long sectors;
+    long lines;
+    long requested_bytes; // distinct bytes asked for by the lanes
+    long transferred_bytes; // bytes of all the sectors moved
+    double sectors_per_request(void) const
+      { return (requests > 0) ? double(sectors)/requests : 0.0; }
+    double lines_per_request(void) const
+      { return (requests > 0) ? double(lines)/requests : 0.0; }
+    long wasted_bytes(void) const { return (transferred_bytes - requested_bytes); }
+    double efficiency(void) const
+      { return (transferred_bytes > 0) ? double(requested_bytes)/transferred_bytes : 1.0; }
+  };
+
+  // Per step statistics followed by the totals over all steps
+  static inline std::vector<CoalescingStats> coalescing(const std::vector<Access> &accesses,
+                                                        bool loads = true)
+  {
+    RequestMap requests = group_requests(accesses, loads);
+    std::map<int,CoalescingStats> steps;
+    CoalescingStats total = { -1, 0, 0, 0, 0, 0 };
+    for (RequestMap::const_iterator it = requests.begin(); it != requests.end(); it++)
+    {
+      std::vector<std::pair<long,long> > ranges;
+      for (unsigned idx = 0; idx < it->second.size(); idx++)
+        ranges.push_back(std::make_pair(it->second[idx].offset,
+                                        it->second[idx].offset + it->second[idx].bytes));
+      std::sort(ranges.begin(), ranges.end());
+      std::set<long> sectors, lines;
+      long requested = 0, covered = 0;
+      for (unsigned idx = 0; idx < ranges.size(); idx++)
+      {
+        // Count each byte once even if several lanes ask for it
+        const long start = (ranges[idx].first > covered) ? ranges[idx].first : covered;
+        if (ranges[idx].second > start)
+          requested += (ranges[idx].second - start);
+        if (ranges[idx].second > covered)
+          covered = ranges[idx].second;
+        for (long sector = ranges[idx].first/SECTOR_BYTES;
+              sector <= (ranges[idx].second-1)/SECTOR_BYTES; sector++)
+          sectors.insert(sector);
+        for (long line = ranges[idx].first/LINE_BYTES;
+              line <= (ranges[idx].second-1)/LINE_BYTES; line++)
+          lines.insert(line);
+      }
+      const int step = it->first.first.first;
+      if (steps.find(step) == steps.end())
+      {
+        CoalescingStats empty = { step, 0, 0, 0, 0, 0 };
+        steps[step] = empty;
+      }
+      CoalescingStats *stats[2] = { &steps[step], &total };
+      for (int i = 0; i < 2; i++)
+      {
+        stats[i]->requests++;
+        stats[i]->sectors += sectors.size();
+        stats[i]->lines += lines.size();
+        stats[i]->requested_bytes += requested;
+        stats[i]->transferred_bytes += long(sectors.size())*SECTOR_BYTES;
+      }
+    }
+    std::vector<CoalescingStats> result;
+    for (std::map<int,CoalescingStats>::iterator it = steps.begin(); it != steps.end(); it++)
+      result.push_back(it->second);
+    result.push_back(total);
+    return result;
+  }
+
+  static inline void print_coalescing(const std::vector<CoalescingStats> &stats, FILE *out = stdout)
+  {
+    fprintf(out,"%6s %9s %12s %10s %10s %12s %8s %11s\n", "step", "requests", "sectors/req",
+            "lines/req", "requested", "transferred", "wasted", "efficiency");
+    for (unsigned idx = 0; idx < stats.size(); idx++)
+    {
+      const CoalescingStats &s = stats[idx];
+      if (s.step < 0)
+        fprintf(out,"%6s", "total");
+      else
+        fprintf(out,"%6d", s.step);
+      fprintf(out," %9d %12.2f %10.2f %10ld %12ld %8ld %10.1f%%\n", s.requests,
+              s.sectors_per_request(), s.lines_per_request(), s.requested_bytes,
+              s.transferred_bytes, s.wasted_bytes(), 100.0*s.efficiency());
+    }
+    fflush(out);
+  }
+
+  // Shared memory bank conflicts of the loads (or stores) of a trace.
+  // Shared memory has 32 banks of 4 byte words.  A request is split into
+  // phases of 128 bytes: all 32 lanes for 4 byte accesses, half warps for
+  // 8 byte accesses and quarter warps for 16 byte accesses.  Each phase
+  // takes as many wavefronts as the largest number of distinct words it
+  // touches in a single bank (lanes reading the same word don't conflict).
+  static const int NUM_BANKS = 32;
+  static const int BANK_BYTES = 4;
+
+  struct BankConflict {
+    int step;
+    int warp;
+    int bytes; // size of the accesses of the request
+    int index; // n-th access of this size by the lanes in the step
+    int lanes;
+    int wavefronts;
+    int ideal_wavefronts; // phases with at least one active lane
+    double degree(void) const
+      { return (ideal_wavefronts > 0) ? double(wavefronts)/ideal_wavefronts : 1.0; }
+  };
+
+  static inline std::vector<BankConflict> bank_conflicts(const std::vector<Access> &accesses,
+                                                        bool loads = false)
+  {
+    RequestMap requests = group_requests(accesses, loads);
+    std::vector<BankConflict> result;
+    for (RequestMap::const_iterator it = requests.begin(); it != requests.end(); it++)
+    {
+      const std::vector<Access> &lanes = it->second;
+      const int bytes = it->first.second.first;
+      const int lanes_per_phase = (bytes < (NUM_BANKS*BANK_BYTES)) ? (NUM_BANKS*BANK_BYTES)/bytes : 1;
+      std::map<int,std::vector<std::set<long> > > phases;
+      for (unsigned idx = 0; idx < lanes.size(); idx++)
+      {
+        std::vector<std::set<long> > &banks = phases[lanes[idx].lane/lanes_per_phase];
+        banks.resize(NUM_BANKS);
+        for (long word = lanes[idx].offset/BANK_BYTES;
+              word <= (lanes[idx].offset+lanes[idx].bytes-1)/BANK_BYTES; word++)
+          banks[word%NUM_BANKS].insert(word);
+      }
+      BankConflict conflict;
+      conflict.step = it->first.first.first;
+      conflict.warp = it->first.first.second;
+      conflict.bytes = bytes;
+      conflict.index = it->first.second.second;
+      conflict.lanes = int(lanes.size());
+      conflict.wavefronts = 0;
+      conflict.ideal_wavefronts = int(phases.size());
+      for (std::map<int,std::vector<std::set<long> > >::const_iterator phase = phases.begin();
+            phase != phases.end(); phase++)
+      {
+        size_t worst = 1;
+        for (int bank = 0; bank < NUM_BANKS; bank++)
+          worst = (phase->second[bank].size() > worst) ? phase->second[bank].size() : worst;
+        conflict.wavefronts += int(worst);
+      }
+      result.push_back(conflict);
+    }
+    return result;
+  }
+
+  static inline long total_wavefronts(const std::vector<BankConflict> &conflicts)
+  {
+    long total = 0;
+    for (unsigned idx = 0; idx < conflicts.size(); idx++)
+      total += conflicts[idx].wavefronts;
+    return total;
+  }
+
+  static inline long total_ideal_wavefronts(const std::vector<BankConflict> &conflicts)
+  {
+    long total = 0;
+    for (unsigned idx = 0; idx < conflicts.size(); idx++)
+      total += conflicts[idx].ideal_wavefronts;
+    return total;
+  }
+
+  static inline void print_bank_conflicts(const std::vector<BankConflict> &conflicts, FILE *out = stdout)
+  {
+    fprintf(out,"%6s %6s %6s %6s %6s %11s %6s %7s\n", "step", "warp", "bytes", "index",
+            "lanes", "wavefronts", "ideal", "degree");
+    for (unsigned idx = 0; idx < conflicts.size(); idx++)
+    {
+      const BankConflict &c = conflicts[idx];
+      fprintf(out,"%6d %6d %6d %6d %6d %11d %6d %6.2fx\n", c.step, c.warp, c.bytes, c.index,
+              c.lanes, c.wavefronts, c.ideal_wavefronts, c.degree());
+    }
+    const long wavefronts = total_wavefronts(conflicts);
+    const long ideal = total_ideal_wavefronts(conflicts);
+    fprintf(out,"%6s %6s %6s %6s %6s %11ld %6ld %6.2fx\n", "total", "", "", "", "", wavefronts, ideal,
+            (ideal > 0) ? double(wavefronts)/ideal : 1.0);
+    fflush(out);
+  }
+
+} // namespace CudaDMATrace
+
+// EOF
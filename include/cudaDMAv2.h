@@ -19,6 +19,22 @@
 // For diagnostic functions we need printf
 #include <cstdio>
 
+// Without nvcc there is no GPU to run on so fall back to
+// emulating CTAs with host threads (see cudaDMAHost.h)
+#if !defined(__CUDACC__) && !defined(CUDADMA_HOST_BACKEND)
+#define CUDADMA_HOST_BACKEND
+#endif
+
+#ifdef CUDADMA_HOST_BACKEND
+#include "cudaDMAHost.h"
+#else
+// Portable spellings of kernel<<<grid,block,shmem,stream>>>(args)
+// and extern __shared__ type name[] that also work on the host
+#define CUDADMA_LAUNCH(grid,block,shmem,stream,...) \
+  __VA_ARGS__<<<grid,block,shmem,stream>>>
+#define CUDADMA_EXTERN_SHARED(type,name) extern __shared__ type name[]
+#endif
+
 #define WARP_SIZE 32
 #define WARP_MASK 0x1f
 #define CUDADMA_DMA_TID (threadIdx.x-dma_threadIdx_start)
@@ -53,6 +69,8 @@ enum CudaDMALoadQualifier {
   LOAD_CACHE_STREAMING, // cache all levels, but mark evict first
   LOAD_CACHE_LAST_USE, // invalidates line after use
   LOAD_CACHE_VOLATILE, // don't cache at any level
+  LOAD_PREFETCH_L2, // prefetch into L2 without loading into registers
+  LOAD_DISCARD, // perform no load at all
 };
 
 enum CudaDMAStoreQualifier {
@@ -62,16 +80,208 @@ enum CudaDMAStoreQualifier {
   STORE_CACHE_WRITE_THROUGH, // write through L2 to system memory
 };
 
+// A store qualifier can carry a shared memory swizzle in the bits above
+// the qualifier itself (see CudaDMASwizzle).  Swizzled qualifiers are
+// accepted wherever a DMA_STORE_QUAL template parameter is.
+#define CUDADMA_STORE_QUAL_MASK 0xff
+#define CUDADMA_STORE_SWIZZLED (1 << 8)
+#define CUDADMA_SWIZZLED_STORE(qual,bits,base,shift) \
+  ((qual) | CUDADMA_STORE_SWIZZLED | ((bits) << 9) | ((base) << 13) | ((shift) << 18))
+#define CUDADMA_SWIZZLE_BITS(qual) (((qual) >> 9) & 0xf)
+#define CUDADMA_SWIZZLE_BASE(qual) (((qual) >> 13) & 0x1f)
+#define CUDADMA_SWIZZLE_SHIFT(qual) (((qual) >> 18) & 0x1f)
+#define CUDADMA_STORE_SWIZZLE_FIELDS (0x7fff << 8)
+
+// The reductions a store qualifier can ask for instead of a plain store
+// (see CudaDMAReduce).  Reducing stores are performed with atomics.
+enum CudaDMAReduceOp {
+  REDUCE_NONE,
+  REDUCE_ADD,
+  REDUCE_MIN,
+  REDUCE_MAX,
+};
+
+#define CUDADMA_REDUCE_STORE(qual,op,is_int,aggregate) \
+  ((qual) | ((op) << 23) | ((is_int) << 25) | ((aggregate) << 26))
+#define CUDADMA_REDUCE_OP(qual) (((qual) >> 23) & 0x3)
+#define CUDADMA_REDUCE_INT(qual) (((qual) >> 25) & 0x1)
+#define CUDADMA_REDUCE_AGGREGATE(qual) (((qual) >> 26) & 0x1)
+
+// A store qualifier with the discard bit set performs no store at all.
+// The prefetch methods of the patterns use it to walk a transfer
+// without writing shared memory.
+#define CUDADMA_STORE_DISCARD (1 << 27)
+
+// A store qualifier with the prefetch bit set prefetches the line it
+// would write into L2 instead of storing.  Scatters prefetch with it,
+// skipping their shared memory loads with LOAD_DISCARD.
+#define CUDADMA_STORE_PREFETCH_L2 (1 << 28)
+
+// The different ways a transfer can be laid out across DMA threads
+enum CudaDMATransferCase {
+  SEQUENTIAL_CASE, // a single contiguous element (CudaDMASequential)
+  SPLIT_ELMTS_CASE, // a single warp loads multiple elements per step
+  BIG_ELMTS_CASE, // all warps work on one element at a time
+  FULL_ELMTS_CASE, // one or more warps per element
+};
+
+// Approximate number of 32-bit registers per DMA thread needed by the
+// state a CudaDMA instance keeps next to its staging buffers.  Pointers
+// count as two registers.  The compiler can fold some of these values
+// into immediates, so the totals are an upper estimate of what ptxas
+// reports; use them to catch configurations likely to spill.
+struct CudaDMARegisterCost {
+  static const int base = 4; // CudaDMA: DMA thread flag, barrier names and size
+  static const int sequential = 4; // offset, partial bytes and source pointer
+  static const int strided = 13; // source pointer, ten offsets and strides, active warp flag
+  static const int indirect = 16; // source and index pointers, eleven offsets and strides, active warp flag
+  static const int tensor = 5; // source pointer, start unit and column, unit count and column step
+  static const int tensor_dim = 5; // per outer dimension: extent, two strides, step and start index
+  static const int runtime_param = 1; // per template parameter passed to the constructor instead
+  static const int working = 8; // addresses and loop counters live during a transfer
+};
+
+// Machine-readable version of the information printed by the
+// diagnose methods, returned by the analyze methods of the
+// diagnostic classes (e.g. CudaDMAStrided<>::analyze).  Register
+// counts are in 32-bit registers per DMA thread.
+struct CudaDMADiagnosis {
+  const char *pattern;
+  int alignment;
+  int bytes_per_thread;
+  int bytes_per_elmt;
+  int num_elmts;
+  int dma_threads;
+  bool full_template;
+  CudaDMATransferCase transfer_case;
+  int total_steps;
+  bool pipelined_steps; // the next step is loaded while the current one is stored
+  int loads_per_thread; // maximum loads issued by a DMA thread in one step
+  int bulk_registers; // bulk_buffer
+  int across_registers; // across_buffer or partial_buffer
+  int state_registers; // offsets, strides and pointers stored by the constructor
+  int registers; // estimated total including CudaDMARegisterCost::working
+  int idle_dma_threads; // DMA threads that issue no loads in the first step
+  bool optimized; // the whole transfer is performed in a single step
+};
+
+__host__ inline
+const char* cudaDMA_transfer_case_name(const CudaDMATransferCase transfer_case)
+{
+  switch (transfer_case)
+  {
+    case SEQUENTIAL_CASE:
+      return "sequential";
+    case SPLIT_ELMTS_CASE:
+      return "split";
+    case BIG_ELMTS_CASE:
+      return "big";
+    case FULL_ELMTS_CASE:
+      return "full";
+  }
+  return "unknown";
+}
+
+// Print a diagnosis as a single line JSON object so that build
+// scripts can check configurations without parsing diagnose output
+__host__ inline
+void cudaDMA_print_diagnosis_json(const CudaDMADiagnosis &diag, FILE *out = stdout)
+{
+  fprintf(out,"{\"pattern\": \"%s\", \"alignment\": %d, \"bytes_per_thread\": %d, "
+              "\"bytes_per_elmt\": %d, \"num_elmts\": %d, \"dma_threads\": %d, "
+              "\"full_template\": %s, \"case\": \"%s\", \"total_steps\": %d, "
+              "\"pipelined_steps\": %s, \"loads_per_thread\": %d, \"bulk_registers\": %d, "
+              "\"across_registers\": %d, \"state_registers\": %d, \"registers\": %d, "
+              "\"idle_dma_threads\": %d, \"verdict\": \"%s\"}\n",
+          diag.pattern, diag.alignment, diag.bytes_per_thread, diag.bytes_per_elmt,
+          diag.num_elmts, diag.dma_threads, (diag.full_template ? "true" : "false"),
+          cudaDMA_transfer_case_name(diag.transfer_case), diag.total_steps,
+          (diag.pipelined_steps ? "true" : "false"), diag.loads_per_thread, diag.bulk_registers,
+          diag.across_registers, diag.state_registers, diag.registers,
+          diag.idle_dma_threads, (diag.optimized ? "OPTIMIZED" : "UN-OPTIMIZED"));
+  fflush(out);
+}
+
+// Registers per thread that ptxas can allocate for a kernel declared with
+// __launch_bounds__(max_threads_per_block, min_blocks_per_mp).  Registers
+// are allocated per warp in units of 256 (8 per thread).  The defaults are
+// for compute capability 3.5; use 32768 and 63 for Fermi.
+#define CUDADMA_LAUNCH_BOUNDS_REGISTERS(threads, blocks, regs_per_mp, max_regs)                   \
+  ((((regs_per_mp)/((((threads)+31)/32)*32*(blocks))) & ~7) < (max_regs) ?                          \
+    (((regs_per_mp)/((((threads)+31)/32)*32*(blocks))) & ~7) : (max_regs))
+
+template<int MAX_THREADS_PER_BLOCK, int MIN_BLOCKS_PER_MP = 1,
+         int REGISTERS_PER_MP = 65536, int MAX_REGISTERS_PER_THREAD = 255>
+struct CudaDMALaunchBounds {
+  static const int registers = CUDADMA_LAUNCH_BOUNDS_REGISTERS(MAX_THREADS_PER_BLOCK,
+                    MIN_BLOCKS_PER_MP, REGISTERS_PER_MP, MAX_REGISTERS_PER_THREAD);
+};
+
+__host__ inline
+int cudaDMA_launch_bounds_registers(const int max_threads_per_block, const int min_blocks_per_mp = 1,
+                                    const int registers_per_mp = 65536,
+                                    const int max_registers_per_thread = 255)
+{
+  return CUDADMA_LAUNCH_BOUNDS_REGISTERS(max_threads_per_block, min_blocks_per_mp,
+                                         registers_per_mp, max_registers_per_thread);
+}
+
+/**
+ * Compile-time check that the registers a fully templated instance needs fit
+ * in the budget left for it, e.g. in a kernel declared __launch_bounds__(256,2)
+ * that needs about 24 registers of its own:
+ *
+ *   typedef CudaDMAStrided<true,16,64,512,96,32> DMA;
+ *   CudaDMARegisterBudget<DMA::Plan,CudaDMALaunchBounds<256,2>::registers-24>::check();
+ *
+ * Exceeding the budget makes ptxas spill bulk_buffer and across_buffer to
+ * local memory, which severely degrades performance.
+ */
+template<typename PLAN, int REGISTER_BUDGET>
+struct CudaDMARegisterBudget {
+  static const int registers = PLAN::registers;
+  static const int budget = REGISTER_BUDGET;
+  static const bool fits = (registers <= REGISTER_BUDGET);
+  __host__ __device__ __forceinline__
+  static void check(void) { STATIC_ASSERT(fits); }
+};
+
+// Host version of CudaDMARegisterBudget for a diagnosis.  Prints a warning
+// and returns false when the instance is likely to spill.
+__host__ inline
+bool cudaDMA_check_register_budget(const CudaDMADiagnosis &diag, const int register_budget,
+                                   FILE *out = stderr)
+{
+  if (diag.registers <= register_budget)
+    return true;
+  fprintf(out,"  WARNING: %s needs about %d registers per DMA thread (%d bulk, %d across, "
+              "%d state, %d working) but the budget is %d.\n"
+              "           Its buffers are likely to spill to local memory.  Reduce BYTES-PER-THREAD\n"
+              "           or relax the __launch_bounds__ of the kernel.\n",
+          diag.pattern, diag.registers, diag.bulk_registers, diag.across_registers,
+          diag.state_registers, CudaDMARegisterCost::working, register_budget);
+  fflush(out);
+  return false;
+}
+
 __device__ __forceinline__ 
 void ptx_cudaDMA_barrier_blocking (const int name, const int num_barriers)
 {
+#ifdef CUDADMA_HOST_BACKEND
+  CudaDMAHost::barrier_blocking(name, num_barriers);
+#else
   asm volatile("bar.sync %0, %1;" : : "r"(name), "r"(num_barriers) : "memory" );
+#endif
 }
 
 __device__ __forceinline__ 
 void ptx_cudaDMA_barrier_nonblocking (const int name, const int num_barriers)
 {
+#ifdef CUDADMA_HOST_BACKEND
+  CudaDMAHost::barrier_nonblocking(name, num_barriers);
+#else
   asm volatile("bar.arrive %0, %1;" : : "r"(name), "r"(num_barriers) : "memory" );
+#endif
 }
 
 /*****************************************************/
@@ -81,11 +291,35 @@ template<typename T, bool GLOBAL_LOAD, int LOAD_QUAL>
 __device__ __forceinline__
 T ptx_cudaDMA_load(const T *src_ptr)
 {
-  T result;
-  STATIC_ASSERT(GLOBAL_LOAD && !GLOBAL_LOAD);
-  return result;
+#ifdef CUDADMA_HOST_BACKEND
+  // Discarded loads touch nothing, prefetches are only traced
+  if (LOAD_QUAL == LOAD_DISCARD)
+    return T();
+  if (LOAD_QUAL == LOAD_PREFETCH_L2)
+  {
+    CudaDMAHost::trace_access(CudaDMAHost::TRACE_PREFETCH, src_ptr, sizeof(T));
+    return T();
+  }
+  // Cache qualifiers mean nothing on the host
+  CudaDMAHost::trace_access(CudaDMAHost::TRACE_LOAD, src_ptr, sizeof(T));
+  return *src_ptr;
+#else
+  // Only prefetches and discarded loads get here, loads have a
+  // specialization below.  The value is never stored (see
+  // CUDADMA_STORE_DISCARD) so no registers are kept live for it.
+  STATIC_ASSERT((LOAD_QUAL == LOAD_PREFETCH_L2) || (LOAD_QUAL == LOAD_DISCARD));
+  if (LOAD_QUAL == LOAD_DISCARD)
+    return T();
+  if (GLOBAL_LOAD)
+    asm volatile("prefetch.global.L2 [%0];" : : "l"(src_ptr) : "memory");
+  else
+    asm volatile("prefetch.L2 [%0];" : : "l"(src_ptr) : "memory");
+  return T();
+#endif
 }
 
+#ifndef CUDADMA_HOST_BACKEND
+
 // No partial function specialization, so just do them all explicitly
 /////////////////////////////
 // FLOAT
@@ -535,17 +769,253 @@ float4 ptx_cudaDMA_load<float4,false,LOAD_CACHE_VOLATILE>(const float4 *src_ptr)
   return result;
 }
 
+#endif // CUDADMA_HOST_BACKEND
+
+/*****************************************************/
+/*           Shared memory swizzle                   */
+/*****************************************************/
+
+/**
+ * CudaDMASwizzle permutes the 2^BASE byte chunks of a shared memory tile by
+ * XOR-ing the chunk index with BITS bits of the row index, where a row is
+ * 2^SHIFT bytes.  For example CudaDMASwizzle<3,4,7> moves the 16 byte chunk c
+ * of 128 byte row r to chunk c^(r%8), so a warp reading a column of a tile of
+ * 32 floats per row hits 8 different banks without any padding.
+ *
+ * DMA threads apply the swizzle when a transfer is issued with a swizzled store
+ * qualifier, e.g.
+ *   dma.template execute_dma<true,LOAD_CACHE_ALL,Swizzle::Store<STORE_WRITE_BACK>::qual>(src, dst);
+ * and compute threads read the tile through the same mapping with
+ *   float value = *Swizzle::apply(&tile[row*32+col]);
+ * The swizzle is a function of the shared memory address, so a swizzled tile has
+ * to start at a multiple of 2^(SHIFT+BITS) bytes of shared memory.  2^BASE must be
+ * at least the ALIGNMENT of the transfer so that no store straddles two chunks.
+ */
+template<int BITS, int BASE, int SHIFT>
+struct CudaDMASwizzle {
+  static const int chunk_bytes = (1 << BASE);
+  static const int row_bytes = (1 << SHIFT);
+  static const int period_bytes = (1 << (SHIFT + BITS));
+  template<int STORE_QUAL>
+  struct Store {
+    static const int qual = CUDADMA_SWIZZLED_STORE(STORE_QUAL,BITS,BASE,SHIFT);
+  };
+  static __host__ __device__ __forceinline__
+  size_t offset(const size_t byte_offset)
+  {
+    STATIC_ASSERT((BITS > 0) && (BITS < 16) && (SHIFT < 32) && (SHIFT >= (BASE + BITS)));
+    return (byte_offset ^ (((byte_offset >> SHIFT) & ((1 << BITS) - 1)) << BASE));
+  }
+  template<typename T>
+  static __host__ __device__ __forceinline__
+  T* apply(T *ptr)
+  {
+    return reinterpret_cast<T*>(offset(reinterpret_cast<size_t>(ptr)));
+  }
+};
+
+/**
+ * CudaDMAReduce turns the stores of a transfer into atomic reductions so that
+ * scatters with duplicate indices accumulate instead of racing, e.g. for
+ * gradient updates and histograms:
+ *   CudaDMAIndirect<false,true,16,64,64,DMA_THREADS,NUM_ELMTS> dma(...); // a scatter
+ *   dma.template execute_dma<true,LOAD_CACHE_ALL,CudaDMAReduce<REDUCE_ADD>::qual>(index_ptr, src, dst);
+ * OP - REDUCE_ADD, REDUCE_MIN or REDUCE_MAX
+ * T - float, or int when the data transferred are ints
+ * AGGREGATE - combine the values of the lanes of a warp storing to the same
+ *             address before issuing a single atomic (compute capability 7.0+)
+ * The qualifier works with every pattern and can be combined with a swizzle
+ * (CudaDMASwizzle<...>::Store<CudaDMAReduce<...>::qual>::qual) for reductions
+ * into shared memory.  Each 4 byte value is reduced with its own atomic.
+ */
+template<int OP, typename T = float, bool AGGREGATE = false>
+struct CudaDMAReduce;
+
+template<int OP, bool AGGREGATE>
+struct CudaDMAReduce<OP,float,AGGREGATE> {
+  static const int qual = CUDADMA_REDUCE_STORE(STORE_WRITE_BACK,OP,0,AGGREGATE);
+};
+
+template<int OP, bool AGGREGATE>
+struct CudaDMAReduce<OP,int,AGGREGATE> {
+  static const int qual = CUDADMA_REDUCE_STORE(STORE_WRITE_BACK,OP,1,AGGREGATE);
+};
+
 /*****************************************************/
 /*           Store functions                         */
 /*****************************************************/
+template<typename T, int STORE_QUAL>
+__device__ __forceinline__
+void ptx_cudaDMA_store(const T &src_val, T *dst_ptr);
+
+namespace CudaDMAMeta {
+  enum StoreKind {
+    PLAIN_STORE,
+    SWIZZLED_STORE,
+    REDUCE_STORE,
+    DISCARD_STORE,
+    PREFETCH_STORE,
+  };
+
+  // Plain stores are provided by the specializations of ptx_cudaDMA_store
+  template<typename T, int STORE_QUAL,
+           int KIND = ((STORE_QUAL & CUDADMA_STORE_DISCARD) ? DISCARD_STORE :
+                       (STORE_QUAL & CUDADMA_STORE_PREFETCH_L2) ? PREFETCH_STORE :
+                       (STORE_QUAL & CUDADMA_STORE_SWIZZLED) ? SWIZZLED_STORE :
+                       (CUDADMA_REDUCE_OP(STORE_QUAL) != REDUCE_NONE) ? REDUCE_STORE : PLAIN_STORE)>
+  struct Store {
+    static __device__ __forceinline__
+    void store(const T &src_val, T *dst_ptr)
+    {
+#ifdef CUDADMA_HOST_BACKEND
+      CudaDMAHost::trace_access(CudaDMAHost::TRACE_STORE, dst_ptr, sizeof(T));
+      *dst_ptr = src_val;
+#else
+      // This template should never be instantiated
+      STATIC_ASSERT(STORE_QUAL < 0);
+#endif
+    }
+  };
+
+  // Swizzled stores remap the address and then perform the plain store
+  template<typename T, int STORE_QUAL>
+  struct Store<T,STORE_QUAL,SWIZZLED_STORE> {
+    static __device__ __forceinline__
+    void store(const T &src_val, T *dst_ptr)
+    {
+      typedef CudaDMASwizzle<CUDADMA_SWIZZLE_BITS(STORE_QUAL),CUDADMA_SWIZZLE_BASE(STORE_QUAL),
+                             CUDADMA_SWIZZLE_SHIFT(STORE_QUAL)> Swizzle;
+      ptx_cudaDMA_store<T,(STORE_QUAL & ~CUDADMA_STORE_SWIZZLE_FIELDS)>(src_val, Swizzle::apply(dst_ptr));
+    }
+  };
+
+  // Discarded stores leave shared memory alone
+  template<typename T, int STORE_QUAL>
+  struct Store<T,STORE_QUAL,DISCARD_STORE> {
+    static __device__ __forceinline__
+    void store(const T &src_val, T *dst_ptr) { }
+  };
+
+  // Prefetching stores warm L2 with the global line they would write
+  template<typename T, int STORE_QUAL>
+  struct Store<T,STORE_QUAL,PREFETCH_STORE> {
+    static __device__ __forceinline__
+    void store(const T &src_val, T *dst_ptr)
+    {
+#ifdef CUDADMA_HOST_BACKEND
+      CudaDMAHost::trace_access(CudaDMAHost::TRACE_PREFETCH, dst_ptr, sizeof(T));
+#else
+      asm volatile("prefetch.global.L2 [%0];" : : "l"(dst_ptr) : "memory");
+#endif
+    }
+  };
+
+  // The operator of a reducing store on the 4 byte values of a transfer,
+  // which hold floats or, when IS_INT is set, the bits of ints
+  template<int OP, bool IS_INT>
+  struct ReduceOp {
+    static __device__ __forceinline__
+    float combine(const float a, const float b)
+    {
+      if (IS_INT)
+      {
+        const int x = __float_as_int(a);
+        const int y = __float_as_int(b);
+        // Add in unsigned to wrap around like red.global.add.s32 does
+        return __int_as_float((OP == REDUCE_ADD) ? int(unsigned(x) + unsigned(y)) :
+                              (OP == REDUCE_MIN) ? ((x < y) ? x : y) : ((x > y) ? x : y));
+      }
+      return ((OP == REDUCE_ADD) ? (a + b) : (OP == REDUCE_MIN) ? ((a < b) ? a : b) : ((a > b) ? a : b));
+    }
+    static __device__ __forceinline__
+    void atomic(float *dst_ptr, const float val)
+    {
+      if (IS_INT)
+      {
+        int *ptr = reinterpret_cast<int*>(dst_ptr);
+        if (OP == REDUCE_ADD)
+          atomicAdd(ptr, __float_as_int(val));
+        else if (OP == REDUCE_MIN)
+          atomicMin(ptr, __float_as_int(val));
+        else
+          atomicMax(ptr, __float_as_int(val));
+      }
+      else if (OP == REDUCE_ADD)
+        atomicAdd(dst_ptr, val);
+      else
+      {
+        // There are no float atomic min and max, so swap in the value
+        // for as long as it improves on the one in memory
+        int *ptr = reinterpret_cast<int*>(dst_ptr);
+        int old = *((volatile int*)ptr);
+        while (combine(val, __int_as_float(old)) != __int_as_float(old))
+        {
+          const int assumed = old;
+          old = atomicCAS(ptr, assumed, __float_as_int(val));
+          if (old == assumed)
+            break;
+        }
+      }
+    }
+    // Combine the values of the lanes of the warp that target the same
+    // address and let a single lane issue the atomic.  Requires the
+    // warp match instructions, so it falls back to one atomic per lane
+    // on older architectures and on the host backend.
+    static __device__ __forceinline__
+    void aggregated_atomic(float *dst_ptr, const float val)
+    {
+#if defined(__CUDA_ARCH__) && (__CUDA_ARCH__ >= 700)
+      const unsigned group = __match_any_sync(__activemask(), reinterpret_cast<unsigned long long>(dst_ptr));
+      unsigned lane;
+      asm volatile("mov.u32 %0, %%laneid;" : "=r"(lane));
+      unsigned others = group & (group - 1);
+      float total = __shfl_sync(group, val, __ffs(group) - 1);
+      while (others != 0)
+      {
+        total = combine(total, __shfl_sync(group, val, __ffs(others) - 1));
+        others &= (others - 1);
+      }
+      if (lane == unsigned(__ffs(group) - 1))
+        atomic(dst_ptr, total);
+#else
+      atomic(dst_ptr, val);
+#endif
+    }
+  };
+
+  // Reducing stores apply the operator to every 4 byte value of the store
+  template<typename T, int STORE_QUAL>
+  struct Store<T,STORE_QUAL,REDUCE_STORE> {
+    static __device__ __forceinline__
+    void store(const T &src_val, T *dst_ptr)
+    {
+      typedef ReduceOp<CUDADMA_REDUCE_OP(STORE_QUAL),(CUDADMA_REDUCE_INT(STORE_QUAL) != 0)> Op;
+      STATIC_ASSERT((sizeof(T)%sizeof(float)) == 0);
+#ifdef CUDADMA_HOST_BACKEND
+      CudaDMAHost::trace_access(CudaDMAHost::TRACE_STORE, dst_ptr, sizeof(T));
+#endif
+      const float *src = reinterpret_cast<const float*>(&src_val);
+      float *dst = reinterpret_cast<float*>(dst_ptr);
+      for (int i = 0; i < int(sizeof(T)/sizeof(float)); i++)
+      {
+        if (CUDADMA_REDUCE_AGGREGATE(STORE_QUAL))
+          Op::aggregated_atomic(dst + i, src[i]);
+        else
+          Op::atomic(dst + i, src[i]);
+      }
+    }
+  };
+};
+
 template<typename T, int STORE_QUAL>
 __device__ __forceinline__
 void ptx_cudaDMA_store(const T &src_val, T *dst_ptr)
 {
-  // This template should never be instantiated
-  STATIC_ASSERT(STORE_QUAL < 0);
+  CudaDMAMeta::Store<T,STORE_QUAL>::store(src_val, dst_ptr);
 }
 
+#ifndef CUDADMA_HOST_BACKEND
+
 /////////////////////////////
 // FLOAT
 /////////////////////////////
@@ -678,12 +1148,20 @@ void ptx_cudaDMA_store<float4,STORE_CACHE_WRITE_THROUGH>(const float4 &src_val,
   asm volatile("st.wt.v4.f32 [%0], {%1,%2,%3,%4};" :  : "l"(dst_ptr), "f"(src_val.x), "f"(src_val.y), "f"(src_val.z), "f"(src_val.w) : "memory");
 }
 
+#endif // CUDADMA_HOST_BACKEND
+
 // Have a special namespace for our meta-programming objects
 // so that we can guarantee that they don't interfere with any
 // user level code.  
 //
 // Why metaprogramming?  I just don't trust the compiler.
 namespace CudaDMAMeta {
+  // A copy of a DMA instance that a prefetch can walk a transfer
+  // with, leaving the state of the instance itself alone
+  template<typename DMA_TYPE>
+  __device__ __forceinline__
+  DMA_TYPE copy_of(const DMA_TYPE &dma) { return dma; }
+
   // A buffer for guaranteeing static access when loading and storing
   // ET = element type
   // NUM_ELMTS = number of elements in the static buffer
@@ -910,7 +1388,7 @@ namespace CudaDMAMeta {
         INNER_STRIDE,INNER_MAX,INNER_MAX,GLOBAL_LOAD,LOAD_QUAL>::load_all
           (buffer, src+((*index)*ELMT_SIZE), in_stride);
       NestedBufferLoader<BUFFER,INNER_STRIDE,INNER_MAX,OUTER_SCALE,OUTER_STRIDE,
-        OUTER_MAX,OUTER_IDX-OUTER_STRIDE,GLOBAL_LOAD,LOAD_QUAL>::load_indirect<ELMT_SIZE>
+        OUTER_MAX,OUTER_IDX-OUTER_STRIDE,GLOBAL_LOAD,LOAD_QUAL>::template load_indirect<ELMT_SIZE>
           (buffer, src, in_stride, index+index_stride, index_stride);
     }
     static __device__ __forceinline__
@@ -1007,7 +1485,7 @@ namespace CudaDMAMeta {
         INNER_STRIDE,INNER_MAX,INNER_MAX,STORE_QUAL>::store_all
           (buffer, dst+((*index)*ELMT_SIZE), in_stride);
       NestedBufferStorer<BUFFER,INNER_STRIDE,INNER_MAX,OUTER_SCALE,OUTER_STRIDE,
-        OUTER_MAX,OUTER_IDX-OUTER_STRIDE,STORE_QUAL>::store_indirect<ELMT_SIZE>
+        OUTER_MAX,OUTER_IDX-OUTER_STRIDE,STORE_QUAL>::template store_indirect<ELMT_SIZE>
           (buffer, dst, in_stride, index+index_stride, index_stride);
     }
     static __device__ __forceinline__
@@ -1109,7 +1587,7 @@ namespace CudaDMAMeta {
           INNER_MAX,INNER_MAX,GLOBAL_LOAD,LOAD_QUAL>::load_all
             (buffer, src+((*index)*ELMT_SIZE), in_stride);
         NestedConditionalLoader<BUFFER,INNER_STRIDE,INNER_MAX,OUTER_SCALE,OUTER_STRIDE,OUTER_MAX,
-          OUTER_IDX-OUTER_STRIDE,GLOBAL_LOAD,LOAD_QUAL>::load_indirect<ELMT_SIZE>
+          OUTER_IDX-OUTER_STRIDE,GLOBAL_LOAD,LOAD_QUAL>::template load_indirect<ELMT_SIZE>
             (buffer, src, in_stride, actual_max, index+index_stride, index_stride);
       }
     }
@@ -1225,7 +1703,7 @@ namespace CudaDMAMeta {
           INNER_MAX,INNER_MAX,STORE_QUAL>::store_all
             (buffer, dst+((*index)*ELMT_SIZE), in_stride);
         NestedConditionalStorer<BUFFER,INNER_STRIDE,INNER_MAX,OUTER_SCALE,OUTER_STRIDE,OUTER_MAX,
-          OUTER_IDX-OUTER_STRIDE,STORE_QUAL>::store_indirect<ELMT_SIZE>
+          OUTER_IDX-OUTER_STRIDE,STORE_QUAL>::template store_indirect<ELMT_SIZE>
             (buffer, dst, in_stride, actual_max, index+index_stride, index_stride);
       }
     }
@@ -1307,11 +1785,120 @@ namespace CudaDMAMeta {
       }
     }
   };
+
+  /********************************************/
+  // VectorType
+  // The type used for loads and stores of a given number of bytes
+  /********************************************/
+  template<int BYTES>
+  struct VectorType;
+
+  template<>
+  struct VectorType<4> { typedef float type; };
+
+  template<>
+  struct VectorType<8> { typedef float2 type; };
+
+  template<>
+  struct VectorType<16> { typedef float4 type; };
+
+  /********************************************/
+  // IndexType
+  // The supported index types of CudaDMAIndirect and the type
+  // used to scale an index into a byte offset.  Indices that
+  // can exceed 2^31 elements or bytes are scaled in 64 bits.
+  /********************************************/
+  template<typename INDEX_TYPE>
+  struct IndexType;
+
+  template<>
+  struct IndexType<unsigned short> { typedef int offset_type; };
+
+  template<>
+  struct IndexType<int> { typedef int offset_type; };
+
+  template<>
+  struct IndexType<unsigned int> { typedef long long offset_type; };
+
+  template<>
+  struct IndexType<long> { typedef long long offset_type; };
+
+  template<>
+  struct IndexType<long long> { typedef long long offset_type; };
+
+  /********************************************/
+  // pack/unpack
+  // Move a narrower vector in and out of the low components of a
+  // wider one so buffers of the wider type can hold either
+  /********************************************/
+  __device__ __forceinline__ void pack(float &dst, const float &src) { dst = src; }
+  __device__ __forceinline__ void pack(float2 &dst, const float &src) { dst.x = src; }
+  __device__ __forceinline__ void pack(float2 &dst, const float2 &src) { dst = src; }
+  __device__ __forceinline__ void pack(float4 &dst, const float &src) { dst.x = src; }
+  __device__ __forceinline__ void pack(float4 &dst, const float2 &src) { dst.x = src.x; dst.y = src.y; }
+  __device__ __forceinline__ void pack(float4 &dst, const float4 &src) { dst = src; }
+
+  __device__ __forceinline__ void unpack(const float &src, float &dst) { dst = src; }
+  __device__ __forceinline__ void unpack(const float2 &src, float &dst) { dst = src.x; }
+  __device__ __forceinline__ void unpack(const float2 &src, float2 &dst) { dst = src; }
+  __device__ __forceinline__ void unpack(const float4 &src, float &dst) { dst = src.x; }
+  __device__ __forceinline__ void unpack(const float4 &src, float2 &dst) { dst.x = src.x; dst.y = src.y; }
+  __device__ __forceinline__ void unpack(const float4 &src, float4 &dst) { dst = src; }
+};
+
+/**
+ * Compile-time allocator for the named barriers used by CudaDMA instances.
+ * A dmaID uses the barriers 2*dmaID and 2*dmaID+1, and there are 16 named
+ * barriers, so only dmaIDs 0 to 7 are usable.  Barrier 0 is the one that
+ * __syncthreads uses, so allocation starts at barrier 2 (dmaID 1) by default.
+ * Each allocation is a type whose Next member continues from the end of it:
+ *
+ *   typedef CudaDMABarriers<>::Allocate<1> Halo;                  // dmaID 1
+ *   typedef Halo::Next::Reserve<1> Reduce;                         // barrier 4 for user code
+ *   typedef Reduce::Next::Allocate<Pipeline::num_dma_ids> Stages;  // dmaIDs 3 to 3+STAGES-1
+ *
+ *   CudaDMASequential<...> dma_halo(Halo::dmaID, ...);
+ *   Pipeline pipeline(buffer, Stages::dmaID, ...);
+ *   ptx_cudaDMA_barrier_blocking(Reduce::barrier, num_compute_threads);
+ *
+ * Using an allocation that does not fit in the 16 named barriers fails to
+ * compile.  FIRST_BARRIER is the first barrier that may be handed out.
+ */
+template<int FIRST_BARRIER = 2>
+struct CudaDMABarriers {
+  static const int num_named_barriers = 16;
+  // NUM_IDS consecutive dmaIDs, i.e. pairs of barriers starting at an even barrier
+  template<int NUM_IDS>
+  struct Allocate {
+    static const int dmaID = (FIRST_BARRIER+1)/2;
+    static const int num_dma_ids = NUM_IDS;
+    static const int end_barrier = 2*(dmaID+NUM_IDS);
+    typedef CudaDMABarriers<end_barrier> Next;
+    typedef char in_range[sizeof(CudaDMAStaticAssert<(NUM_IDS > 0) &&
+                                 (end_barrier <= num_named_barriers)>)];
+  };
+  // NUM_BARRIERS consecutive barriers for use outside of CudaDMA
+  template<int NUM_BARRIERS>
+  struct Reserve {
+    static const int barrier = FIRST_BARRIER;
+    static const int num_barriers = NUM_BARRIERS;
+    static const int end_barrier = FIRST_BARRIER+NUM_BARRIERS;
+    typedef CudaDMABarriers<end_barrier> Next;
+    typedef char in_range[sizeof(CudaDMAStaticAssert<(NUM_BARRIERS > 0) &&
+                                 (end_barrier <= num_named_barriers)>)];
+  };
 };
 
 /**
  * This is the base class for CudaDMA and contains most of the baseline
  * functionality that is used for synchronizing all of the CudaDMA instances.
+ *
+ * Every pattern also has a prefetch method that takes the same arguments as
+ * its start_xfer_async.  It walks the same layout as a transfer but issues
+ * L2 prefetches instead of loads, keeps nothing in registers and performs
+ * no barriers, so DMA threads can warm L2 for a later transfer at any point,
+ * including while a transfer of the same instance is in flight.  A scatter
+ * prefetches the global destination it will write instead of its source.
  */
 class CudaDMA {
 public:
@@ -1392,6 +1979,15 @@ public:
 #define PARTIAL_LDS (PARTIAL_BYTES/FULL_LD_STRIDE)
 // Number of remaining bytes after performing all the partial loads
 #define REMAINING_BYTES (PARTIAL_BYTES - (PARTIAL_LDS*FULL_LD_STRIDE))
+// Loads in the lower and upper halves of the buffer when the steps of a
+// fully templated transfer are software pipelined
+#define PIPE_LOWER_LDS (BULK_LDS/2)
+#define PIPE_UPPER_LDS (BULK_LDS - PIPE_LOWER_LDS)
+// Whether the loads of the partial step fit in the lower half
+#define PIPE_EARLY_PARTIAL (PARTIAL_LDS <= PIPE_LOWER_LDS)
+// Pipeline the steps when the buffer can be split and there is a step to overlap
+#define PIPE_STEPS ((BULK_LDS > 1) && (BULK_STEPS > 0) && ((BULK_STEPS > 1) || \
+                    (PIPE_EARLY_PARTIAL && ((PARTIAL_LDS > 0) || (REMAINING_BYTES > 0)))))
 // Compute the thread offset
 #define THREAD_OFFSET  (CUDADMA_DMA_TID*ALIGNMENT)
 // Compute the number of partial bytes that this thread is responsible for
@@ -1399,12 +1995,50 @@ public:
 #define THREAD_PARTIAL_BYTES ((THREAD_LEFTOVER > ALIGNMENT) ? ALIGNMENT : \
                               (THREAD_LEFTOVER < 0) ? 0 : THREAD_LEFTOVER)
 
+/**
+ * CudaDMASequentialPlan exposes the layout that a fully templated CudaDMASequential
+ * instance will use as compile-time constants.  All the values are computed from the
+ * same expressions as the instances themselves so they can be queried by tools and
+ * static assertions (on the host or the device) without instantiating a kernel.
+ * The plan for an instance is also available as CudaDMASequential<...>::Plan.
+ */
+template<int ALIGNMENT, int BYTES_PER_THREAD, int BYTES_PER_ELMT, int DMA_THREADS>
+struct CudaDMASequentialPlan {
+  static const int alignment = ALIGNMENT;
+  static const int bytes_per_thread = BYTES_PER_THREAD;
+  static const int bytes_per_elmt = BYTES_PER_ELMT;
+  static const int dma_threads = DMA_THREADS;
+  static const int full_ld_stride = FULL_LD_STRIDE;
+  static const int bulk_lds = BULK_LDS;
+  static const int bulk_step_stride = BULK_STEP_STRIDE;
+  static const int bulk_steps = BULK_STEPS;
+  static const int partial_bytes = PARTIAL_BYTES;
+  static const int partial_lds = PARTIAL_LDS;
+  static const int remaining_bytes = REMAINING_BYTES;
+  // Same step count that diagnose reports
+  static const int total_steps = BULK_STEPS + (((PARTIAL_LDS > 0) || (REMAINING_BYTES > 0)) ? 1 : 0);
+  static const bool single_step = (total_steps <= 1);
+  // Maximum number of loads issued by a DMA thread in a step
+  static const int loads_per_step = (BULK_STEPS > 0) ? BULK_LDS :
+                                    (PARTIAL_LDS + ((REMAINING_BYTES > 0) ? 1 : 0));
+  // Whether each half of the buffer is refilled with the next step as soon
+  // as it is stored, keeping loads outstanding between the steps
+  static const bool pipelined_steps = PIPE_STEPS;
+  // Estimated registers per DMA thread (see CudaDMARegisterBudget)
+  static const int bulk_registers = BYTES_PER_THREAD/sizeof(float);
+  static const int across_registers = ALIGNMENT/sizeof(float);
+  static const int state_registers = CudaDMARegisterCost::base + CudaDMARegisterCost::sequential;
+  static const int registers = bulk_registers + across_registers + state_registers +
+                               CudaDMARegisterCost::working;
+};
+
 template<bool DO_SYNC>
 class CudaDMASequential<DO_SYNC,0,0,0,0> {
 public:
   __host__
   static void diagnose(const int ALIGNMENT, const int BYTES_PER_THREAD, const int BYTES_PER_ELMT,
-                       const int DMA_THREADS, const bool FULL_TEMPLATE, const bool verbose = false)
+                       const int DMA_THREADS, const bool FULL_TEMPLATE, const bool verbose = false,
+                       const int register_budget = 0)
   {
 #define PRINT_VAR(var_name) printf(#var_name " %d\n", (var_name))
     fprintf(stdout,"********************************************************************\n");
@@ -1440,6 +2074,8 @@ public:
         fprintf(stdout,"    - Increase element size thereby loading superflous data with the benefit\n");
         fprintf(stdout,"          of improving guaranteed alignment of pointers\n");
       }
+      if (FULL_TEMPLATE && PIPE_STEPS)
+        fprintf(stdout,"  NOTE: the steps are pipelined over the two halves of the buffer.\n");
     }
     if (verbose)
     {
@@ -1450,11 +2086,48 @@ public:
       PRINT_VAR(PARTIAL_BYTES);
       PRINT_VAR(PARTIAL_LDS);
       PRINT_VAR(REMAINING_BYTES);
+      PRINT_VAR(PIPE_STEPS);
     }
+    if (register_budget > 0)
+      cudaDMA_check_register_budget(analyze(ALIGNMENT, BYTES_PER_THREAD, BYTES_PER_ELMT,
+                                            DMA_THREADS, FULL_TEMPLATE),
+                                    register_budget, stdout);
     fprintf(stdout,"\n\n");
     fflush(stdout);
 #undef PRINT_VAR
   }
+  // Same analysis as diagnose, but returned as a CudaDMADiagnosis
+  // (see cudaDMA_print_diagnosis_json) instead of being printed
+  __host__
+  static CudaDMADiagnosis analyze(const int ALIGNMENT, const int BYTES_PER_THREAD, const int BYTES_PER_ELMT,
+                                  const int DMA_THREADS, const bool FULL_TEMPLATE)
+  {
+    CudaDMADiagnosis diag;
+    diag.pattern = "CudaDMASequential";
+    diag.alignment = ALIGNMENT;
+    diag.bytes_per_thread = BYTES_PER_THREAD;
+    diag.bytes_per_elmt = BYTES_PER_ELMT;
+    diag.num_elmts = 1;
+    diag.dma_threads = DMA_THREADS;
+    diag.full_template = FULL_TEMPLATE;
+    diag.transfer_case = SEQUENTIAL_CASE;
+    diag.total_steps = BULK_STEPS + (((PARTIAL_LDS > 0) || (REMAINING_BYTES > 0)) ? 1 : 0);
+    // Only the fully templated instances pipeline their steps
+    diag.pipelined_steps = FULL_TEMPLATE && PIPE_STEPS;
+    diag.loads_per_thread = (BULK_STEPS > 0) ? BULK_LDS :
+                            (PARTIAL_LDS + ((REMAINING_BYTES > 0) ? 1 : 0));
+    diag.bulk_registers = BYTES_PER_THREAD/sizeof(float);
+    diag.across_registers = ALIGNMENT/sizeof(float);
+    // Partially templated instances also store BYTES_PER_ELMT and DMA_THREADS
+    diag.state_registers = CudaDMARegisterCost::base + CudaDMARegisterCost::sequential +
+                           (FULL_TEMPLATE ? 0 : 2*CudaDMARegisterCost::runtime_param);
+    diag.registers = diag.bulk_registers + diag.across_registers + diag.state_registers +
+                     CudaDMARegisterCost::working;
+    diag.idle_dma_threads = ((BULK_STEPS > 0) || (PARTIAL_LDS > 0)) ? 0 :
+                            DMA_THREADS - ((REMAINING_BYTES+ALIGNMENT-1)/ALIGNMENT);
+    diag.optimized = (diag.total_steps <= 1);
+    return diag;
+  }
 };
 
 #define WARP_SPECIALIZED_UNQUALIFIED_METHODS                                                        \
@@ -1469,9 +2142,13 @@ public:
   }                                                                                                 \
   __device__ __forceinline__ void wait_xfer_finish(void *RESTRICT dst_ptr)                          \
   {                                                                                                 \
-    CudaDMA::template wait_for_dma_start();                                                         \
+    CudaDMA::wait_for_dma_start();                                                                  \
     SEQUENTIAL_WAIT_XFER_IMPL(false,LOAD_CACHE_ALL,STORE_WRITE_BACK)                                \
-    CudaDMA::template finish_async_dma();                                                           \
+    CudaDMA::finish_async_dma();                                                                    \
+  }                                                                                                 \
+  __device__ __forceinline__ void prefetch(const void *RESTRICT src_ptr) const                      \
+  {                                                                                                 \
+    prefetch<false>(src_ptr);                                                                       \
   }
 
 #define WARP_SPECIALIZED_QUALIFIED_METHODS                                                          \
@@ -1489,9 +2166,9 @@ public:
   template<bool DMA_GLOBAL_LOAD>                                                                    \
   __device__ __forceinline__ void wait_xfer_finish(void *RESTRICT dst_ptr)                          \
   {                                                                                                 \
-    CudaDMA::template wait_for_dma_start();                                                         \
+    CudaDMA::wait_for_dma_start();                                                                  \
     SEQUENTIAL_WAIT_XFER_IMPL(DMA_GLOBAL_LOAD,LOAD_CACHE_ALL,STORE_WRITE_BACK)                      \
-    CudaDMA::template finish_async_dma();                                                           \
+    CudaDMA::finish_async_dma();                                                                    \
   }                                                                                                 \
   template<bool DMA_GLOBAL_LOAD, int DMA_LOAD_QUAL, int DMA_STORE_QUAL>                             \
   __device__ __forceinline__ void execute_dma(const void *RESTRICT src_ptr, void *RESTRICT dst_ptr) \
@@ -1507,9 +2184,27 @@ public:
   template<bool DMA_GLOBAL_LOAD, int DMA_LOAD_QUAL, int DMA_STORE_QUAL>                             \
   __device__ __forceinline__ void wait_xfer_finish(void *RESTRICT dst_ptr)                          \
   {                                                                                                 \
-    CudaDMA::template wait_for_dma_start();                                                         \
+    CudaDMA::wait_for_dma_start();                                                                  \
     SEQUENTIAL_WAIT_XFER_IMPL(DMA_GLOBAL_LOAD,DMA_LOAD_QUAL,DMA_STORE_QUAL)                         \
-    CudaDMA::template finish_async_dma();                                                           \
+    CudaDMA::finish_async_dma();                                                                    \
+  }                                                                                                 \
+  template<bool DMA_GLOBAL_LOAD>                                                                    \
+  __device__ __forceinline__ void prefetch(const void *RESTRICT src_ptr) const                      \
+  {                                                                                                 \
+    /* Walk the transfer on a copy so that a transfer in flight is untouched */                     \
+    CudaDMAMeta::copy_of(*this).template prefetch_xfer<DMA_GLOBAL_LOAD>(src_ptr);                   \
+  }                                                                                                 \
+private:                                                                                            \
+  template<bool DMA_GLOBAL_LOAD>                                                                    \
+  __device__ __forceinline__ void prefetch_xfer(const void *RESTRICT src_ptr)                       \
+  {                                                                                                 \
+    void *const dst_ptr = NULL;                                                                     \
+    {                                                                                               \
+      SEQUENTIAL_START_XFER_IMPL(DMA_GLOBAL_LOAD,LOAD_PREFETCH_L2,CUDADMA_STORE_DISCARD)            \
+    }                                                                                               \
+    {                                                                                               \
+      SEQUENTIAL_WAIT_XFER_IMPL(DMA_GLOBAL_LOAD,LOAD_PREFETCH_L2,CUDADMA_STORE_DISCARD)             \
+    }                                                                                               \
   }
 
 #define NON_WARP_SPECIALIZED_UNQUALIFIED_METHODS                                                    \
@@ -1525,6 +2220,10 @@ public:
   __device__ __forceinline__ void wait_xfer_finish(void *RESTRICT dst_ptr)                          \
   {                                                                                                 \
     SEQUENTIAL_WAIT_XFER_IMPL(false,LOAD_CACHE_ALL,STORE_WRITE_BACK)                                \
+  }                                                                                                 \
+  __device__ __forceinline__ void prefetch(const void *RESTRICT src_ptr) const                      \
+  {                                                                                                 \
+    prefetch<false>(src_ptr);                                                                       \
   }
 
 #define NON_WARP_SPECIALIZED_QUALIFIED_METHODS                                                      \
@@ -1559,6 +2258,24 @@ public:
   __device__ __forceinline__ void wait_xfer_finish(void *RESTRICT dst_ptr)                          \
   {                                                                                                 \
     SEQUENTIAL_WAIT_XFER_IMPL(DMA_GLOBAL_LOAD,DMA_LOAD_QUAL,DMA_STORE_QUAL)                         \
+  }                                                                                                 \
+  template<bool DMA_GLOBAL_LOAD>                                                                    \
+  __device__ __forceinline__ void prefetch(const void *RESTRICT src_ptr) const                      \
+  {                                                                                                 \
+    /* Walk the transfer on a copy so that a transfer in flight is untouched */                     \
+    CudaDMAMeta::copy_of(*this).template prefetch_xfer<DMA_GLOBAL_LOAD>(src_ptr);                   \
+  }                                                                                                 \
+private:                                                                                            \
+  template<bool DMA_GLOBAL_LOAD>                                                                    \
+  __device__ __forceinline__ void prefetch_xfer(const void *RESTRICT src_ptr)                       \
+  {                                                                                                 \
+    void *const dst_ptr = NULL;                                                                     \
+    {                                                                                               \
+      SEQUENTIAL_START_XFER_IMPL(DMA_GLOBAL_LOAD,LOAD_PREFETCH_L2,CUDADMA_STORE_DISCARD)            \
+    }                                                                                               \
+    {                                                                                               \
+      SEQUENTIAL_WAIT_XFER_IMPL(DMA_GLOBAL_LOAD,LOAD_PREFETCH_L2,CUDADMA_STORE_DISCARD)             \
+    }                                                                                               \
   }
 
 #ifdef DEBUG_CUDADMA
@@ -2634,25 +3351,56 @@ private:
       this->dma_src_ptr += BULK_STEP_STRIDE;                                                  \
     }
 
-#define SEQUENTIAL_WAIT_XFER_IMPL(GLOBAL_LOAD,LOAD_QUAL,STORE_QUAL)                           \
-    char *dst_off_ptr = ((char*)dst_ptr) + this->dma_offset;                                  \
-    if (BULK_STEPS == 0)                                                                      \
-    {                                                                                         \
-      issue_stores<(REMAINING_BYTES>0),PARTIAL_LDS,STORE_QUAL>(dst_off_ptr);                  \
-    }                                                                                         \
-    else                                                                                      \
-    {                                                                                         \
-      issue_stores<false,BULK_LDS,STORE_QUAL>(dst_off_ptr);                                   \
-      dst_off_ptr += BULK_STEP_STRIDE;                                                        \
-      for (int i = 0; i < (BULK_STEPS-1); i++)                                                \
-      {                                                                                       \
-        issue_loads<false,BULK_LDS,GLOBAL_LOAD,LOAD_QUAL>(this->dma_src_ptr);                 \
-        this->dma_src_ptr += BULK_STEP_STRIDE;                                                \
-        issue_stores<false,BULK_LDS,STORE_QUAL>(dst_off_ptr);                                 \
-        dst_off_ptr += BULK_STEP_STRIDE;                                                      \
-      }                                                                                       \
-      issue_loads<(REMAINING_BYTES>0),PARTIAL_LDS,GLOBAL_LOAD,LOAD_QUAL>(this->dma_src_ptr);  \
-      issue_stores<(REMAINING_BYTES>0),PARTIAL_LDS,STORE_QUAL>(dst_off_ptr);                  \
+#define SEQUENTIAL_WAIT_XFER_IMPL(GLOBAL_LOAD,LOAD_QUAL,STORE_QUAL)                                 \
+    char *dst_off_ptr = ((char*)dst_ptr) + this->dma_offset;                                        \
+    if (BULK_STEPS == 0)                                                                            \
+    {                                                                                               \
+      issue_stores<(REMAINING_BYTES>0),PARTIAL_LDS,STORE_QUAL>(dst_off_ptr);                        \
+    }                                                                                               \
+    else if (PIPE_STEPS)                                                                            \
+    {                                                                                               \
+      for (int i = 0; i < BULK_STEPS; i++)                                                          \
+      {                                                                                             \
+        /* Refill each half with the next step as soon as it is stored */                           \
+        /* so the loads of the other half stay outstanding meanwhile */                             \
+        CudaDMAMeta::BufferStorer<BulkBuffer,0,1,PIPE_LOWER_LDS,PIPE_LOWER_LDS,STORE_QUAL>          \
+          ::store_all(bulk_buffer, dst_off_ptr, FULL_LD_STRIDE);                                    \
+        if (i < (BULK_STEPS-1))                                                                     \
+          CudaDMAMeta::BufferLoader<BulkBuffer,0,1,PIPE_LOWER_LDS,PIPE_LOWER_LDS,                   \
+                                    GLOBAL_LOAD,LOAD_QUAL>                                          \
+            ::load_all(bulk_buffer, this->dma_src_ptr, FULL_LD_STRIDE);                             \
+        else if (PIPE_EARLY_PARTIAL)                                                                \
+          issue_loads<(REMAINING_BYTES>0),PARTIAL_LDS,GLOBAL_LOAD,LOAD_QUAL>(this->dma_src_ptr);    \
+        CudaDMAMeta::BufferStorer<BulkBuffer,PIPE_LOWER_LDS,1,PIPE_UPPER_LDS,PIPE_UPPER_LDS,        \
+                                  STORE_QUAL>                                                       \
+          ::store_all(bulk_buffer, dst_off_ptr + PIPE_LOWER_LDS*FULL_LD_STRIDE, FULL_LD_STRIDE);    \
+        if (i < (BULK_STEPS-1))                                                                     \
+        {                                                                                           \
+          CudaDMAMeta::BufferLoader<BulkBuffer,PIPE_LOWER_LDS,1,PIPE_UPPER_LDS,PIPE_UPPER_LDS,      \
+                                    GLOBAL_LOAD,LOAD_QUAL>                                          \
+            ::load_all(bulk_buffer, this->dma_src_ptr + PIPE_LOWER_LDS*FULL_LD_STRIDE,              \
+                       FULL_LD_STRIDE);                                                             \
+          this->dma_src_ptr += BULK_STEP_STRIDE;                                                    \
+        }                                                                                           \
+        dst_off_ptr += BULK_STEP_STRIDE;                                                            \
+      }                                                                                             \
+      if (!PIPE_EARLY_PARTIAL)                                                                      \
+        issue_loads<(REMAINING_BYTES>0),PARTIAL_LDS,GLOBAL_LOAD,LOAD_QUAL>(this->dma_src_ptr);      \
+      issue_stores<(REMAINING_BYTES>0),PARTIAL_LDS,STORE_QUAL>(dst_off_ptr);                        \
+    }                                                                                               \
+    else                                                                                            \
+    {                                                                                               \
+      issue_stores<false,BULK_LDS,STORE_QUAL>(dst_off_ptr);                                         \
+      dst_off_ptr += BULK_STEP_STRIDE;                                                              \
+      for (int i = 0; i < (BULK_STEPS-1); i++)                                                      \
+      {                                                                                             \
+        issue_loads<false,BULK_LDS,GLOBAL_LOAD,LOAD_QUAL>(this->dma_src_ptr);                       \
+        this->dma_src_ptr += BULK_STEP_STRIDE;                                                      \
+        issue_stores<false,BULK_LDS,STORE_QUAL>(dst_off_ptr);                                       \
+        dst_off_ptr += BULK_STEP_STRIDE;                                                            \
+      }                                                                                             \
+      issue_loads<(REMAINING_BYTES>0),PARTIAL_LDS,GLOBAL_LOAD,LOAD_QUAL>(this->dma_src_ptr);        \
+      issue_stores<(REMAINING_BYTES>0),PARTIAL_LDS,STORE_QUAL>(dst_off_ptr);                        \
     }
 
 #define LOCAL_TYPENAME  float
@@ -2660,6 +3408,7 @@ private:
 template<int BYTES_PER_THREAD, int BYTES_PER_ELMT, int DMA_THREADS>
 class CudaDMASequential<true,ALIGNMENT,BYTES_PER_THREAD,BYTES_PER_ELMT,DMA_THREADS> : public CudaDMA {
 public:
+  typedef CudaDMASequentialPlan<ALIGNMENT,BYTES_PER_THREAD,BYTES_PER_ELMT,DMA_THREADS> Plan;
   __device__ CudaDMASequential(const int dmaID,
                                const int num_compute_threads,
                                const int dma_threadIdx_start)
@@ -2709,6 +3458,7 @@ private:
 template<int BYTES_PER_THREAD, int BYTES_PER_ELMT, int DMA_THREADS>
 class CudaDMASequential<true,ALIGNMENT,BYTES_PER_THREAD,BYTES_PER_ELMT,DMA_THREADS> : public CudaDMA {
 public:
+  typedef CudaDMASequentialPlan<ALIGNMENT,BYTES_PER_THREAD,BYTES_PER_ELMT,DMA_THREADS> Plan;
   __device__ CudaDMASequential(const int dmaID,
                                const int num_compute_threads,
                                const int dma_threadIdx_start)
@@ -2758,6 +3508,7 @@ private:
 template<int BYTES_PER_THREAD, int BYTES_PER_ELMT, int DMA_THREADS>
 class CudaDMASequential<true,ALIGNMENT,BYTES_PER_THREAD,BYTES_PER_ELMT,DMA_THREADS> : public CudaDMA {
 public:
+  typedef CudaDMASequentialPlan<ALIGNMENT,BYTES_PER_THREAD,BYTES_PER_ELMT,DMA_THREADS> Plan;
   __device__ CudaDMASequential(const int dmaID,
                                const int num_compute_threads,
                                const int dma_threadIdx_start)
@@ -2808,6 +3559,7 @@ private:
 template<int BYTES_PER_THREAD, int BYTES_PER_ELMT, int DMA_THREADS>
 class CudaDMASequential<false,ALIGNMENT,BYTES_PER_THREAD,BYTES_PER_ELMT,DMA_THREADS> : public CudaDMA {
 public:
+  typedef CudaDMASequentialPlan<ALIGNMENT,BYTES_PER_THREAD,BYTES_PER_ELMT,DMA_THREADS> Plan;
   __device__ CudaDMASequential(const int dma_threadIdx_start = 0)
     : CudaDMA(0, DMA_THREADS, DMA_THREADS, dma_threadIdx_start),
       dma_offset(THREAD_OFFSET),
@@ -2855,6 +3607,7 @@ private:
 template<int BYTES_PER_THREAD, int BYTES_PER_ELMT, int DMA_THREADS>
 class CudaDMASequential<false,ALIGNMENT,BYTES_PER_THREAD,BYTES_PER_ELMT,DMA_THREADS> : public CudaDMA {
 public:
+  typedef CudaDMASequentialPlan<ALIGNMENT,BYTES_PER_THREAD,BYTES_PER_ELMT,DMA_THREADS> Plan;
   __device__ CudaDMASequential(const int dma_threadIdx_start = 0)
     : CudaDMA(0, DMA_THREADS, DMA_THREADS, dma_threadIdx_start),
       dma_offset(THREAD_OFFSET),
@@ -2902,6 +3655,7 @@ private:
 template<int BYTES_PER_THREAD, int BYTES_PER_ELMT, int DMA_THREADS>
 class CudaDMASequential<false,ALIGNMENT,BYTES_PER_THREAD,BYTES_PER_ELMT,DMA_THREADS> : public CudaDMA {
 public:
+  typedef CudaDMASequentialPlan<ALIGNMENT,BYTES_PER_THREAD,BYTES_PER_ELMT,DMA_THREADS> Plan;
   __device__ CudaDMASequential(const int dma_threadIdx_start = 0)
     : CudaDMA(0, DMA_THREADS, DMA_THREADS, dma_threadIdx_start),
       dma_offset(THREAD_OFFSET),
@@ -2954,6 +3708,10 @@ private:
 #undef PARTIAL_BYTES
 #undef PARTIAL_LDS
 #undef REMAINING_BYTES
+#undef PIPE_LOWER_LDS
+#undef PIPE_UPPER_LDS
+#undef PIPE_EARLY_PARTIAL
+#undef PIPE_STEPS
 #undef THREAD_OFFSET
 #undef THREAD_LEFTOVER
 #undef THREAD_PARTIAL_BYTES
@@ -3067,6 +3825,14 @@ private:
 // This is actually whether there are leftovers from the partial loading phase
 #define HAS_PARTIAL_BYTES_BIG (REMAINING_BYTES_BIG > 0)
 #define STEP_ITERS_BIG (NUM_ELMTS)
+// Loads in the lower and upper halves of the buffer when the steps of a big
+// element are software pipelined in the fully templated instances
+#define PIPE_LOWER_LDS_BIG (MAX_LDS_PER_THREAD/2)
+#define PIPE_UPPER_LDS_BIG (MAX_LDS_PER_THREAD - PIPE_LOWER_LDS_BIG)
+// Pipeline the steps of an element when the buffer can be split and there is a
+// step to overlap: another full step, or a partial step that fits in the lower half
+#define PIPE_STEPS_BIG(_max_iters,_part_iters) ((MAX_LDS_PER_THREAD > 1) && ((_max_iters) > 0) && \
+                    (((_max_iters) > 1) || (((_part_iters) > 0) && ((_part_iters) <= PIPE_LOWER_LDS_BIG))))
 // Now handle the case where we don't have to split a warp across multiple elements.
 // For the basic case we'll assign the minimum number of warps to handle an element
 // There is a better version for the four template case that will handle over
@@ -3204,6 +3970,60 @@ public:
   }
 };
 
+// Fill in a CudaDMADiagnosis for the strided layout described by the
+// current definitions of the strided macros.  Used by both CudaDMAStrided
+// and CudaDMAIndirect which lay out their elements in the same way, _state
+// is the CudaDMARegisterCost of the members specific to each of them.
+#define STRIDED_ANALYZE_IMPL(_diag,_state)                                                          \
+  _diag.alignment = ALIGNMENT;                                                                      \
+  _diag.bytes_per_thread = BYTES_PER_THREAD;                                                        \
+  _diag.bytes_per_elmt = BYTES_PER_ELMT;                                                            \
+  _diag.num_elmts = NUM_ELMTS;                                                                      \
+  _diag.dma_threads = DMA_THREADS;                                                                  \
+  _diag.full_template = FULL_TEMPLATE;                                                              \
+  _diag.bulk_registers = BYTES_PER_THREAD/sizeof(float);                                            \
+  if (SPLIT_WARP)                                                                                   \
+  {                                                                                                 \
+    const int active_groups = ((DMA_THREADS/THREADS_PER_ELMT) < NUM_ELMTS) ?                        \
+                                (DMA_THREADS/THREADS_PER_ELMT) : NUM_ELMTS;                         \
+    _diag.transfer_case = SPLIT_ELMTS_CASE;                                                         \
+    _diag.total_steps = STEP_ITERS_SPLIT + (HAS_PARTIAL_ELMTS_SPLIT ? 1 : 0);                       \
+    _diag.pipelined_steps = false;                                                                  \
+    _diag.loads_per_thread = ROW_ITERS_SPLIT;                                                       \
+    _diag.across_registers = FULL_TEMPLATE ? GUARD_ZERO(ROW_ITERS_SPLIT)*ALIGNMENT/sizeof(float) :  \
+                                             BYTES_PER_THREAD/sizeof(float);                        \
+    _diag.idle_dma_threads = DMA_THREADS - active_groups *                                          \
+                              ((THREADS_PER_ELMT < LDS_PER_ELMT) ? THREADS_PER_ELMT : LDS_PER_ELMT);\
+  }                                                                                                 \
+  else if (BIG_ELMTS)                                                                               \
+  {                                                                                                 \
+    _diag.transfer_case = BIG_ELMTS_CASE;                                                           \
+    _diag.total_steps = NUM_ELMTS * (MAX_ITERS_BIG +                                                \
+                          ((HAS_PARTIAL_ELMTS_BIG || HAS_PARTIAL_BYTES_BIG) ? 1 : 0));              \
+    _diag.pipelined_steps = FULL_TEMPLATE && PIPE_STEPS_BIG(MAX_ITERS_BIG,PART_ITERS_BIG);          \
+    _diag.loads_per_thread = MAX_LDS_PER_THREAD;                                                    \
+    _diag.across_registers = FULL_TEMPLATE ? ALIGNMENT/sizeof(float) : BYTES_PER_THREAD/sizeof(float);\
+    _diag.idle_dma_threads = 0;                                                                     \
+  }                                                                                                 \
+  else                                                                                              \
+  {                                                                                                 \
+    const int group_threads = WARPS_PER_ELMT*WARP_SIZE;                                             \
+    _diag.transfer_case = FULL_ELMTS_CASE;                                                          \
+    _diag.total_steps = STEP_ITERS_FULL + (HAS_PARTIAL_ELMTS_FULL ? 1 : 0);                         \
+    _diag.pipelined_steps = false;                                                                  \
+    _diag.loads_per_thread = ROW_ITERS_FULL * (COL_ITERS_FULL + (HAS_PARTIAL_BYTES_FULL ? 1 : 0));  \
+    _diag.across_registers = FULL_TEMPLATE ? GUARD_ZERO(ROW_ITERS_FULL)*ALIGNMENT/sizeof(float) :   \
+                                             BYTES_PER_THREAD/sizeof(float);                        \
+    _diag.idle_dma_threads = DMA_THREADS - (NUM_ACTIVE_WARPS/WARPS_PER_ELMT) *                      \
+                              ((group_threads < LDS_PER_ELMT) ? group_threads : LDS_PER_ELMT);      \
+  }                                                                                                 \
+  /* Partially templated instances also store BYTES_PER_ELMT, DMA_THREADS and NUM_ELMTS */         \
+  _diag.state_registers = CudaDMARegisterCost::base + (_state) +                                    \
+                          (FULL_TEMPLATE ? 0 : 3*CudaDMARegisterCost::runtime_param);               \
+  _diag.registers = _diag.bulk_registers + _diag.across_registers + _diag.state_registers +         \
+                    CudaDMARegisterCost::working;                                                   \
+  _diag.optimized = (_diag.total_steps <= 1);
+
 // Default class implementation that supports diagnostic printing for CudaDMAStrided
 template<bool DO_SYNC>
 class CudaDMAStrided<DO_SYNC,0,0,0,0,0> {
@@ -3211,7 +4031,7 @@ public:
   __host__
   static void diagnose(const int ALIGNMENT, const int BYTES_PER_THREAD, const int BYTES_PER_ELMT,
                        const int DMA_THREADS, const int NUM_ELMTS, const bool FULL_TEMPLATE, 
-                       const bool verbose = false)
+                       const bool verbose = false, const int register_budget = 0)
   {
 #define PRINT_VAR(var_name) printf(#var_name " %d\n", (var_name))
     fprintf(stdout,"********************************************************************\n");
@@ -3278,6 +4098,8 @@ public:
           fprintf(stdout,"    - Increase element size thereby loading superflous data with the benefit\n");
           fprintf(stdout,"          of improving guaranteed alignment of pointers\n");
         }
+        if (FULL_TEMPLATE && PIPE_STEPS_BIG(MAX_ITERS_BIG,PART_ITERS_BIG))
+          fprintf(stdout,"  NOTE: the steps of each element are pipelined over the two halves of the buffer.\n");
         if (verbose)
         {
           PRINT_VAR(HAS_PARTIAL_ELMTS_BIG);
@@ -3297,7 +4119,7 @@ public:
                 ((ELMT_PER_STEP_FULL > NUM_ELMTS) ? NUM_ELMTS : ELMT_PER_STEP_FULL));
         unsigned num_steps = STEP_ITERS_FULL+(HAS_PARTIAL_ELMTS_FULL ? 1 : 0);
         fprintf(stdout,"  TOTAL REQUIRED STEPS: %d\n", num_steps);
-        if (num_steps == 0)
+        if (num_steps <= 1)
         {
           fprintf(stdout,"  DIAGNOSIS: OPTIMIZED! This transfer can be performed in a single step.\n");
         }
@@ -3407,6 +4229,8 @@ public:
           fprintf(stdout,"    - Increase element size thereby loading superflous data with the benefit\n");
           fprintf(stdout,"          of improving guaranteed alignment of pointers\n");
         }
+        if (FULL_TEMPLATE && PIPE_STEPS_BIG(MAX_ITERS_BIG,PART_ITERS_BIG))
+          fprintf(stdout,"  NOTE: the steps of each element are pipelined over the two halves of the buffer.\n");
         if (verbose)
         {
           PRINT_VAR(HAS_PARTIAL_ELMTS_BIG);
@@ -3486,10 +4310,48 @@ public:
 #define WARPS_PER_ELMT (BIG_ELMTS ? NUM_WARPS : \
                         (MINIMUM_COVER > 0) ? MINIMUM_COVER : 1)
     }
+    if (register_budget > 0)
+      cudaDMA_check_register_budget(analyze(ALIGNMENT, BYTES_PER_THREAD, BYTES_PER_ELMT,
+                                            DMA_THREADS, NUM_ELMTS, FULL_TEMPLATE),
+                                    register_budget, stdout);
     fprintf(stdout,"\n\n");
     fflush(stdout);
 #undef PRINT_VAR
   }
+  // Same analysis as diagnose, but returned as a CudaDMADiagnosis
+  // (see cudaDMA_print_diagnosis_json) instead of being printed
+  __host__
+  static CudaDMADiagnosis analyze(const int ALIGNMENT, const int BYTES_PER_THREAD, const int BYTES_PER_ELMT,
+                                  const int DMA_THREADS, const int NUM_ELMTS, const bool FULL_TEMPLATE)
+  {
+    CudaDMADiagnosis diag;
+    diag.pattern = "CudaDMAStrided";
+    if (!FULL_TEMPLATE)
+    {
+      STRIDED_ANALYZE_IMPL(diag,CudaDMARegisterCost::strided)
+    }
+    else
+    {
+#undef MINIMUM_COVER
+#undef WARPS_PER_ELMT
+#define SINGLE_WARP ((LDS_PER_ELMT <= (WARP_SIZE*MAX_LDS_PER_THREAD)) && (NUM_WARPS <= NUM_ELMTS))
+#define MINIMUM_COVER ((LDS_PER_ELMT+(WARP_SIZE*MAX_LDS_PER_THREAD)-1)/(WARP_SIZE*MAX_LDS_PER_THREAD))
+#define MAX_WARPS_PER_ELMT ((LDS_PER_ELMT+WARP_SIZE-1)/WARP_SIZE)
+#define WARPS_PER_ELMT (SINGLE_WARP ? 1 : \
+                        BIG_ELMTS ? NUM_WARPS : \
+                        ((NUM_WARPS/MINIMUM_COVER) <= NUM_ELMTS) ? MINIMUM_COVER : \
+                        ((MAX_WARPS_PER_ELMT >= NUM_WARPS) ? NUM_WARPS : MAX_WARPS_PER_ELMT))
+      STRIDED_ANALYZE_IMPL(diag,CudaDMARegisterCost::strided)
+#undef SINGLE_WARP
+#undef MINIMUM_COVER
+#undef MAX_WARPS_PER_ELMT
+#undef WARPS_PER_ELMT
+#define MINIMUM_COVER ((LDS_PER_ELMT+(WARP_SIZE*MAX_LDS_PER_THREAD)-1)/(WARP_SIZE*MAX_LDS_PER_THREAD))
+#define WARPS_PER_ELMT (BIG_ELMTS ? NUM_WARPS : \
+                        (MINIMUM_COVER > 0) ? MINIMUM_COVER : 1)
+    }
+    return diag;
+  }
 };
 
 #define WARP_SPECIALIZED_UNQUALIFIED_METHODS                                                        \
@@ -3504,9 +4366,13 @@ public:
   }                                                                                                 \
   __device__ __forceinline__ void wait_xfer_finish(void *RESTRICT dst_ptr)                          \
   {                                                                                                 \
-    CudaDMA::template wait_for_dma_start();                                                         \
+    CudaDMA::wait_for_dma_start();                                                                  \
     STRIDED_WAIT_XFER_IMPL(false,LOAD_CACHE_ALL,STORE_WRITE_BACK)                                   \
-    CudaDMA::template finish_async_dma();                                                           \
+    CudaDMA::finish_async_dma();                                                                    \
+  }                                                                                                 \
+  __device__ __forceinline__ void prefetch(const void *RESTRICT src_ptr) const                      \
+  {                                                                                                 \
+    prefetch<false>(src_ptr);                                                                       \
   }
 
 #define WARP_SPECIALIZED_QUALIFIED_METHODS                                                          \
@@ -3524,9 +4390,9 @@ public:
   template<bool DMA_GLOBAL_LOAD>                                                                    \
   __device__ __forceinline__ void wait_xfer_finish(void *RESTRICT dst_ptr)                          \
   {                                                                                                 \
-    CudaDMA::template wait_for_dma_start();                                                         \
+    CudaDMA::wait_for_dma_start();                                                                  \
     STRIDED_WAIT_XFER_IMPL(DMA_GLOBAL_LOAD,LOAD_CACHE_ALL,STORE_WRITE_BACK)                         \
-    CudaDMA::template finish_async_dma();                                                           \
+    CudaDMA::finish_async_dma();                                                                    \
   }                                                                                                 \
   template<bool DMA_GLOBAL_LOAD, int DMA_LOAD_QUAL, int DMA_STORE_QUAL>                             \
   __device__ __forceinline__ void execute_dma(const void *RESTRICT src_ptr, void *RESTRICT dst_ptr) \
@@ -3542,9 +4408,27 @@ public:
   template<bool DMA_GLOBAL_LOAD, int DMA_LOAD_QUAL, int DMA_STORE_QUAL>                             \
   __device__ __forceinline__ void wait_xfer_finish(void *RESTRICT dst_ptr)                          \
   {                                                                                                 \
-    CudaDMA::template wait_for_dma_start();                                                         \
+    CudaDMA::wait_for_dma_start();                                                                  \
     STRIDED_WAIT_XFER_IMPL(DMA_GLOBAL_LOAD,DMA_LOAD_QUAL,DMA_STORE_QUAL)                            \
-    CudaDMA::template finish_async_dma();                                                           \
+    CudaDMA::finish_async_dma();                                                                    \
+  }                                                                                                 \
+  template<bool DMA_GLOBAL_LOAD>                                                                    \
+  __device__ __forceinline__ void prefetch(const void *RESTRICT src_ptr) const                      \
+  {                                                                                                 \
+    /* Walk the transfer on a copy so that a transfer in flight is untouched */                     \
+    CudaDMAMeta::copy_of(*this).template prefetch_xfer<DMA_GLOBAL_LOAD>(src_ptr);                   \
+  }                                                                                                 \
+private:                                                                                            \
+  template<bool DMA_GLOBAL_LOAD>                                                                    \
+  __device__ __forceinline__ void prefetch_xfer(const void *RESTRICT src_ptr)                       \
+  {                                                                                                 \
+    void *const dst_ptr = NULL;                                                                     \
+    {                                                                                               \
+      STRIDED_START_XFER_IMPL(DMA_GLOBAL_LOAD,LOAD_PREFETCH_L2,CUDADMA_STORE_DISCARD)               \
+    }                                                                                               \
+    {                                                                                               \
+      STRIDED_WAIT_XFER_IMPL(DMA_GLOBAL_LOAD,LOAD_PREFETCH_L2,CUDADMA_STORE_DISCARD)                \
+    }                                                                                               \
   }
 
 #define NON_WARP_SPECIALIZED_UNQUALIFIED_METHODS                                                    \
@@ -3560,6 +4444,10 @@ public:
   __device__ __forceinline__ void wait_xfer_finish(void *RESTRICT dst_ptr)                          \
   {                                                                                                 \
     STRIDED_WAIT_XFER_IMPL(false,LOAD_CACHE_ALL,STORE_WRITE_BACK)                                   \
+  }                                                                                                 \
+  __device__ __forceinline__ void prefetch(const void *RESTRICT src_ptr) const                      \
+  {                                                                                                 \
+    prefetch<false>(src_ptr);                                                                       \
   }
 
 #define NON_WARP_SPECIALIZED_QUALIFIED_METHODS                                                      \
@@ -3594,11 +4482,29 @@ public:
   __device__ __forceinline__ void wait_xfer_finish(void *RESTRICT dst_ptr)                          \
   {                                                                                                 \
     STRIDED_WAIT_XFER_IMPL(DMA_GLOBAL_LOAD,DMA_LOAD_QUAL,DMA_STORE_QUAL)                            \
-  }
-
-#ifdef DEBUG_CUDADMA
-#define LOAD_4_PARTIAL_BYTES_IMPL                                                                   \
-  template<int DMA_ROW_ITERS, bool DMA_GLOBAL_LOAD, int DMA_LOAD_QUAL>                              \
+  }                                                                                                 \
+  template<bool DMA_GLOBAL_LOAD>                                                                    \
+  __device__ __forceinline__ void prefetch(const void *RESTRICT src_ptr) const                      \
+  {                                                                                                 \
+    /* Walk the transfer on a copy so that a transfer in flight is untouched */                     \
+    CudaDMAMeta::copy_of(*this).template prefetch_xfer<DMA_GLOBAL_LOAD>(src_ptr);                   \
+  }                                                                                                 \
+private:                                                                                            \
+  template<bool DMA_GLOBAL_LOAD>                                                                    \
+  __device__ __forceinline__ void prefetch_xfer(const void *RESTRICT src_ptr)                       \
+  {                                                                                                 \
+    void *const dst_ptr = NULL;                                                                     \
+    {                                                                                               \
+      STRIDED_START_XFER_IMPL(DMA_GLOBAL_LOAD,LOAD_PREFETCH_L2,CUDADMA_STORE_DISCARD)               \
+    }                                                                                               \
+    {                                                                                               \
+      STRIDED_WAIT_XFER_IMPL(DMA_GLOBAL_LOAD,LOAD_PREFETCH_L2,CUDADMA_STORE_DISCARD)                \
+    }                                                                                               \
+  }
+
+#ifdef DEBUG_CUDADMA
+#define LOAD_4_PARTIAL_BYTES_IMPL                                                                   \
+  template<int DMA_ROW_ITERS, bool DMA_GLOBAL_LOAD, int DMA_LOAD_QUAL>                              \
   __device__ __forceinline__ void load_across(const char *RESTRICT src_ptr,                         \
                                               const int src_elmt_stride, const int partial_bytes)   \
   {                                                                                                 \
@@ -8286,6 +9192,80 @@ private:
                         BIG_ELMTS ? NUM_WARPS : \
                         ((NUM_WARPS/MINIMUM_COVER) <= NUM_ELMTS) ? MINIMUM_COVER : \
                         ((MAX_WARPS_PER_ELMT >= NUM_WARPS) ? NUM_WARPS : MAX_WARPS_PER_ELMT))
+
+/**
+ * CudaDMAStridedPlan exposes the layout that a fully templated CudaDMAStrided
+ * instance will use as compile-time constants.  Like CudaDMASequentialPlan every
+ * value comes from the same expressions as the instances so tools and static
+ * assertions can query a configuration without instantiating a kernel.  Values
+ * that belong to a case other than the one selected are reported as zero.
+ * The plan for an instance is also available as CudaDMAStrided<...>::Plan.
+ */
+template<int ALIGNMENT, int BYTES_PER_THREAD, int BYTES_PER_ELMT, int DMA_THREADS, int NUM_ELMTS>
+struct CudaDMAStridedPlan {
+  static const int alignment = ALIGNMENT;
+  static const int bytes_per_thread = BYTES_PER_THREAD;
+  static const int bytes_per_elmt = BYTES_PER_ELMT;
+  static const int dma_threads = DMA_THREADS;
+  static const int num_elmts = NUM_ELMTS;
+  static const int max_lds_per_thread = MAX_LDS_PER_THREAD;
+  static const int lds_per_elmt = LDS_PER_ELMT;
+  static const int full_lds_per_elmt = FULL_LDS_PER_ELMT;
+  static const int num_warps = NUM_WARPS;
+  // Which of the three cases handles the transfer
+  static const bool split_warp = SPLIT_WARP;
+  static const bool big_elmts = !SPLIT_WARP && BIG_ELMTS;
+  static const bool full_elmts = !SPLIT_WARP && !BIG_ELMTS;
+  // Split case
+  static const int threads_per_elmt = split_warp ? THREADS_PER_ELMT : 0;
+  static const int elmt_per_step_split = split_warp ? ELMT_PER_STEP_SPLIT : 0;
+  static const int row_iters_split = split_warp ? ROW_ITERS_SPLIT : 0;
+  static const int col_iters_split = split_warp ? COL_ITERS_SPLIT : 0;
+  static const int step_iters_split = split_warp ? STEP_ITERS_SPLIT : 0;
+  static const bool has_partial_elmts_split = split_warp && HAS_PARTIAL_ELMTS_SPLIT;
+  static const bool has_partial_bytes_split = split_warp && HAS_PARTIAL_BYTES_SPLIT;
+  // Big case
+  static const int max_iters_big = big_elmts ? MAX_ITERS_BIG : 0;
+  static const int part_iters_big = big_elmts ? PART_ITERS_BIG : 0;
+  static const int remaining_bytes_big = big_elmts ? REMAINING_BYTES_BIG : 0;
+  static const int step_iters_big = big_elmts ? STEP_ITERS_BIG : 0;
+  static const bool has_partial_elmts_big = big_elmts && HAS_PARTIAL_ELMTS_BIG;
+  static const bool has_partial_bytes_big = big_elmts && HAS_PARTIAL_BYTES_BIG;
+  // Whether each half of the buffer is refilled with the next step of an
+  // element as soon as it is stored, keeping loads outstanding between steps
+  static const bool pipelined_steps = big_elmts && PIPE_STEPS_BIG(MAX_ITERS_BIG,PART_ITERS_BIG);
+  // Full case
+  static const int warps_per_elmt = full_elmts ? WARPS_PER_ELMT : 0;
+  static const int lds_per_elmt_per_thread = full_elmts ? LDS_PER_ELMT_PER_THREAD : 0;
+  static const int elmt_per_step_full = full_elmts ? ELMT_PER_STEP_FULL : 0;
+  static const int row_iters_full = full_elmts ? ROW_ITERS_FULL : 0;
+  static const int col_iters_full = full_elmts ? COL_ITERS_FULL : 0;
+  static const int step_iters_full = full_elmts ? STEP_ITERS_FULL : 0;
+  static const bool has_partial_elmts_full = full_elmts && HAS_PARTIAL_ELMTS_FULL;
+  static const bool has_partial_bytes_full = full_elmts && HAS_PARTIAL_BYTES_FULL;
+  static const int num_active_warps = full_elmts ? NUM_ACTIVE_WARPS : NUM_WARPS;
+  static const bool all_warps_active = (num_active_warps == NUM_WARPS);
+  // Summary of the selected case
+  static const bool has_partial_bytes = HAS_PARTIAL_BYTES;
+  static const bool has_partial_elmts = HAS_PARTIAL_ELMTS;
+  static const int total_steps = split_warp ? (step_iters_split + (has_partial_elmts_split ? 1 : 0)) :
+                                 big_elmts ? (NUM_ELMTS * (max_iters_big + 
+                                     ((has_partial_elmts_big || has_partial_bytes_big) ? 1 : 0))) :
+                                 (step_iters_full + (has_partial_elmts_full ? 1 : 0));
+  static const bool single_step = (total_steps <= 1);
+  // Maximum number of loads issued by a DMA thread in a step
+  static const int loads_per_step = split_warp ? row_iters_split :
+                                    big_elmts ? MAX_LDS_PER_THREAD :
+                                    (row_iters_full * (col_iters_full + (has_partial_bytes_full ? 1 : 0)));
+  // Estimated registers per DMA thread (see CudaDMARegisterBudget)
+  static const int bulk_registers = BYTES_PER_THREAD/sizeof(float);
+  static const int across_registers = (split_warp ? GUARD_ZERO(row_iters_split) :
+                                       big_elmts ? 1 : GUARD_ZERO(row_iters_full))*ALIGNMENT/sizeof(float);
+  static const int state_registers = CudaDMARegisterCost::base + CudaDMARegisterCost::strided;
+  static const int registers = bulk_registers + across_registers + state_registers +
+                               CudaDMARegisterCost::working;
+};
+
 #define TEMPLATE_FOUR_IMPL                                                                                  \
   template<bool DMA_GLOBAL_LOAD, int DMA_LOAD_QUAL, bool DMA_IS_SPLIT, bool DMA_IS_BIG,                     \
            int DMA_STEP_ITERS_SPLIT, int DMA_ROW_ITERS_SPLIT, int DMA_COL_ITERS_SPLIT,                      \
@@ -8607,6 +9587,7 @@ private:
 template<int BYTES_PER_THREAD, int BYTES_PER_ELMT, int DMA_THREADS, int NUM_ELMTS>
 class CudaDMAStrided<true,ALIGNMENT,BYTES_PER_THREAD,BYTES_PER_ELMT,DMA_THREADS,NUM_ELMTS> : public CudaDMA {
 public:
+  typedef CudaDMAStridedPlan<ALIGNMENT,BYTES_PER_THREAD,BYTES_PER_ELMT,DMA_THREADS,NUM_ELMTS> Plan;
   __device__ CudaDMAStrided(const int dmaID,
                             const int num_compute_threads,
                             const int dma_threadIdx_start,
@@ -8660,24 +9641,64 @@ private:
   __device__ __forceinline__ void perform_copy_elmt(const char *RESTRICT src_ptr, char *RESTRICT dst_ptr, 
                                                     const int intra_elmt_stride, const int partial_bytes)
   {
-    for (int idx = 0; idx < DMA_MAX_ITERS; idx++)
+    if (PIPE_STEPS_BIG(DMA_MAX_ITERS,DMA_PARTIAL_ITERS))
     {
+      // Refill each half with the next step of the element as soon as it
+      // is stored so the loads of the other half stay outstanding meanwhile
+      const int upper_offset = PIPE_LOWER_LDS_BIG*intra_elmt_stride;
       CudaDMAMeta::BufferLoader<BulkBuffer,0,1,BYTES_PER_THREAD/ALIGNMENT,
         BYTES_PER_THREAD/ALIGNMENT,DMA_GLOBAL_LOAD,DMA_LOAD_QUAL>::load_all(bulk_buffer, src_ptr, intra_elmt_stride);
       src_ptr += ((BYTES_PER_THREAD/ALIGNMENT)*intra_elmt_stride);
-      CudaDMAMeta::BufferStorer<BulkBuffer,0,1,BYTES_PER_THREAD/ALIGNMENT,
-        BYTES_PER_THREAD/ALIGNMENT,DMA_STORE_QUAL>::store_all(bulk_buffer, dst_ptr, intra_elmt_stride);
-      dst_ptr += ((BYTES_PER_THREAD/ALIGNMENT)*intra_elmt_stride);
-    }
-    if (DMA_PARTIAL_ITERS > 0)
-    {
-      CudaDMAMeta::BufferLoader<BulkBuffer,0,1,DMA_PARTIAL_ITERS,
-        DMA_PARTIAL_ITERS,DMA_GLOBAL_LOAD,DMA_LOAD_QUAL>::load_all(bulk_buffer, src_ptr, intra_elmt_stride);
+      for (int idx = 0; idx < DMA_MAX_ITERS; idx++)
+      {
+        CudaDMAMeta::BufferStorer<BulkBuffer,0,1,PIPE_LOWER_LDS_BIG,
+          PIPE_LOWER_LDS_BIG,DMA_STORE_QUAL>::store_all(bulk_buffer, dst_ptr, intra_elmt_stride);
+        if (idx < (DMA_MAX_ITERS-1))
+          CudaDMAMeta::BufferLoader<BulkBuffer,0,1,PIPE_LOWER_LDS_BIG,
+            PIPE_LOWER_LDS_BIG,DMA_GLOBAL_LOAD,DMA_LOAD_QUAL>::load_all(bulk_buffer, src_ptr, intra_elmt_stride);
+        else if (DMA_PARTIAL_ITERS <= PIPE_LOWER_LDS_BIG)
+          CudaDMAMeta::BufferLoader<BulkBuffer,0,1,DMA_PARTIAL_ITERS,
+            DMA_PARTIAL_ITERS,DMA_GLOBAL_LOAD,DMA_LOAD_QUAL>::load_all(bulk_buffer, src_ptr, intra_elmt_stride);
+        CudaDMAMeta::BufferStorer<BulkBuffer,PIPE_LOWER_LDS_BIG,1,PIPE_UPPER_LDS_BIG,
+          PIPE_UPPER_LDS_BIG,DMA_STORE_QUAL>::store_all(bulk_buffer, dst_ptr + upper_offset, intra_elmt_stride);
+        if (idx < (DMA_MAX_ITERS-1))
+        {
+          CudaDMAMeta::BufferLoader<BulkBuffer,PIPE_LOWER_LDS_BIG,1,PIPE_UPPER_LDS_BIG,
+            PIPE_UPPER_LDS_BIG,DMA_GLOBAL_LOAD,DMA_LOAD_QUAL>::load_all(bulk_buffer, src_ptr + upper_offset,
+                                                                         intra_elmt_stride);
+          src_ptr += ((BYTES_PER_THREAD/ALIGNMENT)*intra_elmt_stride);
+        }
+        dst_ptr += ((BYTES_PER_THREAD/ALIGNMENT)*intra_elmt_stride);
+      }
+      if (DMA_PARTIAL_ITERS > PIPE_LOWER_LDS_BIG)
+        CudaDMAMeta::BufferLoader<BulkBuffer,0,1,DMA_PARTIAL_ITERS,
+          DMA_PARTIAL_ITERS,DMA_GLOBAL_LOAD,DMA_LOAD_QUAL>::load_all(bulk_buffer, src_ptr, intra_elmt_stride);
       src_ptr += (DMA_PARTIAL_ITERS * intra_elmt_stride);
       CudaDMAMeta::BufferStorer<BulkBuffer,0,1,DMA_PARTIAL_ITERS,
         DMA_PARTIAL_ITERS,DMA_STORE_QUAL>::store_all(bulk_buffer, dst_ptr, intra_elmt_stride);
       dst_ptr += (DMA_PARTIAL_ITERS * intra_elmt_stride);
     }
+    else
+    {
+      for (int idx = 0; idx < DMA_MAX_ITERS; idx++)
+      {
+        CudaDMAMeta::BufferLoader<BulkBuffer,0,1,BYTES_PER_THREAD/ALIGNMENT,
+          BYTES_PER_THREAD/ALIGNMENT,DMA_GLOBAL_LOAD,DMA_LOAD_QUAL>::load_all(bulk_buffer, src_ptr, intra_elmt_stride);
+        src_ptr += ((BYTES_PER_THREAD/ALIGNMENT)*intra_elmt_stride);
+        CudaDMAMeta::BufferStorer<BulkBuffer,0,1,BYTES_PER_THREAD/ALIGNMENT,
+          BYTES_PER_THREAD/ALIGNMENT,DMA_STORE_QUAL>::store_all(bulk_buffer, dst_ptr, intra_elmt_stride);
+        dst_ptr += ((BYTES_PER_THREAD/ALIGNMENT)*intra_elmt_stride);
+      }
+      if (DMA_PARTIAL_ITERS > 0)
+      {
+        CudaDMAMeta::BufferLoader<BulkBuffer,0,1,DMA_PARTIAL_ITERS,
+          DMA_PARTIAL_ITERS,DMA_GLOBAL_LOAD,DMA_LOAD_QUAL>::load_all(bulk_buffer, src_ptr, intra_elmt_stride);
+        src_ptr += (DMA_PARTIAL_ITERS * intra_elmt_stride);
+        CudaDMAMeta::BufferStorer<BulkBuffer,0,1,DMA_PARTIAL_ITERS,
+          DMA_PARTIAL_ITERS,DMA_STORE_QUAL>::store_all(bulk_buffer, dst_ptr, intra_elmt_stride);
+        dst_ptr += (DMA_PARTIAL_ITERS * intra_elmt_stride);
+      }
+    }
     if (DMA_PARTIAL_BYTES)
     {
       switch (partial_bytes)
@@ -8726,6 +9747,7 @@ private:
 template<int BYTES_PER_THREAD, int BYTES_PER_ELMT, int DMA_THREADS, int NUM_ELMTS>
 class CudaDMAStrided<true,ALIGNMENT,BYTES_PER_THREAD,BYTES_PER_ELMT,DMA_THREADS,NUM_ELMTS> : public CudaDMA {
 public:
+  typedef CudaDMAStridedPlan<ALIGNMENT,BYTES_PER_THREAD,BYTES_PER_ELMT,DMA_THREADS,NUM_ELMTS> Plan;
   __device__ CudaDMAStrided(const int dmaID,
                             const int num_compute_threads,
                             const int dma_threadIdx_start,
@@ -8779,24 +9801,64 @@ private:
   __device__ __forceinline__ void perform_copy_elmt(const char *RESTRICT src_ptr, char *RESTRICT dst_ptr, 
                                                     const int intra_elmt_stride, const int partial_bytes)
   {
-    for (int idx = 0; idx < DMA_MAX_ITERS; idx++)
+    if (PIPE_STEPS_BIG(DMA_MAX_ITERS,DMA_PARTIAL_ITERS))
     {
+      // Refill each half with the next step of the element as soon as it
+      // is stored so the loads of the other half stay outstanding meanwhile
+      const int upper_offset = PIPE_LOWER_LDS_BIG*intra_elmt_stride;
       CudaDMAMeta::BufferLoader<BulkBuffer,0,1,BYTES_PER_THREAD/ALIGNMENT,
         BYTES_PER_THREAD/ALIGNMENT,DMA_GLOBAL_LOAD,DMA_LOAD_QUAL>::load_all(bulk_buffer, src_ptr, intra_elmt_stride);
       src_ptr += ((BYTES_PER_THREAD/ALIGNMENT)*intra_elmt_stride);
-      CudaDMAMeta::BufferStorer<BulkBuffer,0,1,BYTES_PER_THREAD/ALIGNMENT,
-        BYTES_PER_THREAD/ALIGNMENT,DMA_STORE_QUAL>::store_all(bulk_buffer, dst_ptr, intra_elmt_stride);
-      dst_ptr += ((BYTES_PER_THREAD/ALIGNMENT)*intra_elmt_stride);
-    }
-    if (DMA_PARTIAL_ITERS > 0)
-    {
-      CudaDMAMeta::BufferLoader<BulkBuffer,0,1,DMA_PARTIAL_ITERS,
-        DMA_PARTIAL_ITERS,DMA_GLOBAL_LOAD,DMA_LOAD_QUAL>::load_all(bulk_buffer, src_ptr, intra_elmt_stride);
+      for (int idx = 0; idx < DMA_MAX_ITERS; idx++)
+      {
+        CudaDMAMeta::BufferStorer<BulkBuffer,0,1,PIPE_LOWER_LDS_BIG,
+          PIPE_LOWER_LDS_BIG,DMA_STORE_QUAL>::store_all(bulk_buffer, dst_ptr, intra_elmt_stride);
+        if (idx < (DMA_MAX_ITERS-1))
+          CudaDMAMeta::BufferLoader<BulkBuffer,0,1,PIPE_LOWER_LDS_BIG,
+            PIPE_LOWER_LDS_BIG,DMA_GLOBAL_LOAD,DMA_LOAD_QUAL>::load_all(bulk_buffer, src_ptr, intra_elmt_stride);
+        else if (DMA_PARTIAL_ITERS <= PIPE_LOWER_LDS_BIG)
+          CudaDMAMeta::BufferLoader<BulkBuffer,0,1,DMA_PARTIAL_ITERS,
+            DMA_PARTIAL_ITERS,DMA_GLOBAL_LOAD,DMA_LOAD_QUAL>::load_all(bulk_buffer, src_ptr, intra_elmt_stride);
+        CudaDMAMeta::BufferStorer<BulkBuffer,PIPE_LOWER_LDS_BIG,1,PIPE_UPPER_LDS_BIG,
+          PIPE_UPPER_LDS_BIG,DMA_STORE_QUAL>::store_all(bulk_buffer, dst_ptr + upper_offset, intra_elmt_stride);
+        if (idx < (DMA_MAX_ITERS-1))
+        {
+          CudaDMAMeta::BufferLoader<BulkBuffer,PIPE_LOWER_LDS_BIG,1,PIPE_UPPER_LDS_BIG,
+            PIPE_UPPER_LDS_BIG,DMA_GLOBAL_LOAD,DMA_LOAD_QUAL>::load_all(bulk_buffer, src_ptr + upper_offset,
+                                                                         intra_elmt_stride);
+          src_ptr += ((BYTES_PER_THREAD/ALIGNMENT)*intra_elmt_stride);
+        }
+        dst_ptr += ((BYTES_PER_THREAD/ALIGNMENT)*intra_elmt_stride);
+      }
+      if (DMA_PARTIAL_ITERS > PIPE_LOWER_LDS_BIG)
+        CudaDMAMeta::BufferLoader<BulkBuffer,0,1,DMA_PARTIAL_ITERS,
+          DMA_PARTIAL_ITERS,DMA_GLOBAL_LOAD,DMA_LOAD_QUAL>::load_all(bulk_buffer, src_ptr, intra_elmt_stride);
       src_ptr += (DMA_PARTIAL_ITERS * intra_elmt_stride);
       CudaDMAMeta::BufferStorer<BulkBuffer,0,1,DMA_PARTIAL_ITERS,
         DMA_PARTIAL_ITERS,DMA_STORE_QUAL>::store_all(bulk_buffer, dst_ptr, intra_elmt_stride);
       dst_ptr += (DMA_PARTIAL_ITERS * intra_elmt_stride);
     }
+    else
+    {
+      for (int idx = 0; idx < DMA_MAX_ITERS; idx++)
+      {
+        CudaDMAMeta::BufferLoader<BulkBuffer,0,1,BYTES_PER_THREAD/ALIGNMENT,
+          BYTES_PER_THREAD/ALIGNMENT,DMA_GLOBAL_LOAD,DMA_LOAD_QUAL>::load_all(bulk_buffer, src_ptr, intra_elmt_stride);
+        src_ptr += ((BYTES_PER_THREAD/ALIGNMENT)*intra_elmt_stride);
+        CudaDMAMeta::BufferStorer<BulkBuffer,0,1,BYTES_PER_THREAD/ALIGNMENT,
+          BYTES_PER_THREAD/ALIGNMENT,DMA_STORE_QUAL>::store_all(bulk_buffer, dst_ptr, intra_elmt_stride);
+        dst_ptr += ((BYTES_PER_THREAD/ALIGNMENT)*intra_elmt_stride);
+      }
+      if (DMA_PARTIAL_ITERS > 0)
+      {
+        CudaDMAMeta::BufferLoader<BulkBuffer,0,1,DMA_PARTIAL_ITERS,
+          DMA_PARTIAL_ITERS,DMA_GLOBAL_LOAD,DMA_LOAD_QUAL>::load_all(bulk_buffer, src_ptr, intra_elmt_stride);
+        src_ptr += (DMA_PARTIAL_ITERS * intra_elmt_stride);
+        CudaDMAMeta::BufferStorer<BulkBuffer,0,1,DMA_PARTIAL_ITERS,
+          DMA_PARTIAL_ITERS,DMA_STORE_QUAL>::store_all(bulk_buffer, dst_ptr, intra_elmt_stride);
+        dst_ptr += (DMA_PARTIAL_ITERS * intra_elmt_stride);
+      }
+    }
     if (DMA_PARTIAL_BYTES)
     {
       switch (partial_bytes)
@@ -8851,6 +9913,7 @@ private:
 template<int BYTES_PER_THREAD, int BYTES_PER_ELMT, int DMA_THREADS, int NUM_ELMTS>
 class CudaDMAStrided<true,ALIGNMENT,BYTES_PER_THREAD,BYTES_PER_ELMT,DMA_THREADS,NUM_ELMTS> : public CudaDMA {
 public:
+  typedef CudaDMAStridedPlan<ALIGNMENT,BYTES_PER_THREAD,BYTES_PER_ELMT,DMA_THREADS,NUM_ELMTS> Plan;
   __device__ CudaDMAStrided(const int dmaID,
                             const int num_compute_threads,
                             const int dma_threadIdx_start,
@@ -8904,24 +9967,64 @@ private:
   __device__ __forceinline__ void perform_copy_elmt(const char *RESTRICT src_ptr, char *RESTRICT dst_ptr, 
                                                     const int intra_elmt_stride, const int partial_bytes)
   {
-    for (int idx = 0; idx < DMA_MAX_ITERS; idx++)
+    if (PIPE_STEPS_BIG(DMA_MAX_ITERS,DMA_PARTIAL_ITERS))
     {
+      // Refill each half with the next step of the element as soon as it
+      // is stored so the loads of the other half stay outstanding meanwhile
+      const int upper_offset = PIPE_LOWER_LDS_BIG*intra_elmt_stride;
       CudaDMAMeta::BufferLoader<BulkBuffer,0,1,BYTES_PER_THREAD/ALIGNMENT,
         BYTES_PER_THREAD/ALIGNMENT,DMA_GLOBAL_LOAD,DMA_LOAD_QUAL>::load_all(bulk_buffer, src_ptr, intra_elmt_stride);
       src_ptr += ((BYTES_PER_THREAD/ALIGNMENT)*intra_elmt_stride);
-      CudaDMAMeta::BufferStorer<BulkBuffer,0,1,BYTES_PER_THREAD/ALIGNMENT,
-        BYTES_PER_THREAD/ALIGNMENT,DMA_STORE_QUAL>::store_all(bulk_buffer, dst_ptr, intra_elmt_stride);
-      dst_ptr += ((BYTES_PER_THREAD/ALIGNMENT)*intra_elmt_stride);
-    }
-    if (DMA_PARTIAL_ITERS > 0)
-    {
-      CudaDMAMeta::BufferLoader<BulkBuffer,0,1,DMA_PARTIAL_ITERS,
-        DMA_PARTIAL_ITERS,DMA_GLOBAL_LOAD,DMA_LOAD_QUAL>::load_all(bulk_buffer, src_ptr, intra_elmt_stride);
+      for (int idx = 0; idx < DMA_MAX_ITERS; idx++)
+      {
+        CudaDMAMeta::BufferStorer<BulkBuffer,0,1,PIPE_LOWER_LDS_BIG,
+          PIPE_LOWER_LDS_BIG,DMA_STORE_QUAL>::store_all(bulk_buffer, dst_ptr, intra_elmt_stride);
+        if (idx < (DMA_MAX_ITERS-1))
+          CudaDMAMeta::BufferLoader<BulkBuffer,0,1,PIPE_LOWER_LDS_BIG,
+            PIPE_LOWER_LDS_BIG,DMA_GLOBAL_LOAD,DMA_LOAD_QUAL>::load_all(bulk_buffer, src_ptr, intra_elmt_stride);
+        else if (DMA_PARTIAL_ITERS <= PIPE_LOWER_LDS_BIG)
+          CudaDMAMeta::BufferLoader<BulkBuffer,0,1,DMA_PARTIAL_ITERS,
+            DMA_PARTIAL_ITERS,DMA_GLOBAL_LOAD,DMA_LOAD_QUAL>::load_all(bulk_buffer, src_ptr, intra_elmt_stride);
+        CudaDMAMeta::BufferStorer<BulkBuffer,PIPE_LOWER_LDS_BIG,1,PIPE_UPPER_LDS_BIG,
+          PIPE_UPPER_LDS_BIG,DMA_STORE_QUAL>::store_all(bulk_buffer, dst_ptr + upper_offset, intra_elmt_stride);
+        if (idx < (DMA_MAX_ITERS-1))
+        {
+          CudaDMAMeta::BufferLoader<BulkBuffer,PIPE_LOWER_LDS_BIG,1,PIPE_UPPER_LDS_BIG,
+            PIPE_UPPER_LDS_BIG,DMA_GLOBAL_LOAD,DMA_LOAD_QUAL>::load_all(bulk_buffer, src_ptr + upper_offset,
+                                                                         intra_elmt_stride);
+          src_ptr += ((BYTES_PER_THREAD/ALIGNMENT)*intra_elmt_stride);
+        }
+        dst_ptr += ((BYTES_PER_THREAD/ALIGNMENT)*intra_elmt_stride);
+      }
+      if (DMA_PARTIAL_ITERS > PIPE_LOWER_LDS_BIG)
+        CudaDMAMeta::BufferLoader<BulkBuffer,0,1,DMA_PARTIAL_ITERS,
+          DMA_PARTIAL_ITERS,DMA_GLOBAL_LOAD,DMA_LOAD_QUAL>::load_all(bulk_buffer, src_ptr, intra_elmt_stride);
       src_ptr += (DMA_PARTIAL_ITERS * intra_elmt_stride);
       CudaDMAMeta::BufferStorer<BulkBuffer,0,1,DMA_PARTIAL_ITERS,
         DMA_PARTIAL_ITERS,DMA_STORE_QUAL>::store_all(bulk_buffer, dst_ptr, intra_elmt_stride);
       dst_ptr += (DMA_PARTIAL_ITERS * intra_elmt_stride);
     }
+    else
+    {
+      for (int idx = 0; idx < DMA_MAX_ITERS; idx++)
+      {
+        CudaDMAMeta::BufferLoader<BulkBuffer,0,1,BYTES_PER_THREAD/ALIGNMENT,
+          BYTES_PER_THREAD/ALIGNMENT,DMA_GLOBAL_LOAD,DMA_LOAD_QUAL>::load_all(bulk_buffer, src_ptr, intra_elmt_stride);
+        src_ptr += ((BYTES_PER_THREAD/ALIGNMENT)*intra_elmt_stride);
+        CudaDMAMeta::BufferStorer<BulkBuffer,0,1,BYTES_PER_THREAD/ALIGNMENT,
+          BYTES_PER_THREAD/ALIGNMENT,DMA_STORE_QUAL>::store_all(bulk_buffer, dst_ptr, intra_elmt_stride);
+        dst_ptr += ((BYTES_PER_THREAD/ALIGNMENT)*intra_elmt_stride);
+      }
+      if (DMA_PARTIAL_ITERS > 0)
+      {
+        CudaDMAMeta::BufferLoader<BulkBuffer,0,1,DMA_PARTIAL_ITERS,
+          DMA_PARTIAL_ITERS,DMA_GLOBAL_LOAD,DMA_LOAD_QUAL>::load_all(bulk_buffer, src_ptr, intra_elmt_stride);
+        src_ptr += (DMA_PARTIAL_ITERS * intra_elmt_stride);
+        CudaDMAMeta::BufferStorer<BulkBuffer,0,1,DMA_PARTIAL_ITERS,
+          DMA_PARTIAL_ITERS,DMA_STORE_QUAL>::store_all(bulk_buffer, dst_ptr, intra_elmt_stride);
+        dst_ptr += (DMA_PARTIAL_ITERS * intra_elmt_stride);
+      }
+    }
     if (DMA_PARTIAL_BYTES)
     {
       switch (partial_bytes)
@@ -8989,6 +10092,7 @@ private:
 template<int BYTES_PER_THREAD, int BYTES_PER_ELMT, int DMA_THREADS, int NUM_ELMTS>
 class CudaDMAStrided<false,ALIGNMENT,BYTES_PER_THREAD,BYTES_PER_ELMT,DMA_THREADS,NUM_ELMTS> : public CudaDMA {
 public:
+  typedef CudaDMAStridedPlan<ALIGNMENT,BYTES_PER_THREAD,BYTES_PER_ELMT,DMA_THREADS,NUM_ELMTS> Plan;
 #define dma_threadIdx_start 0
   __device__ CudaDMAStrided(const int elmt_stride)
     : CudaDMA(0, DMA_THREADS, DMA_THREADS, dma_threadIdx_start),
@@ -9039,24 +10143,64 @@ private:
   __device__ __forceinline__ void perform_copy_elmt(const char *RESTRICT src_ptr, char *RESTRICT dst_ptr, 
                                                     const int intra_elmt_stride, const int partial_bytes)
   {
-    for (int idx = 0; idx < DMA_MAX_ITERS; idx++)
+    if (PIPE_STEPS_BIG(DMA_MAX_ITERS,DMA_PARTIAL_ITERS))
     {
+      // Refill each half with the next step of the element as soon as it
+      // is stored so the loads of the other half stay outstanding meanwhile
+      const int upper_offset = PIPE_LOWER_LDS_BIG*intra_elmt_stride;
       CudaDMAMeta::BufferLoader<BulkBuffer,0,1,BYTES_PER_THREAD/ALIGNMENT,
         BYTES_PER_THREAD/ALIGNMENT,DMA_GLOBAL_LOAD,DMA_LOAD_QUAL>::load_all(bulk_buffer, src_ptr, intra_elmt_stride);
       src_ptr += ((BYTES_PER_THREAD/ALIGNMENT)*intra_elmt_stride);
-      CudaDMAMeta::BufferStorer<BulkBuffer,0,1,BYTES_PER_THREAD/ALIGNMENT,
-        BYTES_PER_THREAD/ALIGNMENT,DMA_STORE_QUAL>::store_all(bulk_buffer, dst_ptr, intra_elmt_stride);
-      dst_ptr += ((BYTES_PER_THREAD/ALIGNMENT)*intra_elmt_stride);
-    }
-    if (DMA_PARTIAL_ITERS > 0)
-    {
-      CudaDMAMeta::BufferLoader<BulkBuffer,0,1,DMA_PARTIAL_ITERS,
-        DMA_PARTIAL_ITERS,DMA_GLOBAL_LOAD,DMA_LOAD_QUAL>::load_all(bulk_buffer, src_ptr, intra_elmt_stride);
+      for (int idx = 0; idx < DMA_MAX_ITERS; idx++)
+      {
+        CudaDMAMeta::BufferStorer<BulkBuffer,0,1,PIPE_LOWER_LDS_BIG,
+          PIPE_LOWER_LDS_BIG,DMA_STORE_QUAL>::store_all(bulk_buffer, dst_ptr, intra_elmt_stride);
+        if (idx < (DMA_MAX_ITERS-1))
+          CudaDMAMeta::BufferLoader<BulkBuffer,0,1,PIPE_LOWER_LDS_BIG,
+            PIPE_LOWER_LDS_BIG,DMA_GLOBAL_LOAD,DMA_LOAD_QUAL>::load_all(bulk_buffer, src_ptr, intra_elmt_stride);
+        else if (DMA_PARTIAL_ITERS <= PIPE_LOWER_LDS_BIG)
+          CudaDMAMeta::BufferLoader<BulkBuffer,0,1,DMA_PARTIAL_ITERS,
+            DMA_PARTIAL_ITERS,DMA_GLOBAL_LOAD,DMA_LOAD_QUAL>::load_all(bulk_buffer, src_ptr, intra_elmt_stride);
+        CudaDMAMeta::BufferStorer<BulkBuffer,PIPE_LOWER_LDS_BIG,1,PIPE_UPPER_LDS_BIG,
+          PIPE_UPPER_LDS_BIG,DMA_STORE_QUAL>::store_all(bulk_buffer, dst_ptr + upper_offset, intra_elmt_stride);
+        if (idx < (DMA_MAX_ITERS-1))
+        {
+          CudaDMAMeta::BufferLoader<BulkBuffer,PIPE_LOWER_LDS_BIG,1,PIPE_UPPER_LDS_BIG,
+            PIPE_UPPER_LDS_BIG,DMA_GLOBAL_LOAD,DMA_LOAD_QUAL>::load_all(bulk_buffer, src_ptr + upper_offset,
+                                                                         intra_elmt_stride);
+          src_ptr += ((BYTES_PER_THREAD/ALIGNMENT)*intra_elmt_stride);
+        }
+        dst_ptr += ((BYTES_PER_THREAD/ALIGNMENT)*intra_elmt_stride);
+      }
+      if (DMA_PARTIAL_ITERS > PIPE_LOWER_LDS_BIG)
+        CudaDMAMeta::BufferLoader<BulkBuffer,0,1,DMA_PARTIAL_ITERS,
+          DMA_PARTIAL_ITERS,DMA_GLOBAL_LOAD,DMA_LOAD_QUAL>::load_all(bulk_buffer, src_ptr, intra_elmt_stride);
       src_ptr += (DMA_PARTIAL_ITERS * intra_elmt_stride);
       CudaDMAMeta::BufferStorer<BulkBuffer,0,1,DMA_PARTIAL_ITERS,
         DMA_PARTIAL_ITERS,DMA_STORE_QUAL>::store_all(bulk_buffer, dst_ptr, intra_elmt_stride);
       dst_ptr += (DMA_PARTIAL_ITERS * intra_elmt_stride);
     }
+    else
+    {
+      for (int idx = 0; idx < DMA_MAX_ITERS; idx++)
+      {
+        CudaDMAMeta::BufferLoader<BulkBuffer,0,1,BYTES_PER_THREAD/ALIGNMENT,
+          BYTES_PER_THREAD/ALIGNMENT,DMA_GLOBAL_LOAD,DMA_LOAD_QUAL>::load_all(bulk_buffer, src_ptr, intra_elmt_stride);
+        src_ptr += ((BYTES_PER_THREAD/ALIGNMENT)*intra_elmt_stride);
+        CudaDMAMeta::BufferStorer<BulkBuffer,0,1,BYTES_PER_THREAD/ALIGNMENT,
+          BYTES_PER_THREAD/ALIGNMENT,DMA_STORE_QUAL>::store_all(bulk_buffer, dst_ptr, intra_elmt_stride);
+        dst_ptr += ((BYTES_PER_THREAD/ALIGNMENT)*intra_elmt_stride);
+      }
+      if (DMA_PARTIAL_ITERS > 0)
+      {
+        CudaDMAMeta::BufferLoader<BulkBuffer,0,1,DMA_PARTIAL_ITERS,
+          DMA_PARTIAL_ITERS,DMA_GLOBAL_LOAD,DMA_LOAD_QUAL>::load_all(bulk_buffer, src_ptr, intra_elmt_stride);
+        src_ptr += (DMA_PARTIAL_ITERS * intra_elmt_stride);
+        CudaDMAMeta::BufferStorer<BulkBuffer,0,1,DMA_PARTIAL_ITERS,
+          DMA_PARTIAL_ITERS,DMA_STORE_QUAL>::store_all(bulk_buffer, dst_ptr, intra_elmt_stride);
+        dst_ptr += (DMA_PARTIAL_ITERS * intra_elmt_stride);
+      }
+    }
     if (DMA_PARTIAL_BYTES)
     {
       switch (partial_bytes)
@@ -9105,6 +10249,7 @@ private:
 template<int BYTES_PER_THREAD, int BYTES_PER_ELMT, int DMA_THREADS, int NUM_ELMTS>
 class CudaDMAStrided<false,ALIGNMENT,BYTES_PER_THREAD,BYTES_PER_ELMT,DMA_THREADS,NUM_ELMTS> : public CudaDMA {
 public:
+  typedef CudaDMAStridedPlan<ALIGNMENT,BYTES_PER_THREAD,BYTES_PER_ELMT,DMA_THREADS,NUM_ELMTS> Plan;
 #define dma_threadIdx_start 0
   __device__ CudaDMAStrided(const int elmt_stride)
     : CudaDMA(0, DMA_THREADS, DMA_THREADS, dma_threadIdx_start),
@@ -9155,24 +10300,64 @@ private:
   __device__ __forceinline__ void perform_copy_elmt(const char *RESTRICT src_ptr, char *RESTRICT dst_ptr, 
                                                     const int intra_elmt_stride, const int partial_bytes)
   {
-    for (int idx = 0; idx < DMA_MAX_ITERS; idx++)
+    if (PIPE_STEPS_BIG(DMA_MAX_ITERS,DMA_PARTIAL_ITERS))
     {
+      // Refill each half with the next step of the element as soon as it
+      // is stored so the loads of the other half stay outstanding meanwhile
+      const int upper_offset = PIPE_LOWER_LDS_BIG*intra_elmt_stride;
       CudaDMAMeta::BufferLoader<BulkBuffer,0,1,BYTES_PER_THREAD/ALIGNMENT,
         BYTES_PER_THREAD/ALIGNMENT,DMA_GLOBAL_LOAD,DMA_LOAD_QUAL>::load_all(bulk_buffer, src_ptr, intra_elmt_stride);
       src_ptr += ((BYTES_PER_THREAD/ALIGNMENT)*intra_elmt_stride);
-      CudaDMAMeta::BufferStorer<BulkBuffer,0,1,BYTES_PER_THREAD/ALIGNMENT,
-        BYTES_PER_THREAD/ALIGNMENT,DMA_STORE_QUAL>::store_all(bulk_buffer, dst_ptr, intra_elmt_stride);
-      dst_ptr += ((BYTES_PER_THREAD/ALIGNMENT)*intra_elmt_stride);
-    }
-    if (DMA_PARTIAL_ITERS > 0)
-    {
-      CudaDMAMeta::BufferLoader<BulkBuffer,0,1,DMA_PARTIAL_ITERS,
-        DMA_PARTIAL_ITERS,DMA_GLOBAL_LOAD,DMA_LOAD_QUAL>::load_all(bulk_buffer, src_ptr, intra_elmt_stride);
+      for (int idx = 0; idx < DMA_MAX_ITERS; idx++)
+      {
+        CudaDMAMeta::BufferStorer<BulkBuffer,0,1,PIPE_LOWER_LDS_BIG,
+          PIPE_LOWER_LDS_BIG,DMA_STORE_QUAL>::store_all(bulk_buffer, dst_ptr, intra_elmt_stride);
+        if (idx < (DMA_MAX_ITERS-1))
+          CudaDMAMeta::BufferLoader<BulkBuffer,0,1,PIPE_LOWER_LDS_BIG,
+            PIPE_LOWER_LDS_BIG,DMA_GLOBAL_LOAD,DMA_LOAD_QUAL>::load_all(bulk_buffer, src_ptr, intra_elmt_stride);
+        else if (DMA_PARTIAL_ITERS <= PIPE_LOWER_LDS_BIG)
+          CudaDMAMeta::BufferLoader<BulkBuffer,0,1,DMA_PARTIAL_ITERS,
+            DMA_PARTIAL_ITERS,DMA_GLOBAL_LOAD,DMA_LOAD_QUAL>::load_all(bulk_buffer, src_ptr, intra_elmt_stride);
+        CudaDMAMeta::BufferStorer<BulkBuffer,PIPE_LOWER_LDS_BIG,1,PIPE_UPPER_LDS_BIG,
+          PIPE_UPPER_LDS_BIG,DMA_STORE_QUAL>::store_all(bulk_buffer, dst_ptr + upper_offset, intra_elmt_stride);
+        if (idx < (DMA_MAX_ITERS-1))
+        {
+          CudaDMAMeta::BufferLoader<BulkBuffer,PIPE_LOWER_LDS_BIG,1,PIPE_UPPER_LDS_BIG,
+            PIPE_UPPER_LDS_BIG,DMA_GLOBAL_LOAD,DMA_LOAD_QUAL>::load_all(bulk_buffer, src_ptr + upper_offset,
+                                                                         intra_elmt_stride);
+          src_ptr += ((BYTES_PER_THREAD/ALIGNMENT)*intra_elmt_stride);
+        }
+        dst_ptr += ((BYTES_PER_THREAD/ALIGNMENT)*intra_elmt_stride);
+      }
+      if (DMA_PARTIAL_ITERS > PIPE_LOWER_LDS_BIG)
+        CudaDMAMeta::BufferLoader<BulkBuffer,0,1,DMA_PARTIAL_ITERS,
+          DMA_PARTIAL_ITERS,DMA_GLOBAL_LOAD,DMA_LOAD_QUAL>::load_all(bulk_buffer, src_ptr, intra_elmt_stride);
       src_ptr += (DMA_PARTIAL_ITERS * intra_elmt_stride);
       CudaDMAMeta::BufferStorer<BulkBuffer,0,1,DMA_PARTIAL_ITERS,
         DMA_PARTIAL_ITERS,DMA_STORE_QUAL>::store_all(bulk_buffer, dst_ptr, intra_elmt_stride);
       dst_ptr += (DMA_PARTIAL_ITERS * intra_elmt_stride);
     }
+    else
+    {
+      for (int idx = 0; idx < DMA_MAX_ITERS; idx++)
+      {
+        CudaDMAMeta::BufferLoader<BulkBuffer,0,1,BYTES_PER_THREAD/ALIGNMENT,
+          BYTES_PER_THREAD/ALIGNMENT,DMA_GLOBAL_LOAD,DMA_LOAD_QUAL>::load_all(bulk_buffer, src_ptr, intra_elmt_stride);
+        src_ptr += ((BYTES_PER_THREAD/ALIGNMENT)*intra_elmt_stride);
+        CudaDMAMeta::BufferStorer<BulkBuffer,0,1,BYTES_PER_THREAD/ALIGNMENT,
+          BYTES_PER_THREAD/ALIGNMENT,DMA_STORE_QUAL>::store_all(bulk_buffer, dst_ptr, intra_elmt_stride);
+        dst_ptr += ((BYTES_PER_THREAD/ALIGNMENT)*intra_elmt_stride);
+      }
+      if (DMA_PARTIAL_ITERS > 0)
+      {
+        CudaDMAMeta::BufferLoader<BulkBuffer,0,1,DMA_PARTIAL_ITERS,
+          DMA_PARTIAL_ITERS,DMA_GLOBAL_LOAD,DMA_LOAD_QUAL>::load_all(bulk_buffer, src_ptr, intra_elmt_stride);
+        src_ptr += (DMA_PARTIAL_ITERS * intra_elmt_stride);
+        CudaDMAMeta::BufferStorer<BulkBuffer,0,1,DMA_PARTIAL_ITERS,
+          DMA_PARTIAL_ITERS,DMA_STORE_QUAL>::store_all(bulk_buffer, dst_ptr, intra_elmt_stride);
+        dst_ptr += (DMA_PARTIAL_ITERS * intra_elmt_stride);
+      }
+    }
     if (DMA_PARTIAL_BYTES)
     {
       switch (partial_bytes)
@@ -9227,6 +10412,7 @@ private:
 template<int BYTES_PER_THREAD, int BYTES_PER_ELMT, int DMA_THREADS, int NUM_ELMTS>
 class CudaDMAStrided<false,ALIGNMENT,BYTES_PER_THREAD,BYTES_PER_ELMT,DMA_THREADS,NUM_ELMTS> : public CudaDMA {
 public:
+  typedef CudaDMAStridedPlan<ALIGNMENT,BYTES_PER_THREAD,BYTES_PER_ELMT,DMA_THREADS,NUM_ELMTS> Plan;
 #define dma_threadIdx_start 0
   __device__ CudaDMAStrided(const int elmt_stride)
     : CudaDMA(0, DMA_THREADS, DMA_THREADS, dma_threadIdx_start),
@@ -9277,24 +10463,64 @@ private:
   __device__ __forceinline__ void perform_copy_elmt(const char *RESTRICT src_ptr, char *RESTRICT dst_ptr, 
                                                     const int intra_elmt_stride, const int partial_bytes)
   {
-    for (int idx = 0; idx < DMA_MAX_ITERS; idx++)
+    if (PIPE_STEPS_BIG(DMA_MAX_ITERS,DMA_PARTIAL_ITERS))
     {
+      // Refill each half with the next step of the element as soon as it
+      // is stored so the loads of the other half stay outstanding meanwhile
+      const int upper_offset = PIPE_LOWER_LDS_BIG*intra_elmt_stride;
       CudaDMAMeta::BufferLoader<BulkBuffer,0,1,BYTES_PER_THREAD/ALIGNMENT,
         BYTES_PER_THREAD/ALIGNMENT,DMA_GLOBAL_LOAD,DMA_LOAD_QUAL>::load_all(bulk_buffer, src_ptr, intra_elmt_stride);
       src_ptr += ((BYTES_PER_THREAD/ALIGNMENT)*intra_elmt_stride);
-      CudaDMAMeta::BufferStorer<BulkBuffer,0,1,BYTES_PER_THREAD/ALIGNMENT,
-        BYTES_PER_THREAD/ALIGNMENT,DMA_STORE_QUAL>::store_all(bulk_buffer, dst_ptr, intra_elmt_stride);
-      dst_ptr += ((BYTES_PER_THREAD/ALIGNMENT)*intra_elmt_stride);
-    }
-    if (DMA_PARTIAL_ITERS > 0)
-    {
-      CudaDMAMeta::BufferLoader<BulkBuffer,0,1,DMA_PARTIAL_ITERS,
-        DMA_PARTIAL_ITERS,DMA_GLOBAL_LOAD,DMA_LOAD_QUAL>::load_all(bulk_buffer, src_ptr, intra_elmt_stride);
+      for (int idx = 0; idx < DMA_MAX_ITERS; idx++)
+      {
+        CudaDMAMeta::BufferStorer<BulkBuffer,0,1,PIPE_LOWER_LDS_BIG,
+          PIPE_LOWER_LDS_BIG,DMA_STORE_QUAL>::store_all(bulk_buffer, dst_ptr, intra_elmt_stride);
+        if (idx < (DMA_MAX_ITERS-1))
+          CudaDMAMeta::BufferLoader<BulkBuffer,0,1,PIPE_LOWER_LDS_BIG,
+            PIPE_LOWER_LDS_BIG,DMA_GLOBAL_LOAD,DMA_LOAD_QUAL>::load_all(bulk_buffer, src_ptr, intra_elmt_stride);
+        else if (DMA_PARTIAL_ITERS <= PIPE_LOWER_LDS_BIG)
+          CudaDMAMeta::BufferLoader<BulkBuffer,0,1,DMA_PARTIAL_ITERS,
+            DMA_PARTIAL_ITERS,DMA_GLOBAL_LOAD,DMA_LOAD_QUAL>::load_all(bulk_buffer, src_ptr, intra_elmt_stride);
+        CudaDMAMeta::BufferStorer<BulkBuffer,PIPE_LOWER_LDS_BIG,1,PIPE_UPPER_LDS_BIG,
+          PIPE_UPPER_LDS_BIG,DMA_STORE_QUAL>::store_all(bulk_buffer, dst_ptr + upper_offset, intra_elmt_stride);
+        if (idx < (DMA_MAX_ITERS-1))
+        {
+          CudaDMAMeta::BufferLoader<BulkBuffer,PIPE_LOWER_LDS_BIG,1,PIPE_UPPER_LDS_BIG,
+            PIPE_UPPER_LDS_BIG,DMA_GLOBAL_LOAD,DMA_LOAD_QUAL>::load_all(bulk_buffer, src_ptr + upper_offset,
+                                                                         intra_elmt_stride);
+          src_ptr += ((BYTES_PER_THREAD/ALIGNMENT)*intra_elmt_stride);
+        }
+        dst_ptr += ((BYTES_PER_THREAD/ALIGNMENT)*intra_elmt_stride);
+      }
+      if (DMA_PARTIAL_ITERS > PIPE_LOWER_LDS_BIG)
+        CudaDMAMeta::BufferLoader<BulkBuffer,0,1,DMA_PARTIAL_ITERS,
+          DMA_PARTIAL_ITERS,DMA_GLOBAL_LOAD,DMA_LOAD_QUAL>::load_all(bulk_buffer, src_ptr, intra_elmt_stride);
       src_ptr += (DMA_PARTIAL_ITERS * intra_elmt_stride);
       CudaDMAMeta::BufferStorer<BulkBuffer,0,1,DMA_PARTIAL_ITERS,
         DMA_PARTIAL_ITERS,DMA_STORE_QUAL>::store_all(bulk_buffer, dst_ptr, intra_elmt_stride);
       dst_ptr += (DMA_PARTIAL_ITERS * intra_elmt_stride);
     }
+    else
+    {
+      for (int idx = 0; idx < DMA_MAX_ITERS; idx++)
+      {
+        CudaDMAMeta::BufferLoader<BulkBuffer,0,1,BYTES_PER_THREAD/ALIGNMENT,
+          BYTES_PER_THREAD/ALIGNMENT,DMA_GLOBAL_LOAD,DMA_LOAD_QUAL>::load_all(bulk_buffer, src_ptr, intra_elmt_stride);
+        src_ptr += ((BYTES_PER_THREAD/ALIGNMENT)*intra_elmt_stride);
+        CudaDMAMeta::BufferStorer<BulkBuffer,0,1,BYTES_PER_THREAD/ALIGNMENT,
+          BYTES_PER_THREAD/ALIGNMENT,DMA_STORE_QUAL>::store_all(bulk_buffer, dst_ptr, intra_elmt_stride);
+        dst_ptr += ((BYTES_PER_THREAD/ALIGNMENT)*intra_elmt_stride);
+      }
+      if (DMA_PARTIAL_ITERS > 0)
+      {
+        CudaDMAMeta::BufferLoader<BulkBuffer,0,1,DMA_PARTIAL_ITERS,
+          DMA_PARTIAL_ITERS,DMA_GLOBAL_LOAD,DMA_LOAD_QUAL>::load_all(bulk_buffer, src_ptr, intra_elmt_stride);
+        src_ptr += (DMA_PARTIAL_ITERS * intra_elmt_stride);
+        CudaDMAMeta::BufferStorer<BulkBuffer,0,1,DMA_PARTIAL_ITERS,
+          DMA_PARTIAL_ITERS,DMA_STORE_QUAL>::store_all(bulk_buffer, dst_ptr, intra_elmt_stride);
+        dst_ptr += (DMA_PARTIAL_ITERS * intra_elmt_stride);
+      }
+    }
     if (DMA_PARTIAL_BYTES)
     {
       switch (partial_bytes)
@@ -9376,10 +10602,15 @@ private:
  * The only real difference is the level of indirection needed when computing
  * the offset for either loading or storing depending on whether this instance
  * is peforming a gather or a scatter.
+ *
+ * INDEX_TYPE is the type of the entries of the index list: unsigned short to
+ * halve the index traffic for small tables, int, or unsigned int and 64-bit
+ * types for tables with more than 2^31 elements or bytes.  Byte offsets are
+ * computed with the width given by CudaDMAMeta::IndexType.
  */
 
 template<bool GATHER=true, bool DO_SYNC=false, int ALIGNMENT=0, int BYTES_PER_THREAD=4*ALIGNMENT, 
-         int BYTES_PER_ELMT=0, int DMA_THREADS=0, int NUM_ELMTS=0>
+         int BYTES_PER_ELMT=0, int DMA_THREADS=0, int NUM_ELMTS=0, typename INDEX_TYPE=int>
 class CudaDMAIndirect : public CudaDMA {
 public:
   __device__ CudaDMAIndirect(const int dmaID,
@@ -9404,6 +10635,7 @@ public:
 #define INIT_INDIRECT_ELMT_STRIDE(_stride) (GATHER ? INIT_DST_ELMT_STRIDE(_stride) :  \
                                                      INIT_SRC_ELMT_STRIDE(_stride))
 #define SELECT_STRIDE(_stride)  ((_stride > BYTES_PER_ELMT) ? _stride : BYTES_PER_ELMT)
+#define INDEX_OFFSET_TYPE typename CudaDMAMeta::IndexType<INDEX_TYPE>::offset_type
 
 // Switch back to the old way of allocating warps to threads for when we don't know
 // the number of elements at compile time.  We'll reverse this again for the four template
@@ -9414,13 +10646,13 @@ public:
 #define WARPS_PER_ELMT (BIG_ELMTS ? NUM_WARPS : \
                         (MINIMUM_COVER > 0) ? MINIMUM_COVER : 1)
 
-template<bool GATHER, bool DO_SYNC>
-class CudaDMAIndirect<GATHER,DO_SYNC,0,0,0,0,0> {
+template<bool GATHER, bool DO_SYNC, typename INDEX_TYPE>
+class CudaDMAIndirect<GATHER,DO_SYNC,0,0,0,0,0,INDEX_TYPE> {
 public:
   __host__
   static void diagnose(const int ALIGNMENT, const int BYTES_PER_THREAD, const int BYTES_PER_ELMT,
                        const int DMA_THREADS, const int NUM_ELMTS, const bool FULL_TEMPLATE, 
-                       const bool verbose = false)
+                       const bool verbose = false, const int register_budget = 0)
   {
 #define PRINT_VAR(var_name) printf(#var_name " %d\n", (var_name))
     fprintf(stdout,"********************************************************************\n");
@@ -9487,6 +10719,8 @@ public:
           fprintf(stdout,"    - Increase element size thereby loading superflous data with the benefit\n");
           fprintf(stdout,"          of improving guaranteed alignment of pointers\n");
         }
+        if (FULL_TEMPLATE && PIPE_STEPS_BIG(MAX_ITERS_BIG,PART_ITERS_BIG))
+          fprintf(stdout,"  NOTE: the steps of each element are pipelined over the two halves of the buffer.\n");
         if (verbose)
         {
           PRINT_VAR(HAS_PARTIAL_ELMTS_BIG);
@@ -9614,6 +10848,8 @@ public:
           fprintf(stdout,"    - Increase element size thereby loading superflous data with the benefit\n");
           fprintf(stdout,"          of improving guaranteed alignment of pointers\n");
         }
+        if (FULL_TEMPLATE && PIPE_STEPS_BIG(MAX_ITERS_BIG,PART_ITERS_BIG))
+          fprintf(stdout,"  NOTE: the steps of each element are pipelined over the two halves of the buffer.\n");
         if (verbose)
         {
           PRINT_VAR(HAS_PARTIAL_ELMTS_BIG);
@@ -9691,41 +10927,80 @@ public:
 #define WARPS_PER_ELMT (BIG_ELMTS ? NUM_WARPS : \
                         (MINIMUM_COVER > 0) ? MINIMUM_COVER : 1)
     }
+    if (register_budget > 0)
+      cudaDMA_check_register_budget(analyze(ALIGNMENT, BYTES_PER_THREAD, BYTES_PER_ELMT,
+                                            DMA_THREADS, NUM_ELMTS, FULL_TEMPLATE),
+                                    register_budget, stdout);
     fprintf(stdout,"\n\n");
     fflush(stdout);
 #undef PRINT_VAR
   }
+  // Same analysis as diagnose, but returned as a CudaDMADiagnosis
+  // (see cudaDMA_print_diagnosis_json) instead of being printed
+  __host__
+  static CudaDMADiagnosis analyze(const int ALIGNMENT, const int BYTES_PER_THREAD, const int BYTES_PER_ELMT,
+                                  const int DMA_THREADS, const int NUM_ELMTS, const bool FULL_TEMPLATE)
+  {
+    CudaDMADiagnosis diag;
+    diag.pattern = "CudaDMAIndirect";
+    if (!FULL_TEMPLATE)
+    {
+      STRIDED_ANALYZE_IMPL(diag,CudaDMARegisterCost::indirect)
+    }
+    else
+    {
+#undef MINIMUM_COVER
+#undef WARPS_PER_ELMT
+#define MINIMUM_COVER ((LDS_PER_ELMT+(WARP_SIZE*MAX_LDS_PER_THREAD)-1)/(WARP_SIZE*MAX_LDS_PER_THREAD))
+#define WARPS_PER_ELMT (SINGLE_WARP ? 1 : \
+                        BIG_ELMTS ? NUM_WARPS : \
+                        ((NUM_WARPS/MINIMUM_COVER) <= NUM_ELMTS) ? MINIMUM_COVER : \
+                        ((MAX_WARPS_PER_ELMT >= NUM_WARPS) ? NUM_WARPS : MAX_WARPS_PER_ELMT))
+      STRIDED_ANALYZE_IMPL(diag,CudaDMARegisterCost::indirect)
+#undef MINIMUM_COVER
+#undef WARPS_PER_ELMT
+#define MINIMUM_COVER ((LDS_PER_ELMT+(WARP_SIZE*MAX_LDS_PER_THREAD)-1)/(WARP_SIZE*MAX_LDS_PER_THREAD))
+#define WARPS_PER_ELMT (BIG_ELMTS ? NUM_WARPS : \
+                        (MINIMUM_COVER > 0) ? MINIMUM_COVER : 1)
+    }
+    return diag;
+  }
 };
 
 #define WARP_SPECIALIZED_UNQUALIFIED_METHODS                                                        \
-  __device__ __forceinline__ void execute_dma(const int *RESTRICT index_ptr,                        \
+  __device__ __forceinline__ void execute_dma(const INDEX_TYPE *RESTRICT index_ptr,                 \
                         const void *RESTRICT src_ptr, void *RESTRICT dst_ptr)                       \
   {                                                                                                 \
     start_xfer_async(index_ptr, src_ptr);                                                           \
     wait_xfer_finish(dst_ptr);                                                                      \
   }                                                                                                 \
-  __device__ __forceinline__ void start_xfer_async(const int *RESTRICT index_ptr,                   \
+  __device__ __forceinline__ void start_xfer_async(const INDEX_TYPE *RESTRICT index_ptr,            \
                                                    const void *RESTRICT src_ptr)                    \
   {                                                                                                 \
     INDIRECT_START_XFER_IMPL(false,LOAD_CACHE_ALL,STORE_WRITE_BACK)                                 \
   }                                                                                                 \
   __device__ __forceinline__ void wait_xfer_finish(void *RESTRICT dst_ptr)                          \
   {                                                                                                 \
-    CudaDMA::template wait_for_dma_start();                                                         \
+    CudaDMA::wait_for_dma_start();                                                                  \
     INDIRECT_WAIT_XFER_IMPL(false,LOAD_CACHE_ALL,STORE_WRITE_BACK)                                  \
-    CudaDMA::template finish_async_dma();                                                           \
+    CudaDMA::finish_async_dma();                                                                    \
+  }                                                                                                 \
+  __device__ __forceinline__ void prefetch(const INDEX_TYPE *RESTRICT index_ptr,                    \
+                                           const void *RESTRICT xfer_ptr) const                     \
+  {                                                                                                 \
+    prefetch<false>(index_ptr, xfer_ptr);                                                           \
   }
 
 #define WARP_SPECIALIZED_QUALIFIED_METHODS                                                          \
   template<bool DMA_GLOBAL_LOAD>                                                                    \
-  __device__ __forceinline__ void execute_dma(const int *RESTRICT index_ptr,                        \
+  __device__ __forceinline__ void execute_dma(const INDEX_TYPE *RESTRICT index_ptr,                 \
                         const void *RESTRICT src_ptr, void *RESTRICT dst_ptr)                       \
   {                                                                                                 \
     start_xfer_async<DMA_GLOBAL_LOAD>(index_ptr, src_ptr);                                          \
     wait_xfer_finish<DMA_GLOBAL_LOAD>(dst_ptr);                                                     \
   }                                                                                                 \
   template<bool DMA_GLOBAL_LOAD>                                                                    \
-  __device__ __forceinline__ void start_xfer_async(const int *RESTRICT index_ptr,                   \
+  __device__ __forceinline__ void start_xfer_async(const INDEX_TYPE *RESTRICT index_ptr,            \
                                                    const void *RESTRICT src_ptr)                    \
   {                                                                                                 \
     INDIRECT_START_XFER_IMPL(DMA_GLOBAL_LOAD,LOAD_CACHE_ALL,STORE_WRITE_BACK)                       \
@@ -9733,19 +11008,19 @@ public:
   template<bool DMA_GLOBAL_LOAD>                                                                    \
   __device__ __forceinline__ void wait_xfer_finish(void *RESTRICT dst_ptr)                          \
   {                                                                                                 \
-    CudaDMA::template wait_for_dma_start();                                                         \
+    CudaDMA::wait_for_dma_start();                                                                  \
     INDIRECT_WAIT_XFER_IMPL(DMA_GLOBAL_LOAD,LOAD_CACHE_ALL,STORE_WRITE_BACK)                        \
-    CudaDMA::template finish_async_dma();                                                           \
+    CudaDMA::finish_async_dma();                                                                    \
   }                                                                                                 \
   template<bool DMA_GLOBAL_LOAD, int DMA_LOAD_QUAL, int DMA_STORE_QUAL>                             \
-  __device__ __forceinline__ void execute_dma(const int *RESTRICT index_ptr,                        \
+  __device__ __forceinline__ void execute_dma(const INDEX_TYPE *RESTRICT index_ptr,                 \
                         const void *RESTRICT src_ptr, void *RESTRICT dst_ptr)                       \
   {                                                                                                 \
     start_xfer_async<DMA_GLOBAL_LOAD,DMA_LOAD_QUAL,DMA_STORE_QUAL>(index_ptr, src_ptr);             \
     wait_xfer_finish<DMA_GLOBAL_LOAD,DMA_LOAD_QUAL,DMA_STORE_QUAL>(dst_ptr);                        \
   }                                                                                                 \
   template<bool DMA_GLOBAL_LOAD, int DMA_LOAD_QUAL, int DMA_STORE_QUAL>                             \
-  __device__ __forceinline__ void start_xfer_async(const int *RESTRICT index_ptr,                   \
+  __device__ __forceinline__ void start_xfer_async(const INDEX_TYPE *RESTRICT index_ptr,            \
                                                    const void *RESTRICT src_ptr)                    \
   {                                                                                                 \
     INDIRECT_START_XFER_IMPL(DMA_GLOBAL_LOAD,DMA_LOAD_QUAL,DMA_STORE_QUAL)                          \
@@ -9753,19 +11028,45 @@ public:
   template<bool DMA_GLOBAL_LOAD, int DMA_LOAD_QUAL, int DMA_STORE_QUAL>                             \
   __device__ __forceinline__ void wait_xfer_finish(void *RESTRICT dst_ptr)                          \
   {                                                                                                 \
-    CudaDMA::template wait_for_dma_start();                                                         \
+    CudaDMA::wait_for_dma_start();                                                                  \
     INDIRECT_WAIT_XFER_IMPL(DMA_GLOBAL_LOAD,DMA_LOAD_QUAL,DMA_STORE_QUAL)                           \
-    CudaDMA::template finish_async_dma();                                                           \
+    CudaDMA::finish_async_dma();                                                                    \
+  }                                                                                                 \
+  template<bool DMA_GLOBAL_LOAD>                                                                    \
+  __device__ __forceinline__ void prefetch(const INDEX_TYPE *RESTRICT index_ptr,                    \
+                                           const void *RESTRICT xfer_ptr) const                     \
+  {                                                                                                 \
+    /* Walk the transfer on a copy so that a transfer in flight is untouched */                     \
+    CudaDMAMeta::copy_of(*this).template prefetch_xfer<DMA_GLOBAL_LOAD>(index_ptr, xfer_ptr);       \
+  }                                                                                                 \
+private:                                                                                            \
+  template<bool DMA_GLOBAL_LOAD>                                                                    \
+  __device__ __forceinline__ void prefetch_xfer(const INDEX_TYPE *RESTRICT index_ptr,               \
+                                                const void *RESTRICT xfer_ptr)                      \
+  {                                                                                                 \
+    /* A gather prefetches its source, a scatter its indexed destination */                         \
+    const void *const src_ptr = GATHER ? xfer_ptr : NULL;                                           \
+    void *const dst_ptr = GATHER ? NULL : const_cast<void*>(xfer_ptr);                              \
+    if (GATHER)                                                                                     \
+    {                                                                                               \
+      INDIRECT_START_XFER_IMPL(DMA_GLOBAL_LOAD,LOAD_PREFETCH_L2,CUDADMA_STORE_DISCARD)              \
+      INDIRECT_WAIT_XFER_IMPL(DMA_GLOBAL_LOAD,LOAD_PREFETCH_L2,CUDADMA_STORE_DISCARD)               \
+    }                                                                                               \
+    else                                                                                            \
+    {                                                                                               \
+      INDIRECT_START_XFER_IMPL(DMA_GLOBAL_LOAD,LOAD_DISCARD,CUDADMA_STORE_PREFETCH_L2)              \
+      INDIRECT_WAIT_XFER_IMPL(DMA_GLOBAL_LOAD,LOAD_DISCARD,CUDADMA_STORE_PREFETCH_L2)               \
+    }                                                                                               \
   }
 
 #define NON_WARP_SPECIALIZED_UNQUALIFIED_METHODS                                                    \
-  __device__ __forceinline__ void execute_dma(const int *RESTRICT index_ptr,                        \
+  __device__ __forceinline__ void execute_dma(const INDEX_TYPE *RESTRICT index_ptr,                 \
                         const void *RESTRICT src_ptr, void *RESTRICT dst_ptr)                       \
   {                                                                                                 \
     start_xfer_async(index_ptr, src_ptr);                                                           \
     wait_xfer_finish(dst_ptr);                                                                      \
   }                                                                                                 \
-  __device__ __forceinline__ void start_xfer_async(const int *RESTRICT index_ptr,                   \
+  __device__ __forceinline__ void start_xfer_async(const INDEX_TYPE *RESTRICT index_ptr,            \
                                                    const void *RESTRICT src_ptr)                    \
   {                                                                                                 \
     INDIRECT_START_XFER_IMPL(false,LOAD_CACHE_ALL,STORE_WRITE_BACK)                                 \
@@ -9773,18 +11074,23 @@ public:
   __device__ __forceinline__ void wait_xfer_finish(void *RESTRICT dst_ptr)                          \
   {                                                                                                 \
     INDIRECT_WAIT_XFER_IMPL(false,LOAD_CACHE_ALL,STORE_WRITE_BACK)                                  \
+  }                                                                                                 \
+  __device__ __forceinline__ void prefetch(const INDEX_TYPE *RESTRICT index_ptr,                    \
+                                           const void *RESTRICT xfer_ptr) const                     \
+  {                                                                                                 \
+    prefetch<false>(index_ptr, xfer_ptr);                                                           \
   }
 
 #define NON_WARP_SPECIALIZED_QUALIFIED_METHODS                                                      \
   template<bool DMA_GLOBAL_LOAD>                                                                    \
-  __device__ __forceinline__ void execute_dma(const void *RESTRICT index_ptr,                       \
+  __device__ __forceinline__ void execute_dma(const INDEX_TYPE *RESTRICT index_ptr,                 \
                           const void *RESTRICT src_ptr, void *RESTRICT dst_ptr)                     \
   {                                                                                                 \
     start_xfer_async<DMA_GLOBAL_LOAD>(index_ptr, src_ptr);                                          \
     wait_xfer_finish<DMA_GLOBAL_LOAD>(dst_ptr);                                                     \
   }                                                                                                 \
   template<bool DMA_GLOBAL_LOAD>                                                                    \
-  __device__ __forceinline__ void start_xfer_async(const int *RESTRICT index_ptr,                   \
+  __device__ __forceinline__ void start_xfer_async(const INDEX_TYPE *RESTRICT index_ptr,            \
                                                    const void *RESTRICT src_ptr)                    \
   {                                                                                                 \
     INDIRECT_START_XFER_IMPL(DMA_GLOBAL_LOAD,LOAD_CACHE_ALL,STORE_WRITE_BACK)                       \
@@ -9795,14 +11101,14 @@ public:
     INDIRECT_WAIT_XFER_IMPL(DMA_GLOBAL_LOAD,LOAD_CACHE_ALL,STORE_WRITE_BACK)                        \
   }                                                                                                 \
   template<bool DMA_GLOBAL_LOAD, int DMA_LOAD_QUAL, int DMA_STORE_QUAL>                             \
-  __device__ __forceinline__ void execute_dma(const int *RESTRICT index_ptr,                        \
+  __device__ __forceinline__ void execute_dma(const INDEX_TYPE *RESTRICT index_ptr,                 \
                         const void *RESTRICT src_ptr, void *RESTRICT dst_ptr)                       \
   {                                                                                                 \
     start_xfer_async<DMA_GLOBAL_LOAD,DMA_LOAD_QUAL,DMA_STORE_QUAL>(index_ptr, src_ptr);             \
     wait_xfer_finish<DMA_GLOBAL_LOAD,DMA_LOAD_QUAL,DMA_STORE_QUAL>(dst_ptr);                        \
   }                                                                                                 \
   template<bool DMA_GLOBAL_LOAD, int DMA_LOAD_QUAL, int DMA_STORE_QUAL>                             \
-  __device__ __forceinline__ void start_xfer_async(const int *RESTRICT index_ptr,                   \
+  __device__ __forceinline__ void start_xfer_async(const INDEX_TYPE *RESTRICT index_ptr,            \
                                                    const void *RESTRICT src_ptr)                    \
   {                                                                                                 \
     INDIRECT_START_XFER_IMPL(DMA_GLOBAL_LOAD,DMA_LOAD_QUAL,DMA_STORE_QUAL)                          \
@@ -9811,6 +11117,32 @@ public:
   __device__ __forceinline__ void wait_xfer_finish(void *RESTRICT dst_ptr)                          \
   {                                                                                                 \
     INDIRECT_WAIT_XFER_IMPL(DMA_GLOBAL_LOAD,DMA_LOAD_QUAL,DMA_STORE_QUAL)                           \
+  }                                                                                                 \
+  template<bool DMA_GLOBAL_LOAD>                                                                    \
+  __device__ __forceinline__ void prefetch(const INDEX_TYPE *RESTRICT index_ptr,                    \
+                                           const void *RESTRICT xfer_ptr) const                     \
+  {                                                                                                 \
+    /* Walk the transfer on a copy so that a transfer in flight is untouched */                     \
+    CudaDMAMeta::copy_of(*this).template prefetch_xfer<DMA_GLOBAL_LOAD>(index_ptr, xfer_ptr);       \
+  }                                                                                                 \
+private:                                                                                            \
+  template<bool DMA_GLOBAL_LOAD>                                                                    \
+  __device__ __forceinline__ void prefetch_xfer(const INDEX_TYPE *RESTRICT index_ptr,               \
+                                                const void *RESTRICT xfer_ptr)                      \
+  {                                                                                                 \
+    /* A gather prefetches its source, a scatter its indexed destination */                         \
+    const void *const src_ptr = GATHER ? xfer_ptr : NULL;                                           \
+    void *const dst_ptr = GATHER ? NULL : const_cast<void*>(xfer_ptr);                              \
+    if (GATHER)                                                                                     \
+    {                                                                                               \
+      INDIRECT_START_XFER_IMPL(DMA_GLOBAL_LOAD,LOAD_PREFETCH_L2,CUDADMA_STORE_DISCARD)              \
+      INDIRECT_WAIT_XFER_IMPL(DMA_GLOBAL_LOAD,LOAD_PREFETCH_L2,CUDADMA_STORE_DISCARD)               \
+    }                                                                                               \
+    else                                                                                            \
+    {                                                                                               \
+      INDIRECT_START_XFER_IMPL(DMA_GLOBAL_LOAD,LOAD_DISCARD,CUDADMA_STORE_PREFETCH_L2)              \
+      INDIRECT_WAIT_XFER_IMPL(DMA_GLOBAL_LOAD,LOAD_DISCARD,CUDADMA_STORE_PREFETCH_L2)               \
+    }                                                                                               \
   }
 
 // one template, warp-specialized
@@ -9830,7 +11162,7 @@ public:
 
 #define TEMPLATE_ONE_IMPL                                                                                   \
   template<bool DMA_GLOBAL_LOAD, int DMA_LOAD_QUAL>                                                         \
-  __device__ __forceinline__ void execute_start_xfer(const int *RESTRICT index_ptr,                         \
+  __device__ __forceinline__ void execute_start_xfer(const INDEX_TYPE *RESTRICT index_ptr,                  \
       const void *RESTRICT src_ptr, bool DMA_IS_SPLIT, bool DMA_IS_BIG,                                     \
       int DMA_STEP_ITERS_SPLIT, int DMA_ROW_ITERS_SPLIT, int DMA_COL_ITERS_SPLIT,                           \
       int DMA_STEP_ITERS_BIG, int DMA_MAX_ITERS_BIG, int DMA_PART_ITERS_BIG,                                \
@@ -9939,10 +11271,10 @@ public:
   {                                                                                                         \
     if (GATHER)                                                                                             \
     {                                                                                                       \
-      const int *index_ptr = this->dma_index_ptr + index_offset;                                            \
+      const INDEX_TYPE *index_ptr = this->dma_index_ptr + index_offset;                                     \
       for (int i = 0; i < DMA_ROW_ITERS; i++)                                                               \
       {                                                                                                     \
-        const int offset = index_ptr[i * this->dma_index_elmt_stride];                                      \
+        const INDEX_OFFSET_TYPE offset = index_ptr[i * this->dma_index_elmt_stride];                        \
         const char *temp_ptr = src_ptr + (offset * BYTES_PER_ELMT);                                         \
         for (int j = 0; j < DMA_COL_ITERS; j++)                                                             \
         {                                                                                                   \
@@ -10198,10 +11530,10 @@ public:
     }                                                                                                       \
     else                                                                                                    \
     {                                                                                                       \
-      const int *index_ptr = this->dma_index_ptr + index_offset;                                            \
+      const INDEX_TYPE *index_ptr = this->dma_index_ptr + index_offset;                                     \
       for (int i = 0; i < DMA_ROW_ITERS; i++)                                                               \
       {                                                                                                     \
-        const int offset = index_ptr[i * this->dma_index_elmt_stride];                                      \
+        const INDEX_OFFSET_TYPE offset = index_ptr[i * this->dma_index_elmt_stride];                        \
         char *temp_ptr = dst_ptr + (offset * BYTES_PER_ELMT);                                               \
         for (int j = 0; j < DMA_COL_ITERS; j++)                                                             \
         {                                                                                                   \
@@ -10219,8 +11551,8 @@ public:
 
 #define LOCAL_TYPENAME float
 #define ALIGNMENT 4
-template<bool GATHER, int BYTES_PER_THREAD>
-class CudaDMAIndirect<GATHER,true,ALIGNMENT,BYTES_PER_THREAD,0,0,0> : public CudaDMA {
+template<bool GATHER, int BYTES_PER_THREAD, typename INDEX_TYPE>
+class CudaDMAIndirect<GATHER,true,ALIGNMENT,BYTES_PER_THREAD,0,0,0,INDEX_TYPE> : public CudaDMA {
 public:
   __device__ CudaDMAIndirect(const int dmaID,
                              const int num_dma_threads,
@@ -10263,12 +11595,12 @@ private:
   {
     if (GATHER)
     {
-      const int offset = this->dma_index_ptr[index_offset];
+      const INDEX_OFFSET_TYPE offset = this->dma_index_ptr[index_offset];
       src_ptr += (offset * BYTES_PER_ELMT);
     }
     else
     {
-      const int offset = this->dma_index_ptr[index_offset];
+      const INDEX_OFFSET_TYPE offset = this->dma_index_ptr[index_offset];
       dst_ptr += (offset * BYTES_PER_ELMT);
     }
     for (int i = 0; i < DMA_MAX_ITERS; i++)
@@ -10321,7 +11653,7 @@ private:
   STORE_4_PARTIAL_BYTES_IMPL
 private:
   const char *dma_src_off_ptr;
-  const int *dma_index_ptr;
+  const INDEX_TYPE *dma_index_ptr;
   const unsigned int BYTES_PER_ELMT;
   const unsigned int DMA_THREADS;
   const unsigned int NUM_ELMTS;
@@ -10345,8 +11677,8 @@ private:
 
 #define LOCAL_TYPENAME float2
 #define ALIGNMENT 8
-template<bool GATHER, int BYTES_PER_THREAD>
-class CudaDMAIndirect<GATHER,true,ALIGNMENT,BYTES_PER_THREAD,0,0,0> : public CudaDMA {
+template<bool GATHER, int BYTES_PER_THREAD, typename INDEX_TYPE>
+class CudaDMAIndirect<GATHER,true,ALIGNMENT,BYTES_PER_THREAD,0,0,0,INDEX_TYPE> : public CudaDMA {
 public:
   __device__ CudaDMAIndirect(const int dmaID,
                              const int num_dma_threads,
@@ -10389,12 +11721,12 @@ private:
   {
     if (GATHER)
     {
-      const int offset = this->dma_index_ptr[index_offset];
+      const INDEX_OFFSET_TYPE offset = this->dma_index_ptr[index_offset];
       src_ptr += (offset * BYTES_PER_ELMT);
     }
     else
     {
-      const int offset = this->dma_index_ptr[index_offset];
+      const INDEX_OFFSET_TYPE offset = this->dma_index_ptr[index_offset];
       dst_ptr += (offset * BYTES_PER_ELMT);
     }
     for (int i = 0; i < DMA_MAX_ITERS; i++)
@@ -10453,7 +11785,7 @@ private:
   STORE_8_PARTIAL_BYTES_IMPL
 private:
   const char *dma_src_off_ptr;
-  const int *dma_index_ptr;
+  const INDEX_TYPE *dma_index_ptr;
   const unsigned int BYTES_PER_ELMT;
   const unsigned int DMA_THREADS;
   const unsigned int NUM_ELMTS;
@@ -10477,8 +11809,8 @@ private:
 
 #define LOCAL_TYPENAME float4
 #define ALIGNMENT 16 
-template<bool GATHER, int BYTES_PER_THREAD>
-class CudaDMAIndirect<GATHER,true,ALIGNMENT,BYTES_PER_THREAD,0,0,0> : public CudaDMA {
+template<bool GATHER, int BYTES_PER_THREAD, typename INDEX_TYPE>
+class CudaDMAIndirect<GATHER,true,ALIGNMENT,BYTES_PER_THREAD,0,0,0,INDEX_TYPE> : public CudaDMA {
 public:
   __device__ CudaDMAIndirect(const int dmaID,
                              const int num_dma_threads,
@@ -10521,12 +11853,12 @@ private:
   {
     if (GATHER)
     {
-      const int offset = this->dma_index_ptr[index_offset];
+      const INDEX_OFFSET_TYPE offset = this->dma_index_ptr[index_offset];
       src_ptr += (offset * BYTES_PER_ELMT);
     }
     else
     {
-      const int offset = this->dma_index_ptr[index_offset];
+      const INDEX_OFFSET_TYPE offset = this->dma_index_ptr[index_offset];
       dst_ptr += (offset * BYTES_PER_ELMT);
     }
     for (int i = 0; i < DMA_MAX_ITERS; i++)
@@ -10597,7 +11929,7 @@ private:
   STORE_16_PARTIAL_BYTES_IMPL
 private:
   const char *dma_src_off_ptr;
-  const int *dma_index_ptr;
+  const INDEX_TYPE *dma_index_ptr;
   const unsigned int BYTES_PER_ELMT;
   const unsigned int DMA_THREADS;
   const unsigned int NUM_ELMTS;
@@ -10622,8 +11954,8 @@ private:
 // one template, non-warp-specialized
 #define LOCAL_TYPENAME float
 #define ALIGNMENT 4
-template<bool GATHER, int BYTES_PER_THREAD>
-class CudaDMAIndirect<GATHER,false,ALIGNMENT,BYTES_PER_THREAD,0,0,0> : public CudaDMA {
+template<bool GATHER, int BYTES_PER_THREAD, typename INDEX_TYPE>
+class CudaDMAIndirect<GATHER,false,ALIGNMENT,BYTES_PER_THREAD,0,0,0,INDEX_TYPE> : public CudaDMA {
 public:
   __device__ CudaDMAIndirect(const int elmt_size_in_bytes,
                              const int num_elements,
@@ -10664,12 +11996,12 @@ private:
   {
     if (GATHER)
     {
-      const int offset = this->dma_index_ptr[index_offset];
+      const INDEX_OFFSET_TYPE offset = this->dma_index_ptr[index_offset];
       src_ptr += (offset * BYTES_PER_ELMT);
     }
     else
     {
-      const int offset = this->dma_index_ptr[index_offset];
+      const INDEX_OFFSET_TYPE offset = this->dma_index_ptr[index_offset];
       dst_ptr += (offset * BYTES_PER_ELMT);
     }
     for (int i = 0; i < DMA_MAX_ITERS; i++)
@@ -10722,7 +12054,7 @@ private:
   STORE_4_PARTIAL_BYTES_IMPL
 private:
   const char *dma_src_off_ptr;
-  const int *dma_index_ptr;
+  const INDEX_TYPE *dma_index_ptr;
   const unsigned int BYTES_PER_ELMT;
   const unsigned int DMA_THREADS;
   const unsigned int NUM_ELMTS;
@@ -10746,8 +12078,8 @@ private:
 
 #define LOCAL_TYPENAME float2
 #define ALIGNMENT 8
-template<bool GATHER, int BYTES_PER_THREAD>
-class CudaDMAIndirect<GATHER,false,ALIGNMENT,BYTES_PER_THREAD,0,0,0> : public CudaDMA {
+template<bool GATHER, int BYTES_PER_THREAD, typename INDEX_TYPE>
+class CudaDMAIndirect<GATHER,false,ALIGNMENT,BYTES_PER_THREAD,0,0,0,INDEX_TYPE> : public CudaDMA {
 public:
   __device__ CudaDMAIndirect(const int elmt_size_in_bytes,
                              const int num_elements,
@@ -10788,12 +12120,12 @@ private:
   {
     if (GATHER)
     {
-      const int offset = this->dma_index_ptr[index_offset];
+      const INDEX_OFFSET_TYPE offset = this->dma_index_ptr[index_offset];
       src_ptr += (offset * BYTES_PER_ELMT);
     }
     else
     {
-      const int offset = this->dma_index_ptr[index_offset];
+      const INDEX_OFFSET_TYPE offset = this->dma_index_ptr[index_offset];
       dst_ptr += (offset * BYTES_PER_ELMT);
     }
     for (int i = 0; i < DMA_MAX_ITERS; i++)
@@ -10852,7 +12184,7 @@ private:
   STORE_8_PARTIAL_BYTES_IMPL
 private:
   const char *dma_src_off_ptr;
-  const int *dma_index_ptr;
+  const INDEX_TYPE *dma_index_ptr;
   const unsigned int BYTES_PER_ELMT;
   const unsigned int DMA_THREADS;
   const unsigned int NUM_ELMTS;
@@ -10876,8 +12208,8 @@ private:
 
 #define LOCAL_TYPENAME float4
 #define ALIGNMENT 16 
-template<bool GATHER, int BYTES_PER_THREAD>
-class CudaDMAIndirect<GATHER,false,ALIGNMENT,BYTES_PER_THREAD,0,0,0> : public CudaDMA {
+template<bool GATHER, int BYTES_PER_THREAD, typename INDEX_TYPE>
+class CudaDMAIndirect<GATHER,false,ALIGNMENT,BYTES_PER_THREAD,0,0,0,INDEX_TYPE> : public CudaDMA {
 public:
   __device__ CudaDMAIndirect(const int elmt_size_in_bytes,
                              const int num_elements,
@@ -10918,12 +12250,12 @@ private:
   {
     if (GATHER)
     {
-      const int offset = this->dma_index_ptr[index_offset];
+      const INDEX_OFFSET_TYPE offset = this->dma_index_ptr[index_offset];
       src_ptr += (offset * BYTES_PER_ELMT);
     }
     else
     {
-      const int offset = this->dma_index_ptr[index_offset];
+      const INDEX_OFFSET_TYPE offset = this->dma_index_ptr[index_offset];
       dst_ptr += (offset * BYTES_PER_ELMT);
     }
     for (int i = 0; i < DMA_MAX_ITERS; i++)
@@ -10994,7 +12326,7 @@ private:
   STORE_16_PARTIAL_BYTES_IMPL
 private:
   const char *dma_src_off_ptr;
-  const int *dma_index_ptr;
+  const INDEX_TYPE *dma_index_ptr;
   const unsigned int BYTES_PER_ELMT;
   const unsigned int DMA_THREADS;
   const unsigned int NUM_ELMTS;
@@ -11037,7 +12369,7 @@ private:
 
 #define TEMPLATE_TWO_IMPL                                                                                   \
   template<bool DMA_GLOBAL_LOAD, int DMA_LOAD_QUAL, bool DMA_IS_SPLIT>                                      \
-  __device__ __forceinline__ void execute_start_xfer(const int *RESTRICT index_ptr,                         \
+  __device__ __forceinline__ void execute_start_xfer(const INDEX_TYPE *RESTRICT index_ptr,                  \
       const void *RESTRICT src_ptr, bool DMA_IS_BIG,                                                        \
       int DMA_STEP_ITERS_SPLIT, int DMA_ROW_ITERS_SPLIT, int DMA_COL_ITERS_SPLIT,                           \
       int DMA_STEP_ITERS_BIG, int DMA_MAX_ITERS_BIG, int DMA_PART_ITERS_BIG,                                \
@@ -11146,10 +12478,10 @@ private:
   {                                                                                                         \
     if (GATHER)                                                                                             \
     {                                                                                                       \
-      const int *index_ptr = this->dma_index_ptr + index_offset;                                            \
+      const INDEX_TYPE *index_ptr = this->dma_index_ptr + index_offset;                                     \
       for (int i = 0; i < DMA_ROW_ITERS; i++)                                                               \
       {                                                                                                     \
-        const int offset = index_ptr[i * this->dma_index_elmt_stride];                                      \
+        const INDEX_OFFSET_TYPE offset = index_ptr[i * this->dma_index_elmt_stride];                        \
         const char *temp_ptr = src_ptr + (offset * BYTES_PER_ELMT);                                         \
         for (int j = 0; j < DMA_COL_ITERS; j++)                                                             \
         {                                                                                                   \
@@ -11404,10 +12736,10 @@ private:
     }                                                                                                       \
     else                                                                                                    \
     {                                                                                                       \
-      const int *index_ptr = this->dma_index_ptr + index_offset;                                            \
+      const INDEX_TYPE *index_ptr = this->dma_index_ptr + index_offset;                                     \
       for (int i = 0; i < DMA_ROW_ITERS; i++)                                                               \
       {                                                                                                     \
-        const int offset = index_ptr[i * this->dma_index_elmt_stride];                                      \
+        const INDEX_OFFSET_TYPE offset = index_ptr[i * this->dma_index_elmt_stride];                        \
         char *temp_ptr = dst_ptr + (offset * BYTES_PER_ELMT);                                               \
         for (int j = 0; j < DMA_COL_ITERS; j++)                                                             \
         {                                                                                                   \
@@ -11425,8 +12757,8 @@ private:
 
 #define LOCAL_TYPENAME float
 #define ALIGNMENT 4
-template<bool GATHER, int BYTES_PER_THREAD, int BYTES_PER_ELMT>
-class CudaDMAIndirect<GATHER,true,ALIGNMENT,BYTES_PER_THREAD,BYTES_PER_ELMT,0,0> : public CudaDMA {
+template<bool GATHER, int BYTES_PER_THREAD, int BYTES_PER_ELMT, typename INDEX_TYPE>
+class CudaDMAIndirect<GATHER,true,ALIGNMENT,BYTES_PER_THREAD,BYTES_PER_ELMT,0,0,INDEX_TYPE> : public CudaDMA {
 public:
   __device__ CudaDMAIndirect(const int dmaID,
                              const int num_dma_threads,
@@ -11467,12 +12799,12 @@ private:
   {
     if (GATHER)
     {
-      const int offset = this->dma_index_ptr[index_offset];
+      const INDEX_OFFSET_TYPE offset = this->dma_index_ptr[index_offset];
       src_ptr += (offset * BYTES_PER_ELMT);
     }
     else
     {
-      const int offset = this->dma_index_ptr[index_offset];
+      const INDEX_OFFSET_TYPE offset = this->dma_index_ptr[index_offset];
       dst_ptr += (offset * BYTES_PER_ELMT);
     }
     for (int i = 0; i < DMA_MAX_ITERS; i++)
@@ -11525,7 +12857,7 @@ private:
   STORE_4_PARTIAL_BYTES_IMPL
 private:
   const char *dma_src_off_ptr;
-  const int *dma_index_ptr;
+  const INDEX_TYPE *dma_index_ptr;
   const unsigned int DMA_THREADS;
   const unsigned int NUM_ELMTS;
   const unsigned int dma_index_offset;
@@ -11548,8 +12880,8 @@ private:
 
 #define LOCAL_TYPENAME float2
 #define ALIGNMENT 8
-template<bool GATHER, int BYTES_PER_THREAD, int BYTES_PER_ELMT>
-class CudaDMAIndirect<GATHER,true,ALIGNMENT,BYTES_PER_THREAD,BYTES_PER_ELMT,0,0> : public CudaDMA {
+template<bool GATHER, int BYTES_PER_THREAD, int BYTES_PER_ELMT, typename INDEX_TYPE>
+class CudaDMAIndirect<GATHER,true,ALIGNMENT,BYTES_PER_THREAD,BYTES_PER_ELMT,0,0,INDEX_TYPE> : public CudaDMA {
 public:
   __device__ CudaDMAIndirect(const int dmaID,
                              const int num_dma_threads,
@@ -11590,12 +12922,12 @@ private:
   {
     if (GATHER)
     {
-      const int offset = this->dma_index_ptr[index_offset];
+      const INDEX_OFFSET_TYPE offset = this->dma_index_ptr[index_offset];
       src_ptr += (offset * BYTES_PER_ELMT);
     }
     else
     {
-      const int offset = this->dma_index_ptr[index_offset];
+      const INDEX_OFFSET_TYPE offset = this->dma_index_ptr[index_offset];
       dst_ptr += (offset * BYTES_PER_ELMT);
     }
     for (int i = 0; i < DMA_MAX_ITERS; i++)
@@ -11654,7 +12986,7 @@ private:
   STORE_8_PARTIAL_BYTES_IMPL
 private:
   const char *dma_src_off_ptr;
-  const int *dma_index_ptr;
+  const INDEX_TYPE *dma_index_ptr;
   const unsigned int DMA_THREADS;
   const unsigned int NUM_ELMTS;
   const unsigned int dma_index_offset;
@@ -11677,8 +13009,8 @@ private:
 
 #define LOCAL_TYPENAME float4
 #define ALIGNMENT 16 
-template<bool GATHER, int BYTES_PER_THREAD, int BYTES_PER_ELMT>
-class CudaDMAIndirect<GATHER,true,ALIGNMENT,BYTES_PER_THREAD,BYTES_PER_ELMT,0,0> : public CudaDMA {
+template<bool GATHER, int BYTES_PER_THREAD, int BYTES_PER_ELMT, typename INDEX_TYPE>
+class CudaDMAIndirect<GATHER,true,ALIGNMENT,BYTES_PER_THREAD,BYTES_PER_ELMT,0,0,INDEX_TYPE> : public CudaDMA {
 public:
   __device__ CudaDMAIndirect(const int dmaID,
                              const int num_dma_threads,
@@ -11719,12 +13051,12 @@ private:
   {
     if (GATHER)
     {
-      const int offset = this->dma_index_ptr[index_offset];
+      const INDEX_OFFSET_TYPE offset = this->dma_index_ptr[index_offset];
       src_ptr += (offset * BYTES_PER_ELMT);
     }
     else
     {
-      const int offset = this->dma_index_ptr[index_offset];
+      const INDEX_OFFSET_TYPE offset = this->dma_index_ptr[index_offset];
       dst_ptr += (offset * BYTES_PER_ELMT);
     }
     for (int i = 0; i < DMA_MAX_ITERS; i++)
@@ -11795,7 +13127,7 @@ private:
   STORE_16_PARTIAL_BYTES_IMPL
 private:
   const char *dma_src_off_ptr;
-  const int *dma_index_ptr;
+  const INDEX_TYPE *dma_index_ptr;
   const unsigned int DMA_THREADS;
   const unsigned int NUM_ELMTS;
   const unsigned int dma_index_offset;
@@ -11819,8 +13151,8 @@ private:
 // two template, non-warp-specialized
 #define LOCAL_TYPENAME float
 #define ALIGNMENT 4
-template<bool GATHER, int BYTES_PER_THREAD, int BYTES_PER_ELMT>
-class CudaDMAIndirect<GATHER,false,ALIGNMENT,BYTES_PER_THREAD,BYTES_PER_ELMT,0,0> : public CudaDMA {
+template<bool GATHER, int BYTES_PER_THREAD, int BYTES_PER_ELMT, typename INDEX_TYPE>
+class CudaDMAIndirect<GATHER,false,ALIGNMENT,BYTES_PER_THREAD,BYTES_PER_ELMT,0,0,INDEX_TYPE> : public CudaDMA {
 public:
   __device__ CudaDMAIndirect(const int num_elements,
                              const int alternate_stride = 0,
@@ -11859,12 +13191,12 @@ private:
   {
     if (GATHER)
     {
-      const int offset = this->dma_index_ptr[index_offset];
+      const INDEX_OFFSET_TYPE offset = this->dma_index_ptr[index_offset];
       src_ptr += (offset * BYTES_PER_ELMT);
     }
     else
     {
-      const int offset = this->dma_index_ptr[index_offset];
+      const INDEX_OFFSET_TYPE offset = this->dma_index_ptr[index_offset];
       dst_ptr += (offset * BYTES_PER_ELMT);
     }
     for (int i = 0; i < DMA_MAX_ITERS; i++)
@@ -11917,7 +13249,7 @@ private:
   STORE_4_PARTIAL_BYTES_IMPL
 private:
   const char *dma_src_off_ptr;
-  const int *dma_index_ptr;
+  const INDEX_TYPE *dma_index_ptr;
   const unsigned int DMA_THREADS;
   const unsigned int NUM_ELMTS;
   const unsigned int dma_index_offset;
@@ -11940,8 +13272,8 @@ private:
 
 #define LOCAL_TYPENAME float2
 #define ALIGNMENT 8
-template<bool GATHER, int BYTES_PER_THREAD, int BYTES_PER_ELMT>
-class CudaDMAIndirect<GATHER,false,ALIGNMENT,BYTES_PER_THREAD,BYTES_PER_ELMT,0,0> : public CudaDMA {
+template<bool GATHER, int BYTES_PER_THREAD, int BYTES_PER_ELMT, typename INDEX_TYPE>
+class CudaDMAIndirect<GATHER,false,ALIGNMENT,BYTES_PER_THREAD,BYTES_PER_ELMT,0,0,INDEX_TYPE> : public CudaDMA {
 public:
   __device__ CudaDMAIndirect(const int num_elements,
                              const int alternate_stride = 0,
@@ -11980,12 +13312,12 @@ private:
   {
     if (GATHER)
     {
-      const int offset = this->dma_index_ptr[index_offset];
+      const INDEX_OFFSET_TYPE offset = this->dma_index_ptr[index_offset];
       src_ptr += (offset * BYTES_PER_ELMT);
     }
     else
     {
-      const int offset = this->dma_index_ptr[index_offset];
+      const INDEX_OFFSET_TYPE offset = this->dma_index_ptr[index_offset];
       dst_ptr += (offset * BYTES_PER_ELMT);
     }
     for (int i = 0; i < DMA_MAX_ITERS; i++)
@@ -12044,7 +13376,7 @@ private:
   STORE_8_PARTIAL_BYTES_IMPL
 private:
   const char *dma_src_off_ptr;
-  const int *dma_index_ptr;
+  const INDEX_TYPE *dma_index_ptr;
   const unsigned int DMA_THREADS;
   const unsigned int NUM_ELMTS;
   const unsigned int dma_index_offset;
@@ -12067,8 +13399,8 @@ private:
 
 #define LOCAL_TYPENAME float4
 #define ALIGNMENT 16 
-template<bool GATHER, int BYTES_PER_THREAD, int BYTES_PER_ELMT>
-class CudaDMAIndirect<GATHER,false,ALIGNMENT,BYTES_PER_THREAD,BYTES_PER_ELMT,0,0> : public CudaDMA {
+template<bool GATHER, int BYTES_PER_THREAD, int BYTES_PER_ELMT, typename INDEX_TYPE>
+class CudaDMAIndirect<GATHER,false,ALIGNMENT,BYTES_PER_THREAD,BYTES_PER_ELMT,0,0,INDEX_TYPE> : public CudaDMA {
 public:
   __device__ CudaDMAIndirect(const int num_elements,
                              const int alternate_stride = 0,
@@ -12107,12 +13439,12 @@ private:
   {
     if (GATHER)
     {
-      const int offset = this->dma_index_ptr[index_offset];
+      const INDEX_OFFSET_TYPE offset = this->dma_index_ptr[index_offset];
       src_ptr += (offset * BYTES_PER_ELMT);
     }
     else
     {
-      const int offset = this->dma_index_ptr[index_offset];
+      const INDEX_OFFSET_TYPE offset = this->dma_index_ptr[index_offset];
       dst_ptr += (offset * BYTES_PER_ELMT);
     }
     for (int i = 0; i < DMA_MAX_ITERS; i++)
@@ -12183,7 +13515,7 @@ private:
   STORE_16_PARTIAL_BYTES_IMPL
 private:
   const char *dma_src_off_ptr;
-  const int *dma_index_ptr;
+  const INDEX_TYPE *dma_index_ptr;
   const unsigned int DMA_THREADS;
   const unsigned int NUM_ELMTS;
   const unsigned int dma_index_offset;
@@ -12233,7 +13565,7 @@ private:
            int DMA_MAX_ITERS_BIG,   int DMA_PART_ITERS_BIG,                                                 \
            int DMA_ROW_ITERS_FULL,  int DMA_COL_ITERS_FULL,                                                 \
 	   bool DMA_PARTIAL_BYTES>                                                                          \
-  __device__ __forceinline__ void execute_start_xfer(const int *RESTRICT index_ptr,                         \
+  __device__ __forceinline__ void execute_start_xfer(const INDEX_TYPE *RESTRICT index_ptr,                  \
       const void *RESTRICT src_ptr, int DMA_STEP_ITERS_SPLIT, int DMA_STEP_ITERS_BIG,                       \
       int DMA_STEP_ITERS_FULL, bool DMA_PARTIAL_ROWS, bool DMA_ALL_WARPS_ACTIVE)                            \
   {                                                                                                         \
@@ -12336,10 +13668,10 @@ private:
   {                                                                                                         \
     if (GATHER)                                                                                             \
     {                                                                                                       \
-      const int *index_ptr = this->dma_index_ptr + index_offset;                                            \
+      const INDEX_TYPE *index_ptr = this->dma_index_ptr + index_offset;                                     \
       for (int i = 0; i < DMA_ROW_ITERS; i++)                                                               \
       {                                                                                                     \
-        const int offset = index_ptr[i * this->dma_index_elmt_stride];                                      \
+        const INDEX_OFFSET_TYPE offset = index_ptr[i * this->dma_index_elmt_stride];                        \
         const char *temp_ptr = src_ptr + (offset * BYTES_PER_ELMT);                                         \
         for (int j = 0; j < DMA_COL_ITERS; j++)                                                             \
         {                                                                                                   \
@@ -12380,10 +13712,10 @@ private:
   {                                                                                                         \
     if (GATHER)                                                                                             \
     {                                                                                                       \
-      const int *index_ptr = this->dma_index_ptr + index_offset;                                            \
+      const INDEX_TYPE *index_ptr = this->dma_index_ptr + index_offset;                                     \
       for (int i = 0; i < row_iters; i++)                                                                   \
       {                                                                                                     \
-        const int offset = index_ptr[i * this->dma_index_elmt_stride];                                      \
+        const INDEX_OFFSET_TYPE offset = index_ptr[i * this->dma_index_elmt_stride];                        \
         const char *temp_ptr = src_ptr + (offset * BYTES_PER_ELMT);                                         \
         for (int j = 0; j < DMA_COL_ITERS; j++)                                                             \
         {                                                                                                   \
@@ -12638,10 +13970,10 @@ private:
     }                                                                                                       \
     else                                                                                                    \
     {                                                                                                       \
-      const int *index_ptr = this->dma_index_ptr + index_offset;                                            \
+      const INDEX_TYPE *index_ptr = this->dma_index_ptr + index_offset;                                     \
       for (int i = 0; i < DMA_ROW_ITERS; i++)                                                               \
       {                                                                                                     \
-        const int offset = index_ptr[i * this->dma_index_elmt_stride];                                      \
+        const INDEX_OFFSET_TYPE offset = index_ptr[i * this->dma_index_elmt_stride];                        \
         char *temp_ptr = dst_ptr + (offset * BYTES_PER_ELMT);                                               \
         for (int j = 0; j < DMA_COL_ITERS; j++)                                                             \
         {                                                                                                   \
@@ -12683,10 +14015,10 @@ private:
     }                                                                                                       \
     else                                                                                                    \
     {                                                                                                       \
-      const int *index_ptr = this->dma_index_ptr + index_offset;                                            \
+      const INDEX_TYPE *index_ptr = this->dma_index_ptr + index_offset;                                     \
       for (int i = 0; i < row_iters; i++)                                                                   \
       {                                                                                                     \
-        const int offset = index_ptr[i * this->dma_index_elmt_stride];                                      \
+        const INDEX_OFFSET_TYPE offset = index_ptr[i * this->dma_index_elmt_stride];                        \
         char *temp_ptr = dst_ptr + (offset * BYTES_PER_ELMT);                                               \
         for (int j = 0; j < DMA_COL_ITERS; j++)                                                             \
         {                                                                                                   \
@@ -12704,8 +14036,8 @@ private:
 
 #define LOCAL_TYPENAME float
 #define ALIGNMENT 4
-template<bool GATHER, int BYTES_PER_THREAD, int BYTES_PER_ELMT, int DMA_THREADS>
-class CudaDMAIndirect<GATHER,true,ALIGNMENT,BYTES_PER_THREAD,BYTES_PER_ELMT,DMA_THREADS,0> : public CudaDMA {
+template<bool GATHER, int BYTES_PER_THREAD, int BYTES_PER_ELMT, int DMA_THREADS, typename INDEX_TYPE>
+class CudaDMAIndirect<GATHER,true,ALIGNMENT,BYTES_PER_THREAD,BYTES_PER_ELMT,DMA_THREADS,0,INDEX_TYPE> : public CudaDMA {
 public:
   __device__ CudaDMAIndirect(const int dmaID,
                              const int num_compute_threads,
@@ -12744,12 +14076,12 @@ private:
   {
     if (GATHER)
     {
-      const int offset = this->dma_index_ptr[index_offset];
+      const INDEX_OFFSET_TYPE offset = this->dma_index_ptr[index_offset];
       src_ptr += (offset * BYTES_PER_ELMT);
     }
     else
     {
-      const int offset = this->dma_index_ptr[index_offset];
+      const INDEX_OFFSET_TYPE offset = this->dma_index_ptr[index_offset];
       dst_ptr += (offset * BYTES_PER_ELMT);
     }
     for (int i = 0; i < DMA_MAX_ITERS; i++)
@@ -12802,7 +14134,7 @@ private:
   STORE_4_PARTIAL_BYTES_IMPL
 private:
   const char *dma_src_off_ptr;
-  const int *dma_index_ptr;
+  const INDEX_TYPE *dma_index_ptr;
   const unsigned int NUM_ELMTS;
   const unsigned int dma_index_offset;
   const unsigned int dma_index_step_stride;
@@ -12825,8 +14157,8 @@ private:
 
 #define LOCAL_TYPENAME float2
 #define ALIGNMENT 8
-template<bool GATHER, int BYTES_PER_THREAD, int BYTES_PER_ELMT, int DMA_THREADS>
-class CudaDMAIndirect<GATHER,true,ALIGNMENT,BYTES_PER_THREAD,BYTES_PER_ELMT,DMA_THREADS,0> : public CudaDMA {
+template<bool GATHER, int BYTES_PER_THREAD, int BYTES_PER_ELMT, int DMA_THREADS, typename INDEX_TYPE>
+class CudaDMAIndirect<GATHER,true,ALIGNMENT,BYTES_PER_THREAD,BYTES_PER_ELMT,DMA_THREADS,0,INDEX_TYPE> : public CudaDMA {
 public:
   __device__ CudaDMAIndirect(const int dmaID,
                              const int num_compute_threads,
@@ -12865,12 +14197,12 @@ private:
   {
     if (GATHER)
     {
-      const int offset = this->dma_index_ptr[index_offset];
+      const INDEX_OFFSET_TYPE offset = this->dma_index_ptr[index_offset];
       src_ptr += (offset * BYTES_PER_ELMT);
     }
     else
     {
-      const int offset = this->dma_index_ptr[index_offset];
+      const INDEX_OFFSET_TYPE offset = this->dma_index_ptr[index_offset];
       dst_ptr += (offset * BYTES_PER_ELMT);
     }
     for (int i = 0; i < DMA_MAX_ITERS; i++)
@@ -12929,7 +14261,7 @@ private:
   STORE_8_PARTIAL_BYTES_IMPL
 private:
   const char *dma_src_off_ptr;
-  const int *dma_index_ptr;
+  const INDEX_TYPE *dma_index_ptr;
   const unsigned int NUM_ELMTS;
   const unsigned int dma_index_offset;
   const unsigned int dma_index_step_stride;
@@ -12952,8 +14284,8 @@ private:
 
 #define LOCAL_TYPENAME float4
 #define ALIGNMENT 16 
-template<bool GATHER, int BYTES_PER_THREAD, int BYTES_PER_ELMT, int DMA_THREADS>
-class CudaDMAIndirect<GATHER,true,ALIGNMENT,BYTES_PER_THREAD,BYTES_PER_ELMT,DMA_THREADS,0> : public CudaDMA {
+template<bool GATHER, int BYTES_PER_THREAD, int BYTES_PER_ELMT, int DMA_THREADS, typename INDEX_TYPE>
+class CudaDMAIndirect<GATHER,true,ALIGNMENT,BYTES_PER_THREAD,BYTES_PER_ELMT,DMA_THREADS,0,INDEX_TYPE> : public CudaDMA {
 public:
   __device__ CudaDMAIndirect(const int dmaID,
                              const int num_compute_threads,
@@ -12992,12 +14324,12 @@ private:
   {
     if (GATHER)
     {
-      const int offset = this->dma_index_ptr[index_offset];
+      const INDEX_OFFSET_TYPE offset = this->dma_index_ptr[index_offset];
       src_ptr += (offset * BYTES_PER_ELMT);
     }
     else
     {
-      const int offset = this->dma_index_ptr[index_offset];
+      const INDEX_OFFSET_TYPE offset = this->dma_index_ptr[index_offset];
       dst_ptr += (offset * BYTES_PER_ELMT);
     }
     for (int i = 0; i < DMA_MAX_ITERS; i++)
@@ -13068,7 +14400,7 @@ private:
   STORE_16_PARTIAL_BYTES_IMPL
 private:
   const char *dma_src_off_ptr;
-  const int *dma_index_ptr;
+  const INDEX_TYPE *dma_index_ptr;
   const unsigned int NUM_ELMTS;
   const unsigned int dma_index_offset;
   const unsigned int dma_index_step_stride;
@@ -13092,8 +14424,8 @@ private:
 // three template, non-warp-specizlied
 #define LOCAL_TYPENAME float
 #define ALIGNMENT 4
-template<bool GATHER, int BYTES_PER_THREAD, int BYTES_PER_ELMT, int DMA_THREADS>
-class CudaDMAIndirect<GATHER,false,ALIGNMENT,BYTES_PER_THREAD,BYTES_PER_ELMT,DMA_THREADS,0> : public CudaDMA {
+template<bool GATHER, int BYTES_PER_THREAD, int BYTES_PER_ELMT, int DMA_THREADS, typename INDEX_TYPE>
+class CudaDMAIndirect<GATHER,false,ALIGNMENT,BYTES_PER_THREAD,BYTES_PER_ELMT,DMA_THREADS,0,INDEX_TYPE> : public CudaDMA {
 public:
   __device__ CudaDMAIndirect(const int num_elements,
                              const int alternate_stride = 0,
@@ -13130,12 +14462,12 @@ private:
   {
     if (GATHER)
     {
-      const int offset = this->dma_index_ptr[index_offset];
+      const INDEX_OFFSET_TYPE offset = this->dma_index_ptr[index_offset];
       src_ptr += (offset * BYTES_PER_ELMT);
     }
     else
     {
-      const int offset = this->dma_index_ptr[index_offset];
+      const INDEX_OFFSET_TYPE offset = this->dma_index_ptr[index_offset];
       dst_ptr += (offset * BYTES_PER_ELMT);
     }
     for (int i = 0; i < DMA_MAX_ITERS; i++)
@@ -13188,7 +14520,7 @@ private:
   STORE_4_PARTIAL_BYTES_IMPL
 private:
   const char *dma_src_off_ptr;
-  const int *dma_index_ptr;
+  const INDEX_TYPE *dma_index_ptr;
   const unsigned int NUM_ELMTS;
   const unsigned int dma_index_offset;
   const unsigned int dma_index_step_stride;
@@ -13211,8 +14543,8 @@ private:
 
 #define LOCAL_TYPENAME float2
 #define ALIGNMENT 8
-template<bool GATHER, int BYTES_PER_THREAD, int BYTES_PER_ELMT, int DMA_THREADS>
-class CudaDMAIndirect<GATHER,false,ALIGNMENT,BYTES_PER_THREAD,BYTES_PER_ELMT,DMA_THREADS,0> : public CudaDMA {
+template<bool GATHER, int BYTES_PER_THREAD, int BYTES_PER_ELMT, int DMA_THREADS, typename INDEX_TYPE>
+class CudaDMAIndirect<GATHER,false,ALIGNMENT,BYTES_PER_THREAD,BYTES_PER_ELMT,DMA_THREADS,0,INDEX_TYPE> : public CudaDMA {
 public:
   __device__ CudaDMAIndirect(const int num_elements,
                              const int alternate_stride = 0,
@@ -13249,12 +14581,12 @@ private:
   {
     if (GATHER)
     {
-      const int offset = this->dma_index_ptr[index_offset];
+      const INDEX_OFFSET_TYPE offset = this->dma_index_ptr[index_offset];
       src_ptr += (offset * BYTES_PER_ELMT);
     }
     else
     {
-      const int offset = this->dma_index_ptr[index_offset];
+      const INDEX_OFFSET_TYPE offset = this->dma_index_ptr[index_offset];
       dst_ptr += (offset * BYTES_PER_ELMT);
     }
     for (int i = 0; i < DMA_MAX_ITERS; i++)
@@ -13313,7 +14645,7 @@ private:
   STORE_8_PARTIAL_BYTES_IMPL
 private:
   const char *dma_src_off_ptr;
-  const int *dma_index_ptr;
+  const INDEX_TYPE *dma_index_ptr;
   const unsigned int NUM_ELMTS;
   const unsigned int dma_index_offset;
   const unsigned int dma_index_step_stride;
@@ -13336,8 +14668,8 @@ private:
 
 #define LOCAL_TYPENAME float4
 #define ALIGNMENT 16 
-template<bool GATHER, int BYTES_PER_THREAD, int BYTES_PER_ELMT, int DMA_THREADS>
-class CudaDMAIndirect<GATHER,false,ALIGNMENT,BYTES_PER_THREAD,BYTES_PER_ELMT,DMA_THREADS,0> : public CudaDMA {
+template<bool GATHER, int BYTES_PER_THREAD, int BYTES_PER_ELMT, int DMA_THREADS, typename INDEX_TYPE>
+class CudaDMAIndirect<GATHER,false,ALIGNMENT,BYTES_PER_THREAD,BYTES_PER_ELMT,DMA_THREADS,0,INDEX_TYPE> : public CudaDMA {
 public:
   __device__ CudaDMAIndirect(const int num_elements,
                              const int alternate_stride = 0,
@@ -13374,12 +14706,12 @@ private:
   {
     if (GATHER)
     {
-      const int offset = this->dma_index_ptr[index_offset];
+      const INDEX_OFFSET_TYPE offset = this->dma_index_ptr[index_offset];
       src_ptr += (offset * BYTES_PER_ELMT);
     }
     else
     {
-      const int offset = this->dma_index_ptr[index_offset];
+      const INDEX_OFFSET_TYPE offset = this->dma_index_ptr[index_offset];
       dst_ptr += (offset * BYTES_PER_ELMT);
     }
     for (int i = 0; i < DMA_MAX_ITERS; i++)
@@ -13450,7 +14782,7 @@ private:
   STORE_16_PARTIAL_BYTES_IMPL
 private:
   const char *dma_src_off_ptr;
-  const int *dma_index_ptr;
+  const INDEX_TYPE *dma_index_ptr;
   const unsigned int NUM_ELMTS;
   const unsigned int dma_index_offset;
   const unsigned int dma_index_step_stride;
@@ -13491,6 +14823,22 @@ private:
                         ((NUM_WARPS/MINIMUM_COVER) <= NUM_ELMTS) ? MINIMUM_COVER : \
                         ((MAX_WARPS_PER_ELMT >= NUM_WARPS) ? NUM_WARPS : MAX_WARPS_PER_ELMT))
 
+/**
+ * CudaDMAIndirectPlan exposes the layout of a fully templated CudaDMAIndirect
+ * instance.  Indirect instances lay out elements exactly like CudaDMAStrided
+ * so the plan is the same with the direction of the transfer added.
+ * The plan for an instance is also available as CudaDMAIndirect<...>::Plan.
+ */
+template<bool GATHER, int ALIGNMENT, int BYTES_PER_THREAD, int BYTES_PER_ELMT, int DMA_THREADS, int NUM_ELMTS>
+struct CudaDMAIndirectPlan : public CudaDMAStridedPlan<ALIGNMENT,BYTES_PER_THREAD,BYTES_PER_ELMT,DMA_THREADS,NUM_ELMTS> {
+  typedef CudaDMAStridedPlan<ALIGNMENT,BYTES_PER_THREAD,BYTES_PER_ELMT,DMA_THREADS,NUM_ELMTS> Strided;
+  static const bool gather = GATHER;
+  // Indirect instances also keep the index pointer and offsets
+  static const int state_registers = CudaDMARegisterCost::base + CudaDMARegisterCost::indirect;
+  static const int registers = Strided::bulk_registers + Strided::across_registers + state_registers +
+                               CudaDMARegisterCost::working;
+};
+
 #define INDIRECT_START_XFER_IMPL(GLOBAL_LOAD,LOAD_QUAL,STORE_QUAL)                                          \
   execute_start_xfer<GLOBAL_LOAD,LOAD_QUAL,SPLIT_WARP,BIG_ELMTS,                                            \
                      STEP_ITERS_SPLIT,ROW_ITERS_SPLIT,COL_ITERS_SPLIT,                                      \
@@ -13511,7 +14859,7 @@ private:
            int DMA_STEP_ITERS_BIG,   int DMA_MAX_ITERS_BIG,   int DMA_PART_ITERS_BIG,                       \
            int DMA_STEP_ITERS_FULL,  int DMA_ROW_ITERS_FULL,  int DMA_COL_ITERS_FULL,                       \
 	   bool DMA_PARTIAL_BYTES, bool DMA_PARTIAL_ROWS, bool DMA_ALL_WARPS_ACTIVE>                        \
-  __device__ __forceinline__ void execute_start_xfer(const int *RESTRICT index_ptr,                         \
+  __device__ __forceinline__ void execute_start_xfer(const INDEX_TYPE *RESTRICT index_ptr,                  \
                                                      const void *RESTRICT src_ptr)                          \
   {                                                                                                         \
     this->dma_src_off_ptr = ((const char*)src_ptr) + (GATHER ? this->dma_elmt_offset : this->dma_offset);   \
@@ -13612,10 +14960,10 @@ private:
   {                                                                                                         \
     if (GATHER)                                                                                             \
     {                                                                                                       \
-      const int *index_ptr = this->dma_index_ptr + index_offset;                                            \
+      const INDEX_TYPE *index_ptr = this->dma_index_ptr + index_offset;                                     \
       for (int i = 0; i < DMA_ROW_ITERS; i++)                                                               \
       {                                                                                                     \
-        const int offset = index_ptr[i * this->dma_index_elmt_stride];                                      \
+        const INDEX_OFFSET_TYPE offset = index_ptr[i * this->dma_index_elmt_stride];                        \
         const char *temp_ptr = src_ptr + (offset * BYTES_PER_ELMT);                                         \
         for (int j = 0; j < DMA_COL_ITERS; j++)                                                             \
         {                                                                                                   \
@@ -13656,10 +15004,10 @@ private:
   {                                                                                                         \
     if (GATHER)                                                                                             \
     {                                                                                                       \
-      const int *index_ptr = this->dma_index_ptr + index_offset;                                            \
+      const INDEX_TYPE *index_ptr = this->dma_index_ptr + index_offset;                                     \
       for (int i = 0; i < row_iters; i++)                                                                   \
       {                                                                                                     \
-        const int offset = index_ptr[i * this->dma_index_elmt_stride];                                      \
+        const INDEX_OFFSET_TYPE offset = index_ptr[i * this->dma_index_elmt_stride];                        \
         const char *temp_ptr = src_ptr + (offset * BYTES_PER_ELMT);                                         \
         for (int j = 0; j < DMA_COL_ITERS; j++)                                                             \
         {                                                                                                   \
@@ -13911,10 +15259,10 @@ private:
     }                                                                                                       \
     else                                                                                                    \
     {                                                                                                       \
-      const int *index_ptr = this->dma_index_ptr + index_offset;                                            \
+      const INDEX_TYPE *index_ptr = this->dma_index_ptr + index_offset;                                     \
       for (int i = 0; i < DMA_ROW_ITERS; i++)                                                               \
       {                                                                                                     \
-        const int offset = index_ptr[i * this->dma_index_elmt_stride];                                      \
+        const INDEX_OFFSET_TYPE offset = index_ptr[i * this->dma_index_elmt_stride];                        \
         char *temp_ptr = dst_ptr + (offset * BYTES_PER_ELMT);                                               \
         for (int j = 0; j < DMA_COL_ITERS; j++)                                                             \
         {                                                                                                   \
@@ -13956,10 +15304,10 @@ private:
     }                                                                                                       \
     else                                                                                                    \
     {                                                                                                       \
-      const int *index_ptr = this->dma_index_ptr + index_offset;                                            \
+      const INDEX_TYPE *index_ptr = this->dma_index_ptr + index_offset;                                     \
       for (int i = 0; i < row_iters; i++)                                                                   \
       {                                                                                                     \
-        const int offset = index_ptr[i * this->dma_index_elmt_stride];                                      \
+        const INDEX_OFFSET_TYPE offset = index_ptr[i * this->dma_index_elmt_stride];                        \
         char *temp_ptr = dst_ptr + (offset * BYTES_PER_ELMT);                                               \
         for (int j = 0; j < DMA_COL_ITERS; j++)                                                             \
         {                                                                                                   \
@@ -13977,9 +15325,10 @@ private:
 
 #define LOCAL_TYPENAME float
 #define ALIGNMENT 4
-template<bool GATHER, int BYTES_PER_THREAD, int BYTES_PER_ELMT, int DMA_THREADS, int NUM_ELMTS>
-class CudaDMAIndirect<GATHER,true,ALIGNMENT,BYTES_PER_THREAD,BYTES_PER_ELMT,DMA_THREADS,NUM_ELMTS> : public CudaDMA {
+template<bool GATHER, int BYTES_PER_THREAD, int BYTES_PER_ELMT, int DMA_THREADS, int NUM_ELMTS, typename INDEX_TYPE>
+class CudaDMAIndirect<GATHER,true,ALIGNMENT,BYTES_PER_THREAD,BYTES_PER_ELMT,DMA_THREADS,NUM_ELMTS,INDEX_TYPE> : public CudaDMA {
 public:
+  typedef CudaDMAIndirectPlan<GATHER,ALIGNMENT,BYTES_PER_THREAD,BYTES_PER_ELMT,DMA_THREADS,NUM_ELMTS> Plan;
   __device__ CudaDMAIndirect(const int dmaID,
                              const int num_compute_threads,
                              const int dma_threadIdx_start,
@@ -14015,38 +15364,84 @@ private:
   {
     if (GATHER)
     {
-      const int offset = this->dma_index_ptr[index_offset];
+      const INDEX_OFFSET_TYPE offset = this->dma_index_ptr[index_offset];
       src_ptr += (offset * BYTES_PER_ELMT);
     }
     else
     {
-      const int offset = this->dma_index_ptr[index_offset];
+      const INDEX_OFFSET_TYPE offset = this->dma_index_ptr[index_offset];
       dst_ptr += (offset * BYTES_PER_ELMT);
     }
-    for (int i = 0; i < DMA_MAX_ITERS; i++)
+    if (PIPE_STEPS_BIG(DMA_MAX_ITERS,DMA_PARTIAL_ITERS))
     {
+      // Refill each half with the next step of the element as soon as it
+      // is stored so the loads of the other half stay outstanding meanwhile
       for (int j = 0; j < (BYTES_PER_THREAD/ALIGNMENT); j++)
+        bulk_buffer[j] = ptx_cudaDMA_load<LOCAL_TYPENAME,DMA_GLOBAL_LOAD,DMA_LOAD_QUAL>(
+                                          (LOCAL_TYPENAME*)(src_ptr + j*intra_elmt_stride));
+      src_ptr += ((BYTES_PER_THREAD/ALIGNMENT)*intra_elmt_stride);
+      for (int i = 0; i < DMA_MAX_ITERS; i++)
       {
-        bulk_buffer[j] = ptx_cudaDMA_load<LOCAL_TYPENAME,DMA_GLOBAL_LOAD,DMA_LOAD_QUAL>((LOCAL_TYPENAME*)src_ptr);
-        src_ptr += intra_elmt_stride;
+        for (int j = 0; j < PIPE_LOWER_LDS_BIG; j++)
+          ptx_cudaDMA_store<LOCAL_TYPENAME,DMA_STORE_QUAL>(bulk_buffer[j],
+                                          (LOCAL_TYPENAME*)(dst_ptr + j*intra_elmt_stride));
+        const int lower_loads = (i < (DMA_MAX_ITERS-1)) ? PIPE_LOWER_LDS_BIG :
+                                (DMA_PARTIAL_ITERS <= PIPE_LOWER_LDS_BIG) ? DMA_PARTIAL_ITERS : 0;
+        for (int j = 0; j < lower_loads; j++)
+          bulk_buffer[j] = ptx_cudaDMA_load<LOCAL_TYPENAME,DMA_GLOBAL_LOAD,DMA_LOAD_QUAL>(
+                                          (LOCAL_TYPENAME*)(src_ptr + j*intra_elmt_stride));
+        for (int j = PIPE_LOWER_LDS_BIG; j < (BYTES_PER_THREAD/ALIGNMENT); j++)
+          ptx_cudaDMA_store<LOCAL_TYPENAME,DMA_STORE_QUAL>(bulk_buffer[j],
+                                          (LOCAL_TYPENAME*)(dst_ptr + j*intra_elmt_stride));
+        if (i < (DMA_MAX_ITERS-1))
+        {
+          for (int j = PIPE_LOWER_LDS_BIG; j < (BYTES_PER_THREAD/ALIGNMENT); j++)
+            bulk_buffer[j] = ptx_cudaDMA_load<LOCAL_TYPENAME,DMA_GLOBAL_LOAD,DMA_LOAD_QUAL>(
+                                          (LOCAL_TYPENAME*)(src_ptr + j*intra_elmt_stride));
+          src_ptr += ((BYTES_PER_THREAD/ALIGNMENT)*intra_elmt_stride);
+        }
+        dst_ptr += ((BYTES_PER_THREAD/ALIGNMENT)*intra_elmt_stride);
       }
-      for (int j = 0; j < (BYTES_PER_THREAD/ALIGNMENT); j++)
+      if (DMA_PARTIAL_ITERS > PIPE_LOWER_LDS_BIG)
+      {
+        for (int j = 0; j < DMA_PARTIAL_ITERS; j++)
+          bulk_buffer[j] = ptx_cudaDMA_load<LOCAL_TYPENAME,DMA_GLOBAL_LOAD,DMA_LOAD_QUAL>(
+                                          (LOCAL_TYPENAME*)(src_ptr + j*intra_elmt_stride));
+      }
+      src_ptr += (DMA_PARTIAL_ITERS * intra_elmt_stride);
+      for (int j = 0; j < DMA_PARTIAL_ITERS; j++)
       {
         ptx_cudaDMA_store<LOCAL_TYPENAME,DMA_STORE_QUAL>(bulk_buffer[j], (LOCAL_TYPENAME*)dst_ptr);
         dst_ptr += intra_elmt_stride;
       }
     }
-    if (DMA_PARTIAL_ITERS > 0)
+    else
     {
-      for (int i = 0; i < DMA_PARTIAL_ITERS; i++)
+      for (int i = 0; i < DMA_MAX_ITERS; i++)
       {
-        bulk_buffer[i] = ptx_cudaDMA_load<LOCAL_TYPENAME,DMA_GLOBAL_LOAD,DMA_LOAD_QUAL>((LOCAL_TYPENAME*)src_ptr);
-        src_ptr += intra_elmt_stride;
+        for (int j = 0; j < (BYTES_PER_THREAD/ALIGNMENT); j++)
+        {
+          bulk_buffer[j] = ptx_cudaDMA_load<LOCAL_TYPENAME,DMA_GLOBAL_LOAD,DMA_LOAD_QUAL>((LOCAL_TYPENAME*)src_ptr);
+          src_ptr += intra_elmt_stride;
+        }
+        for (int j = 0; j < (BYTES_PER_THREAD/ALIGNMENT); j++)
+        {
+          ptx_cudaDMA_store<LOCAL_TYPENAME,DMA_STORE_QUAL>(bulk_buffer[j], (LOCAL_TYPENAME*)dst_ptr);
+          dst_ptr += intra_elmt_stride;
+        }
       }
-      for (int i = 0; i < DMA_PARTIAL_ITERS; i++)
+      if (DMA_PARTIAL_ITERS > 0)
       {
-        ptx_cudaDMA_store<LOCAL_TYPENAME,DMA_STORE_QUAL>(bulk_buffer[i], (LOCAL_TYPENAME*)dst_ptr);
-        dst_ptr += intra_elmt_stride;
+        for (int i = 0; i < DMA_PARTIAL_ITERS; i++)
+        {
+          bulk_buffer[i] = ptx_cudaDMA_load<LOCAL_TYPENAME,DMA_GLOBAL_LOAD,DMA_LOAD_QUAL>((LOCAL_TYPENAME*)src_ptr);
+          src_ptr += intra_elmt_stride;
+        }
+        for (int i = 0; i < DMA_PARTIAL_ITERS; i++)
+        {
+          ptx_cudaDMA_store<LOCAL_TYPENAME,DMA_STORE_QUAL>(bulk_buffer[i], (LOCAL_TYPENAME*)dst_ptr);
+          dst_ptr += intra_elmt_stride;
+        }
       }
     }
     if (DMA_PARTIAL_BYTES)
@@ -14073,7 +15468,7 @@ private:
   STORE_4_PARTIAL_BYTES_IMPL
 private:
   const char *dma_src_off_ptr;
-  const int *dma_index_ptr;
+  const INDEX_TYPE *dma_index_ptr;
   const unsigned int dma_index_offset;
   const unsigned int dma_index_step_stride;
   const unsigned int dma_index_elmt_stride;
@@ -14095,9 +15490,10 @@ private:
 
 #define LOCAL_TYPENAME float2
 #define ALIGNMENT 8
-template<bool GATHER, int BYTES_PER_THREAD, int BYTES_PER_ELMT, int DMA_THREADS, int NUM_ELMTS>
-class CudaDMAIndirect<GATHER,true,ALIGNMENT,BYTES_PER_THREAD,BYTES_PER_ELMT,DMA_THREADS,NUM_ELMTS> : public CudaDMA {
+template<bool GATHER, int BYTES_PER_THREAD, int BYTES_PER_ELMT, int DMA_THREADS, int NUM_ELMTS, typename INDEX_TYPE>
+class CudaDMAIndirect<GATHER,true,ALIGNMENT,BYTES_PER_THREAD,BYTES_PER_ELMT,DMA_THREADS,NUM_ELMTS,INDEX_TYPE> : public CudaDMA {
 public:
+  typedef CudaDMAIndirectPlan<GATHER,ALIGNMENT,BYTES_PER_THREAD,BYTES_PER_ELMT,DMA_THREADS,NUM_ELMTS> Plan;
   __device__ CudaDMAIndirect(const int dmaID,
                              const int num_compute_threads,
                              const int dma_threadIdx_start,
@@ -14133,38 +15529,84 @@ private:
   {
     if (GATHER)
     {
-      const int offset = this->dma_index_ptr[index_offset];
+      const INDEX_OFFSET_TYPE offset = this->dma_index_ptr[index_offset];
       src_ptr += (offset * BYTES_PER_ELMT);
     }
     else
     {
-      const int offset = this->dma_index_ptr[index_offset];
+      const INDEX_OFFSET_TYPE offset = this->dma_index_ptr[index_offset];
       dst_ptr += (offset * BYTES_PER_ELMT);
     }
-    for (int i = 0; i < DMA_MAX_ITERS; i++)
+    if (PIPE_STEPS_BIG(DMA_MAX_ITERS,DMA_PARTIAL_ITERS))
     {
+      // Refill each half with the next step of the element as soon as it
+      // is stored so the loads of the other half stay outstanding meanwhile
       for (int j = 0; j < (BYTES_PER_THREAD/ALIGNMENT); j++)
+        bulk_buffer[j] = ptx_cudaDMA_load<LOCAL_TYPENAME,DMA_GLOBAL_LOAD,DMA_LOAD_QUAL>(
+                                          (LOCAL_TYPENAME*)(src_ptr + j*intra_elmt_stride));
+      src_ptr += ((BYTES_PER_THREAD/ALIGNMENT)*intra_elmt_stride);
+      for (int i = 0; i < DMA_MAX_ITERS; i++)
       {
-        bulk_buffer[j] = ptx_cudaDMA_load<LOCAL_TYPENAME,DMA_GLOBAL_LOAD,DMA_LOAD_QUAL>((LOCAL_TYPENAME*)src_ptr);
-        src_ptr += intra_elmt_stride;
+        for (int j = 0; j < PIPE_LOWER_LDS_BIG; j++)
+          ptx_cudaDMA_store<LOCAL_TYPENAME,DMA_STORE_QUAL>(bulk_buffer[j],
+                                          (LOCAL_TYPENAME*)(dst_ptr + j*intra_elmt_stride));
+        const int lower_loads = (i < (DMA_MAX_ITERS-1)) ? PIPE_LOWER_LDS_BIG :
+                                (DMA_PARTIAL_ITERS <= PIPE_LOWER_LDS_BIG) ? DMA_PARTIAL_ITERS : 0;
+        for (int j = 0; j < lower_loads; j++)
+          bulk_buffer[j] = ptx_cudaDMA_load<LOCAL_TYPENAME,DMA_GLOBAL_LOAD,DMA_LOAD_QUAL>(
+                                          (LOCAL_TYPENAME*)(src_ptr + j*intra_elmt_stride));
+        for (int j = PIPE_LOWER_LDS_BIG; j < (BYTES_PER_THREAD/ALIGNMENT); j++)
+          ptx_cudaDMA_store<LOCAL_TYPENAME,DMA_STORE_QUAL>(bulk_buffer[j],
+                                          (LOCAL_TYPENAME*)(dst_ptr + j*intra_elmt_stride));
+        if (i < (DMA_MAX_ITERS-1))
+        {
+          for (int j = PIPE_LOWER_LDS_BIG; j < (BYTES_PER_THREAD/ALIGNMENT); j++)
+            bulk_buffer[j] = ptx_cudaDMA_load<LOCAL_TYPENAME,DMA_GLOBAL_LOAD,DMA_LOAD_QUAL>(
+                                          (LOCAL_TYPENAME*)(src_ptr + j*intra_elmt_stride));
+          src_ptr += ((BYTES_PER_THREAD/ALIGNMENT)*intra_elmt_stride);
+        }
+        dst_ptr += ((BYTES_PER_THREAD/ALIGNMENT)*intra_elmt_stride);
       }
-      for (int j = 0; j < (BYTES_PER_THREAD/ALIGNMENT); j++)
+      if (DMA_PARTIAL_ITERS > PIPE_LOWER_LDS_BIG)
+      {
+        for (int j = 0; j < DMA_PARTIAL_ITERS; j++)
+          bulk_buffer[j] = ptx_cudaDMA_load<LOCAL_TYPENAME,DMA_GLOBAL_LOAD,DMA_LOAD_QUAL>(
+                                          (LOCAL_TYPENAME*)(src_ptr + j*intra_elmt_stride));
+      }
+      src_ptr += (DMA_PARTIAL_ITERS * intra_elmt_stride);
+      for (int j = 0; j < DMA_PARTIAL_ITERS; j++)
       {
         ptx_cudaDMA_store<LOCAL_TYPENAME,DMA_STORE_QUAL>(bulk_buffer[j], (LOCAL_TYPENAME*)dst_ptr);
         dst_ptr += intra_elmt_stride;
       }
     }
-    if (DMA_PARTIAL_ITERS > 0)
+    else
     {
-      for (int i = 0; i < DMA_PARTIAL_ITERS; i++)
+      for (int i = 0; i < DMA_MAX_ITERS; i++)
       {
-        bulk_buffer[i] = ptx_cudaDMA_load<LOCAL_TYPENAME,DMA_GLOBAL_LOAD,DMA_LOAD_QUAL>((LOCAL_TYPENAME*)src_ptr);
-        src_ptr += intra_elmt_stride;
+        for (int j = 0; j < (BYTES_PER_THREAD/ALIGNMENT); j++)
+        {
+          bulk_buffer[j] = ptx_cudaDMA_load<LOCAL_TYPENAME,DMA_GLOBAL_LOAD,DMA_LOAD_QUAL>((LOCAL_TYPENAME*)src_ptr);
+          src_ptr += intra_elmt_stride;
+        }
+        for (int j = 0; j < (BYTES_PER_THREAD/ALIGNMENT); j++)
+        {
+          ptx_cudaDMA_store<LOCAL_TYPENAME,DMA_STORE_QUAL>(bulk_buffer[j], (LOCAL_TYPENAME*)dst_ptr);
+          dst_ptr += intra_elmt_stride;
+        }
       }
-      for (int i = 0; i < DMA_PARTIAL_ITERS; i++)
+      if (DMA_PARTIAL_ITERS > 0)
       {
-        ptx_cudaDMA_store<LOCAL_TYPENAME,DMA_STORE_QUAL>(bulk_buffer[i], (LOCAL_TYPENAME*)dst_ptr);
-        dst_ptr += intra_elmt_stride;
+        for (int i = 0; i < DMA_PARTIAL_ITERS; i++)
+        {
+          bulk_buffer[i] = ptx_cudaDMA_load<LOCAL_TYPENAME,DMA_GLOBAL_LOAD,DMA_LOAD_QUAL>((LOCAL_TYPENAME*)src_ptr);
+          src_ptr += intra_elmt_stride;
+        }
+        for (int i = 0; i < DMA_PARTIAL_ITERS; i++)
+        {
+          ptx_cudaDMA_store<LOCAL_TYPENAME,DMA_STORE_QUAL>(bulk_buffer[i], (LOCAL_TYPENAME*)dst_ptr);
+          dst_ptr += intra_elmt_stride;
+        }
       }
     }
     if (DMA_PARTIAL_BYTES)
@@ -14197,7 +15639,7 @@ private:
   STORE_8_PARTIAL_BYTES_IMPL
 private:
   const char *dma_src_off_ptr;
-  const int *dma_index_ptr;
+  const INDEX_TYPE *dma_index_ptr;
   const unsigned int dma_index_offset;
   const unsigned int dma_index_step_stride;
   const unsigned int dma_index_elmt_stride;
@@ -14219,9 +15661,10 @@ private:
 
 #define LOCAL_TYPENAME float4
 #define ALIGNMENT 16 
-template<bool GATHER, int BYTES_PER_THREAD, int BYTES_PER_ELMT, int DMA_THREADS, int NUM_ELMTS>
-class CudaDMAIndirect<GATHER,true,ALIGNMENT,BYTES_PER_THREAD,BYTES_PER_ELMT,DMA_THREADS,NUM_ELMTS> : public CudaDMA {
+template<bool GATHER, int BYTES_PER_THREAD, int BYTES_PER_ELMT, int DMA_THREADS, int NUM_ELMTS, typename INDEX_TYPE>
+class CudaDMAIndirect<GATHER,true,ALIGNMENT,BYTES_PER_THREAD,BYTES_PER_ELMT,DMA_THREADS,NUM_ELMTS,INDEX_TYPE> : public CudaDMA {
 public:
+  typedef CudaDMAIndirectPlan<GATHER,ALIGNMENT,BYTES_PER_THREAD,BYTES_PER_ELMT,DMA_THREADS,NUM_ELMTS> Plan;
   __device__ CudaDMAIndirect(const int dmaID,
                              const int num_compute_threads,
                              const int dma_threadIdx_start,
@@ -14257,38 +15700,84 @@ private:
   {
     if (GATHER)
     {
-      const int offset = this->dma_index_ptr[index_offset];
+      const INDEX_OFFSET_TYPE offset = this->dma_index_ptr[index_offset];
       src_ptr += (offset * BYTES_PER_ELMT);
     }
     else
     {
-      const int offset = this->dma_index_ptr[index_offset];
+      const INDEX_OFFSET_TYPE offset = this->dma_index_ptr[index_offset];
       dst_ptr += (offset * BYTES_PER_ELMT);
     }
-    for (int i = 0; i < DMA_MAX_ITERS; i++)
+    if (PIPE_STEPS_BIG(DMA_MAX_ITERS,DMA_PARTIAL_ITERS))
     {
+      // Refill each half with the next step of the element as soon as it
+      // is stored so the loads of the other half stay outstanding meanwhile
       for (int j = 0; j < (BYTES_PER_THREAD/ALIGNMENT); j++)
+        bulk_buffer[j] = ptx_cudaDMA_load<LOCAL_TYPENAME,DMA_GLOBAL_LOAD,DMA_LOAD_QUAL>(
+                                          (LOCAL_TYPENAME*)(src_ptr + j*intra_elmt_stride));
+      src_ptr += ((BYTES_PER_THREAD/ALIGNMENT)*intra_elmt_stride);
+      for (int i = 0; i < DMA_MAX_ITERS; i++)
       {
-        bulk_buffer[j] = ptx_cudaDMA_load<LOCAL_TYPENAME,DMA_GLOBAL_LOAD,DMA_LOAD_QUAL>((LOCAL_TYPENAME*)src_ptr);
-        src_ptr += intra_elmt_stride;
+        for (int j = 0; j < PIPE_LOWER_LDS_BIG; j++)
+          ptx_cudaDMA_store<LOCAL_TYPENAME,DMA_STORE_QUAL>(bulk_buffer[j],
+                                          (LOCAL_TYPENAME*)(dst_ptr + j*intra_elmt_stride));
+        const int lower_loads = (i < (DMA_MAX_ITERS-1)) ? PIPE_LOWER_LDS_BIG :
+                                (DMA_PARTIAL_ITERS <= PIPE_LOWER_LDS_BIG) ? DMA_PARTIAL_ITERS : 0;
+        for (int j = 0; j < lower_loads; j++)
+          bulk_buffer[j] = ptx_cudaDMA_load<LOCAL_TYPENAME,DMA_GLOBAL_LOAD,DMA_LOAD_QUAL>(
+                                          (LOCAL_TYPENAME*)(src_ptr + j*intra_elmt_stride));
+        for (int j = PIPE_LOWER_LDS_BIG; j < (BYTES_PER_THREAD/ALIGNMENT); j++)
+          ptx_cudaDMA_store<LOCAL_TYPENAME,DMA_STORE_QUAL>(bulk_buffer[j],
+                                          (LOCAL_TYPENAME*)(dst_ptr + j*intra_elmt_stride));
+        if (i < (DMA_MAX_ITERS-1))
+        {
+          for (int j = PIPE_LOWER_LDS_BIG; j < (BYTES_PER_THREAD/ALIGNMENT); j++)
+            bulk_buffer[j] = ptx_cudaDMA_load<LOCAL_TYPENAME,DMA_GLOBAL_LOAD,DMA_LOAD_QUAL>(
+                                          (LOCAL_TYPENAME*)(src_ptr + j*intra_elmt_stride));
+          src_ptr += ((BYTES_PER_THREAD/ALIGNMENT)*intra_elmt_stride);
+        }
+        dst_ptr += ((BYTES_PER_THREAD/ALIGNMENT)*intra_elmt_stride);
       }
-      for (int j = 0; j < (BYTES_PER_THREAD/ALIGNMENT); j++)
+      if (DMA_PARTIAL_ITERS > PIPE_LOWER_LDS_BIG)
+      {
+        for (int j = 0; j < DMA_PARTIAL_ITERS; j++)
+          bulk_buffer[j] = ptx_cudaDMA_load<LOCAL_TYPENAME,DMA_GLOBAL_LOAD,DMA_LOAD_QUAL>(
+                                          (LOCAL_TYPENAME*)(src_ptr + j*intra_elmt_stride));
+      }
+      src_ptr += (DMA_PARTIAL_ITERS * intra_elmt_stride);
+      for (int j = 0; j < DMA_PARTIAL_ITERS; j++)
       {
         ptx_cudaDMA_store<LOCAL_TYPENAME,DMA_STORE_QUAL>(bulk_buffer[j], (LOCAL_TYPENAME*)dst_ptr);
         dst_ptr += intra_elmt_stride;
       }
     }
-    if (DMA_PARTIAL_ITERS > 0)
+    else
     {
-      for (int i = 0; i < DMA_PARTIAL_ITERS; i++)
+      for (int i = 0; i < DMA_MAX_ITERS; i++)
       {
-        bulk_buffer[i] = ptx_cudaDMA_load<LOCAL_TYPENAME,DMA_GLOBAL_LOAD,DMA_LOAD_QUAL>((LOCAL_TYPENAME*)src_ptr);
-        src_ptr += intra_elmt_stride;
+        for (int j = 0; j < (BYTES_PER_THREAD/ALIGNMENT); j++)
+        {
+          bulk_buffer[j] = ptx_cudaDMA_load<LOCAL_TYPENAME,DMA_GLOBAL_LOAD,DMA_LOAD_QUAL>((LOCAL_TYPENAME*)src_ptr);
+          src_ptr += intra_elmt_stride;
+        }
+        for (int j = 0; j < (BYTES_PER_THREAD/ALIGNMENT); j++)
+        {
+          ptx_cudaDMA_store<LOCAL_TYPENAME,DMA_STORE_QUAL>(bulk_buffer[j], (LOCAL_TYPENAME*)dst_ptr);
+          dst_ptr += intra_elmt_stride;
+        }
       }
-      for (int i = 0; i < DMA_PARTIAL_ITERS; i++)
+      if (DMA_PARTIAL_ITERS > 0)
       {
-        ptx_cudaDMA_store<LOCAL_TYPENAME,DMA_STORE_QUAL>(bulk_buffer[i], (LOCAL_TYPENAME*)dst_ptr);
-        dst_ptr += intra_elmt_stride;
+        for (int i = 0; i < DMA_PARTIAL_ITERS; i++)
+        {
+          bulk_buffer[i] = ptx_cudaDMA_load<LOCAL_TYPENAME,DMA_GLOBAL_LOAD,DMA_LOAD_QUAL>((LOCAL_TYPENAME*)src_ptr);
+          src_ptr += intra_elmt_stride;
+        }
+        for (int i = 0; i < DMA_PARTIAL_ITERS; i++)
+        {
+          ptx_cudaDMA_store<LOCAL_TYPENAME,DMA_STORE_QUAL>(bulk_buffer[i], (LOCAL_TYPENAME*)dst_ptr);
+          dst_ptr += intra_elmt_stride;
+        }
       }
     }
     if (DMA_PARTIAL_BYTES)
@@ -14333,7 +15822,7 @@ private:
   STORE_16_PARTIAL_BYTES_IMPL
 private:
   const char *dma_src_off_ptr;
-  const int *dma_index_ptr;
+  const INDEX_TYPE *dma_index_ptr;
   const unsigned int dma_index_offset;
   const unsigned int dma_index_step_stride;
   const unsigned int dma_index_elmt_stride;
@@ -14356,9 +15845,10 @@ private:
 // four template, non-warp-specialized
 #define LOCAL_TYPENAME float
 #define ALIGNMENT 4
-template<bool GATHER, int BYTES_PER_THREAD, int BYTES_PER_ELMT, int DMA_THREADS, int NUM_ELMTS>
-class CudaDMAIndirect<GATHER,false,ALIGNMENT,BYTES_PER_THREAD,BYTES_PER_ELMT,DMA_THREADS,NUM_ELMTS> : public CudaDMA {
+template<bool GATHER, int BYTES_PER_THREAD, int BYTES_PER_ELMT, int DMA_THREADS, int NUM_ELMTS, typename INDEX_TYPE>
+class CudaDMAIndirect<GATHER,false,ALIGNMENT,BYTES_PER_THREAD,BYTES_PER_ELMT,DMA_THREADS,NUM_ELMTS,INDEX_TYPE> : public CudaDMA {
 public:
+  typedef CudaDMAIndirectPlan<GATHER,ALIGNMENT,BYTES_PER_THREAD,BYTES_PER_ELMT,DMA_THREADS,NUM_ELMTS> Plan;
   __device__ CudaDMAIndirect(const int alternate_stride = 0,
                              const int dma_threadIdx_start = 0)
     : CudaDMA(0, DMA_THREADS, DMA_THREADS, dma_threadIdx_start),
@@ -14392,38 +15882,84 @@ private:
   {
     if (GATHER)
     {
-      const int offset = this->dma_index_ptr[index_offset];
+      const INDEX_OFFSET_TYPE offset = this->dma_index_ptr[index_offset];
       src_ptr += (offset * BYTES_PER_ELMT);
     }
     else
     {
-      const int offset = this->dma_index_ptr[index_offset];
+      const INDEX_OFFSET_TYPE offset = this->dma_index_ptr[index_offset];
       dst_ptr += (offset * BYTES_PER_ELMT);
     }
-    for (int i = 0; i < DMA_MAX_ITERS; i++)
+    if (PIPE_STEPS_BIG(DMA_MAX_ITERS,DMA_PARTIAL_ITERS))
     {
+      // Refill each half with the next step of the element as soon as it
+      // is stored so the loads of the other half stay outstanding meanwhile
       for (int j = 0; j < (BYTES_PER_THREAD/ALIGNMENT); j++)
+        bulk_buffer[j] = ptx_cudaDMA_load<LOCAL_TYPENAME,DMA_GLOBAL_LOAD,DMA_LOAD_QUAL>(
+                                          (LOCAL_TYPENAME*)(src_ptr + j*intra_elmt_stride));
+      src_ptr += ((BYTES_PER_THREAD/ALIGNMENT)*intra_elmt_stride);
+      for (int i = 0; i < DMA_MAX_ITERS; i++)
       {
-        bulk_buffer[j] = ptx_cudaDMA_load<LOCAL_TYPENAME,DMA_GLOBAL_LOAD,DMA_LOAD_QUAL>((LOCAL_TYPENAME*)src_ptr);
-        src_ptr += intra_elmt_stride;
+        for (int j = 0; j < PIPE_LOWER_LDS_BIG; j++)
+          ptx_cudaDMA_store<LOCAL_TYPENAME,DMA_STORE_QUAL>(bulk_buffer[j],
+                                          (LOCAL_TYPENAME*)(dst_ptr + j*intra_elmt_stride));
+        const int lower_loads = (i < (DMA_MAX_ITERS-1)) ? PIPE_LOWER_LDS_BIG :
+                                (DMA_PARTIAL_ITERS <= PIPE_LOWER_LDS_BIG) ? DMA_PARTIAL_ITERS : 0;
+        for (int j = 0; j < lower_loads; j++)
+          bulk_buffer[j] = ptx_cudaDMA_load<LOCAL_TYPENAME,DMA_GLOBAL_LOAD,DMA_LOAD_QUAL>(
+                                          (LOCAL_TYPENAME*)(src_ptr + j*intra_elmt_stride));
+        for (int j = PIPE_LOWER_LDS_BIG; j < (BYTES_PER_THREAD/ALIGNMENT); j++)
+          ptx_cudaDMA_store<LOCAL_TYPENAME,DMA_STORE_QUAL>(bulk_buffer[j],
+                                          (LOCAL_TYPENAME*)(dst_ptr + j*intra_elmt_stride));
+        if (i < (DMA_MAX_ITERS-1))
+        {
+          for (int j = PIPE_LOWER_LDS_BIG; j < (BYTES_PER_THREAD/ALIGNMENT); j++)
+            bulk_buffer[j] = ptx_cudaDMA_load<LOCAL_TYPENAME,DMA_GLOBAL_LOAD,DMA_LOAD_QUAL>(
+                                          (LOCAL_TYPENAME*)(src_ptr + j*intra_elmt_stride));
+          src_ptr += ((BYTES_PER_THREAD/ALIGNMENT)*intra_elmt_stride);
+        }
+        dst_ptr += ((BYTES_PER_THREAD/ALIGNMENT)*intra_elmt_stride);
       }
-      for (int j = 0; j < (BYTES_PER_THREAD/ALIGNMENT); j++)
+      if (DMA_PARTIAL_ITERS > PIPE_LOWER_LDS_BIG)
+      {
+        for (int j = 0; j < DMA_PARTIAL_ITERS; j++)
+          bulk_buffer[j] = ptx_cudaDMA_load<LOCAL_TYPENAME,DMA_GLOBAL_LOAD,DMA_LOAD_QUAL>(
+                                          (LOCAL_TYPENAME*)(src_ptr + j*intra_elmt_stride));
+      }
+      src_ptr += (DMA_PARTIAL_ITERS * intra_elmt_stride);
+      for (int j = 0; j < DMA_PARTIAL_ITERS; j++)
       {
         ptx_cudaDMA_store<LOCAL_TYPENAME,DMA_STORE_QUAL>(bulk_buffer[j], (LOCAL_TYPENAME*)dst_ptr);
         dst_ptr += intra_elmt_stride;
       }
     }
-    if (DMA_PARTIAL_ITERS > 0)
+    else
     {
-      for (int i = 0; i < DMA_PARTIAL_ITERS; i++)
+      for (int i = 0; i < DMA_MAX_ITERS; i++)
       {
-        bulk_buffer[i] = ptx_cudaDMA_load<LOCAL_TYPENAME,DMA_GLOBAL_LOAD,DMA_LOAD_QUAL>((LOCAL_TYPENAME*)src_ptr);
-        src_ptr += intra_elmt_stride;
+        for (int j = 0; j < (BYTES_PER_THREAD/ALIGNMENT); j++)
+        {
+          bulk_buffer[j] = ptx_cudaDMA_load<LOCAL_TYPENAME,DMA_GLOBAL_LOAD,DMA_LOAD_QUAL>((LOCAL_TYPENAME*)src_ptr);
+          src_ptr += intra_elmt_stride;
+        }
+        for (int j = 0; j < (BYTES_PER_THREAD/ALIGNMENT); j++)
+        {
+          ptx_cudaDMA_store<LOCAL_TYPENAME,DMA_STORE_QUAL>(bulk_buffer[j], (LOCAL_TYPENAME*)dst_ptr);
+          dst_ptr += intra_elmt_stride;
+        }
       }
-      for (int i = 0; i < DMA_PARTIAL_ITERS; i++)
+      if (DMA_PARTIAL_ITERS > 0)
       {
-        ptx_cudaDMA_store<LOCAL_TYPENAME,DMA_STORE_QUAL>(bulk_buffer[i], (LOCAL_TYPENAME*)dst_ptr);
-        dst_ptr += intra_elmt_stride;
+        for (int i = 0; i < DMA_PARTIAL_ITERS; i++)
+        {
+          bulk_buffer[i] = ptx_cudaDMA_load<LOCAL_TYPENAME,DMA_GLOBAL_LOAD,DMA_LOAD_QUAL>((LOCAL_TYPENAME*)src_ptr);
+          src_ptr += intra_elmt_stride;
+        }
+        for (int i = 0; i < DMA_PARTIAL_ITERS; i++)
+        {
+          ptx_cudaDMA_store<LOCAL_TYPENAME,DMA_STORE_QUAL>(bulk_buffer[i], (LOCAL_TYPENAME*)dst_ptr);
+          dst_ptr += intra_elmt_stride;
+        }
       }
     }
     if (DMA_PARTIAL_BYTES)
@@ -14450,7 +15986,7 @@ private:
   STORE_4_PARTIAL_BYTES_IMPL
 private:
   const char *dma_src_off_ptr;
-  const int *dma_index_ptr;
+  const INDEX_TYPE *dma_index_ptr;
   const unsigned int dma_index_offset;
   const unsigned int dma_index_step_stride;
   const unsigned int dma_index_elmt_stride;
@@ -14472,9 +16008,10 @@ private:
 
 #define LOCAL_TYPENAME float2
 #define ALIGNMENT 8
-template<bool GATHER, int BYTES_PER_THREAD, int BYTES_PER_ELMT, int DMA_THREADS, int NUM_ELMTS>
-class CudaDMAIndirect<GATHER,false,ALIGNMENT,BYTES_PER_THREAD,BYTES_PER_ELMT,DMA_THREADS,NUM_ELMTS> : public CudaDMA {
+template<bool GATHER, int BYTES_PER_THREAD, int BYTES_PER_ELMT, int DMA_THREADS, int NUM_ELMTS, typename INDEX_TYPE>
+class CudaDMAIndirect<GATHER,false,ALIGNMENT,BYTES_PER_THREAD,BYTES_PER_ELMT,DMA_THREADS,NUM_ELMTS,INDEX_TYPE> : public CudaDMA {
 public:
+  typedef CudaDMAIndirectPlan<GATHER,ALIGNMENT,BYTES_PER_THREAD,BYTES_PER_ELMT,DMA_THREADS,NUM_ELMTS> Plan;
   __device__ CudaDMAIndirect(const int alternate_stride = 0,
                              const int dma_threadIdx_start = 0)
     : CudaDMA(0, DMA_THREADS, DMA_THREADS, dma_threadIdx_start),
@@ -14508,38 +16045,84 @@ private:
   {
     if (GATHER)
     {
-      const int offset = this->dma_index_ptr[index_offset];
+      const INDEX_OFFSET_TYPE offset = this->dma_index_ptr[index_offset];
       src_ptr += (offset * BYTES_PER_ELMT);
     }
     else
     {
-      const int offset = this->dma_index_ptr[index_offset];
+      const INDEX_OFFSET_TYPE offset = this->dma_index_ptr[index_offset];
       dst_ptr += (offset * BYTES_PER_ELMT);
     }
-    for (int i = 0; i < DMA_MAX_ITERS; i++)
+    if (PIPE_STEPS_BIG(DMA_MAX_ITERS,DMA_PARTIAL_ITERS))
     {
+      // Refill each half with the next step of the element as soon as it
+      // is stored so the loads of the other half stay outstanding meanwhile
       for (int j = 0; j < (BYTES_PER_THREAD/ALIGNMENT); j++)
+        bulk_buffer[j] = ptx_cudaDMA_load<LOCAL_TYPENAME,DMA_GLOBAL_LOAD,DMA_LOAD_QUAL>(
+                                          (LOCAL_TYPENAME*)(src_ptr + j*intra_elmt_stride));
+      src_ptr += ((BYTES_PER_THREAD/ALIGNMENT)*intra_elmt_stride);
+      for (int i = 0; i < DMA_MAX_ITERS; i++)
       {
-        bulk_buffer[j] = ptx_cudaDMA_load<LOCAL_TYPENAME,DMA_GLOBAL_LOAD,DMA_LOAD_QUAL>((LOCAL_TYPENAME*)src_ptr);
-        src_ptr += intra_elmt_stride;
+        for (int j = 0; j < PIPE_LOWER_LDS_BIG; j++)
+          ptx_cudaDMA_store<LOCAL_TYPENAME,DMA_STORE_QUAL>(bulk_buffer[j],
+                                          (LOCAL_TYPENAME*)(dst_ptr + j*intra_elmt_stride));
+        const int lower_loads = (i < (DMA_MAX_ITERS-1)) ? PIPE_LOWER_LDS_BIG :
+                                (DMA_PARTIAL_ITERS <= PIPE_LOWER_LDS_BIG) ? DMA_PARTIAL_ITERS : 0;
+        for (int j = 0; j < lower_loads; j++)
+          bulk_buffer[j] = ptx_cudaDMA_load<LOCAL_TYPENAME,DMA_GLOBAL_LOAD,DMA_LOAD_QUAL>(
+                                          (LOCAL_TYPENAME*)(src_ptr + j*intra_elmt_stride));
+        for (int j = PIPE_LOWER_LDS_BIG; j < (BYTES_PER_THREAD/ALIGNMENT); j++)
+          ptx_cudaDMA_store<LOCAL_TYPENAME,DMA_STORE_QUAL>(bulk_buffer[j],
+                                          (LOCAL_TYPENAME*)(dst_ptr + j*intra_elmt_stride));
+        if (i < (DMA_MAX_ITERS-1))
+        {
+          for (int j = PIPE_LOWER_LDS_BIG; j < (BYTES_PER_THREAD/ALIGNMENT); j++)
+            bulk_buffer[j] = ptx_cudaDMA_load<LOCAL_TYPENAME,DMA_GLOBAL_LOAD,DMA_LOAD_QUAL>(
+                                          (LOCAL_TYPENAME*)(src_ptr + j*intra_elmt_stride));
+          src_ptr += ((BYTES_PER_THREAD/ALIGNMENT)*intra_elmt_stride);
+        }
+        dst_ptr += ((BYTES_PER_THREAD/ALIGNMENT)*intra_elmt_stride);
       }
-      for (int j = 0; j < (BYTES_PER_THREAD/ALIGNMENT); j++)
+      if (DMA_PARTIAL_ITERS > PIPE_LOWER_LDS_BIG)
+      {
+        for (int j = 0; j < DMA_PARTIAL_ITERS; j++)
+          bulk_buffer[j] = ptx_cudaDMA_load<LOCAL_TYPENAME,DMA_GLOBAL_LOAD,DMA_LOAD_QUAL>(
+                                          (LOCAL_TYPENAME*)(src_ptr + j*intra_elmt_stride));
+      }
+      src_ptr += (DMA_PARTIAL_ITERS * intra_elmt_stride);
+      for (int j = 0; j < DMA_PARTIAL_ITERS; j++)
       {
         ptx_cudaDMA_store<LOCAL_TYPENAME,DMA_STORE_QUAL>(bulk_buffer[j], (LOCAL_TYPENAME*)dst_ptr);
         dst_ptr += intra_elmt_stride;
       }
     }
-    if (DMA_PARTIAL_ITERS > 0)
+    else
     {
-      for (int i = 0; i < DMA_PARTIAL_ITERS; i++)
+      for (int i = 0; i < DMA_MAX_ITERS; i++)
       {
-        bulk_buffer[i] = ptx_cudaDMA_load<LOCAL_TYPENAME,DMA_GLOBAL_LOAD,DMA_LOAD_QUAL>((LOCAL_TYPENAME*)src_ptr);
-        src_ptr += intra_elmt_stride;
+        for (int j = 0; j < (BYTES_PER_THREAD/ALIGNMENT); j++)
+        {
+          bulk_buffer[j] = ptx_cudaDMA_load<LOCAL_TYPENAME,DMA_GLOBAL_LOAD,DMA_LOAD_QUAL>((LOCAL_TYPENAME*)src_ptr);
+          src_ptr += intra_elmt_stride;
+        }
+        for (int j = 0; j < (BYTES_PER_THREAD/ALIGNMENT); j++)
+        {
+          ptx_cudaDMA_store<LOCAL_TYPENAME,DMA_STORE_QUAL>(bulk_buffer[j], (LOCAL_TYPENAME*)dst_ptr);
+          dst_ptr += intra_elmt_stride;
+        }
       }
-      for (int i = 0; i < DMA_PARTIAL_ITERS; i++)
+      if (DMA_PARTIAL_ITERS > 0)
       {
-        ptx_cudaDMA_store<LOCAL_TYPENAME,DMA_STORE_QUAL>(bulk_buffer[i], (LOCAL_TYPENAME*)dst_ptr);
-        dst_ptr += intra_elmt_stride;
+        for (int i = 0; i < DMA_PARTIAL_ITERS; i++)
+        {
+          bulk_buffer[i] = ptx_cudaDMA_load<LOCAL_TYPENAME,DMA_GLOBAL_LOAD,DMA_LOAD_QUAL>((LOCAL_TYPENAME*)src_ptr);
+          src_ptr += intra_elmt_stride;
+        }
+        for (int i = 0; i < DMA_PARTIAL_ITERS; i++)
+        {
+          ptx_cudaDMA_store<LOCAL_TYPENAME,DMA_STORE_QUAL>(bulk_buffer[i], (LOCAL_TYPENAME*)dst_ptr);
+          dst_ptr += intra_elmt_stride;
+        }
       }
     }
     if (DMA_PARTIAL_BYTES)
@@ -14572,7 +16155,7 @@ private:
   STORE_8_PARTIAL_BYTES_IMPL
 private:
   const char *dma_src_off_ptr;
-  const int *dma_index_ptr;
+  const INDEX_TYPE *dma_index_ptr;
   const unsigned int dma_index_offset;
   const unsigned int dma_index_step_stride;
   const unsigned int dma_index_elmt_stride;
@@ -14594,9 +16177,10 @@ private:
 
 #define LOCAL_TYPENAME float4
 #define ALIGNMENT 16 
-template<bool GATHER, int BYTES_PER_THREAD, int BYTES_PER_ELMT, int DMA_THREADS, int NUM_ELMTS>
-class CudaDMAIndirect<GATHER,false,ALIGNMENT,BYTES_PER_THREAD,BYTES_PER_ELMT,DMA_THREADS,NUM_ELMTS> : public CudaDMA {
+template<bool GATHER, int BYTES_PER_THREAD, int BYTES_PER_ELMT, int DMA_THREADS, int NUM_ELMTS, typename INDEX_TYPE>
+class CudaDMAIndirect<GATHER,false,ALIGNMENT,BYTES_PER_THREAD,BYTES_PER_ELMT,DMA_THREADS,NUM_ELMTS,INDEX_TYPE> : public CudaDMA {
 public:
+  typedef CudaDMAIndirectPlan<GATHER,ALIGNMENT,BYTES_PER_THREAD,BYTES_PER_ELMT,DMA_THREADS,NUM_ELMTS> Plan;
   __device__ CudaDMAIndirect(const int alternate_stride = 0,
                              const int dma_threadIdx_start = 0)
     : CudaDMA(0, DMA_THREADS, DMA_THREADS, dma_threadIdx_start),
@@ -14630,38 +16214,84 @@ private:
   {
     if (GATHER)
     {
-      const int offset = this->dma_index_ptr[index_offset];
+      const INDEX_OFFSET_TYPE offset = this->dma_index_ptr[index_offset];
       src_ptr += (offset * BYTES_PER_ELMT);
     }
     else
     {
-      const int offset = this->dma_index_ptr[index_offset];
+      const INDEX_OFFSET_TYPE offset = this->dma_index_ptr[index_offset];
       dst_ptr += (offset * BYTES_PER_ELMT);
     }
-    for (int i = 0; i < DMA_MAX_ITERS; i++)
+    if (PIPE_STEPS_BIG(DMA_MAX_ITERS,DMA_PARTIAL_ITERS))
     {
+      // Refill each half with the next step of the element as soon as it
+      // is stored so the loads of the other half stay outstanding meanwhile
       for (int j = 0; j < (BYTES_PER_THREAD/ALIGNMENT); j++)
+        bulk_buffer[j] = ptx_cudaDMA_load<LOCAL_TYPENAME,DMA_GLOBAL_LOAD,DMA_LOAD_QUAL>(
+                                          (LOCAL_TYPENAME*)(src_ptr + j*intra_elmt_stride));
+      src_ptr += ((BYTES_PER_THREAD/ALIGNMENT)*intra_elmt_stride);
+      for (int i = 0; i < DMA_MAX_ITERS; i++)
       {
-        bulk_buffer[j] = ptx_cudaDMA_load<LOCAL_TYPENAME,DMA_GLOBAL_LOAD,DMA_LOAD_QUAL>((LOCAL_TYPENAME*)src_ptr);
-        src_ptr += intra_elmt_stride;
+        for (int j = 0; j < PIPE_LOWER_LDS_BIG; j++)
+          ptx_cudaDMA_store<LOCAL_TYPENAME,DMA_STORE_QUAL>(bulk_buffer[j],
+                                          (LOCAL_TYPENAME*)(dst_ptr + j*intra_elmt_stride));
+        const int lower_loads = (i < (DMA_MAX_ITERS-1)) ? PIPE_LOWER_LDS_BIG :
+                                (DMA_PARTIAL_ITERS <= PIPE_LOWER_LDS_BIG) ? DMA_PARTIAL_ITERS : 0;
+        for (int j = 0; j < lower_loads; j++)
+          bulk_buffer[j] = ptx_cudaDMA_load<LOCAL_TYPENAME,DMA_GLOBAL_LOAD,DMA_LOAD_QUAL>(
+                                          (LOCAL_TYPENAME*)(src_ptr + j*intra_elmt_stride));
+        for (int j = PIPE_LOWER_LDS_BIG; j < (BYTES_PER_THREAD/ALIGNMENT); j++)
+          ptx_cudaDMA_store<LOCAL_TYPENAME,DMA_STORE_QUAL>(bulk_buffer[j],
+                                          (LOCAL_TYPENAME*)(dst_ptr + j*intra_elmt_stride));
+        if (i < (DMA_MAX_ITERS-1))
+        {
+          for (int j = PIPE_LOWER_LDS_BIG; j < (BYTES_PER_THREAD/ALIGNMENT); j++)
+            bulk_buffer[j] = ptx_cudaDMA_load<LOCAL_TYPENAME,DMA_GLOBAL_LOAD,DMA_LOAD_QUAL>(
+                                          (LOCAL_TYPENAME*)(src_ptr + j*intra_elmt_stride));
+          src_ptr += ((BYTES_PER_THREAD/ALIGNMENT)*intra_elmt_stride);
+        }
+        dst_ptr += ((BYTES_PER_THREAD/ALIGNMENT)*intra_elmt_stride);
       }
-      for (int j = 0; j < (BYTES_PER_THREAD/ALIGNMENT); j++)
+      if (DMA_PARTIAL_ITERS > PIPE_LOWER_LDS_BIG)
+      {
+        for (int j = 0; j < DMA_PARTIAL_ITERS; j++)
+          bulk_buffer[j] = ptx_cudaDMA_load<LOCAL_TYPENAME,DMA_GLOBAL_LOAD,DMA_LOAD_QUAL>(
+                                          (LOCAL_TYPENAME*)(src_ptr + j*intra_elmt_stride));
+      }
+      src_ptr += (DMA_PARTIAL_ITERS * intra_elmt_stride);
+      for (int j = 0; j < DMA_PARTIAL_ITERS; j++)
       {
         ptx_cudaDMA_store<LOCAL_TYPENAME,DMA_STORE_QUAL>(bulk_buffer[j], (LOCAL_TYPENAME*)dst_ptr);
         dst_ptr += intra_elmt_stride;
       }
     }
-    if (DMA_PARTIAL_ITERS > 0)
+    else
     {
-      for (int i = 0; i < DMA_PARTIAL_ITERS; i++)
+      for (int i = 0; i < DMA_MAX_ITERS; i++)
       {
-        bulk_buffer[i] = ptx_cudaDMA_load<LOCAL_TYPENAME,DMA_GLOBAL_LOAD,DMA_LOAD_QUAL>((LOCAL_TYPENAME*)src_ptr);
-        src_ptr += intra_elmt_stride;
+        for (int j = 0; j < (BYTES_PER_THREAD/ALIGNMENT); j++)
+        {
+          bulk_buffer[j] = ptx_cudaDMA_load<LOCAL_TYPENAME,DMA_GLOBAL_LOAD,DMA_LOAD_QUAL>((LOCAL_TYPENAME*)src_ptr);
+          src_ptr += intra_elmt_stride;
+        }
+        for (int j = 0; j < (BYTES_PER_THREAD/ALIGNMENT); j++)
+        {
+          ptx_cudaDMA_store<LOCAL_TYPENAME,DMA_STORE_QUAL>(bulk_buffer[j], (LOCAL_TYPENAME*)dst_ptr);
+          dst_ptr += intra_elmt_stride;
+        }
       }
-      for (int i = 0; i < DMA_PARTIAL_ITERS; i++)
+      if (DMA_PARTIAL_ITERS > 0)
       {
-        ptx_cudaDMA_store<LOCAL_TYPENAME,DMA_STORE_QUAL>(bulk_buffer[i], (LOCAL_TYPENAME*)dst_ptr);
-        dst_ptr += intra_elmt_stride;
+        for (int i = 0; i < DMA_PARTIAL_ITERS; i++)
+        {
+          bulk_buffer[i] = ptx_cudaDMA_load<LOCAL_TYPENAME,DMA_GLOBAL_LOAD,DMA_LOAD_QUAL>((LOCAL_TYPENAME*)src_ptr);
+          src_ptr += intra_elmt_stride;
+        }
+        for (int i = 0; i < DMA_PARTIAL_ITERS; i++)
+        {
+          ptx_cudaDMA_store<LOCAL_TYPENAME,DMA_STORE_QUAL>(bulk_buffer[i], (LOCAL_TYPENAME*)dst_ptr);
+          dst_ptr += intra_elmt_stride;
+        }
       }
     }
     if (DMA_PARTIAL_BYTES)
@@ -14706,7 +16336,7 @@ private:
   STORE_16_PARTIAL_BYTES_IMPL
 private:
   const char *dma_src_off_ptr;
-  const int *dma_index_ptr;
+  const INDEX_TYPE *dma_index_ptr;
   const unsigned int dma_index_offset;
   const unsigned int dma_index_step_stride;
   const unsigned int dma_index_elmt_stride;
@@ -14749,6 +16379,7 @@ private:
 #undef INIT_INDIRECT_STEP_STRIDE
 #undef INIT_INDIRECT_ELMT_STRIDE
 #undef SELECT_STRIDE
+#undef INDEX_OFFSET_TYPE
 
 #undef MAX_LDS_PER_THREAD
 #undef LDS_PER_ELMT
@@ -14769,6 +16400,9 @@ private:
 #undef REMAINING_BYTES_BIG
 #undef HAS_PARTIAL_BYTES_BIG
 #undef STEP_ITERS_BIG
+#undef PIPE_LOWER_LDS_BIG
+#undef PIPE_UPPER_LDS_BIG
+#undef PIPE_STEPS_BIG
 #undef SINGLE_WARP
 #undef MINIMUM_COVER
 #undef MAX_WARPS_PER_ELMT
@@ -14839,8 +16473,3309 @@ private:
 #undef INIT_PARTIAL_BYTES
 #undef INIT_PARTIAL_ELMTS
 #undef INIT_PARTIAL_OFFSET
+#undef STRIDED_ANALYZE_IMPL
 ////////////////////////  End of CudaDMAIndirect    //////////////////////////////////////////////////
 
+//////////////////////////////////////////////////////////////////////////////////////////////////
+// CudaDMAHalo
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * CudaDMAHalo will transfer the ring of cells around a 2D tile that is already
+ * resident in shared memory, i.e. the RADIUS rows above and below the tile and
+ * the RADIUS columns to its left and right, without reloading the tile itself.
+ * DO_SYNC - is warp-specialized or not
+ * ALIGNMENT - guaranteed alignment of the tile origin, the row size and the pitches
+ * BYTES_PER_THREAD - maximum number of bytes that can be used for buffering inside the instance
+ * BYTES_PER_ELMT - the size of a cell of the tile (e.g. 4 for float)
+ * RADIUS - the width of the ring in cells
+ * CORNERS - whether the RADIUS x RADIUS corners of the ring are also transferred
+ *
+ * The source and destination pointers passed to the transfer methods point to the
+ * origin (the first cell) of the tile, and the ring is located with the row pitches
+ * passed to the constructor.  The ring is split into chunks that are assigned to DMA
+ * threads round robin, so consecutive threads move consecutive chunks of a row.  Each
+ * thread loads at most BYTES_PER_THREAD bytes in a step before storing them, which
+ * bounds the registers used for buffering.  Rows are moved with ALIGNMENT loads and
+ * the sides with the largest loads that divide RADIUS*BYTES_PER_ELMT, which must be a
+ * multiple of 4 bytes.  When CORNERS is set the rows start on a side, so they are
+ * moved with the same loads as the sides.  The rows of the ring, corners included,
+ * must be at least one load long; an empty tile is rejected by an assert.
+ */
+// Bytes in a side of the ring and the loads used to move them
+#define HALO_SIDE_BYTES (RADIUS*BYTES_PER_ELMT)
+#define HALO_SIDE_ALIGNMENT (((ALIGNMENT >= 16) && ((HALO_SIDE_BYTES%16) == 0)) ? 16 :              \
+                             ((ALIGNMENT >= 8) && ((HALO_SIDE_BYTES%8) == 0)) ? 8 : 4)
+#define HALO_SIDE_CHUNKS (HALO_SIDE_BYTES/HALO_SIDE_ALIGNMENT)
+// With corners the rows start and end on a side
+#define HALO_CORNER_BYTES (CORNERS ? HALO_SIDE_BYTES : 0)
+#define HALO_ROW_ALIGNMENT (CORNERS ? HALO_SIDE_ALIGNMENT : ALIGNMENT)
+// Loads issued by each thread per step
+#define HALO_LDS (BYTES_PER_THREAD/HALO_ROW_ALIGNMENT)
+
+namespace CudaDMAMeta {
+  // Chunks in a row of a tile.  The round robin cursors divide by it, so
+  // a row has to be at least one chunk long.
+  __device__ __forceinline__
+  int row_chunks(const int row_size, const int chunk_size)
+  {
+#ifdef DEBUG_CUDADMA
+    assert(row_size >= chunk_size);
+#endif
+    return (row_size/chunk_size);
+  }
+
+  // Position of a DMA thread in a tile: the chunk of the whole transfer and
+  // its column, row and slice.  Unsliced tiles leave the slice at zero.
+  struct TileCursor {
+    int unit;
+    int col;
+    int row;
+    int slice;
+  };
+
+  // Round robin walk of the chunks of a tile shared by the tile patterns, which
+  // only describe how a cursor maps to an address.  Every thread starts at the
+  // chunk of its own index and advances by the number of DMA threads, updating
+  // the column, row and slice of its cursor incrementally to avoid divisions.
+  // The transfer has num_rows rows of row_chunks chunks followed by extra_units
+  // chunks that the pattern places itself.  SLICED walks wrap every slice_rows
+  // rows into the next slice.
+  template<bool SLICED = false>
+  struct TileWalk {
+  public:
+    __device__ TileWalk(const int tid, const int num_threads, const int chunks,
+                        const int num_rows, const int extra_units = 0,
+                        const int rows_per_slice = 1)
+      : threads(num_threads),
+        row_chunks(chunks),
+        slice_rows(rows_per_slice),
+        total_units(chunks*num_rows + extra_units),
+        col_step(num_threads%chunks),
+        row_step(SLICED ? ((num_threads/chunks)%rows_per_slice) : (num_threads/chunks)),
+        slice_step(SLICED ? (num_threads/(chunks*rows_per_slice)) : 0),
+        start_unit(tid),
+        start_col(tid%chunks),
+        start_row(SLICED ? ((tid/chunks)%rows_per_slice) : (tid/chunks)),
+        start_slice(SLICED ? (tid/(chunks*rows_per_slice)) : 0) { }
+  public:
+    __device__ __forceinline__ TileCursor start(void) const
+    {
+      TileCursor cursor;
+      cursor.unit = start_unit;
+      cursor.col = start_col;
+      cursor.row = start_row;
+      cursor.slice = start_slice;
+      return cursor;
+    }
+    __device__ __forceinline__ bool valid(const TileCursor &cursor) const
+    {
+      return (cursor.unit < total_units);
+    }
+    // Move the cursor to the next chunk of this thread
+    __device__ __forceinline__ void advance(TileCursor &cursor) const
+    {
+      cursor.unit += threads;
+      cursor.col += col_step;
+      cursor.row += row_step;
+      if (cursor.col >= row_chunks)
+      {
+        cursor.col -= row_chunks;
+        cursor.row++;
+      }
+      if (SLICED)
+      {
+        cursor.slice += slice_step;
+        if (cursor.row >= slice_rows)
+        {
+          cursor.row -= slice_rows;
+          cursor.slice++;
+        }
+      }
+    }
+  public:
+    const int threads;
+    const int row_chunks;
+    const int slice_rows;
+    const int total_units;
+  private:
+    const int col_step;
+    const int row_step;
+    const int slice_step;
+    const int start_unit;
+    const int start_col;
+    const int start_row;
+    const int start_slice;
+  };
+}
+
+// Wait phase of the tile patterns: store the chunks loaded by the start phase,
+// then keep loading and storing a step at a time until the walk leaves the
+// tile.  The pattern provides load_step, store_step, dma_walk and dma_src_ptr.
+#define TILE_WAIT_XFER_IMPL                                                                         \
+  template<bool DMA_GLOBAL_LOAD, int DMA_LOAD_QUAL, int DMA_STORE_QUAL>                             \
+  __device__ __forceinline__ void execute_wait_xfer(void *RESTRICT dst_ptr)                         \
+  {                                                                                                 \
+    CudaDMAMeta::TileCursor cursor = dma_walk.start();                                              \
+    store_step<DMA_STORE_QUAL>((char*)dst_ptr, cursor);                                             \
+    while (dma_walk.valid(cursor))                                                                  \
+    {                                                                                               \
+      load_step<DMA_GLOBAL_LOAD,DMA_LOAD_QUAL>(dma_src_ptr, cursor);                                \
+      store_step<DMA_STORE_QUAL>((char*)dst_ptr, cursor);                                           \
+    }                                                                                               \
+  }
+
+// Every thread walks the chunks of the ring starting at its own index and
+// advancing by the number of DMA threads: first the 2*RADIUS rows (top then
+// bottom) in chunks of HALO_ROW_ALIGNMENT bytes, then the 2*num_rows sides
+// (left and right of each row) in chunks of HALO_SIDE_ALIGNMENT bytes, which
+// the walk counts as extra units after the rows.
+#define HALO_INIT(_tid,_threads)                                                                    \
+      dma_row_bytes(row_bytes),                                                                     \
+      dma_num_rows(num_rows),                                                                       \
+      dma_src_pitch(src_pitch),                                                                     \
+      dma_dst_pitch(dst_pitch),                                                                     \
+      dma_walk(_tid, _threads, CudaDMAMeta::row_chunks(row_bytes + 2*HALO_CORNER_BYTES,             \
+                                                       HALO_ROW_ALIGNMENT),                         \
+               2*RADIUS, 2*num_rows*HALO_SIDE_CHUNKS),                                              \
+      dma_row_units(2*RADIUS*dma_walk.row_chunks)
+
+#define HALO_STATIC_ASSERTS                                                                         \
+    STATIC_ASSERT((ALIGNMENT == 4) || (ALIGNMENT == 8) || (ALIGNMENT == 16));                       \
+    STATIC_ASSERT((BYTES_PER_THREAD/HALO_ROW_ALIGNMENT) > 0);                                       \
+    STATIC_ASSERT((BYTES_PER_THREAD%ALIGNMENT) == 0);                                               \
+    STATIC_ASSERT(RADIUS > 0);                                                                      \
+    STATIC_ASSERT((HALO_SIDE_BYTES%4) == 0)
+
+#define HALO_TRANSFER_IMPL                                                                          \
+  typedef typename CudaDMAMeta::VectorType<HALO_ROW_ALIGNMENT>::type RowType;                       \
+  typedef typename CudaDMAMeta::VectorType<HALO_SIDE_ALIGNMENT>::type SideType;                     \
+  /* Byte offset of the chunk at the cursor from the tile origin */                                 \
+  __device__ __forceinline__ int chunk_offset(const CudaDMAMeta::TileCursor &cursor,                \
+                                              const int pitch) const                                \
+  {                                                                                                 \
+    if (cursor.unit < dma_row_units)                                                                \
+    {                                                                                               \
+      const int line = (cursor.row < RADIUS) ? (cursor.row - RADIUS) :                              \
+                                               (dma_num_rows + cursor.row - RADIUS);                \
+      return (line*pitch + cursor.col*HALO_ROW_ALIGNMENT - HALO_CORNER_BYTES);                      \
+    }                                                                                               \
+    const int side = cursor.unit - dma_row_units;                                                   \
+    const int segment = side/HALO_SIDE_CHUNKS;                                                      \
+    const int part = side - segment*HALO_SIDE_CHUNKS;                                               \
+    return ((segment >> 1)*pitch + part*HALO_SIDE_ALIGNMENT +                                       \
+            ((segment & 1) ? dma_row_bytes : -HALO_SIDE_BYTES));                                    \
+  }                                                                                                 \
+  template<bool DMA_GLOBAL_LOAD, int DMA_LOAD_QUAL>                                                 \
+  __device__ __forceinline__ void load_step(const char *RESTRICT src_ptr,                           \
+                                            CudaDMAMeta::TileCursor cursor)                         \
+  {                                                                                                 \
+    for (int i = 0; i < HALO_LDS; i++)                                                              \
+    {                                                                                               \
+      if (dma_walk.valid(cursor))                                                                   \
+      {                                                                                             \
+        const char *ptr = src_ptr + chunk_offset(cursor, dma_src_pitch);                            \
+        if (cursor.unit < dma_row_units)                                                            \
+          bulk_buffer[i] =                                                                          \
+              ptx_cudaDMA_load<RowType,DMA_GLOBAL_LOAD,DMA_LOAD_QUAL>((const RowType*)ptr);         \
+        else                                                                                        \
+          CudaDMAMeta::pack(bulk_buffer[i],                                                         \
+              ptx_cudaDMA_load<SideType,DMA_GLOBAL_LOAD,DMA_LOAD_QUAL>((const SideType*)ptr));      \
+      }                                                                                             \
+      dma_walk.advance(cursor);                                                                     \
+    }                                                                                               \
+  }                                                                                                 \
+  template<int DMA_STORE_QUAL>                                                                      \
+  __device__ __forceinline__ void store_step(char *RESTRICT dst_ptr,                                \
+                                             CudaDMAMeta::TileCursor &cursor)                       \
+  {                                                                                                 \
+    for (int i = 0; i < HALO_LDS; i++)                                                              \
+    {                                                                                               \
+      if (dma_walk.valid(cursor))                                                                   \
+      {                                                                                             \
+        char *ptr = dst_ptr + chunk_offset(cursor, dma_dst_pitch);                                  \
+        if (cursor.unit < dma_row_units)                                                            \
+          ptx_cudaDMA_store<RowType,DMA_STORE_QUAL>(bulk_buffer[i], (RowType*)ptr);                 \
+        else                                                                                        \
+        {                                                                                           \
+          SideType side;                                                                            \
+          CudaDMAMeta::unpack(bulk_buffer[i], side);                                                \
+          ptx_cudaDMA_store<SideType,DMA_STORE_QUAL>(side, (SideType*)ptr);                         \
+        }                                                                                           \
+      }                                                                                             \
+      dma_walk.advance(cursor);                                                                     \
+    }                                                                                               \
+  }                                                                                                 \
+  template<bool DMA_GLOBAL_LOAD, int DMA_LOAD_QUAL>                                                 \
+  __device__ __forceinline__ void execute_start_xfer(const void *RESTRICT src_ptr)                  \
+  {                                                                                                 \
+    dma_src_ptr = (const char*)src_ptr;                                                             \
+    load_step<DMA_GLOBAL_LOAD,DMA_LOAD_QUAL>(dma_src_ptr, dma_walk.start());                        \
+  }                                                                                                 \
+  TILE_WAIT_XFER_IMPL                                                                               \
+private:                                                                                            \
+  const int dma_row_bytes;                                                                          \
+  const int dma_num_rows;                                                                           \
+  const int dma_src_pitch;                                                                          \
+  const int dma_dst_pitch;                                                                          \
+  const CudaDMAMeta::TileWalk<> dma_walk;                                                           \
+  const int dma_row_units;                                                                          \
+  const char *dma_src_ptr;                                                                          \
+  RowType bulk_buffer[HALO_LDS];
+
+#define HALO_START_XFER_IMPL(GLOBAL_LOAD,LOAD_QUAL,STORE_QUAL)                                      \
+  execute_start_xfer<GLOBAL_LOAD,LOAD_QUAL>(src_ptr);
+
+#define HALO_WAIT_XFER_IMPL(GLOBAL_LOAD,LOAD_QUAL,STORE_QUAL)                                       \
+  execute_wait_xfer<GLOBAL_LOAD,LOAD_QUAL,STORE_QUAL>(dst_ptr);
+
+#define WARP_SPECIALIZED_UNQUALIFIED_METHODS                                                        \
+  __device__ __forceinline__ void execute_dma(const void *RESTRICT src_ptr, void *RESTRICT dst_ptr) \
+  {                                                                                                 \
+    start_xfer_async(src_ptr);                                                                      \
+    wait_xfer_finish(dst_ptr);                                                                      \
+  }                                                                                                 \
+  __device__ __forceinline__ void start_xfer_async(const void *RESTRICT src_ptr)                    \
+  {                                                                                                 \
+    HALO_START_XFER_IMPL(false,LOAD_CACHE_ALL,STORE_WRITE_BACK)                                     \
+  }                                                                                                 \
+  __device__ __forceinline__ void wait_xfer_finish(void *RESTRICT dst_ptr)                          \
+  {                                                                                                 \
+    CudaDMA::wait_for_dma_start();                                                                  \
+    HALO_WAIT_XFER_IMPL(false,LOAD_CACHE_ALL,STORE_WRITE_BACK)                                      \
+    CudaDMA::finish_async_dma();                                                                    \
+  }                                                                                                 \
+  __device__ __forceinline__ void prefetch(const void *RESTRICT src_ptr) const                      \
+  {                                                                                                 \
+    prefetch<false>(src_ptr);                                                                       \
+  }
+
+#define WARP_SPECIALIZED_QUALIFIED_METHODS                                                          \
+  template<bool DMA_GLOBAL_LOAD>                                                                    \
+  __device__ __forceinline__ void execute_dma(const void *RESTRICT src_ptr, void *RESTRICT dst_ptr) \
+  {                                                                                                 \
+    start_xfer_async<DMA_GLOBAL_LOAD>(src_ptr);                                                     \
+    wait_xfer_finish<DMA_GLOBAL_LOAD>(dst_ptr);                                                     \
+  }                                                                                                 \
+  template<bool DMA_GLOBAL_LOAD>                                                                    \
+  __device__ __forceinline__ void start_xfer_async(const void *RESTRICT src_ptr)                    \
+  {                                                                                                 \
+    HALO_START_XFER_IMPL(DMA_GLOBAL_LOAD,LOAD_CACHE_ALL,STORE_WRITE_BACK)                           \
+  }                                                                                                 \
+  template<bool DMA_GLOBAL_LOAD>                                                                    \
+  __device__ __forceinline__ void wait_xfer_finish(void *RESTRICT dst_ptr)                          \
+  {                                                                                                 \
+    CudaDMA::wait_for_dma_start();                                                                  \
+    HALO_WAIT_XFER_IMPL(DMA_GLOBAL_LOAD,LOAD_CACHE_ALL,STORE_WRITE_BACK)                            \
+    CudaDMA::finish_async_dma();                                                                    \
+  }                                                                                                 \
+  template<bool DMA_GLOBAL_LOAD, int DMA_LOAD_QUAL, int DMA_STORE_QUAL>                             \
+  __device__ __forceinline__ void execute_dma(const void *RESTRICT src_ptr, void *RESTRICT dst_ptr) \
+  {                                                                                                 \
+    start_xfer_async<DMA_GLOBAL_LOAD,DMA_LOAD_QUAL,DMA_STORE_QUAL>(src_ptr);                        \
+    wait_xfer_finish<DMA_GLOBAL_LOAD,DMA_LOAD_QUAL,DMA_STORE_QUAL>(dst_ptr);                        \
+  }                                                                                                 \
+  template<bool DMA_GLOBAL_LOAD, int DMA_LOAD_QUAL, int DMA_STORE_QUAL>                             \
+  __device__ __forceinline__ void start_xfer_async(const void *RESTRICT src_ptr)                    \
+  {                                                                                                 \
+    HALO_START_XFER_IMPL(DMA_GLOBAL_LOAD,DMA_LOAD_QUAL,DMA_STORE_QUAL)                              \
+  }                                                                                                 \
+  template<bool DMA_GLOBAL_LOAD, int DMA_LOAD_QUAL, int DMA_STORE_QUAL>                             \
+  __device__ __forceinline__ void wait_xfer_finish(void *RESTRICT dst_ptr)                          \
+  {                                                                                                 \
+    CudaDMA::wait_for_dma_start();                                                                  \
+    HALO_WAIT_XFER_IMPL(DMA_GLOBAL_LOAD,DMA_LOAD_QUAL,DMA_STORE_QUAL)                               \
+    CudaDMA::finish_async_dma();                                                                    \
+  }                                                                                                 \
+  template<bool DMA_GLOBAL_LOAD>                                                                    \
+  __device__ __forceinline__ void prefetch(const void *RESTRICT src_ptr) const                      \
+  {                                                                                                 \
+    /* Walk the transfer on a copy so that a transfer in flight is untouched */                     \
+    CudaDMAMeta::copy_of(*this).template prefetch_xfer<DMA_GLOBAL_LOAD>(src_ptr);                   \
+  }                                                                                                 \
+private:                                                                                            \
+  template<bool DMA_GLOBAL_LOAD>                                                                    \
+  __device__ __forceinline__ void prefetch_xfer(const void *RESTRICT src_ptr)                       \
+  {                                                                                                 \
+    void *const dst_ptr = NULL;                                                                     \
+    {                                                                                               \
+      HALO_START_XFER_IMPL(DMA_GLOBAL_LOAD,LOAD_PREFETCH_L2,CUDADMA_STORE_DISCARD)                  \
+    }                                                                                               \
+    {                                                                                               \
+      HALO_WAIT_XFER_IMPL(DMA_GLOBAL_LOAD,LOAD_PREFETCH_L2,CUDADMA_STORE_DISCARD)                   \
+    }                                                                                               \
+  }
+
+#define NON_WARP_SPECIALIZED_UNQUALIFIED_METHODS                                                    \
+  __device__ __forceinline__ void execute_dma(const void *RESTRICT src_ptr, void *RESTRICT dst_ptr) \
+  {                                                                                                 \
+    start_xfer_async(src_ptr);                                                                      \
+    wait_xfer_finish(dst_ptr);                                                                      \
+  }                                                                                                 \
+  __device__ __forceinline__ void start_xfer_async(const void *RESTRICT src_ptr)                    \
+  {                                                                                                 \
+    HALO_START_XFER_IMPL(false,LOAD_CACHE_ALL,STORE_WRITE_BACK)                                     \
+  }                                                                                                 \
+  __device__ __forceinline__ void wait_xfer_finish(void *RESTRICT dst_ptr)                          \
+  {                                                                                                 \
+    HALO_WAIT_XFER_IMPL(false,LOAD_CACHE_ALL,STORE_WRITE_BACK)                                      \
+  }                                                                                                 \
+  __device__ __forceinline__ void prefetch(const void *RESTRICT src_ptr) const                      \
+  {                                                                                                 \
+    prefetch<false>(src_ptr);                                                                       \
+  }
+
+#define NON_WARP_SPECIALIZED_QUALIFIED_METHODS                                                      \
+  template<bool DMA_GLOBAL_LOAD>                                                                    \
+  __device__ __forceinline__ void execute_dma(const void *RESTRICT src_ptr, void *RESTRICT dst_ptr) \
+  {                                                                                                 \
+    start_xfer_async<DMA_GLOBAL_LOAD>(src_ptr);                                                     \
+    wait_xfer_finish<DMA_GLOBAL_LOAD>(dst_ptr);                                                     \
+  }                                                                                                 \
+  template<bool DMA_GLOBAL_LOAD>                                                                    \
+  __device__ __forceinline__ void start_xfer_async(const void *RESTRICT src_ptr)                    \
+  {                                                                                                 \
+    HALO_START_XFER_IMPL(DMA_GLOBAL_LOAD,LOAD_CACHE_ALL,STORE_WRITE_BACK)                           \
+  }                                                                                                 \
+  template<bool DMA_GLOBAL_LOAD>                                                                    \
+  __device__ __forceinline__ void wait_xfer_finish(void *RESTRICT dst_ptr)                          \
+  {                                                                                                 \
+    HALO_WAIT_XFER_IMPL(DMA_GLOBAL_LOAD,LOAD_CACHE_ALL,STORE_WRITE_BACK)                            \
+  }                                                                                                 \
+  template<bool DMA_GLOBAL_LOAD, int DMA_LOAD_QUAL, int DMA_STORE_QUAL>                             \
+  __device__ __forceinline__ void execute_dma(const void *RESTRICT src_ptr, void *RESTRICT dst_ptr) \
+  {                                                                                                 \
+    start_xfer_async<DMA_GLOBAL_LOAD,DMA_LOAD_QUAL,DMA_STORE_QUAL>(src_ptr);                        \
+    wait_xfer_finish<DMA_GLOBAL_LOAD,DMA_LOAD_QUAL,DMA_STORE_QUAL>(dst_ptr);                        \
+  }                                                                                                 \
+  template<bool DMA_GLOBAL_LOAD, int DMA_LOAD_QUAL, int DMA_STORE_QUAL>                             \
+  __device__ __forceinline__ void start_xfer_async(const void *RESTRICT src_ptr)                    \
+  {                                                                                                 \
+    HALO_START_XFER_IMPL(DMA_GLOBAL_LOAD,DMA_LOAD_QUAL,DMA_STORE_QUAL)                              \
+  }                                                                                                 \
+  template<bool DMA_GLOBAL_LOAD, int DMA_LOAD_QUAL, int DMA_STORE_QUAL>                             \
+  __device__ __forceinline__ void wait_xfer_finish(void *RESTRICT dst_ptr)                          \
+  {                                                                                                 \
+    HALO_WAIT_XFER_IMPL(DMA_GLOBAL_LOAD,DMA_LOAD_QUAL,DMA_STORE_QUAL)                               \
+  }                                                                                                 \
+  template<bool DMA_GLOBAL_LOAD>                                                                    \
+  __device__ __forceinline__ void prefetch(const void *RESTRICT src_ptr) const                      \
+  {                                                                                                 \
+    /* Walk the transfer on a copy so that a transfer in flight is untouched */                     \
+    CudaDMAMeta::copy_of(*this).template prefetch_xfer<DMA_GLOBAL_LOAD>(src_ptr);                   \
+  }                                                                                                 \
+private:                                                                                            \
+  template<bool DMA_GLOBAL_LOAD>                                                                    \
+  __device__ __forceinline__ void prefetch_xfer(const void *RESTRICT src_ptr)                       \
+  {                                                                                                 \
+    void *const dst_ptr = NULL;                                                                     \
+    {                                                                                               \
+      HALO_START_XFER_IMPL(DMA_GLOBAL_LOAD,LOAD_PREFETCH_L2,CUDADMA_STORE_DISCARD)                  \
+    }                                                                                               \
+    {                                                                                               \
+      HALO_WAIT_XFER_IMPL(DMA_GLOBAL_LOAD,LOAD_PREFETCH_L2,CUDADMA_STORE_DISCARD)                   \
+    }                                                                                               \
+  }
+
+template<bool DO_SYNC=false, int ALIGNMENT=0, int BYTES_PER_THREAD=4*ALIGNMENT, int BYTES_PER_ELMT=4,
+         int RADIUS=1, bool CORNERS=false>
+class CudaDMAHalo : public CudaDMA {
+public:
+  __device__ CudaDMAHalo(const int dmaID,
+                         const int num_dma_threads,
+                         const int num_compute_threads,
+                         const int dma_threadIdx_start,
+                         const int row_bytes,
+                         const int num_rows,
+                         const int src_pitch,
+                         const int dst_pitch)
+    : CudaDMA(dmaID, num_dma_threads, num_compute_threads, dma_threadIdx_start),
+      HALO_INIT(CUDADMA_DMA_TID, num_dma_threads)
+  {
+    HALO_STATIC_ASSERTS;
+  }
+public:
+  WARP_SPECIALIZED_UNQUALIFIED_METHODS
+  WARP_SPECIALIZED_QUALIFIED_METHODS
+private:
+  HALO_TRANSFER_IMPL
+};
+
+template<int ALIGNMENT, int BYTES_PER_THREAD, int BYTES_PER_ELMT, int RADIUS, bool CORNERS>
+class CudaDMAHalo<false,ALIGNMENT,BYTES_PER_THREAD,BYTES_PER_ELMT,RADIUS,CORNERS> : public CudaDMA {
+public:
+  __device__ CudaDMAHalo(const int row_bytes,
+                         const int num_rows,
+                         const int src_pitch,
+                         const int dst_pitch)
+    : CudaDMA(0, blockDim.x, blockDim.x, 0),
+      HALO_INIT(threadIdx.x, blockDim.x)
+  {
+    HALO_STATIC_ASSERTS;
+  }
+public:
+  NON_WARP_SPECIALIZED_UNQUALIFIED_METHODS
+  NON_WARP_SPECIALIZED_QUALIFIED_METHODS
+private:
+  HALO_TRANSFER_IMPL
+};
+
+#undef HALO_SIDE_BYTES
+#undef HALO_SIDE_ALIGNMENT
+#undef HALO_SIDE_CHUNKS
+#undef HALO_CORNER_BYTES
+#undef HALO_ROW_ALIGNMENT
+#undef HALO_LDS
+#undef HALO_INIT
+#undef HALO_STATIC_ASSERTS
+#undef HALO_TRANSFER_IMPL
+#undef HALO_START_XFER_IMPL
+#undef HALO_WAIT_XFER_IMPL
+#undef WARP_SPECIALIZED_UNQUALIFIED_METHODS
+#undef WARP_SPECIALIZED_QUALIFIED_METHODS
+#undef NON_WARP_SPECIALIZED_UNQUALIFIED_METHODS
+#undef NON_WARP_SPECIALIZED_QUALIFIED_METHODS
+////////////////////////  End of CudaDMAHalo     //////////////////////////////////////////////////
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+// CudaDMABox
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * CudaDMABox will transfer a 3D sub-box of a volume, i.e. num_slices slices of num_rows
+ * rows of row_bytes bytes each, with independent row and slice pitches in the source and
+ * destination.  When RADIUS is non-zero the box is extended by RADIUS cells on both sides
+ * of every dimension, edges and corners included, so a 7-point or 27-point stencil can get
+ * a slab of slices and their halo in a single transfer instead of one transfer per slice.
+ * DO_SYNC - is warp-specialized or not
+ * ALIGNMENT - guaranteed alignment of the box origin, the row size and the pitches
+ * BYTES_PER_THREAD - maximum number of bytes that can be used for buffering inside the instance
+ * BYTES_PER_ELMT - the size of a cell of the volume (e.g. 4 for float)
+ * RADIUS - the width of the halo in cells
+ *
+ * The source and destination pointers passed to the transfer methods point to the origin
+ * (the first cell) of the box without its halo.  Rows are split into chunks that are
+ * assigned to DMA threads round robin across the whole box, so there is a single setup
+ * and a single barrier for all slices.  Each thread loads at most BYTES_PER_THREAD bytes
+ * in a step before storing them.  The halo shifts the rows by RADIUS*BYTES_PER_ELMT bytes,
+ * so with a halo the chunks are the largest loads that divide both ALIGNMENT and
+ * RADIUS*BYTES_PER_ELMT, which must be a multiple of 4 bytes.  Rows, halo included, must
+ * be at least one chunk long; an empty box is rejected by an assert.
+ */
+// Bytes the halo adds on each side of a row and the loads used to move the rows
+#define BOX_HALO_BYTES (RADIUS*BYTES_PER_ELMT)
+#define BOX_ALIGNMENT ((RADIUS == 0) ? ALIGNMENT :                                                  \
+                       ((ALIGNMENT >= 16) && ((BOX_HALO_BYTES%16) == 0)) ? 16 :                     \
+                       ((ALIGNMENT >= 8) && ((BOX_HALO_BYTES%8) == 0)) ? 8 : 4)
+// Loads issued by each thread per step
+#define BOX_LDS (BYTES_PER_THREAD/BOX_ALIGNMENT)
+
+// Every thread walks the chunks of the box starting at its own index and
+// advancing by the number of DMA threads.  The walk wraps the rows of each
+// slice, halo included, into the next slice.
+#define BOX_INIT(_tid,_threads)                                                                     \
+      dma_src_row_pitch(src_row_pitch),                                                             \
+      dma_src_slice_pitch(src_slice_pitch),                                                         \
+      dma_dst_row_pitch(dst_row_pitch),                                                             \
+      dma_dst_slice_pitch(dst_slice_pitch),                                                         \
+      dma_walk(_tid, _threads,                                                                      \
+               CudaDMAMeta::row_chunks(row_bytes + 2*BOX_HALO_BYTES, BOX_ALIGNMENT),                \
+               (num_rows + 2*RADIUS)*(num_slices + 2*RADIUS), 0, num_rows + 2*RADIUS)
+
+#define BOX_STATIC_ASSERTS                                                                          \
+    STATIC_ASSERT((ALIGNMENT == 4) || (ALIGNMENT == 8) || (ALIGNMENT == 16));                       \
+    STATIC_ASSERT((BYTES_PER_THREAD/BOX_ALIGNMENT) > 0);                                            \
+    STATIC_ASSERT((BYTES_PER_THREAD%ALIGNMENT) == 0);                                               \
+    STATIC_ASSERT(RADIUS >= 0);                                                                     \
+    STATIC_ASSERT((BOX_HALO_BYTES%4) == 0)
+
+#define BOX_TRANSFER_IMPL                                                                           \
+  typedef typename CudaDMAMeta::VectorType<BOX_ALIGNMENT>::type BoxType;                            \
+  /* Byte offset of the chunk at the cursor from the box origin */                                  \
+  __device__ __forceinline__ int chunk_offset(const CudaDMAMeta::TileCursor &cursor,                \
+                                              const int row_pitch, const int slice_pitch) const     \
+  {                                                                                                 \
+    return ((cursor.slice - RADIUS)*slice_pitch + (cursor.row - RADIUS)*row_pitch +                 \
+            cursor.col*BOX_ALIGNMENT - BOX_HALO_BYTES);                                             \
+  }                                                                                                 \
+  template<bool DMA_GLOBAL_LOAD, int DMA_LOAD_QUAL>                                                 \
+  __device__ __forceinline__ void load_step(const char *RESTRICT src_ptr,                           \
+                                            CudaDMAMeta::TileCursor cursor)                         \
+  {                                                                                                 \
+    for (int i = 0; i < BOX_LDS; i++)                                                               \
+    {                                                                                               \
+      if (dma_walk.valid(cursor))                                                                   \
+      {                                                                                             \
+        const char *ptr = src_ptr +                                                                 \
+          chunk_offset(cursor, dma_src_row_pitch, dma_src_slice_pitch);                             \
+        bulk_buffer[i] = ptx_cudaDMA_load<BoxType,DMA_GLOBAL_LOAD,DMA_LOAD_QUAL>((const BoxType*)ptr);\
+      }                                                                                             \
+      dma_walk.advance(cursor);                                                                     \
+    }                                                                                               \
+  }                                                                                                 \
+  template<int DMA_STORE_QUAL>                                                                      \
+  __device__ __forceinline__ void store_step(char *RESTRICT dst_ptr,                                \
+                                             CudaDMAMeta::TileCursor &cursor)                       \
+  {                                                                                                 \
+    for (int i = 0; i < BOX_LDS; i++)                                                               \
+    {                                                                                               \
+      if (dma_walk.valid(cursor))                                                                   \
+      {                                                                                             \
+        char *ptr = dst_ptr + chunk_offset(cursor, dma_dst_row_pitch, dma_dst_slice_pitch);         \
+        ptx_cudaDMA_store<BoxType,DMA_STORE_QUAL>(bulk_buffer[i], (BoxType*)ptr);                   \
+      }                                                                                             \
+      dma_walk.advance(cursor);                                                                     \
+    }                                                                                               \
+  }                                                                                                 \
+  template<bool DMA_GLOBAL_LOAD, int DMA_LOAD_QUAL>                                                 \
+  __device__ __forceinline__ void execute_start_xfer(const void *RESTRICT src_ptr)                  \
+  {                                                                                                 \
+    dma_src_ptr = (const char*)src_ptr;                                                             \
+    load_step<DMA_GLOBAL_LOAD,DMA_LOAD_QUAL>(dma_src_ptr, dma_walk.start());                        \
+  }                                                                                                 \
+  TILE_WAIT_XFER_IMPL                                                                               \
+private:                                                                                            \
+  const int dma_src_row_pitch;                                                                      \
+  const int dma_src_slice_pitch;                                                                    \
+  const int dma_dst_row_pitch;                                                                      \
+  const int dma_dst_slice_pitch;                                                                    \
+  const CudaDMAMeta::TileWalk<true> dma_walk;                                                       \
+  const char *dma_src_ptr;                                                                          \
+  BoxType bulk_buffer[BOX_LDS];
+
+#define BOX_START_XFER_IMPL(GLOBAL_LOAD,LOAD_QUAL,STORE_QUAL)                                       \
+  execute_start_xfer<GLOBAL_LOAD,LOAD_QUAL>(src_ptr);
+
+#define BOX_WAIT_XFER_IMPL(GLOBAL_LOAD,LOAD_QUAL,STORE_QUAL)                                        \
+  execute_wait_xfer<GLOBAL_LOAD,LOAD_QUAL,STORE_QUAL>(dst_ptr);
+
+#define WARP_SPECIALIZED_UNQUALIFIED_METHODS                                                        \
+  __device__ __forceinline__ void execute_dma(const void *RESTRICT src_ptr, void *RESTRICT dst_ptr) \
+  {                                                                                                 \
+    start_xfer_async(src_ptr);                                                                      \
+    wait_xfer_finish(dst_ptr);                                                                      \
+  }                                                                                                 \
+  __device__ __forceinline__ void start_xfer_async(const void *RESTRICT src_ptr)                    \
+  {                                                                                                 \
+    BOX_START_XFER_IMPL(false,LOAD_CACHE_ALL,STORE_WRITE_BACK)                                      \
+  }                                                                                                 \
+  __device__ __forceinline__ void wait_xfer_finish(void *RESTRICT dst_ptr)                          \
+  {                                                                                                 \
+    CudaDMA::wait_for_dma_start();                                                                  \
+    BOX_WAIT_XFER_IMPL(false,LOAD_CACHE_ALL,STORE_WRITE_BACK)                                       \
+    CudaDMA::finish_async_dma();                                                                    \
+  }                                                                                                 \
+  __device__ __forceinline__ void prefetch(const void *RESTRICT src_ptr) const                      \
+  {                                                                                                 \
+    prefetch<false>(src_ptr);                                                                       \
+  }
+
+#define WARP_SPECIALIZED_QUALIFIED_METHODS                                                          \
+  template<bool DMA_GLOBAL_LOAD>                                                                    \
+  __device__ __forceinline__ void execute_dma(const void *RESTRICT src_ptr, void *RESTRICT dst_ptr) \
+  {                                                                                                 \
+    start_xfer_async<DMA_GLOBAL_LOAD>(src_ptr);                                                     \
+    wait_xfer_finish<DMA_GLOBAL_LOAD>(dst_ptr);                                                     \
+  }                                                                                                 \
+  template<bool DMA_GLOBAL_LOAD>                                                                    \
+  __device__ __forceinline__ void start_xfer_async(const void *RESTRICT src_ptr)                    \
+  {                                                                                                 \
+    BOX_START_XFER_IMPL(DMA_GLOBAL_LOAD,LOAD_CACHE_ALL,STORE_WRITE_BACK)                            \
+  }                                                                                                 \
+  template<bool DMA_GLOBAL_LOAD>                                                                    \
+  __device__ __forceinline__ void wait_xfer_finish(void *RESTRICT dst_ptr)                          \
+  {                                                                                                 \
+    CudaDMA::wait_for_dma_start();                                                                  \
+    BOX_WAIT_XFER_IMPL(DMA_GLOBAL_LOAD,LOAD_CACHE_ALL,STORE_WRITE_BACK)                             \
+    CudaDMA::finish_async_dma();                                                                    \
+  }                                                                                                 \
+  template<bool DMA_GLOBAL_LOAD, int DMA_LOAD_QUAL, int DMA_STORE_QUAL>                             \
+  __device__ __forceinline__ void execute_dma(const void *RESTRICT src_ptr, void *RESTRICT dst_ptr) \
+  {                                                                                                 \
+    start_xfer_async<DMA_GLOBAL_LOAD,DMA_LOAD_QUAL,DMA_STORE_QUAL>(src_ptr);                        \
+    wait_xfer_finish<DMA_GLOBAL_LOAD,DMA_LOAD_QUAL,DMA_STORE_QUAL>(dst_ptr);                        \
+  }                                                                                                 \
+  template<bool DMA_GLOBAL_LOAD, int DMA_LOAD_QUAL, int DMA_STORE_QUAL>                             \
+  __device__ __forceinline__ void start_xfer_async(const void *RESTRICT src_ptr)                    \
+  {                                                                                                 \
+    BOX_START_XFER_IMPL(DMA_GLOBAL_LOAD,DMA_LOAD_QUAL,DMA_STORE_QUAL)                               \
+  }                                                                                                 \
+  template<bool DMA_GLOBAL_LOAD, int DMA_LOAD_QUAL, int DMA_STORE_QUAL>                             \
+  __device__ __forceinline__ void wait_xfer_finish(void *RESTRICT dst_ptr)                          \
+  {                                                                                                 \
+    CudaDMA::wait_for_dma_start();                                                                  \
+    BOX_WAIT_XFER_IMPL(DMA_GLOBAL_LOAD,DMA_LOAD_QUAL,DMA_STORE_QUAL)                                \
+    CudaDMA::finish_async_dma();                                                                    \
+  }                                                                                                 \
+  template<bool DMA_GLOBAL_LOAD>                                                                    \
+  __device__ __forceinline__ void prefetch(const void *RESTRICT src_ptr) const                      \
+  {                                                                                                 \
+    /* Walk the transfer on a copy so that a transfer in flight is untouched */                     \
+    CudaDMAMeta::copy_of(*this).template prefetch_xfer<DMA_GLOBAL_LOAD>(src_ptr);                   \
+  }                                                                                                 \
+private:                                                                                            \
+  template<bool DMA_GLOBAL_LOAD>                                                                    \
+  __device__ __forceinline__ void prefetch_xfer(const void *RESTRICT src_ptr)                       \
+  {                                                                                                 \
+    void *const dst_ptr = NULL;                                                                     \
+    {                                                                                               \
+      BOX_START_XFER_IMPL(DMA_GLOBAL_LOAD,LOAD_PREFETCH_L2,CUDADMA_STORE_DISCARD)                   \
+    }                                                                                               \
+    {                                                                                               \
+      BOX_WAIT_XFER_IMPL(DMA_GLOBAL_LOAD,LOAD_PREFETCH_L2,CUDADMA_STORE_DISCARD)                    \
+    }                                                                                               \
+  }
+
+#define NON_WARP_SPECIALIZED_UNQUALIFIED_METHODS                                                    \
+  __device__ __forceinline__ void execute_dma(const void *RESTRICT src_ptr, void *RESTRICT dst_ptr) \
+  {                                                                                                 \
+    start_xfer_async(src_ptr);                                                                      \
+    wait_xfer_finish(dst_ptr);                                                                      \
+  }                                                                                                 \
+  __device__ __forceinline__ void start_xfer_async(const void *RESTRICT src_ptr)                    \
+  {                                                                                                 \
+    BOX_START_XFER_IMPL(false,LOAD_CACHE_ALL,STORE_WRITE_BACK)                                      \
+  }                                                                                                 \
+  __device__ __forceinline__ void wait_xfer_finish(void *RESTRICT dst_ptr)                          \
+  {                                                                                                 \
+    BOX_WAIT_XFER_IMPL(false,LOAD_CACHE_ALL,STORE_WRITE_BACK)                                       \
+  }                                                                                                 \
+  __device__ __forceinline__ void prefetch(const void *RESTRICT src_ptr) const                      \
+  {                                                                                                 \
+    prefetch<false>(src_ptr);                                                                       \
+  }
+
+#define NON_WARP_SPECIALIZED_QUALIFIED_METHODS                                                      \
+  template<bool DMA_GLOBAL_LOAD>                                                                    \
+  __device__ __forceinline__ void execute_dma(const void *RESTRICT src_ptr, void *RESTRICT dst_ptr) \
+  {                                                                                                 \
+    start_xfer_async<DMA_GLOBAL_LOAD>(src_ptr);                                                     \
+    wait_xfer_finish<DMA_GLOBAL_LOAD>(dst_ptr);                                                     \
+  }                                                                                                 \
+  template<bool DMA_GLOBAL_LOAD>                                                                    \
+  __device__ __forceinline__ void start_xfer_async(const void *RESTRICT src_ptr)                    \
+  {                                                                                                 \
+    BOX_START_XFER_IMPL(DMA_GLOBAL_LOAD,LOAD_CACHE_ALL,STORE_WRITE_BACK)                            \
+  }                                                                                                 \
+  template<bool DMA_GLOBAL_LOAD>                                                                    \
+  __device__ __forceinline__ void wait_xfer_finish(void *RESTRICT dst_ptr)                          \
+  {                                                                                                 \
+    BOX_WAIT_XFER_IMPL(DMA_GLOBAL_LOAD,LOAD_CACHE_ALL,STORE_WRITE_BACK)                             \
+  }                                                                                                 \
+  template<bool DMA_GLOBAL_LOAD, int DMA_LOAD_QUAL, int DMA_STORE_QUAL>                             \
+  __device__ __forceinline__ void execute_dma(const void *RESTRICT src_ptr, void *RESTRICT dst_ptr) \
+  {                                                                                                 \
+    start_xfer_async<DMA_GLOBAL_LOAD,DMA_LOAD_QUAL,DMA_STORE_QUAL>(src_ptr);                        \
+    wait_xfer_finish<DMA_GLOBAL_LOAD,DMA_LOAD_QUAL,DMA_STORE_QUAL>(dst_ptr);                        \
+  }                                                                                                 \
+  template<bool DMA_GLOBAL_LOAD, int DMA_LOAD_QUAL, int DMA_STORE_QUAL>                             \
+  __device__ __forceinline__ void start_xfer_async(const void *RESTRICT src_ptr)                    \
+  {                                                                                                 \
+    BOX_START_XFER_IMPL(DMA_GLOBAL_LOAD,DMA_LOAD_QUAL,DMA_STORE_QUAL)                               \
+  }                                                                                                 \
+  template<bool DMA_GLOBAL_LOAD, int DMA_LOAD_QUAL, int DMA_STORE_QUAL>                             \
+  __device__ __forceinline__ void wait_xfer_finish(void *RESTRICT dst_ptr)                          \
+  {                                                                                                 \
+    BOX_WAIT_XFER_IMPL(DMA_GLOBAL_LOAD,DMA_LOAD_QUAL,DMA_STORE_QUAL)                                \
+  }                                                                                                 \
+  template<bool DMA_GLOBAL_LOAD>                                                                    \
+  __device__ __forceinline__ void prefetch(const void *RESTRICT src_ptr) const                      \
+  {                                                                                                 \
+    /* Walk the transfer on a copy so that a transfer in flight is untouched */                     \
+    CudaDMAMeta::copy_of(*this).template prefetch_xfer<DMA_GLOBAL_LOAD>(src_ptr);                   \
+  }                                                                                                 \
+private:                                                                                            \
+  template<bool DMA_GLOBAL_LOAD>                                                                    \
+  __device__ __forceinline__ void prefetch_xfer(const void *RESTRICT src_ptr)                       \
+  {                                                                                                 \
+    void *const dst_ptr = NULL;                                                                     \
+    {                                                                                               \
+      BOX_START_XFER_IMPL(DMA_GLOBAL_LOAD,LOAD_PREFETCH_L2,CUDADMA_STORE_DISCARD)                   \
+    }                                                                                               \
+    {                                                                                               \
+      BOX_WAIT_XFER_IMPL(DMA_GLOBAL_LOAD,LOAD_PREFETCH_L2,CUDADMA_STORE_DISCARD)                    \
+    }                                                                                               \
+  }
+
+template<bool DO_SYNC=false, int ALIGNMENT=0, int BYTES_PER_THREAD=4*ALIGNMENT, int BYTES_PER_ELMT=4,
+         int RADIUS=0>
+class CudaDMABox : public CudaDMA {
+public:
+  __device__ CudaDMABox(const int dmaID,
+                        const int num_dma_threads,
+                        const int num_compute_threads,
+                        const int dma_threadIdx_start,
+                        const int row_bytes,
+                        const int num_rows,
+                        const int num_slices,
+                        const int src_row_pitch,
+                        const int src_slice_pitch,
+                        const int dst_row_pitch,
+                        const int dst_slice_pitch)
+    : CudaDMA(dmaID, num_dma_threads, num_compute_threads, dma_threadIdx_start),
+      BOX_INIT(CUDADMA_DMA_TID, num_dma_threads)
+  {
+    BOX_STATIC_ASSERTS;
+  }
+public:
+  WARP_SPECIALIZED_UNQUALIFIED_METHODS
+  WARP_SPECIALIZED_QUALIFIED_METHODS
+private:
+  BOX_TRANSFER_IMPL
+};
+
+template<int ALIGNMENT, int BYTES_PER_THREAD, int BYTES_PER_ELMT, int RADIUS>
+class CudaDMABox<false,ALIGNMENT,BYTES_PER_THREAD,BYTES_PER_ELMT,RADIUS> : public CudaDMA {
+public:
+  __device__ CudaDMABox(const int row_bytes,
+                        const int num_rows,
+                        const int num_slices,
+                        const int src_row_pitch,
+                        const int src_slice_pitch,
+                        const int dst_row_pitch,
+                        const int dst_slice_pitch)
+    : CudaDMA(0, blockDim.x, blockDim.x, 0),
+      BOX_INIT(threadIdx.x, blockDim.x)
+  {
+    BOX_STATIC_ASSERTS;
+  }
+public:
+  NON_WARP_SPECIALIZED_UNQUALIFIED_METHODS
+  NON_WARP_SPECIALIZED_QUALIFIED_METHODS
+private:
+  BOX_TRANSFER_IMPL
+};
+
+#undef BOX_HALO_BYTES
+#undef BOX_ALIGNMENT
+#undef BOX_LDS
+#undef BOX_INIT
+#undef BOX_STATIC_ASSERTS
+#undef BOX_TRANSFER_IMPL
+#undef BOX_START_XFER_IMPL
+#undef BOX_WAIT_XFER_IMPL
+#undef WARP_SPECIALIZED_UNQUALIFIED_METHODS
+#undef WARP_SPECIALIZED_QUALIFIED_METHODS
+#undef NON_WARP_SPECIALIZED_UNQUALIFIED_METHODS
+#undef NON_WARP_SPECIALIZED_QUALIFIED_METHODS
+////////////////////////  End of CudaDMABox      //////////////////////////////////////////////////
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+// CudaDMATensor
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * CudaDMATensor will transfer an N-dimensional tile (2 <= DIMS <= 5) made of contiguous
+ * rows of BYTES_PER_ROW bytes.  The DIMS-1 outer dimensions each have their own extent
+ * and their own byte stride in the source and the destination, so a 4-D tile of a
+ * tensor can be moved with a single instance and a single barrier.
+ * DO_SYNC - is warp-specialized or not
+ * ALIGNMENT - guaranteed alignment of the tile origin, the row size and all the strides
+ * BYTES_PER_THREAD - maximum number of bytes that can be used for buffering inside the instance
+ * DIMS - number of dimensions of the tile including the contiguous rows
+ * BYTES_PER_ROW - size of the contiguous innermost dimension in bytes, a multiple of ALIGNMENT
+ * DMA_THREADS - number of DMA threads
+ *
+ * The extents and strides are passed to the constructor as arrays of DIMS-1 values, ordered
+ * from the dimension just above the rows to the outermost one.  As for CudaDMAStrided the
+ * template parameters can be given progressively: with BYTES_PER_ROW and DMA_THREADS known
+ * at compile time the split of the rows between the threads is constant (see
+ * CudaDMATensorPlan) and only the outer dimensions are walked at runtime.  The rows are
+ * split into ALIGNMENT chunks that are assigned to the DMA threads round robin, and each
+ * thread loads at most BYTES_PER_THREAD bytes in a step before storing them.
+ */
+// Number of outer dimensions described by the extent and stride arrays
+#define TENSOR_OUTER (DIMS-1)
+// Loads issued by each thread per step
+#define TENSOR_LDS (BYTES_PER_THREAD/ALIGNMENT)
+
+template<int ALIGNMENT, int BYTES_PER_THREAD, int DIMS, int BYTES_PER_ROW, int DMA_THREADS>
+struct CudaDMATensorPlan {
+  static const int alignment = ALIGNMENT;
+  static const int bytes_per_thread = BYTES_PER_THREAD;
+  static const int dims = DIMS;
+  static const int bytes_per_row = BYTES_PER_ROW;
+  static const int dma_threads = DMA_THREADS;
+  static const int row_chunks = BYTES_PER_ROW/ALIGNMENT;
+  // Rows and chunks that the cursor of every thread advances by
+  static const int row_step = DMA_THREADS/row_chunks;
+  static const int col_step = DMA_THREADS%row_chunks;
+  // Maximum number of loads issued by a DMA thread in a step
+  static const int loads_per_step = TENSOR_LDS;
+  // Estimated registers per DMA thread (see CudaDMARegisterBudget), the
+  // extents, strides, steps and start of every outer dimension are kept
+  static const int bulk_registers = BYTES_PER_THREAD/sizeof(float);
+  static const int across_registers = 0;
+  static const int state_registers = CudaDMARegisterCost::base + CudaDMARegisterCost::tensor +
+                                     CudaDMARegisterCost::tensor_dim*TENSOR_OUTER;
+  static const int registers = bulk_registers + across_registers + state_registers +
+                               CudaDMARegisterCost::working;
+};
+
+// The cursor of a thread is the chunk in its row and the index in every
+// outer dimension.  It advances by the number of DMA threads with the
+// per-dimension steps computed once at construction, carrying into the
+// next dimension at most once, so no divisions are needed while moving.
+#define TENSOR_STATIC_ASSERTS                                                                       \
+    STATIC_ASSERT((ALIGNMENT == 4) || (ALIGNMENT == 8) || (ALIGNMENT == 16));                       \
+    STATIC_ASSERT((BYTES_PER_THREAD/ALIGNMENT) > 0);                                                \
+    STATIC_ASSERT((BYTES_PER_THREAD%ALIGNMENT) == 0);                                               \
+    STATIC_ASSERT((DIMS >= 2) && (DIMS <= 5))
+
+// Extents of a tensor tile can be zero, in which case nothing moves, but
+// never negative
+#ifdef DEBUG_CUDADMA
+#define TENSOR_CHECK_EXTENT(EXTENT)                                                                 \
+      if ((EXTENT) < 0) assert(false);
+#else
+#define TENSOR_CHECK_EXTENT(EXTENT)
+#endif
+
+#define TENSOR_TRANSFER_IMPL                                                                        \
+  typedef typename CudaDMAMeta::VectorType<ALIGNMENT>::type TensorType;                             \
+  struct Cursor {                                                                                   \
+    int unit;                                                                                       \
+    int col;                                                                                        \
+    int index[TENSOR_OUTER];                                                                        \
+  };                                                                                                \
+  __device__ __forceinline__ void initialize(const int tid, const int *extents,                     \
+                                             const int *src_strides, const int *dst_strides)        \
+  {                                                                                                 \
+    /* An empty tile, or rows shorter than one load, moves nothing */                               \
+    bool empty = (int(dma_row_chunks) <= 0);                                                        \
+    dma_start_unit = tid;                                                                           \
+    dma_start_col = 0;                                                                              \
+    dma_total_units = 0;                                                                            \
+    for (int d = 0; d < TENSOR_OUTER; d++)                                                          \
+    {                                                                                               \
+      TENSOR_CHECK_EXTENT(extents[d])                                                               \
+      dma_extents[d] = extents[d];                                                                  \
+      dma_src_strides[d] = src_strides[d];                                                          \
+      dma_dst_strides[d] = dst_strides[d];                                                          \
+      dma_steps[d] = 0;                                                                             \
+      dma_start[d] = 0;                                                                             \
+      if (extents[d] <= 0)                                                                          \
+        empty = true;                                                                               \
+    }                                                                                               \
+    if (empty)                                                                                      \
+      return;                                                                                       \
+    int threads = int(dma_threads)/int(dma_row_chunks);                                             \
+    int start = tid/int(dma_row_chunks);                                                            \
+    dma_start_col = tid%int(dma_row_chunks);                                                        \
+    dma_total_units = dma_row_chunks;                                                               \
+    for (int d = 0; d < TENSOR_OUTER; d++)                                                          \
+    {                                                                                               \
+      dma_total_units *= extents[d];                                                                \
+      /* The outermost dimension never wraps around */                                              \
+      dma_steps[d] = (d < (TENSOR_OUTER-1)) ? (threads%extents[d]) : threads;                       \
+      dma_start[d] = (d < (TENSOR_OUTER-1)) ? (start%extents[d]) : start;                           \
+      threads /= extents[d];                                                                        \
+      start /= extents[d];                                                                          \
+    }                                                                                               \
+  }                                                                                                 \
+  __device__ __forceinline__ void start_cursor(Cursor &cursor) const                                \
+  {                                                                                                 \
+    cursor.unit = dma_start_unit;                                                                   \
+    cursor.col = dma_start_col;                                                                     \
+    for (int d = 0; d < TENSOR_OUTER; d++)                                                          \
+      cursor.index[d] = dma_start[d];                                                               \
+  }                                                                                                 \
+  /* Byte offset of the chunk at the cursor from the tile origin */                                 \
+  __device__ __forceinline__ int chunk_offset(const Cursor &cursor, const int *strides) const       \
+  {                                                                                                 \
+    int offset = cursor.col*ALIGNMENT;                                                              \
+    for (int d = 0; d < TENSOR_OUTER; d++)                                                          \
+      offset += cursor.index[d]*strides[d];                                                         \
+    return offset;                                                                                  \
+  }                                                                                                 \
+  /* Move the cursor to the next chunk of this thread */                                            \
+  __device__ __forceinline__ void advance(Cursor &cursor) const                                     \
+  {                                                                                                 \
+    cursor.unit += dma_threads;                                                                     \
+    cursor.col += dma_col_step;                                                                     \
+    int carry = 0;                                                                                  \
+    if (cursor.col >= dma_row_chunks)                                                               \
+    {                                                                                               \
+      cursor.col -= dma_row_chunks;                                                                 \
+      carry = 1;                                                                                    \
+    }                                                                                               \
+    for (int d = 0; d < TENSOR_OUTER; d++)                                                          \
+    {                                                                                               \
+      cursor.index[d] += dma_steps[d] + carry;                                                      \
+      carry = 0;                                                                                    \
+      if ((d < (TENSOR_OUTER-1)) && (cursor.index[d] >= dma_extents[d]))                            \
+      {                                                                                             \
+        cursor.index[d] -= dma_extents[d];                                                          \
+        carry = 1;                                                                                  \
+      }                                                                                             \
+    }                                                                                               \
+  }                                                                                                 \
+  template<bool DMA_GLOBAL_LOAD, int DMA_LOAD_QUAL>                                                 \
+  __device__ __forceinline__ void load_step(const char *RESTRICT src_ptr, Cursor cursor)            \
+  {                                                                                                 \
+    for (int i = 0; i < TENSOR_LDS; i++)                                                            \
+    {                                                                                               \
+      if (cursor.unit < dma_total_units)                                                            \
+      {                                                                                             \
+        const char *ptr = src_ptr + chunk_offset(cursor, dma_src_strides);                          \
+        bulk_buffer[i] =                                                                            \
+            ptx_cudaDMA_load<TensorType,DMA_GLOBAL_LOAD,DMA_LOAD_QUAL>((const TensorType*)ptr);     \
+      }                                                                                             \
+      advance(cursor);                                                                              \
+    }                                                                                               \
+  }                                                                                                 \
+  template<int DMA_STORE_QUAL>                                                                      \
+  __device__ __forceinline__ void store_step(char *RESTRICT dst_ptr, Cursor &cursor)                \
+  {                                                                                                 \
+    for (int i = 0; i < TENSOR_LDS; i++)                                                            \
+    {                                                                                               \
+      if (cursor.unit < dma_total_units)                                                            \
+      {                                                                                             \
+        char *ptr = dst_ptr + chunk_offset(cursor, dma_dst_strides);                                \
+        ptx_cudaDMA_store<TensorType,DMA_STORE_QUAL>(bulk_buffer[i], (TensorType*)ptr);             \
+      }                                                                                             \
+      advance(cursor);                                                                              \
+    }                                                                                               \
+  }                                                                                                 \
+  template<bool DMA_GLOBAL_LOAD, int DMA_LOAD_QUAL>                                                 \
+  __device__ __forceinline__ void execute_start_xfer(const void *RESTRICT src_ptr)                  \
+  {                                                                                                 \
+    dma_src_ptr = (const char*)src_ptr;                                                             \
+    Cursor cursor;                                                                                  \
+    start_cursor(cursor);                                                                           \
+    load_step<DMA_GLOBAL_LOAD,DMA_LOAD_QUAL>(dma_src_ptr, cursor);                                  \
+  }                                                                                                 \
+  template<bool DMA_GLOBAL_LOAD, int DMA_LOAD_QUAL, int DMA_STORE_QUAL>                             \
+  __device__ __forceinline__ void execute_wait_xfer(void *RESTRICT dst_ptr)                         \
+  {                                                                                                 \
+    Cursor cursor;                                                                                  \
+    start_cursor(cursor);                                                                           \
+    store_step<DMA_STORE_QUAL>((char*)dst_ptr, cursor);                                             \
+    while (cursor.unit < dma_total_units)                                                           \
+    {                                                                                               \
+      load_step<DMA_GLOBAL_LOAD,DMA_LOAD_QUAL>(dma_src_ptr, cursor);                                \
+      store_step<DMA_STORE_QUAL>((char*)dst_ptr, cursor);                                           \
+    }                                                                                               \
+  }                                                                                                 \
+private:                                                                                            \
+  int dma_extents[TENSOR_OUTER];                                                                    \
+  int dma_src_strides[TENSOR_OUTER];                                                                \
+  int dma_dst_strides[TENSOR_OUTER];                                                                \
+  int dma_steps[TENSOR_OUTER];                                                                      \
+  int dma_start[TENSOR_OUTER];                                                                      \
+  int dma_start_unit;                                                                               \
+  int dma_start_col;                                                                                \
+  int dma_total_units;                                                                              \
+  const char *dma_src_ptr;                                                                          \
+  TensorType bulk_buffer[TENSOR_LDS];
+
+#define TENSOR_START_XFER_IMPL(GLOBAL_LOAD,LOAD_QUAL,STORE_QUAL)                                    \
+  execute_start_xfer<GLOBAL_LOAD,LOAD_QUAL>(src_ptr);
+
+#define TENSOR_WAIT_XFER_IMPL(GLOBAL_LOAD,LOAD_QUAL,STORE_QUAL)                                     \
+  execute_wait_xfer<GLOBAL_LOAD,LOAD_QUAL,STORE_QUAL>(dst_ptr);
+
+#define WARP_SPECIALIZED_UNQUALIFIED_METHODS                                                        \
+  __device__ __forceinline__ void execute_dma(const void *RESTRICT src_ptr, void *RESTRICT dst_ptr) \
+  {                                                                                                 \
+    start_xfer_async(src_ptr);                                                                      \
+    wait_xfer_finish(dst_ptr);                                                                      \
+  }                                                                                                 \
+  __device__ __forceinline__ void start_xfer_async(const void *RESTRICT src_ptr)                    \
+  {                                                                                                 \
+    TENSOR_START_XFER_IMPL(false,LOAD_CACHE_ALL,STORE_WRITE_BACK)                                   \
+  }                                                                                                 \
+  __device__ __forceinline__ void wait_xfer_finish(void *RESTRICT dst_ptr)                          \
+  {                                                                                                 \
+    CudaDMA::wait_for_dma_start();                                                                  \
+    TENSOR_WAIT_XFER_IMPL(false,LOAD_CACHE_ALL,STORE_WRITE_BACK)                                    \
+    CudaDMA::finish_async_dma();                                                                    \
+  }                                                                                                 \
+  __device__ __forceinline__ void prefetch(const void *RESTRICT src_ptr) const                      \
+  {                                                                                                 \
+    prefetch<false>(src_ptr);                                                                       \
+  }
+
+#define WARP_SPECIALIZED_QUALIFIED_METHODS                                                          \
+  template<bool DMA_GLOBAL_LOAD>                                                                    \
+  __device__ __forceinline__ void execute_dma(const void *RESTRICT src_ptr, void *RESTRICT dst_ptr) \
+  {                                                                                                 \
+    start_xfer_async<DMA_GLOBAL_LOAD>(src_ptr);                                                     \
+    wait_xfer_finish<DMA_GLOBAL_LOAD>(dst_ptr);                                                     \
+  }                                                                                                 \
+  template<bool DMA_GLOBAL_LOAD>                                                                    \
+  __device__ __forceinline__ void start_xfer_async(const void *RESTRICT src_ptr)                    \
+  {                                                                                                 \
+    TENSOR_START_XFER_IMPL(DMA_GLOBAL_LOAD,LOAD_CACHE_ALL,STORE_WRITE_BACK)                         \
+  }                                                                                                 \
+  template<bool DMA_GLOBAL_LOAD>                                                                    \
+  __device__ __forceinline__ void wait_xfer_finish(void *RESTRICT dst_ptr)                          \
+  {                                                                                                 \
+    CudaDMA::wait_for_dma_start();                                                                  \
+    TENSOR_WAIT_XFER_IMPL(DMA_GLOBAL_LOAD,LOAD_CACHE_ALL,STORE_WRITE_BACK)                          \
+    CudaDMA::finish_async_dma();                                                                    \
+  }                                                                                                 \
+  template<bool DMA_GLOBAL_LOAD, int DMA_LOAD_QUAL, int DMA_STORE_QUAL>                             \
+  __device__ __forceinline__ void execute_dma(const void *RESTRICT src_ptr, void *RESTRICT dst_ptr) \
+  {                                                                                                 \
+    start_xfer_async<DMA_GLOBAL_LOAD,DMA_LOAD_QUAL,DMA_STORE_QUAL>(src_ptr);                        \
+    wait_xfer_finish<DMA_GLOBAL_LOAD,DMA_LOAD_QUAL,DMA_STORE_QUAL>(dst_ptr);                        \
+  }                                                                                                 \
+  template<bool DMA_GLOBAL_LOAD, int DMA_LOAD_QUAL, int DMA_STORE_QUAL>                             \
+  __device__ __forceinline__ void start_xfer_async(const void *RESTRICT src_ptr)                    \
+  {                                                                                                 \
+    TENSOR_START_XFER_IMPL(DMA_GLOBAL_LOAD,DMA_LOAD_QUAL,DMA_STORE_QUAL)                            \
+  }                                                                                                 \
+  template<bool DMA_GLOBAL_LOAD, int DMA_LOAD_QUAL, int DMA_STORE_QUAL>                             \
+  __device__ __forceinline__ void wait_xfer_finish(void *RESTRICT dst_ptr)                          \
+  {                                                                                                 \
+    CudaDMA::wait_for_dma_start();                                                                  \
+    TENSOR_WAIT_XFER_IMPL(DMA_GLOBAL_LOAD,DMA_LOAD_QUAL,DMA_STORE_QUAL)                             \
+    CudaDMA::finish_async_dma();                                                                    \
+  }                                                                                                 \
+  template<bool DMA_GLOBAL_LOAD>                                                                    \
+  __device__ __forceinline__ void prefetch(const void *RESTRICT src_ptr) const                      \
+  {                                                                                                 \
+    /* Walk the transfer on a copy so that a transfer in flight is untouched */                     \
+    CudaDMAMeta::copy_of(*this).template prefetch_xfer<DMA_GLOBAL_LOAD>(src_ptr);                   \
+  }                                                                                                 \
+private:                                                                                            \
+  template<bool DMA_GLOBAL_LOAD>                                                                    \
+  __device__ __forceinline__ void prefetch_xfer(const void *RESTRICT src_ptr)                       \
+  {                                                                                                 \
+    void *const dst_ptr = NULL;                                                                     \
+    {                                                                                               \
+      TENSOR_START_XFER_IMPL(DMA_GLOBAL_LOAD,LOAD_PREFETCH_L2,CUDADMA_STORE_DISCARD)                \
+    }                                                                                               \
+    {                                                                                               \
+      TENSOR_WAIT_XFER_IMPL(DMA_GLOBAL_LOAD,LOAD_PREFETCH_L2,CUDADMA_STORE_DISCARD)                 \
+    }                                                                                               \
+  }
+
+#define NON_WARP_SPECIALIZED_UNQUALIFIED_METHODS                                                    \
+  __device__ __forceinline__ void execute_dma(const void *RESTRICT src_ptr, void *RESTRICT dst_ptr) \
+  {                                                                                                 \
+    start_xfer_async(src_ptr);                                                                      \
+    wait_xfer_finish(dst_ptr);                                                                      \
+  }                                                                                                 \
+  __device__ __forceinline__ void start_xfer_async(const void *RESTRICT src_ptr)                    \
+  {                                                                                                 \
+    TENSOR_START_XFER_IMPL(false,LOAD_CACHE_ALL,STORE_WRITE_BACK)                                   \
+  }                                                                                                 \
+  __device__ __forceinline__ void wait_xfer_finish(void *RESTRICT dst_ptr)                          \
+  {                                                                                                 \
+    TENSOR_WAIT_XFER_IMPL(false,LOAD_CACHE_ALL,STORE_WRITE_BACK)                                    \
+  }                                                                                                 \
+  __device__ __forceinline__ void prefetch(const void *RESTRICT src_ptr) const                      \
+  {                                                                                                 \
+    prefetch<false>(src_ptr);                                                                       \
+  }
+
+#define NON_WARP_SPECIALIZED_QUALIFIED_METHODS                                                      \
+  template<bool DMA_GLOBAL_LOAD>                                                                    \
+  __device__ __forceinline__ void execute_dma(const void *RESTRICT src_ptr, void *RESTRICT dst_ptr) \
+  {                                                                                                 \
+    start_xfer_async<DMA_GLOBAL_LOAD>(src_ptr);                                                     \
+    wait_xfer_finish<DMA_GLOBAL_LOAD>(dst_ptr);                                                     \
+  }                                                                                                 \
+  template<bool DMA_GLOBAL_LOAD>                                                                    \
+  __device__ __forceinline__ void start_xfer_async(const void *RESTRICT src_ptr)                    \
+  {                                                                                                 \
+    TENSOR_START_XFER_IMPL(DMA_GLOBAL_LOAD,LOAD_CACHE_ALL,STORE_WRITE_BACK)                         \
+  }                                                                                                 \
+  template<bool DMA_GLOBAL_LOAD>                                                                    \
+  __device__ __forceinline__ void wait_xfer_finish(void *RESTRICT dst_ptr)                          \
+  {                                                                                                 \
+    TENSOR_WAIT_XFER_IMPL(DMA_GLOBAL_LOAD,LOAD_CACHE_ALL,STORE_WRITE_BACK)                          \
+  }                                                                                                 \
+  template<bool DMA_GLOBAL_LOAD, int DMA_LOAD_QUAL, int DMA_STORE_QUAL>                             \
+  __device__ __forceinline__ void execute_dma(const void *RESTRICT src_ptr, void *RESTRICT dst_ptr) \
+  {                                                                                                 \
+    start_xfer_async<DMA_GLOBAL_LOAD,DMA_LOAD_QUAL,DMA_STORE_QUAL>(src_ptr);                        \
+    wait_xfer_finish<DMA_GLOBAL_LOAD,DMA_LOAD_QUAL,DMA_STORE_QUAL>(dst_ptr);                        \
+  }                                                                                                 \
+  template<bool DMA_GLOBAL_LOAD, int DMA_LOAD_QUAL, int DMA_STORE_QUAL>                             \
+  __device__ __forceinline__ void start_xfer_async(const void *RESTRICT src_ptr)                    \
+  {                                                                                                 \
+    TENSOR_START_XFER_IMPL(DMA_GLOBAL_LOAD,DMA_LOAD_QUAL,DMA_STORE_QUAL)                            \
+  }                                                                                                 \
+  template<bool DMA_GLOBAL_LOAD, int DMA_LOAD_QUAL, int DMA_STORE_QUAL>                             \
+  __device__ __forceinline__ void wait_xfer_finish(void *RESTRICT dst_ptr)                          \
+  {                                                                                                 \
+    TENSOR_WAIT_XFER_IMPL(DMA_GLOBAL_LOAD,DMA_LOAD_QUAL,DMA_STORE_QUAL)                             \
+  }                                                                                                 \
+  template<bool DMA_GLOBAL_LOAD>                                                                    \
+  __device__ __forceinline__ void prefetch(const void *RESTRICT src_ptr) const                      \
+  {                                                                                                 \
+    /* Walk the transfer on a copy so that a transfer in flight is untouched */                     \
+    CudaDMAMeta::copy_of(*this).template prefetch_xfer<DMA_GLOBAL_LOAD>(src_ptr);                   \
+  }                                                                                                 \
+private:                                                                                            \
+  template<bool DMA_GLOBAL_LOAD>                                                                    \
+  __device__ __forceinline__ void prefetch_xfer(const void *RESTRICT src_ptr)                       \
+  {                                                                                                 \
+    void *const dst_ptr = NULL;                                                                     \
+    {                                                                                               \
+      TENSOR_START_XFER_IMPL(DMA_GLOBAL_LOAD,LOAD_PREFETCH_L2,CUDADMA_STORE_DISCARD)                \
+    }                                                                                               \
+    {                                                                                               \
+      TENSOR_WAIT_XFER_IMPL(DMA_GLOBAL_LOAD,LOAD_PREFETCH_L2,CUDADMA_STORE_DISCARD)                 \
+    }                                                                                               \
+  }
+
+// Fully templated, warp-specialized
+template<bool DO_SYNC=false, int ALIGNMENT=0, int BYTES_PER_THREAD=4*ALIGNMENT, int DIMS=2,
+         int BYTES_PER_ROW=0, int DMA_THREADS=0>
+class CudaDMATensor : public CudaDMA {
+public:
+  typedef CudaDMATensorPlan<ALIGNMENT,BYTES_PER_THREAD,DIMS,BYTES_PER_ROW,DMA_THREADS> Plan;
+  __device__ CudaDMATensor(const int dmaID,
+                           const int num_compute_threads,
+                           const int dma_threadIdx_start,
+                           const int *extents,
+                           const int *src_strides,
+                           const int *dst_strides)
+    : CudaDMA(dmaID, DMA_THREADS, num_compute_threads, dma_threadIdx_start)
+  {
+    TENSOR_STATIC_ASSERTS;
+    STATIC_ASSERT(DO_SYNC && (BYTES_PER_ROW > 0) && (DMA_THREADS > 0));
+    STATIC_ASSERT((BYTES_PER_ROW%ALIGNMENT) == 0);
+    initialize(CUDADMA_DMA_TID, extents, src_strides, dst_strides);
+  }
+public:
+  WARP_SPECIALIZED_UNQUALIFIED_METHODS
+  WARP_SPECIALIZED_QUALIFIED_METHODS
+private:
+  static const int dma_threads = DMA_THREADS;
+  static const int dma_row_chunks = BYTES_PER_ROW/ALIGNMENT;
+  static const int dma_col_step = DMA_THREADS%(BYTES_PER_ROW/ALIGNMENT);
+  TENSOR_TRANSFER_IMPL
+};
+
+// Row size templated, warp-specialized
+template<int ALIGNMENT, int BYTES_PER_THREAD, int DIMS, int BYTES_PER_ROW>
+class CudaDMATensor<true,ALIGNMENT,BYTES_PER_THREAD,DIMS,BYTES_PER_ROW,0> : public CudaDMA {
+public:
+  __device__ CudaDMATensor(const int dmaID,
+                           const int num_dma_threads,
+                           const int num_compute_threads,
+                           const int dma_threadIdx_start,
+                           const int *extents,
+                           const int *src_strides,
+                           const int *dst_strides)
+    : CudaDMA(dmaID, num_dma_threads, num_compute_threads, dma_threadIdx_start),
+      dma_threads(num_dma_threads),
+      dma_col_step(num_dma_threads%(BYTES_PER_ROW/ALIGNMENT))
+  {
+    TENSOR_STATIC_ASSERTS;
+    STATIC_ASSERT(BYTES_PER_ROW > 0);
+    STATIC_ASSERT((BYTES_PER_ROW%ALIGNMENT) == 0);
+    initialize(CUDADMA_DMA_TID, extents, src_strides, dst_strides);
+  }
+public:
+  WARP_SPECIALIZED_UNQUALIFIED_METHODS
+  WARP_SPECIALIZED_QUALIFIED_METHODS
+private:
+  const int dma_threads;
+  static const int dma_row_chunks = BYTES_PER_ROW/ALIGNMENT;
+  const int dma_col_step;
+  TENSOR_TRANSFER_IMPL
+};
+
+// Nothing templated, warp-specialized
+template<int ALIGNMENT, int BYTES_PER_THREAD, int DIMS>
+class CudaDMATensor<true,ALIGNMENT,BYTES_PER_THREAD,DIMS,0,0> : public CudaDMA {
+public:
+  __device__ CudaDMATensor(const int dmaID,
+                           const int num_dma_threads,
+                           const int num_compute_threads,
+                           const int dma_threadIdx_start,
+                           const int bytes_per_row,
+                           const int *extents,
+                           const int *src_strides,
+                           const int *dst_strides)
+    : CudaDMA(dmaID, num_dma_threads, num_compute_threads, dma_threadIdx_start),
+      dma_threads(num_dma_threads),
+      dma_row_chunks(bytes_per_row/ALIGNMENT),
+      dma_col_step((bytes_per_row >= ALIGNMENT) ? (num_dma_threads%(bytes_per_row/ALIGNMENT)) : 0)
+  {
+    TENSOR_STATIC_ASSERTS;
+#ifdef DEBUG_CUDADMA
+    assert((bytes_per_row%ALIGNMENT) == 0);
+#endif
+    initialize(CUDADMA_DMA_TID, extents, src_strides, dst_strides);
+  }
+public:
+  WARP_SPECIALIZED_UNQUALIFIED_METHODS
+  WARP_SPECIALIZED_QUALIFIED_METHODS
+private:
+  const int dma_threads;
+  const int dma_row_chunks;
+  const int dma_col_step;
+  TENSOR_TRANSFER_IMPL
+};
+
+// Fully templated, non-warp-specialized
+template<int ALIGNMENT, int BYTES_PER_THREAD, int DIMS, int BYTES_PER_ROW, int DMA_THREADS>
+class CudaDMATensor<false,ALIGNMENT,BYTES_PER_THREAD,DIMS,BYTES_PER_ROW,DMA_THREADS>
+  : public CudaDMA {
+public:
+  typedef CudaDMATensorPlan<ALIGNMENT,BYTES_PER_THREAD,DIMS,BYTES_PER_ROW,DMA_THREADS> Plan;
+  __device__ CudaDMATensor(const int *extents,
+                           const int *src_strides,
+                           const int *dst_strides,
+                           const int dma_threadIdx_start = 0)
+    : CudaDMA(0, DMA_THREADS, DMA_THREADS, dma_threadIdx_start)
+  {
+    TENSOR_STATIC_ASSERTS;
+    STATIC_ASSERT((BYTES_PER_ROW > 0) && (DMA_THREADS > 0));
+    STATIC_ASSERT((BYTES_PER_ROW%ALIGNMENT) == 0);
+    initialize(CUDADMA_DMA_TID, extents, src_strides, dst_strides);
+  }
+public:
+  NON_WARP_SPECIALIZED_UNQUALIFIED_METHODS
+  NON_WARP_SPECIALIZED_QUALIFIED_METHODS
+private:
+  static const int dma_threads = DMA_THREADS;
+  static const int dma_row_chunks = BYTES_PER_ROW/ALIGNMENT;
+  static const int dma_col_step = DMA_THREADS%(BYTES_PER_ROW/ALIGNMENT);
+  TENSOR_TRANSFER_IMPL
+};
+
+// Row size templated, non-warp-specialized
+template<int ALIGNMENT, int BYTES_PER_THREAD, int DIMS, int BYTES_PER_ROW>
+class CudaDMATensor<false,ALIGNMENT,BYTES_PER_THREAD,DIMS,BYTES_PER_ROW,0> : public CudaDMA {
+public:
+  __device__ CudaDMATensor(const int *extents,
+                           const int *src_strides,
+                           const int *dst_strides)
+    : CudaDMA(0, blockDim.x, blockDim.x, 0),
+      dma_threads(blockDim.x),
+      dma_col_step(blockDim.x%(BYTES_PER_ROW/ALIGNMENT))
+  {
+    TENSOR_STATIC_ASSERTS;
+    STATIC_ASSERT(BYTES_PER_ROW > 0);
+    STATIC_ASSERT((BYTES_PER_ROW%ALIGNMENT) == 0);
+    initialize(threadIdx.x, extents, src_strides, dst_strides);
+  }
+public:
+  NON_WARP_SPECIALIZED_UNQUALIFIED_METHODS
+  NON_WARP_SPECIALIZED_QUALIFIED_METHODS
+private:
+  const int dma_threads;
+  static const int dma_row_chunks = BYTES_PER_ROW/ALIGNMENT;
+  const int dma_col_step;
+  TENSOR_TRANSFER_IMPL
+};
+
+// Nothing templated, non-warp-specialized
+template<int ALIGNMENT, int BYTES_PER_THREAD, int DIMS>
+class CudaDMATensor<false,ALIGNMENT,BYTES_PER_THREAD,DIMS,0,0> : public CudaDMA {
+public:
+  __device__ CudaDMATensor(const int bytes_per_row,
+                           const int *extents,
+                           const int *src_strides,
+                           const int *dst_strides)
+    : CudaDMA(0, blockDim.x, blockDim.x, 0),
+      dma_threads(blockDim.x),
+      dma_row_chunks(bytes_per_row/ALIGNMENT),
+      dma_col_step((bytes_per_row >= ALIGNMENT) ? (blockDim.x%(bytes_per_row/ALIGNMENT)) : 0)
+  {
+    TENSOR_STATIC_ASSERTS;
+#ifdef DEBUG_CUDADMA
+    assert((bytes_per_row%ALIGNMENT) == 0);
+#endif
+    initialize(threadIdx.x, extents, src_strides, dst_strides);
+  }
+public:
+  NON_WARP_SPECIALIZED_UNQUALIFIED_METHODS
+  NON_WARP_SPECIALIZED_QUALIFIED_METHODS
+private:
+  const int dma_threads;
+  const int dma_row_chunks;
+  const int dma_col_step;
+  TENSOR_TRANSFER_IMPL
+};
+
+#undef TENSOR_OUTER
+#undef TENSOR_LDS
+#undef TENSOR_STATIC_ASSERTS
+#undef TENSOR_CHECK_EXTENT
+#undef TENSOR_TRANSFER_IMPL
+#undef TENSOR_START_XFER_IMPL
+#undef TENSOR_WAIT_XFER_IMPL
+#undef WARP_SPECIALIZED_UNQUALIFIED_METHODS
+#undef WARP_SPECIALIZED_QUALIFIED_METHODS
+#undef NON_WARP_SPECIALIZED_UNQUALIFIED_METHODS
+#undef NON_WARP_SPECIALIZED_QUALIFIED_METHODS
+////////////////////////  End of CudaDMATensor   //////////////////////////////////////////////////
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+// CudaDMATranspose
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * CudaDMATranspose will transfer a tile of num_rows contiguous rows of row_bytes bytes
+ * (e.g. the columns of a column-major matrix) and store it transposed, so the element in
+ * column c of source row r ends up in column r of destination row c.  The loads are the
+ * same coalesced row loads as CudaDMAStrided, and the transpose is done by the DMA
+ * warps while storing, so the compute warps can read the tile in row-major order.
+ * DO_SYNC - is warp-specialized or not
+ * ALIGNMENT - guaranteed alignment of the tile origin, the row size and the source pitch
+ * BYTES_PER_THREAD - maximum number of bytes that can be used for buffering inside the instance
+ * BYTES_PER_ELMT - the size of an element of the tile, 4, 8 or 16 bytes
+ *
+ * Consecutive threads load consecutive chunks of a row and store them to consecutive
+ * destination rows, which maps them to the same shared memory bank when dst_pitch is a
+ * multiple of 128 bytes.  Either pad dst_pitch by one element or issue the transfer with
+ * a swizzled store qualifier whose rows are the destination rows to spread the stores over
+ * the banks, e.g. CudaDMASwizzle<5,2,7>::Store<STORE_WRITE_BACK>::qual for 4 byte elements
+ * and a dst_pitch of 128 bytes.  The swizzle keeps the tile dense and compute warps read
+ * element (c, r) through the same mapping with *Swizzle::apply(&tile[c*32+r]).  dst_pitch
+ * has to be the row size of the swizzle and 2^BASE at least BYTES_PER_ELMT.  The source
+ * pointer points to the first row and the destination pointer to the first destination
+ * row, the pitches are in bytes.
+ */
+// Elements of a row moved by a load
+#define TRANSPOSE_ELMTS (ALIGNMENT/BYTES_PER_ELMT)
+// Loads issued by each thread per step
+#define TRANSPOSE_LDS (BYTES_PER_THREAD/ALIGNMENT)
+
+// Every thread walks the chunks of the tile starting at its own index
+// and advancing by the number of DMA threads.
+#define TRANSPOSE_INIT(_tid,_threads)                                                               \
+      dma_num_rows(num_rows),                                                                       \
+      dma_src_pitch(src_pitch),                                                                     \
+      dma_dst_pitch(dst_pitch),                                                                     \
+      dma_walk(_tid, _threads, CudaDMAMeta::row_chunks(row_bytes, ALIGNMENT), num_rows)
+
+#define TRANSPOSE_STATIC_ASSERTS                                                                    \
+    STATIC_ASSERT((ALIGNMENT == 4) || (ALIGNMENT == 8) || (ALIGNMENT == 16));                       \
+    STATIC_ASSERT((BYTES_PER_ELMT == 4) || (BYTES_PER_ELMT == 8) || (BYTES_PER_ELMT == 16));        \
+    STATIC_ASSERT(ALIGNMENT >= BYTES_PER_ELMT);                                                     \
+    STATIC_ASSERT((BYTES_PER_THREAD/ALIGNMENT) > 0);                                                \
+    STATIC_ASSERT((BYTES_PER_THREAD%ALIGNMENT) == 0)
+
+#define TRANSPOSE_TRANSFER_IMPL                                                                     \
+  typedef typename CudaDMAMeta::VectorType<ALIGNMENT>::type RowType;                                \
+  typedef typename CudaDMAMeta::VectorType<BYTES_PER_ELMT>::type ElmtType;                          \
+  template<bool DMA_GLOBAL_LOAD, int DMA_LOAD_QUAL>                                                 \
+  __device__ __forceinline__ void load_step(const char *RESTRICT src_ptr,                           \
+                                            CudaDMAMeta::TileCursor cursor)                         \
+  {                                                                                                 \
+    for (int i = 0; i < TRANSPOSE_LDS; i++)                                                         \
+    {                                                                                               \
+      if (dma_walk.valid(cursor))                                                                   \
+      {                                                                                             \
+        const char *ptr = src_ptr + cursor.row*dma_src_pitch + cursor.col*ALIGNMENT;                \
+        bulk_buffer[i] = ptx_cudaDMA_load<RowType,DMA_GLOBAL_LOAD,DMA_LOAD_QUAL>((const RowType*)ptr);\
+      }                                                                                             \
+      dma_walk.advance(cursor);                                                                     \
+    }                                                                                               \
+  }                                                                                                 \
+  template<int DMA_STORE_QUAL>                                                                      \
+  __device__ __forceinline__ void store_step(char *RESTRICT dst_ptr,                                \
+                                             CudaDMAMeta::TileCursor &cursor)                       \
+  {                                                                                                 \
+    /* A swizzle may only permute the elements within a destination row */                          \
+    STATIC_ASSERT(!(DMA_STORE_QUAL & CUDADMA_STORE_SWIZZLED) ||                                     \
+                  ((1 << CUDADMA_SWIZZLE_BASE(DMA_STORE_QUAL)) >= BYTES_PER_ELMT));                 \
+    TRANSPOSE_CHECK_SWIZZLE(DMA_STORE_QUAL,dst_ptr)                                                 \
+    for (int i = 0; i < TRANSPOSE_LDS; i++)                                                         \
+    {                                                                                               \
+      if (dma_walk.valid(cursor))                                                                   \
+      {                                                                                             \
+        const ElmtType *elmts = reinterpret_cast<const ElmtType*>(&bulk_buffer[i]);                 \
+        const int dst_row = cursor.col*TRANSPOSE_ELMTS;                                             \
+        for (int j = 0; j < TRANSPOSE_ELMTS; j++)                                                   \
+        {                                                                                           \
+          char *ptr = dst_ptr + (dst_row+j)*dma_dst_pitch + cursor.row*BYTES_PER_ELMT;              \
+          ptx_cudaDMA_store<ElmtType,DMA_STORE_QUAL>(elmts[j], (ElmtType*)ptr);                     \
+        }                                                                                           \
+      }                                                                                             \
+      dma_walk.advance(cursor);                                                                     \
+    }                                                                                               \
+  }                                                                                                 \
+  template<bool DMA_GLOBAL_LOAD, int DMA_LOAD_QUAL>                                                 \
+  __device__ __forceinline__ void execute_start_xfer(const void *RESTRICT src_ptr)                  \
+  {                                                                                                 \
+    dma_src_ptr = (const char*)src_ptr;                                                             \
+    load_step<DMA_GLOBAL_LOAD,DMA_LOAD_QUAL>(dma_src_ptr, dma_walk.start());                        \
+  }                                                                                                 \
+  TILE_WAIT_XFER_IMPL                                                                               \
+private:                                                                                            \
+  const int dma_num_rows;                                                                           \
+  const int dma_src_pitch;                                                                          \
+  const int dma_dst_pitch;                                                                          \
+  const CudaDMAMeta::TileWalk<> dma_walk;                                                           \
+  const char *dma_src_ptr;                                                                          \
+  RowType bulk_buffer[TRANSPOSE_LDS];
+
+// The rows of a swizzled store qualifier have to be the destination rows,
+// otherwise the swizzle moves elements into the neighbouring rows
+#ifdef DEBUG_CUDADMA
+#define TRANSPOSE_CHECK_SWIZZLE(STORE_QUAL,DST_PTR)                                                 \
+    if ((STORE_QUAL & CUDADMA_STORE_SWIZZLED) &&                                                    \
+        ((dma_dst_pitch != (1 << CUDADMA_SWIZZLE_SHIFT(STORE_QUAL))) ||                             \
+         ((size_t(DST_PTR) % (size_t(dma_dst_pitch) << CUDADMA_SWIZZLE_BITS(STORE_QUAL))) != 0)))   \
+      assert(false);
+#else
+#define TRANSPOSE_CHECK_SWIZZLE(STORE_QUAL,DST_PTR)
+#endif
+
+#define TRANSPOSE_START_XFER_IMPL(GLOBAL_LOAD,LOAD_QUAL,STORE_QUAL)                                 \
+  execute_start_xfer<GLOBAL_LOAD,LOAD_QUAL>(src_ptr);
+
+#define TRANSPOSE_WAIT_XFER_IMPL(GLOBAL_LOAD,LOAD_QUAL,STORE_QUAL)                                  \
+  execute_wait_xfer<GLOBAL_LOAD,LOAD_QUAL,STORE_QUAL>(dst_ptr);
+
+#define WARP_SPECIALIZED_UNQUALIFIED_METHODS                                                        \
+  __device__ __forceinline__ void execute_dma(const void *RESTRICT src_ptr, void *RESTRICT dst_ptr) \
+  {                                                                                                 \
+    start_xfer_async(src_ptr);                                                                      \
+    wait_xfer_finish(dst_ptr);                                                                      \
+  }                                                                                                 \
+  __device__ __forceinline__ void start_xfer_async(const void *RESTRICT src_ptr)                    \
+  {                                                                                                 \
+    TRANSPOSE_START_XFER_IMPL(false,LOAD_CACHE_ALL,STORE_WRITE_BACK)                                \
+  }                                                                                                 \
+  __device__ __forceinline__ void wait_xfer_finish(void *RESTRICT dst_ptr)                          \
+  {                                                                                                 \
+    CudaDMA::wait_for_dma_start();                                                                  \
+    TRANSPOSE_WAIT_XFER_IMPL(false,LOAD_CACHE_ALL,STORE_WRITE_BACK)                                 \
+    CudaDMA::finish_async_dma();                                                                    \
+  }                                                                                                 \
+  __device__ __forceinline__ void prefetch(const void *RESTRICT src_ptr) const                      \
+  {                                                                                                 \
+    prefetch<false>(src_ptr);                                                                       \
+  }
+
+#define WARP_SPECIALIZED_QUALIFIED_METHODS                                                          \
+  template<bool DMA_GLOBAL_LOAD>                                                                    \
+  __device__ __forceinline__ void execute_dma(const void *RESTRICT src_ptr, void *RESTRICT dst_ptr) \
+  {                                                                                                 \
+    start_xfer_async<DMA_GLOBAL_LOAD>(src_ptr);                                                     \
+    wait_xfer_finish<DMA_GLOBAL_LOAD>(dst_ptr);                                                     \
+  }                                                                                                 \
+  template<bool DMA_GLOBAL_LOAD>                                                                    \
+  __device__ __forceinline__ void start_xfer_async(const void *RESTRICT src_ptr)                    \
+  {                                                                                                 \
+    TRANSPOSE_START_XFER_IMPL(DMA_GLOBAL_LOAD,LOAD_CACHE_ALL,STORE_WRITE_BACK)                      \
+  }                                                                                                 \
+  template<bool DMA_GLOBAL_LOAD>                                                                    \
+  __device__ __forceinline__ void wait_xfer_finish(void *RESTRICT dst_ptr)                          \
+  {                                                                                                 \
+    CudaDMA::wait_for_dma_start();                                                                  \
+    TRANSPOSE_WAIT_XFER_IMPL(DMA_GLOBAL_LOAD,LOAD_CACHE_ALL,STORE_WRITE_BACK)                       \
+    CudaDMA::finish_async_dma();                                                                    \
+  }                                                                                                 \
+  template<bool DMA_GLOBAL_LOAD, int DMA_LOAD_QUAL, int DMA_STORE_QUAL>                             \
+  __device__ __forceinline__ void execute_dma(const void *RESTRICT src_ptr, void *RESTRICT dst_ptr) \
+  {                                                                                                 \
+    start_xfer_async<DMA_GLOBAL_LOAD,DMA_LOAD_QUAL,DMA_STORE_QUAL>(src_ptr);                        \
+    wait_xfer_finish<DMA_GLOBAL_LOAD,DMA_LOAD_QUAL,DMA_STORE_QUAL>(dst_ptr);                        \
+  }                                                                                                 \
+  template<bool DMA_GLOBAL_LOAD, int DMA_LOAD_QUAL, int DMA_STORE_QUAL>                             \
+  __device__ __forceinline__ void start_xfer_async(const void *RESTRICT src_ptr)                    \
+  {                                                                                                 \
+    TRANSPOSE_START_XFER_IMPL(DMA_GLOBAL_LOAD,DMA_LOAD_QUAL,DMA_STORE_QUAL)                         \
+  }                                                                                                 \
+  template<bool DMA_GLOBAL_LOAD, int DMA_LOAD_QUAL, int DMA_STORE_QUAL>                             \
+  __device__ __forceinline__ void wait_xfer_finish(void *RESTRICT dst_ptr)                          \
+  {                                                                                                 \
+    CudaDMA::wait_for_dma_start();                                                                  \
+    TRANSPOSE_WAIT_XFER_IMPL(DMA_GLOBAL_LOAD,DMA_LOAD_QUAL,DMA_STORE_QUAL)                          \
+    CudaDMA::finish_async_dma();                                                                    \
+  }                                                                                                 \
+  template<bool DMA_GLOBAL_LOAD>                                                                    \
+  __device__ __forceinline__ void prefetch(const void *RESTRICT src_ptr) const                      \
+  {                                                                                                 \
+    /* Walk the transfer on a copy so that a transfer in flight is untouched */                     \
+    CudaDMAMeta::copy_of(*this).template prefetch_xfer<DMA_GLOBAL_LOAD>(src_ptr);                   \
+  }                                                                                                 \
+private:                                                                                            \
+  template<bool DMA_GLOBAL_LOAD>                                                                    \
+  __device__ __forceinline__ void prefetch_xfer(const void *RESTRICT src_ptr)                       \
+  {                                                                                                 \
+    void *const dst_ptr = NULL;                                                                     \
+    {                                                                                               \
+      TRANSPOSE_START_XFER_IMPL(DMA_GLOBAL_LOAD,LOAD_PREFETCH_L2,CUDADMA_STORE_DISCARD)             \
+    }                                                                                               \
+    {                                                                                               \
+      TRANSPOSE_WAIT_XFER_IMPL(DMA_GLOBAL_LOAD,LOAD_PREFETCH_L2,CUDADMA_STORE_DISCARD)              \
+    }                                                                                               \
+  }
+
+#define NON_WARP_SPECIALIZED_UNQUALIFIED_METHODS                                                    \
+  __device__ __forceinline__ void execute_dma(const void *RESTRICT src_ptr, void *RESTRICT dst_ptr) \
+  {                                                                                                 \
+    start_xfer_async(src_ptr);                                                                      \
+    wait_xfer_finish(dst_ptr);                                                                      \
+  }                                                                                                 \
+  __device__ __forceinline__ void start_xfer_async(const void *RESTRICT src_ptr)                    \
+  {                                                                                                 \
+    TRANSPOSE_START_XFER_IMPL(false,LOAD_CACHE_ALL,STORE_WRITE_BACK)                                \
+  }                                                                                                 \
+  __device__ __forceinline__ void wait_xfer_finish(void *RESTRICT dst_ptr)                          \
+  {                                                                                                 \
+    TRANSPOSE_WAIT_XFER_IMPL(false,LOAD_CACHE_ALL,STORE_WRITE_BACK)                                 \
+  }                                                                                                 \
+  __device__ __forceinline__ void prefetch(const void *RESTRICT src_ptr) const                      \
+  {                                                                                                 \
+    prefetch<false>(src_ptr);                                                                       \
+  }
+
+#define NON_WARP_SPECIALIZED_QUALIFIED_METHODS                                                      \
+  template<bool DMA_GLOBAL_LOAD>                                                                    \
+  __device__ __forceinline__ void execute_dma(const void *RESTRICT src_ptr, void *RESTRICT dst_ptr) \
+  {                                                                                                 \
+    start_xfer_async<DMA_GLOBAL_LOAD>(src_ptr);                                                     \
+    wait_xfer_finish<DMA_GLOBAL_LOAD>(dst_ptr);                                                     \
+  }                                                                                                 \
+  template<bool DMA_GLOBAL_LOAD>                                                                    \
+  __device__ __forceinline__ void start_xfer_async(const void *RESTRICT src_ptr)                    \
+  {                                                                                                 \
+    TRANSPOSE_START_XFER_IMPL(DMA_GLOBAL_LOAD,LOAD_CACHE_ALL,STORE_WRITE_BACK)                      \
+  }                                                                                                 \
+  template<bool DMA_GLOBAL_LOAD>                                                                    \
+  __device__ __forceinline__ void wait_xfer_finish(void *RESTRICT dst_ptr)                          \
+  {                                                                                                 \
+    TRANSPOSE_WAIT_XFER_IMPL(DMA_GLOBAL_LOAD,LOAD_CACHE_ALL,STORE_WRITE_BACK)                       \
+  }                                                                                                 \
+  template<bool DMA_GLOBAL_LOAD, int DMA_LOAD_QUAL, int DMA_STORE_QUAL>                             \
+  __device__ __forceinline__ void execute_dma(const void *RESTRICT src_ptr, void *RESTRICT dst_ptr) \
+  {                                                                                                 \
+    start_xfer_async<DMA_GLOBAL_LOAD,DMA_LOAD_QUAL,DMA_STORE_QUAL>(src_ptr);                        \
+    wait_xfer_finish<DMA_GLOBAL_LOAD,DMA_LOAD_QUAL,DMA_STORE_QUAL>(dst_ptr);                        \
+  }                                                                                                 \
+  template<bool DMA_GLOBAL_LOAD, int DMA_LOAD_QUAL, int DMA_STORE_QUAL>                             \
+  __device__ __forceinline__ void start_xfer_async(const void *RESTRICT src_ptr)                    \
+  {                                                                                                 \
+    TRANSPOSE_START_XFER_IMPL(DMA_GLOBAL_LOAD,DMA_LOAD_QUAL,DMA_STORE_QUAL)                         \
+  }                                                                                                 \
+  template<bool DMA_GLOBAL_LOAD, int DMA_LOAD_QUAL, int DMA_STORE_QUAL>                             \
+  __device__ __forceinline__ void wait_xfer_finish(void *RESTRICT dst_ptr)                          \
+  {                                                                                                 \
+    TRANSPOSE_WAIT_XFER_IMPL(DMA_GLOBAL_LOAD,DMA_LOAD_QUAL,DMA_STORE_QUAL)                          \
+  }                                                                                                 \
+  template<bool DMA_GLOBAL_LOAD>                                                                    \
+  __device__ __forceinline__ void prefetch(const void *RESTRICT src_ptr) const                      \
+  {                                                                                                 \
+    /* Walk the transfer on a copy so that a transfer in flight is untouched */                     \
+    CudaDMAMeta::copy_of(*this).template prefetch_xfer<DMA_GLOBAL_LOAD>(src_ptr);                   \
+  }                                                                                                 \
+private:                                                                                            \
+  template<bool DMA_GLOBAL_LOAD>                                                                    \
+  __device__ __forceinline__ void prefetch_xfer(const void *RESTRICT src_ptr)                       \
+  {                                                                                                 \
+    void *const dst_ptr = NULL;                                                                     \
+    {                                                                                               \
+      TRANSPOSE_START_XFER_IMPL(DMA_GLOBAL_LOAD,LOAD_PREFETCH_L2,CUDADMA_STORE_DISCARD)             \
+    }                                                                                               \
+    {                                                                                               \
+      TRANSPOSE_WAIT_XFER_IMPL(DMA_GLOBAL_LOAD,LOAD_PREFETCH_L2,CUDADMA_STORE_DISCARD)              \
+    }                                                                                               \
+  }
+
+template<bool DO_SYNC=false, int ALIGNMENT=0, int BYTES_PER_THREAD=4*ALIGNMENT, int BYTES_PER_ELMT=4>
+class CudaDMATranspose : public CudaDMA {
+public:
+  __device__ CudaDMATranspose(const int dmaID,
+                              const int num_dma_threads,
+                              const int num_compute_threads,
+                              const int dma_threadIdx_start,
+                              const int row_bytes,
+                              const int num_rows,
+                              const int src_pitch,
+                              const int dst_pitch)
+    : CudaDMA(dmaID, num_dma_threads, num_compute_threads, dma_threadIdx_start),
+      TRANSPOSE_INIT(CUDADMA_DMA_TID, num_dma_threads)
+  {
+    TRANSPOSE_STATIC_ASSERTS;
+  }
+public:
+  WARP_SPECIALIZED_UNQUALIFIED_METHODS
+  WARP_SPECIALIZED_QUALIFIED_METHODS
+private:
+  TRANSPOSE_TRANSFER_IMPL
+};
+
+template<int ALIGNMENT, int BYTES_PER_THREAD, int BYTES_PER_ELMT>
+class CudaDMATranspose<false,ALIGNMENT,BYTES_PER_THREAD,BYTES_PER_ELMT> : public CudaDMA {
+public:
+  __device__ CudaDMATranspose(const int row_bytes,
+                              const int num_rows,
+                              const int src_pitch,
+                              const int dst_pitch)
+    : CudaDMA(0, blockDim.x, blockDim.x, 0),
+      TRANSPOSE_INIT(threadIdx.x, blockDim.x)
+  {
+    TRANSPOSE_STATIC_ASSERTS;
+  }
+public:
+  NON_WARP_SPECIALIZED_UNQUALIFIED_METHODS
+  NON_WARP_SPECIALIZED_QUALIFIED_METHODS
+private:
+  TRANSPOSE_TRANSFER_IMPL
+};
+
+#undef TRANSPOSE_ELMTS
+#undef TRANSPOSE_LDS
+#undef TRANSPOSE_INIT
+#undef TRANSPOSE_STATIC_ASSERTS
+#undef TRANSPOSE_TRANSFER_IMPL
+#undef TRANSPOSE_CHECK_SWIZZLE
+#undef TRANSPOSE_START_XFER_IMPL
+#undef TRANSPOSE_WAIT_XFER_IMPL
+#undef WARP_SPECIALIZED_UNQUALIFIED_METHODS
+#undef WARP_SPECIALIZED_QUALIFIED_METHODS
+#undef NON_WARP_SPECIALIZED_UNQUALIFIED_METHODS
+#undef NON_WARP_SPECIALIZED_QUALIFIED_METHODS
+////////////////////////  End of CudaDMATranspose //////////////////////////////////////////////////
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+// CudaDMAIndirectRuns
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * A run of consecutive element indices of an indirect transfer, i.e. the
+ * elements index, index+1, ..., index+length-1.  start is the position of
+ * the first element of the run on the packed side of the transfer.
+ */
+struct CudaDMAIndirectRun {
+  int index;
+  int length;
+  int start;
+};
+
+/**
+ * Compress the index list of an indirect transfer into runs of consecutive
+ * indices.  runs must have room for num_elmts entries and the number of runs
+ * written is returned.  The table can be built once on the host for index
+ * lists that are reused (e.g. CSR neighbour lists), or on the device by a
+ * single thread before the transfer is started.
+ */
+__host__ __device__ inline
+int cudaDMA_build_indirect_runs(const int *index_ptr, const int num_elmts, CudaDMAIndirectRun *runs)
+{
+  int num_runs = 0;
+  for (int i = 0; i < num_elmts; i++)
+  {
+    if ((num_runs > 0) && (index_ptr[i] == (runs[num_runs-1].index + runs[num_runs-1].length)))
+      runs[num_runs-1].length++;
+    else
+    {
+      runs[num_runs].index = index_ptr[i];
+      runs[num_runs].length = 1;
+      runs[num_runs].start = i;
+      num_runs++;
+    }
+  }
+  return num_runs;
+}
+
+/**
+ * CudaDMAIndirectRuns performs the same gathers and scatters as CudaDMAIndirect
+ * but takes the index list as a table of runs of consecutive indices built by
+ * cudaDMA_build_indirect_runs.  The elements are packed on one side of the
+ * transfer, so the transfer is split into ALIGNMENT sized chunks of the packed
+ * side which are assigned to DMA threads round robin exactly as in
+ * CudaDMASequential.  Within a run the chunks are contiguous on both sides and
+ * a warp issues fully coalesced loads and stores regardless of the element size.
+ * GATHER - gather (index the source) or scatter (index the destination)
+ * DO_SYNC - is warp-specialized or not
+ * ALIGNMENT - guaranteed alignment of the pointers and the element size
+ * BYTES_PER_THREAD - maximum number of bytes that can be used for buffering inside the instance
+ * BYTES_PER_ELMT - the size of the element to be transfered
+ *
+ * The transfer methods take the run table and the number of runs returned by
+ * cudaDMA_build_indirect_runs.  Each DMA thread finds the run of its first
+ * chunk with a binary search on the packed starts of the runs, and the run of
+ * every later chunk with a binary search of the few runs it can have moved
+ * past.  This pays off when the average run is at least a few elements long,
+ * e.g. for sorted or mostly sorted index lists.  Use CudaDMAIndirect for
+ * random index lists.
+ */
+// Chunks per element and loads issued by each thread per step
+#define RUNS_ELMT_UNITS (BYTES_PER_ELMT/ALIGNMENT)
+#define RUNS_LDS (BYTES_PER_THREAD/ALIGNMENT)
+
+#define RUNS_INIT(_tid,_threads)                                                                    \
+      dma_threads(_threads),                                                                        \
+      dma_total_units(num_elmts*RUNS_ELMT_UNITS),                                                   \
+      dma_start_unit(int(_tid))
+
+#define RUNS_STATIC_ASSERTS                                                                         \
+    STATIC_ASSERT((ALIGNMENT == 4) || (ALIGNMENT == 8) || (ALIGNMENT == 16));                       \
+    STATIC_ASSERT((BYTES_PER_THREAD/ALIGNMENT) > 0);                                                \
+    STATIC_ASSERT((BYTES_PER_THREAD%ALIGNMENT) == 0);                                               \
+    STATIC_ASSERT((BYTES_PER_ELMT > 0) && ((BYTES_PER_ELMT%ALIGNMENT) == 0))
+
+#define RUNS_TRANSFER_IMPL                                                                          \
+  typedef typename CudaDMAMeta::VectorType<ALIGNMENT>::type RunsType;                               \
+  /* Move the cursor to the run containing its chunk.  run_offset is the byte */                    \
+  /* offset of the indexed side minus the one of the packed side.  Every run */                     \
+  /* holds at least one element, so the run of the chunk is at most as many */                      \
+  /* runs past the cursor as there are elements between the end of the run */                       \
+  /* at the cursor and the chunk.  A binary search of that range on the packed */                   \
+  /* starts of the runs costs a handful of dependent loads however short the */                     \
+  /* runs are. */                                                                                   \
+  __device__ __forceinline__ void seek(const int unit, int &run, int &run_end,                      \
+                                       long long &run_offset) const                                 \
+  {                                                                                                 \
+    if ((unit < run_end) || (unit >= dma_total_units))                                              \
+      return;                                                                                       \
+    const int elmt = unit/RUNS_ELMT_UNITS;                                                          \
+    int lo = run + 1;                                                                               \
+    int hi = lo + (elmt - run_end/RUNS_ELMT_UNITS);                                                 \
+    if (hi > (dma_num_runs-1))                                                                      \
+      hi = dma_num_runs-1;                                                                          \
+    while (lo < hi)                                                                                 \
+    {                                                                                               \
+      const int mid = (lo + hi + 1) >> 1;                                                           \
+      if (dma_runs[mid].start <= elmt)                                                              \
+        lo = mid;                                                                                   \
+      else                                                                                          \
+        hi = mid - 1;                                                                               \
+    }                                                                                               \
+    run = lo;                                                                                       \
+    const CudaDMAIndirectRun entry = dma_runs[run];                                                 \
+    run_end = (entry.start + entry.length)*RUNS_ELMT_UNITS;                                         \
+    run_offset = (long long)(entry.index - entry.start)*BYTES_PER_ELMT;                             \
+  }                                                                                                 \
+  template<bool DMA_GLOBAL_LOAD, int DMA_LOAD_QUAL>                                                 \
+  __device__ __forceinline__ void load_step(const char *RESTRICT src_ptr, int unit, int run,        \
+                                            int run_end, long long run_offset)                      \
+  {                                                                                                 \
+    for (int i = 0; i < RUNS_LDS; i++)                                                              \
+    {                                                                                               \
+      if (unit < dma_total_units)                                                                   \
+      {                                                                                             \
+        const char *ptr = src_ptr + unit*ALIGNMENT + (GATHER ? run_offset : 0);                     \
+        bulk_buffer[i] = ptx_cudaDMA_load<RunsType,DMA_GLOBAL_LOAD,DMA_LOAD_QUAL>((const RunsType*)ptr);\
+      }                                                                                             \
+      unit += dma_threads;                                                                          \
+      seek(unit, run, run_end, run_offset);                                                         \
+    }                                                                                               \
+  }                                                                                                 \
+  template<int DMA_STORE_QUAL>                                                                      \
+  __device__ __forceinline__ void store_step(char *RESTRICT dst_ptr, int &unit, int &run,           \
+                                             int &run_end, long long &run_offset)                   \
+  {                                                                                                 \
+    for (int i = 0; i < RUNS_LDS; i++)                                                              \
+    {                                                                                               \
+      if (unit < dma_total_units)                                                                   \
+      {                                                                                             \
+        char *ptr = dst_ptr + unit*ALIGNMENT + (GATHER ? 0 : run_offset);                           \
+        ptx_cudaDMA_store<RunsType,DMA_STORE_QUAL>(bulk_buffer[i], (RunsType*)ptr);                 \
+      }                                                                                             \
+      unit += dma_threads;                                                                          \
+      seek(unit, run, run_end, run_offset);                                                         \
+    }                                                                                               \
+  }                                                                                                 \
+  template<bool DMA_GLOBAL_LOAD, int DMA_LOAD_QUAL>                                                 \
+  __device__ __forceinline__ void execute_start_xfer(const CudaDMAIndirectRun *RESTRICT run_ptr,    \
+                                                     const int num_runs,                            \
+                                                     const void *RESTRICT src_ptr)                  \
+  {                                                                                                 \
+    dma_src_ptr = (const char*)src_ptr;                                                             \
+    dma_runs = run_ptr;                                                                             \
+    dma_num_runs = num_runs;                                                                        \
+    /* Search the whole table for the first chunk of this thread */                                 \
+    dma_start_run = -1;                                                                             \
+    dma_start_run_end = 0;                                                                          \
+    dma_start_run_offset = 0;                                                                       \
+    seek(dma_start_unit, dma_start_run, dma_start_run_end, dma_start_run_offset);                   \
+    load_step<DMA_GLOBAL_LOAD,DMA_LOAD_QUAL>(dma_src_ptr, dma_start_unit, dma_start_run,            \
+                                             dma_start_run_end, dma_start_run_offset);              \
+  }                                                                                                 \
+  template<bool DMA_GLOBAL_LOAD, int DMA_LOAD_QUAL, int DMA_STORE_QUAL>                             \
+  __device__ __forceinline__ void execute_wait_xfer(void *RESTRICT dst_ptr)                         \
+  {                                                                                                 \
+    int unit = dma_start_unit;                                                                      \
+    int run = dma_start_run;                                                                        \
+    int run_end = dma_start_run_end;                                                                \
+    long long run_offset = dma_start_run_offset;                                                    \
+    store_step<DMA_STORE_QUAL>((char*)dst_ptr, unit, run, run_end, run_offset);                     \
+    while (unit < dma_total_units)                                                                  \
+    {                                                                                               \
+      load_step<DMA_GLOBAL_LOAD,DMA_LOAD_QUAL>(dma_src_ptr, unit, run, run_end, run_offset);        \
+      store_step<DMA_STORE_QUAL>((char*)dst_ptr, unit, run, run_end, run_offset);                   \
+    }                                                                                               \
+  }                                                                                                 \
+private:                                                                                            \
+  const int dma_threads;                                                                            \
+  const int dma_total_units;                                                                        \
+  const int dma_start_unit;                                                                         \
+  const char *dma_src_ptr;                                                                          \
+  const CudaDMAIndirectRun *dma_runs;                                                               \
+  int dma_num_runs;                                                                                 \
+  int dma_start_run;                                                                                \
+  int dma_start_run_end;                                                                            \
+  long long dma_start_run_offset;                                                                   \
+  RunsType bulk_buffer[RUNS_LDS];
+
+#define RUNS_START_XFER_IMPL(GLOBAL_LOAD,LOAD_QUAL,STORE_QUAL)                                      \
+  execute_start_xfer<GLOBAL_LOAD,LOAD_QUAL>(run_ptr, num_runs, src_ptr);
+
+#define RUNS_WAIT_XFER_IMPL(GLOBAL_LOAD,LOAD_QUAL,STORE_QUAL)                                       \
+  execute_wait_xfer<GLOBAL_LOAD,LOAD_QUAL,STORE_QUAL>(dst_ptr);
+
+#define WARP_SPECIALIZED_UNQUALIFIED_METHODS                                                        \
+  __device__ __forceinline__ void execute_dma(const CudaDMAIndirectRun *RESTRICT run_ptr,           \
+                        const int num_runs,                                                         \
+                        const void *RESTRICT src_ptr, void *RESTRICT dst_ptr)                       \
+  {                                                                                                 \
+    start_xfer_async(run_ptr, num_runs, src_ptr);                                                   \
+    wait_xfer_finish(dst_ptr);                                                                      \
+  }                                                                                                 \
+  __device__ __forceinline__ void start_xfer_async(const CudaDMAIndirectRun *RESTRICT run_ptr,      \
+                                                   const int num_runs,                              \
+                                                   const void *RESTRICT src_ptr)                    \
+  {                                                                                                 \
+    RUNS_START_XFER_IMPL(false,LOAD_CACHE_ALL,STORE_WRITE_BACK)                                     \
+  }                                                                                                 \
+  __device__ __forceinline__ void wait_xfer_finish(void *RESTRICT dst_ptr)                          \
+  {                                                                                                 \
+    CudaDMA::wait_for_dma_start();                                                                  \
+    RUNS_WAIT_XFER_IMPL(false,LOAD_CACHE_ALL,STORE_WRITE_BACK)                                      \
+    CudaDMA::finish_async_dma();                                                                    \
+  }                                                                                                 \
+  __device__ __forceinline__ void prefetch(const CudaDMAIndirectRun *RESTRICT run_ptr,              \
+                                           const int num_runs,                                      \
+                                           const void *RESTRICT xfer_ptr) const                     \
+  {                                                                                                 \
+    prefetch<false>(run_ptr, num_runs, xfer_ptr);                                                   \
+  }
+
+#define WARP_SPECIALIZED_QUALIFIED_METHODS                                                          \
+  template<bool DMA_GLOBAL_LOAD>                                                                    \
+  __device__ __forceinline__ void execute_dma(const CudaDMAIndirectRun *RESTRICT run_ptr,           \
+                        const int num_runs,                                                         \
+                        const void *RESTRICT src_ptr, void *RESTRICT dst_ptr)                       \
+  {                                                                                                 \
+    start_xfer_async<DMA_GLOBAL_LOAD>(run_ptr, num_runs, src_ptr);                                  \
+    wait_xfer_finish<DMA_GLOBAL_LOAD>(dst_ptr);                                                     \
+  }                                                                                                 \
+  template<bool DMA_GLOBAL_LOAD>                                                                    \
+  __device__ __forceinline__ void start_xfer_async(const CudaDMAIndirectRun *RESTRICT run_ptr,      \
+                                                   const int num_runs,                              \
+                                                   const void *RESTRICT src_ptr)                    \
+  {                                                                                                 \
+    RUNS_START_XFER_IMPL(DMA_GLOBAL_LOAD,LOAD_CACHE_ALL,STORE_WRITE_BACK)                           \
+  }                                                                                                 \
+  template<bool DMA_GLOBAL_LOAD>                                                                    \
+  __device__ __forceinline__ void wait_xfer_finish(void *RESTRICT dst_ptr)                          \
+  {                                                                                                 \
+    CudaDMA::wait_for_dma_start();                                                                  \
+    RUNS_WAIT_XFER_IMPL(DMA_GLOBAL_LOAD,LOAD_CACHE_ALL,STORE_WRITE_BACK)                            \
+    CudaDMA::finish_async_dma();                                                                    \
+  }                                                                                                 \
+  template<bool DMA_GLOBAL_LOAD, int DMA_LOAD_QUAL, int DMA_STORE_QUAL>                             \
+  __device__ __forceinline__ void execute_dma(const CudaDMAIndirectRun *RESTRICT run_ptr,           \
+                        const int num_runs,                                                         \
+                        const void *RESTRICT src_ptr, void *RESTRICT dst_ptr)                       \
+  {                                                                                                 \
+    start_xfer_async<DMA_GLOBAL_LOAD,DMA_LOAD_QUAL,DMA_STORE_QUAL>(run_ptr, num_runs, src_ptr);     \
+    wait_xfer_finish<DMA_GLOBAL_LOAD,DMA_LOAD_QUAL,DMA_STORE_QUAL>(dst_ptr);                        \
+  }                                                                                                 \
+  template<bool DMA_GLOBAL_LOAD, int DMA_LOAD_QUAL, int DMA_STORE_QUAL>                             \
+  __device__ __forceinline__ void start_xfer_async(const CudaDMAIndirectRun *RESTRICT run_ptr,      \
+                                                   const int num_runs,                              \
+                                                   const void *RESTRICT src_ptr)                    \
+  {                                                                                                 \
+    RUNS_START_XFER_IMPL(DMA_GLOBAL_LOAD,DMA_LOAD_QUAL,DMA_STORE_QUAL)                              \
+  }                                                                                                 \
+  template<bool DMA_GLOBAL_LOAD, int DMA_LOAD_QUAL, int DMA_STORE_QUAL>                             \
+  __device__ __forceinline__ void wait_xfer_finish(void *RESTRICT dst_ptr)                          \
+  {                                                                                                 \
+    CudaDMA::wait_for_dma_start();                                                                  \
+    RUNS_WAIT_XFER_IMPL(DMA_GLOBAL_LOAD,DMA_LOAD_QUAL,DMA_STORE_QUAL)                               \
+    CudaDMA::finish_async_dma();                                                                    \
+  }                                                                                                 \
+  template<bool DMA_GLOBAL_LOAD>                                                                    \
+  __device__ __forceinline__ void prefetch(const CudaDMAIndirectRun *RESTRICT run_ptr,              \
+                                           const int num_runs,                                      \
+                                           const void *RESTRICT xfer_ptr) const                     \
+  {                                                                                                 \
+    /* Walk the transfer on a copy so that a transfer in flight is untouched */                     \
+    CudaDMAMeta::copy_of(*this).template prefetch_xfer<DMA_GLOBAL_LOAD>(run_ptr, num_runs,          \
+                                                                        xfer_ptr);                  \
+  }                                                                                                 \
+private:                                                                                            \
+  template<bool DMA_GLOBAL_LOAD>                                                                    \
+  __device__ __forceinline__ void prefetch_xfer(const CudaDMAIndirectRun *RESTRICT run_ptr,         \
+                                                const int num_runs,                                 \
+                                                const void *RESTRICT xfer_ptr)                      \
+  {                                                                                                 \
+    /* A gather prefetches its source, a scatter its destination runs */                            \
+    const void *const src_ptr = GATHER ? xfer_ptr : NULL;                                           \
+    void *const dst_ptr = GATHER ? NULL : const_cast<void*>(xfer_ptr);                              \
+    if (GATHER)                                                                                     \
+    {                                                                                               \
+      RUNS_START_XFER_IMPL(DMA_GLOBAL_LOAD,LOAD_PREFETCH_L2,CUDADMA_STORE_DISCARD)                  \
+      RUNS_WAIT_XFER_IMPL(DMA_GLOBAL_LOAD,LOAD_PREFETCH_L2,CUDADMA_STORE_DISCARD)                   \
+    }                                                                                               \
+    else                                                                                            \
+    {                                                                                               \
+      RUNS_START_XFER_IMPL(DMA_GLOBAL_LOAD,LOAD_DISCARD,CUDADMA_STORE_PREFETCH_L2)                  \
+      RUNS_WAIT_XFER_IMPL(DMA_GLOBAL_LOAD,LOAD_DISCARD,CUDADMA_STORE_PREFETCH_L2)                   \
+    }                                                                                               \
+  }
+
+#define NON_WARP_SPECIALIZED_UNQUALIFIED_METHODS                                                    \
+  __device__ __forceinline__ void execute_dma(const CudaDMAIndirectRun *RESTRICT run_ptr,           \
+                        const int num_runs,                                                         \
+                        const void *RESTRICT src_ptr, void *RESTRICT dst_ptr)                       \
+  {                                                                                                 \
+    start_xfer_async(run_ptr, num_runs, src_ptr);                                                   \
+    wait_xfer_finish(dst_ptr);                                                                      \
+  }                                                                                                 \
+  __device__ __forceinline__ void start_xfer_async(const CudaDMAIndirectRun *RESTRICT run_ptr,      \
+                                                   const int num_runs,                              \
+                                                   const void *RESTRICT src_ptr)                    \
+  {                                                                                                 \
+    RUNS_START_XFER_IMPL(false,LOAD_CACHE_ALL,STORE_WRITE_BACK)                                     \
+  }                                                                                                 \
+  __device__ __forceinline__ void wait_xfer_finish(void *RESTRICT dst_ptr)                          \
+  {                                                                                                 \
+    RUNS_WAIT_XFER_IMPL(false,LOAD_CACHE_ALL,STORE_WRITE_BACK)                                      \
+  }                                                                                                 \
+  __device__ __forceinline__ void prefetch(const CudaDMAIndirectRun *RESTRICT run_ptr,              \
+                                           const int num_runs,                                      \
+                                           const void *RESTRICT xfer_ptr) const                     \
+  {                                                                                                 \
+    prefetch<false>(run_ptr, num_runs, xfer_ptr);                                                   \
+  }
+
+#define NON_WARP_SPECIALIZED_QUALIFIED_METHODS                                                      \
+  template<bool DMA_GLOBAL_LOAD>                                                                    \
+  __device__ __forceinline__ void execute_dma(const CudaDMAIndirectRun *RESTRICT run_ptr,           \
+                        const int num_runs,                                                         \
+                        const void *RESTRICT src_ptr, void *RESTRICT dst_ptr)                       \
+  {                                                                                                 \
+    start_xfer_async<DMA_GLOBAL_LOAD>(run_ptr, num_runs, src_ptr);                                  \
+    wait_xfer_finish<DMA_GLOBAL_LOAD>(dst_ptr);                                                     \
+  }                                                                                                 \
+  template<bool DMA_GLOBAL_LOAD>                                                                    \
+  __device__ __forceinline__ void start_xfer_async(const CudaDMAIndirectRun *RESTRICT run_ptr,      \
+                                                   const int num_runs,                              \
+                                                   const void *RESTRICT src_ptr)                    \
+  {                                                                                                 \
+    RUNS_START_XFER_IMPL(DMA_GLOBAL_LOAD,LOAD_CACHE_ALL,STORE_WRITE_BACK)                           \
+  }                                                                                                 \
+  template<bool DMA_GLOBAL_LOAD>                                                                    \
+  __device__ __forceinline__ void wait_xfer_finish(void *RESTRICT dst_ptr)                          \
+  {                                                                                                 \
+    RUNS_WAIT_XFER_IMPL(DMA_GLOBAL_LOAD,LOAD_CACHE_ALL,STORE_WRITE_BACK)                            \
+  }                                                                                                 \
+  template<bool DMA_GLOBAL_LOAD, int DMA_LOAD_QUAL, int DMA_STORE_QUAL>                             \
+  __device__ __forceinline__ void execute_dma(const CudaDMAIndirectRun *RESTRICT run_ptr,           \
+                        const int num_runs,                                                         \
+                        const void *RESTRICT src_ptr, void *RESTRICT dst_ptr)                       \
+  {                                                                                                 \
+    start_xfer_async<DMA_GLOBAL_LOAD,DMA_LOAD_QUAL,DMA_STORE_QUAL>(run_ptr, num_runs, src_ptr);     \
+    wait_xfer_finish<DMA_GLOBAL_LOAD,DMA_LOAD_QUAL,DMA_STORE_QUAL>(dst_ptr);                        \
+  }                                                                                                 \
+  template<bool DMA_GLOBAL_LOAD, int DMA_LOAD_QUAL, int DMA_STORE_QUAL>                             \
+  __device__ __forceinline__ void start_xfer_async(const CudaDMAIndirectRun *RESTRICT run_ptr,      \
+                                                   const int num_runs,                              \
+                                                   const void *RESTRICT src_ptr)                    \
+  {                                                                                                 \
+    RUNS_START_XFER_IMPL(DMA_GLOBAL_LOAD,DMA_LOAD_QUAL,DMA_STORE_QUAL)                              \
+  }                                                                                                 \
+  template<bool DMA_GLOBAL_LOAD, int DMA_LOAD_QUAL, int DMA_STORE_QUAL>                             \
+  __device__ __forceinline__ void wait_xfer_finish(void *RESTRICT dst_ptr)                          \
+  {                                                                                                 \
+    RUNS_WAIT_XFER_IMPL(DMA_GLOBAL_LOAD,DMA_LOAD_QUAL,DMA_STORE_QUAL)                               \
+  }                                                                                                 \
+  template<bool DMA_GLOBAL_LOAD>                                                                    \
+  __device__ __forceinline__ void prefetch(const CudaDMAIndirectRun *RESTRICT run_ptr,              \
+                                           const int num_runs,                                      \
+                                           const void *RESTRICT xfer_ptr) const                     \
+  {                                                                                                 \
+    /* Walk the transfer on a copy so that a transfer in flight is untouched */                     \
+    CudaDMAMeta::copy_of(*this).template prefetch_xfer<DMA_GLOBAL_LOAD>(run_ptr, num_runs,          \
+                                                                        xfer_ptr);                  \
+  }                                                                                                 \
+private:                                                                                            \
+  template<bool DMA_GLOBAL_LOAD>                                                                    \
+  __device__ __forceinline__ void prefetch_xfer(const CudaDMAIndirectRun *RESTRICT run_ptr,         \
+                                                const int num_runs,                                 \
+                                                const void *RESTRICT xfer_ptr)                      \
+  {                                                                                                 \
+    /* A gather prefetches its source, a scatter its destination runs */                            \
+    const void *const src_ptr = GATHER ? xfer_ptr : NULL;                                           \
+    void *const dst_ptr = GATHER ? NULL : const_cast<void*>(xfer_ptr);                              \
+    if (GATHER)                                                                                     \
+    {                                                                                               \
+      RUNS_START_XFER_IMPL(DMA_GLOBAL_LOAD,LOAD_PREFETCH_L2,CUDADMA_STORE_DISCARD)                  \
+      RUNS_WAIT_XFER_IMPL(DMA_GLOBAL_LOAD,LOAD_PREFETCH_L2,CUDADMA_STORE_DISCARD)                   \
+    }                                                                                               \
+    else                                                                                            \
+    {                                                                                               \
+      RUNS_START_XFER_IMPL(DMA_GLOBAL_LOAD,LOAD_DISCARD,CUDADMA_STORE_PREFETCH_L2)                  \
+      RUNS_WAIT_XFER_IMPL(DMA_GLOBAL_LOAD,LOAD_DISCARD,CUDADMA_STORE_PREFETCH_L2)                   \
+    }                                                                                               \
+  }
+
+template<bool GATHER=true, bool DO_SYNC=false, int ALIGNMENT=0, int BYTES_PER_THREAD=4*ALIGNMENT,
+         int BYTES_PER_ELMT=0>
+class CudaDMAIndirectRuns : public CudaDMA {
+public:
+  __device__ CudaDMAIndirectRuns(const int dmaID,
+                                 const int num_dma_threads,
+                                 const int num_compute_threads,
+                                 const int dma_threadIdx_start,
+                                 const int num_elmts)
+    : CudaDMA(dmaID, num_dma_threads, num_compute_threads, dma_threadIdx_start),
+      RUNS_INIT(CUDADMA_DMA_TID, num_dma_threads)
+  {
+    RUNS_STATIC_ASSERTS;
+  }
+public:
+  WARP_SPECIALIZED_UNQUALIFIED_METHODS
+  WARP_SPECIALIZED_QUALIFIED_METHODS
+private:
+  RUNS_TRANSFER_IMPL
+};
+
+template<bool GATHER, int ALIGNMENT, int BYTES_PER_THREAD, int BYTES_PER_ELMT>
+class CudaDMAIndirectRuns<GATHER,false,ALIGNMENT,BYTES_PER_THREAD,BYTES_PER_ELMT> : public CudaDMA {
+public:
+  __device__ CudaDMAIndirectRuns(const int num_elmts)
+    : CudaDMA(0, blockDim.x, blockDim.x, 0),
+      RUNS_INIT(threadIdx.x, blockDim.x)
+  {
+    RUNS_STATIC_ASSERTS;
+  }
+public:
+  NON_WARP_SPECIALIZED_UNQUALIFIED_METHODS
+  NON_WARP_SPECIALIZED_QUALIFIED_METHODS
+private:
+  RUNS_TRANSFER_IMPL
+};
+
+#undef RUNS_ELMT_UNITS
+#undef RUNS_LDS
+#undef RUNS_INIT
+#undef RUNS_STATIC_ASSERTS
+#undef RUNS_TRANSFER_IMPL
+#undef RUNS_START_XFER_IMPL
+#undef RUNS_WAIT_XFER_IMPL
+#undef WARP_SPECIALIZED_UNQUALIFIED_METHODS
+#undef WARP_SPECIALIZED_QUALIFIED_METHODS
+#undef NON_WARP_SPECIALIZED_UNQUALIFIED_METHODS
+#undef NON_WARP_SPECIALIZED_QUALIFIED_METHODS
+////////////////////////  End of CudaDMAIndirectRuns ////////////////////////////////////////////////
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+// CudaDMAConvert
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * Storage types for 16-bit floating point values that can be converted
+ * by CudaDMAConvert.  Only the bits are kept so that no fp16 headers are
+ * required.
+ */
+struct CudaDMAHalf {
+  unsigned short bits;
+};
+
+struct CudaDMABFloat16 {
+  unsigned short bits;
+};
+
+namespace CudaDMAMeta {
+  /********************************************/
+  // Numeric
+  // Conversion of the element types supported by CudaDMAConvert to and
+  // from float.  8-bit integers are quantized values: x = (q - zero)*scale.
+  /********************************************/
+  template<typename T>
+  struct Numeric;
+
+  template<>
+  struct Numeric<float> {
+    static __device__ __forceinline__
+    float to_float(const float x, const float, const float) { return x; }
+    static __device__ __forceinline__
+    float from_float(const float x, const float, const float) { return x; }
+  };
+
+  template<>
+  struct Numeric<CudaDMAHalf> {
+    static __device__ __forceinline__
+    float to_float(const CudaDMAHalf x, const float, const float)
+    {
+#ifdef CUDADMA_HOST_BACKEND
+      const unsigned sign = (unsigned(x.bits) & 0x8000) << 16;
+      const unsigned exponent = (x.bits >> 10) & 0x1f;
+      const unsigned mantissa = x.bits & 0x3ff;
+      if (exponent == 0x1f)
+        return __int_as_float(sign | 0x7f800000 | (mantissa << 13));
+      if (exponent == 0)
+      {
+        // Zeros and subnormals are exact multiples of 2^-24
+        const float value = float(mantissa) * (1.0f / 16777216.0f);
+        return (sign ? -value : value);
+      }
+      return __int_as_float(sign | ((exponent + 112) << 23) | (mantissa << 13));
+#else
+      float result;
+      asm("cvt.f32.f16 %0, %1;" : "=f"(result) : "h"(x.bits));
+      return result;
+#endif
+    }
+    static __device__ __forceinline__
+    CudaDMAHalf from_float(const float x, const float, const float)
+    {
+      CudaDMAHalf result;
+#ifdef CUDADMA_HOST_BACKEND
+      const unsigned bits = unsigned(__float_as_int(x));
+      const unsigned sign = (bits >> 16) & 0x8000;
+      const int exponent = int((bits >> 23) & 0xff) - 112;
+      unsigned mantissa = bits & 0x7fffff;
+      if (((bits >> 23) & 0xff) == 0xff)
+        result.bits = sign | 0x7c00 | (mantissa ? 0x200 : 0);
+      else if (exponent >= 0x1f)
+        result.bits = sign | 0x7c00;
+      else if (exponent <= 0)
+      {
+        // Subnormal or zero, round to nearest even on the shifted mantissa
+        if (exponent < -10)
+          result.bits = sign;
+        else
+        {
+          mantissa |= 0x800000;
+          const int shift = 14 - exponent;
+          unsigned half = mantissa >> shift;
+          const unsigned rest = mantissa & ((1u << shift) - 1);
+          const unsigned midpoint = 1u << (shift - 1);
+          if ((rest > midpoint) || ((rest == midpoint) && (half & 1)))
+            half++;
+          result.bits = sign | half;
+        }
+      }
+      else
+      {
+        unsigned half = (unsigned(exponent) << 10) | (mantissa >> 13);
+        const unsigned rest = mantissa & 0x1fff;
+        if ((rest > 0x1000) || ((rest == 0x1000) && (half & 1)))
+          half++;
+        result.bits = sign | half;
+      }
+#else
+      asm("cvt.rn.f16.f32 %0, %1;" : "=h"(result.bits) : "f"(x));
+#endif
+      return result;
+    }
+  };
+
+  template<>
+  struct Numeric<CudaDMABFloat16> {
+    static __device__ __forceinline__
+    float to_float(const CudaDMABFloat16 x, const float, const float)
+    {
+      return __int_as_float(int(unsigned(x.bits) << 16));
+    }
+    static __device__ __forceinline__
+    CudaDMABFloat16 from_float(const float x, const float, const float)
+    {
+      // Round to nearest even, NaNs stay quiet NaNs
+      const unsigned bits = unsigned(__float_as_int(x));
+      CudaDMABFloat16 result;
+      if ((bits & 0x7fffffff) > 0x7f800000)
+        result.bits = (unsigned short)((bits >> 16) | 0x40);
+      else
+        result.bits = (unsigned short)((bits + 0x7fff + ((bits >> 16) & 1)) >> 16);
+      return result;
+    }
+  };
+
+  template<typename T, int LOWEST, int HIGHEST>
+  struct QuantizedNumeric {
+    static __device__ __forceinline__
+    float to_float(const T x, const float scale, const float zero)
+    {
+      return (float(x) - zero) * scale;
+    }
+    static __device__ __forceinline__
+    T from_float(const float x, const float inv_scale, const float zero)
+    {
+#ifdef CUDADMA_HOST_BACKEND
+      int q = int(rintf(x * inv_scale + zero));
+#else
+      int q = __float2int_rn(x * inv_scale + zero);
+#endif
+      q = (q < LOWEST) ? LOWEST : (q > HIGHEST) ? HIGHEST : q;
+      return T(q);
+    }
+  };
+
+  template<>
+  struct Numeric<signed char> : public QuantizedNumeric<signed char,-128,127> { };
+
+  template<>
+  struct Numeric<unsigned char> : public QuantizedNumeric<unsigned char,0,255> { };
+
+  /********************************************/
+  // Chunk
+  // BYTES bytes moved with the widest loads and stores
+  // that they are aligned to
+  /********************************************/
+  template<int BYTES>
+  struct Chunk {
+    static const int PIECE_BYTES = ((BYTES%16) == 0) ? 16 : ((BYTES%8) == 0) ? 8 : 4;
+    static const int PIECES = BYTES/PIECE_BYTES;
+    typedef typename VectorType<PIECE_BYTES>::type PieceType;
+    PieceType pieces[PIECES];
+  };
+};
+
+/**
+ * CudaDMAConvert will transfer num_rows rows of row_elmts elements (a single row for a
+ * contiguous block) and convert every element from SRC_TYPE to DST_TYPE as it goes.
+ * Weights kept in half, bfloat16 or 8-bit integers in global memory can be widened to
+ * float while they are stored into shared memory, and results narrowed on the way
+ * back, without a conversion pass in the compute threads.
+ * DO_SYNC - is warp-specialized or not
+ * ALIGNMENT - guaranteed alignment in bytes of the narrower of the two sides
+ * BYTES_PER_THREAD - maximum number of bytes of the source that can be buffered inside the instance
+ * SRC_TYPE - float, CudaDMAHalf, CudaDMABFloat16, signed char or unsigned char
+ * DST_TYPE - same choices as SRC_TYPE
+ *
+ * Rows are split into chunks of ALIGNMENT bytes of the narrower type and the same
+ * number of elements of the wider type, so the wider side has to be aligned to the
+ * chunk size multiplied by the ratio of the element sizes (capped at 16 bytes).
+ * There are no partial chunks, so row_elmts must be a non-zero multiple of the
+ * elements in a chunk, e.g. of 8 for half to float with an ALIGNMENT of 16.  This is
+ * only checked with DEBUG_CUDADMA, otherwise the trailing elements of longer rows are
+ * not transferred.  The pitches are in bytes.  8-bit integers are quantized with a
+ * per-tensor scale and zero point: value = (q - zero_point)*scale, rounding to nearest
+ * even and saturating when narrowing.  The scale and zero point are ignored by the
+ * other types.
+ */
+// Elements converted per chunk and the bytes of a chunk on each side
+#define CONVERT_ELMTS (ALIGNMENT/((sizeof(SRC_TYPE) < sizeof(DST_TYPE)) ? sizeof(SRC_TYPE) :       \
+                                                                       sizeof(DST_TYPE)))
+#define CONVERT_SRC_BYTES (CONVERT_ELMTS*sizeof(SRC_TYPE))
+#define CONVERT_DST_BYTES (CONVERT_ELMTS*sizeof(DST_TYPE))
+// Chunks loaded by each thread per step
+#define CONVERT_LDS int(BYTES_PER_THREAD/CONVERT_SRC_BYTES)
+
+#define CONVERT_INIT(_tid,_threads)                                                                 \
+      dma_src_pitch(src_pitch),                                                                     \
+      dma_dst_pitch(dst_pitch),                                                                     \
+      dma_scale(scale),                                                                             \
+      dma_inv_scale(1.0f/scale),                                                                    \
+      dma_zero_point(zero_point),                                                                   \
+      dma_walk(_tid, _threads, CudaDMAMeta::row_chunks(row_elmts, int(CONVERT_ELMTS)), num_rows)
+
+#define CONVERT_STATIC_ASSERTS                                                                      \
+    STATIC_ASSERT((ALIGNMENT == 4) || (ALIGNMENT == 8) || (ALIGNMENT == 16));                       \
+    STATIC_ASSERT(CONVERT_ELMTS > 0);                                                               \
+    STATIC_ASSERT((BYTES_PER_THREAD/CONVERT_SRC_BYTES) > 0);                                        \
+    STATIC_ASSERT((BYTES_PER_THREAD%CONVERT_SRC_BYTES) == 0)
+
+#define CONVERT_TRANSFER_IMPL                                                                       \
+  typedef CudaDMAMeta::Chunk<CONVERT_SRC_BYTES> SrcChunk;                                           \
+  typedef CudaDMAMeta::Chunk<CONVERT_DST_BYTES> DstChunk;                                           \
+  template<bool DMA_GLOBAL_LOAD, int DMA_LOAD_QUAL>                                                 \
+  __device__ __forceinline__ void load_step(const char *RESTRICT src_ptr,                           \
+                                            CudaDMAMeta::TileCursor cursor)                         \
+  {                                                                                                 \
+    for (int i = 0; i < CONVERT_LDS; i++)                                                           \
+    {                                                                                               \
+      if (dma_walk.valid(cursor))                                                                   \
+      {                                                                                             \
+        const typename SrcChunk::PieceType *ptr = (const typename SrcChunk::PieceType*)             \
+          (src_ptr + cursor.row*dma_src_pitch + cursor.col*int(CONVERT_SRC_BYTES));                 \
+        for (int j = 0; j < SrcChunk::PIECES; j++)                                                  \
+          bulk_buffer[i].pieces[j] =                                                                \
+            ptx_cudaDMA_load<typename SrcChunk::PieceType,DMA_GLOBAL_LOAD,DMA_LOAD_QUAL>(ptr + j);  \
+      }                                                                                             \
+      dma_walk.advance(cursor);                                                                     \
+    }                                                                                               \
+  }                                                                                                 \
+  template<int DMA_STORE_QUAL>                                                                      \
+  __device__ __forceinline__ void store_step(char *RESTRICT dst_ptr,                                \
+                                             CudaDMAMeta::TileCursor &cursor)                       \
+  {                                                                                                 \
+    for (int i = 0; i < CONVERT_LDS; i++)                                                           \
+    {                                                                                               \
+      if (dma_walk.valid(cursor))                                                                   \
+      {                                                                                             \
+        const SRC_TYPE *src = reinterpret_cast<const SRC_TYPE*>(bulk_buffer[i].pieces);             \
+        DstChunk converted;                                                                         \
+        DST_TYPE *dst = reinterpret_cast<DST_TYPE*>(converted.pieces);                              \
+        for (int j = 0; j < int(CONVERT_ELMTS); j++)                                                \
+          dst[j] = CudaDMAMeta::Numeric<DST_TYPE>::from_float(                                      \
+                     CudaDMAMeta::Numeric<SRC_TYPE>::to_float(src[j], dma_scale, dma_zero_point),   \
+                     dma_inv_scale, dma_zero_point);                                                \
+        typename DstChunk::PieceType *ptr = (typename DstChunk::PieceType*)                         \
+          (dst_ptr + cursor.row*dma_dst_pitch + cursor.col*int(CONVERT_DST_BYTES));                 \
+        for (int j = 0; j < DstChunk::PIECES; j++)                                                  \
+          ptx_cudaDMA_store<typename DstChunk::PieceType,DMA_STORE_QUAL>(converted.pieces[j],       \
+                                                                         ptr + j);                  \
+      }                                                                                             \
+      dma_walk.advance(cursor);                                                                     \
+    }                                                                                               \
+  }                                                                                                 \
+  template<bool DMA_GLOBAL_LOAD, int DMA_LOAD_QUAL>                                                 \
+  __device__ __forceinline__ void execute_start_xfer(const void *RESTRICT src_ptr)                  \
+  {                                                                                                 \
+    dma_src_ptr = (const char*)src_ptr;                                                             \
+    load_step<DMA_GLOBAL_LOAD,DMA_LOAD_QUAL>(dma_src_ptr, dma_walk.start());                        \
+  }                                                                                                 \
+  TILE_WAIT_XFER_IMPL                                                                               \
+private:                                                                                            \
+  const int dma_src_pitch;                                                                          \
+  const int dma_dst_pitch;                                                                          \
+  const float dma_scale;                                                                            \
+  const float dma_inv_scale;                                                                        \
+  const float dma_zero_point;                                                                       \
+  const CudaDMAMeta::TileWalk<> dma_walk;                                                           \
+  const char *dma_src_ptr;                                                                          \
+  SrcChunk bulk_buffer[CONVERT_LDS];
+
+#define CONVERT_START_XFER_IMPL(GLOBAL_LOAD,LOAD_QUAL,STORE_QUAL)                                   \
+  execute_start_xfer<GLOBAL_LOAD,LOAD_QUAL>(src_ptr);
+
+#define CONVERT_WAIT_XFER_IMPL(GLOBAL_LOAD,LOAD_QUAL,STORE_QUAL)                                    \
+  execute_wait_xfer<GLOBAL_LOAD,LOAD_QUAL,STORE_QUAL>(dst_ptr);
+
+#define WARP_SPECIALIZED_UNQUALIFIED_METHODS                                                        \
+  __device__ __forceinline__ void execute_dma(const void *RESTRICT src_ptr, void *RESTRICT dst_ptr) \
+  {                                                                                                 \
+    start_xfer_async(src_ptr);                                                                      \
+    wait_xfer_finish(dst_ptr);                                                                      \
+  }                                                                                                 \
+  __device__ __forceinline__ void start_xfer_async(const void *RESTRICT src_ptr)                    \
+  {                                                                                                 \
+    CONVERT_START_XFER_IMPL(false,LOAD_CACHE_ALL,STORE_WRITE_BACK)                                  \
+  }                                                                                                 \
+  __device__ __forceinline__ void wait_xfer_finish(void *RESTRICT dst_ptr)                          \
+  {                                                                                                 \
+    CudaDMA::wait_for_dma_start();                                                                  \
+    CONVERT_WAIT_XFER_IMPL(false,LOAD_CACHE_ALL,STORE_WRITE_BACK)                                   \
+    CudaDMA::finish_async_dma();                                                                    \
+  }                                                                                                 \
+  __device__ __forceinline__ void prefetch(const void *RESTRICT src_ptr) const                      \
+  {                                                                                                 \
+    prefetch<false>(src_ptr);                                                                       \
+  }
+
+#define WARP_SPECIALIZED_QUALIFIED_METHODS                                                          \
+  template<bool DMA_GLOBAL_LOAD>                                                                    \
+  __device__ __forceinline__ void execute_dma(const void *RESTRICT src_ptr, void *RESTRICT dst_ptr) \
+  {                                                                                                 \
+    start_xfer_async<DMA_GLOBAL_LOAD>(src_ptr);                                                     \
+    wait_xfer_finish<DMA_GLOBAL_LOAD>(dst_ptr);                                                     \
+  }                                                                                                 \
+  template<bool DMA_GLOBAL_LOAD>                                                                    \
+  __device__ __forceinline__ void start_xfer_async(const void *RESTRICT src_ptr)                    \
+  {                                                                                                 \
+    CONVERT_START_XFER_IMPL(DMA_GLOBAL_LOAD,LOAD_CACHE_ALL,STORE_WRITE_BACK)                        \
+  }                                                                                                 \
+  template<bool DMA_GLOBAL_LOAD>                                                                    \
+  __device__ __forceinline__ void wait_xfer_finish(void *RESTRICT dst_ptr)                          \
+  {                                                                                                 \
+    CudaDMA::wait_for_dma_start();                                                                  \
+    CONVERT_WAIT_XFER_IMPL(DMA_GLOBAL_LOAD,LOAD_CACHE_ALL,STORE_WRITE_BACK)                         \
+    CudaDMA::finish_async_dma();                                                                    \
+  }                                                                                                 \
+  template<bool DMA_GLOBAL_LOAD, int DMA_LOAD_QUAL, int DMA_STORE_QUAL>                             \
+  __device__ __forceinline__ void execute_dma(const void *RESTRICT src_ptr, void *RESTRICT dst_ptr) \
+  {                                                                                                 \
+    start_xfer_async<DMA_GLOBAL_LOAD,DMA_LOAD_QUAL,DMA_STORE_QUAL>(src_ptr);                        \
+    wait_xfer_finish<DMA_GLOBAL_LOAD,DMA_LOAD_QUAL,DMA_STORE_QUAL>(dst_ptr);                        \
+  }                                                                                                 \
+  template<bool DMA_GLOBAL_LOAD, int DMA_LOAD_QUAL, int DMA_STORE_QUAL>                             \
+  __device__ __forceinline__ void start_xfer_async(const void *RESTRICT src_ptr)                    \
+  {                                                                                                 \
+    CONVERT_START_XFER_IMPL(DMA_GLOBAL_LOAD,DMA_LOAD_QUAL,DMA_STORE_QUAL)                           \
+  }                                                                                                 \
+  template<bool DMA_GLOBAL_LOAD, int DMA_LOAD_QUAL, int DMA_STORE_QUAL>                             \
+  __device__ __forceinline__ void wait_xfer_finish(void *RESTRICT dst_ptr)                          \
+  {                                                                                                 \
+    CudaDMA::wait_for_dma_start();                                                                  \
+    CONVERT_WAIT_XFER_IMPL(DMA_GLOBAL_LOAD,DMA_LOAD_QUAL,DMA_STORE_QUAL)                            \
+    CudaDMA::finish_async_dma();                                                                    \
+  }                                                                                                 \
+  template<bool DMA_GLOBAL_LOAD>                                                                    \
+  __device__ __forceinline__ void prefetch(const void *RESTRICT src_ptr) const                      \
+  {                                                                                                 \
+    /* Walk the transfer on a copy so that a transfer in flight is untouched */                     \
+    CudaDMAMeta::copy_of(*this).template prefetch_xfer<DMA_GLOBAL_LOAD>(src_ptr);                   \
+  }                                                                                                 \
+private:                                                                                            \
+  template<bool DMA_GLOBAL_LOAD>                                                                    \
+  __device__ __forceinline__ void prefetch_xfer(const void *RESTRICT src_ptr)                       \
+  {                                                                                                 \
+    void *const dst_ptr = NULL;                                                                     \
+    {                                                                                               \
+      CONVERT_START_XFER_IMPL(DMA_GLOBAL_LOAD,LOAD_PREFETCH_L2,CUDADMA_STORE_DISCARD)               \
+    }                                                                                               \
+    {                                                                                               \
+      CONVERT_WAIT_XFER_IMPL(DMA_GLOBAL_LOAD,LOAD_PREFETCH_L2,CUDADMA_STORE_DISCARD)                \
+    }                                                                                               \
+  }
+
+#define NON_WARP_SPECIALIZED_UNQUALIFIED_METHODS                                                    \
+  __device__ __forceinline__ void execute_dma(const void *RESTRICT src_ptr, void *RESTRICT dst_ptr) \
+  {                                                                                                 \
+    start_xfer_async(src_ptr);                                                                      \
+    wait_xfer_finish(dst_ptr);                                                                      \
+  }                                                                                                 \
+  __device__ __forceinline__ void start_xfer_async(const void *RESTRICT src_ptr)                    \
+  {                                                                                                 \
+    CONVERT_START_XFER_IMPL(false,LOAD_CACHE_ALL,STORE_WRITE_BACK)                                  \
+  }                                                                                                 \
+  __device__ __forceinline__ void wait_xfer_finish(void *RESTRICT dst_ptr)                          \
+  {                                                                                                 \
+    CONVERT_WAIT_XFER_IMPL(false,LOAD_CACHE_ALL,STORE_WRITE_BACK)                                   \
+  }                                                                                                 \
+  __device__ __forceinline__ void prefetch(const void *RESTRICT src_ptr) const                      \
+  {                                                                                                 \
+    prefetch<false>(src_ptr);                                                                       \
+  }
+
+#define NON_WARP_SPECIALIZED_QUALIFIED_METHODS                                                      \
+  template<bool DMA_GLOBAL_LOAD>                                                                    \
+  __device__ __forceinline__ void execute_dma(const void *RESTRICT src_ptr, void *RESTRICT dst_ptr) \
+  {                                                                                                 \
+    start_xfer_async<DMA_GLOBAL_LOAD>(src_ptr);                                                     \
+    wait_xfer_finish<DMA_GLOBAL_LOAD>(dst_ptr);                                                     \
+  }                                                                                                 \
+  template<bool DMA_GLOBAL_LOAD>                                                                    \
+  __device__ __forceinline__ void start_xfer_async(const void *RESTRICT src_ptr)                    \
+  {                                                                                                 \
+    CONVERT_START_XFER_IMPL(DMA_GLOBAL_LOAD,LOAD_CACHE_ALL,STORE_WRITE_BACK)                        \
+  }                                                                                                 \
+  template<bool DMA_GLOBAL_LOAD>                                                                    \
+  __device__ __forceinline__ void wait_xfer_finish(void *RESTRICT dst_ptr)                          \
+  {                                                                                                 \
+    CONVERT_WAIT_XFER_IMPL(DMA_GLOBAL_LOAD,LOAD_CACHE_ALL,STORE_WRITE_BACK)                         \
+  }                                                                                                 \
+  template<bool DMA_GLOBAL_LOAD, int DMA_LOAD_QUAL, int DMA_STORE_QUAL>                             \
+  __device__ __forceinline__ void execute_dma(const void *RESTRICT src_ptr, void *RESTRICT dst_ptr) \
+  {                                                                                                 \
+    start_xfer_async<DMA_GLOBAL_LOAD,DMA_LOAD_QUAL,DMA_STORE_QUAL>(src_ptr);                        \
+    wait_xfer_finish<DMA_GLOBAL_LOAD,DMA_LOAD_QUAL,DMA_STORE_QUAL>(dst_ptr);                        \
+  }                                                                                                 \
+  template<bool DMA_GLOBAL_LOAD, int DMA_LOAD_QUAL, int DMA_STORE_QUAL>                             \
+  __device__ __forceinline__ void start_xfer_async(const void *RESTRICT src_ptr)                    \
+  {                                                                                                 \
+    CONVERT_START_XFER_IMPL(DMA_GLOBAL_LOAD,DMA_LOAD_QUAL,DMA_STORE_QUAL)                           \
+  }                                                                                                 \
+  template<bool DMA_GLOBAL_LOAD, int DMA_LOAD_QUAL, int DMA_STORE_QUAL>                             \
+  __device__ __forceinline__ void wait_xfer_finish(void *RESTRICT dst_ptr)                          \
+  {                                                                                                 \
+    CONVERT_WAIT_XFER_IMPL(DMA_GLOBAL_LOAD,DMA_LOAD_QUAL,DMA_STORE_QUAL)                            \
+  }                                                                                                 \
+  template<bool DMA_GLOBAL_LOAD>                                                                    \
+  __device__ __forceinline__ void prefetch(const void *RESTRICT src_ptr) const                      \
+  {                                                                                                 \
+    /* Walk the transfer on a copy so that a transfer in flight is untouched */                     \
+    CudaDMAMeta::copy_of(*this).template prefetch_xfer<DMA_GLOBAL_LOAD>(src_ptr);                   \
+  }                                                                                                 \
+private:                                                                                            \
+  template<bool DMA_GLOBAL_LOAD>                                                                    \
+  __device__ __forceinline__ void prefetch_xfer(const void *RESTRICT src_ptr)                       \
+  {                                                                                                 \
+    void *const dst_ptr = NULL;                                                                     \
+    {                                                                                               \
+      CONVERT_START_XFER_IMPL(DMA_GLOBAL_LOAD,LOAD_PREFETCH_L2,CUDADMA_STORE_DISCARD)               \
+    }                                                                                               \
+    {                                                                                               \
+      CONVERT_WAIT_XFER_IMPL(DMA_GLOBAL_LOAD,LOAD_PREFETCH_L2,CUDADMA_STORE_DISCARD)                \
+    }                                                                                               \
+  }
+
+template<bool DO_SYNC=false, int ALIGNMENT=0, int BYTES_PER_THREAD=4*ALIGNMENT,
+         typename SRC_TYPE=CudaDMAHalf, typename DST_TYPE=float>
+class CudaDMAConvert : public CudaDMA {
+public:
+  __device__ CudaDMAConvert(const int dmaID,
+                            const int num_dma_threads,
+                            const int num_compute_threads,
+                            const int dma_threadIdx_start,
+                            const int row_elmts,
+                            const int num_rows = 1,
+                            const int src_pitch = 0,
+                            const int dst_pitch = 0,
+                            const float scale = 1.0f,
+                            const float zero_point = 0.0f)
+    : CudaDMA(dmaID, num_dma_threads, num_compute_threads, dma_threadIdx_start),
+      CONVERT_INIT(CUDADMA_DMA_TID, num_dma_threads)
+  {
+    CONVERT_STATIC_ASSERTS;
+#ifdef DEBUG_CUDADMA
+    assert((row_elmts%int(CONVERT_ELMTS)) == 0);
+#endif
+  }
+public:
+  WARP_SPECIALIZED_UNQUALIFIED_METHODS
+  WARP_SPECIALIZED_QUALIFIED_METHODS
+private:
+  CONVERT_TRANSFER_IMPL
+};
+
+template<int ALIGNMENT, int BYTES_PER_THREAD, typename SRC_TYPE, typename DST_TYPE>
+class CudaDMAConvert<false,ALIGNMENT,BYTES_PER_THREAD,SRC_TYPE,DST_TYPE> : public CudaDMA {
+public:
+  __device__ CudaDMAConvert(const int row_elmts,
+                            const int num_rows = 1,
+                            const int src_pitch = 0,
+                            const int dst_pitch = 0,
+                            const float scale = 1.0f,
+                            const float zero_point = 0.0f)
+    : CudaDMA(0, blockDim.x, blockDim.x, 0),
+      CONVERT_INIT(threadIdx.x, blockDim.x)
+  {
+    CONVERT_STATIC_ASSERTS;
+#ifdef DEBUG_CUDADMA
+    assert((row_elmts%int(CONVERT_ELMTS)) == 0);
+#endif
+  }
+public:
+  NON_WARP_SPECIALIZED_UNQUALIFIED_METHODS
+  NON_WARP_SPECIALIZED_QUALIFIED_METHODS
+private:
+  CONVERT_TRANSFER_IMPL
+};
+
+#undef CONVERT_ELMTS
+#undef CONVERT_SRC_BYTES
+#undef CONVERT_DST_BYTES
+#undef CONVERT_LDS
+#undef CONVERT_INIT
+#undef CONVERT_STATIC_ASSERTS
+#undef CONVERT_TRANSFER_IMPL
+#undef CONVERT_START_XFER_IMPL
+#undef CONVERT_WAIT_XFER_IMPL
+#undef WARP_SPECIALIZED_UNQUALIFIED_METHODS
+#undef WARP_SPECIALIZED_QUALIFIED_METHODS
+#undef NON_WARP_SPECIALIZED_UNQUALIFIED_METHODS
+#undef NON_WARP_SPECIALIZED_QUALIFIED_METHODS
+////////////////////////  End of CudaDMAConvert /////////////////////////////////////////////////////
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+// CudaDMAStridedMasked
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * How CudaDMAStridedMasked fills the parts of a tile that fall outside
+ * of the valid region of the source.
+ * FILL_ZERO - write zeros
+ * FILL_CLAMP - repeat the last valid row or column
+ * FILL_MIRROR - reflect the valid region about its edge (the edge is repeated once),
+ *               slots past the reflection repeat the first row or column
+ */
+enum CudaDMAFillMode {
+  FILL_ZERO,
+  FILL_CLAMP,
+  FILL_MIRROR
+};
+
+/**
+ * CudaDMAStridedMasked performs the same transfers as CudaDMAStrided for tiles that
+ * may hang over the edge of the source, e.g. the boundary tiles of stencils and GEMMs.
+ * Every transfer is given the number of valid elements (rows) and valid bytes of each
+ * element (columns) and may also be given a bitmask with one bit per element.  Slots
+ * outside of the valid region are not loaded from global memory and are filled as
+ * selected by FILL, while elements whose bit is clear are always filled with zeros.
+ * The bitmask is passed by value so that no load of it stands in front of the loads
+ * of the data: bit i of the 64-bit word is element i, so a transfer with a bitmask
+ * can have at most 64 elements.
+ * DO_SYNC - is warp-specialized or not
+ * ALIGNMENT - guaranteed alignment of the pointers, strides and element size
+ * BYTES_PER_THREAD - maximum number of bytes that can be used for buffering inside the instance
+ * FILL - the CudaDMAFillMode for slots outside of the valid region
+ *
+ * Elements are split into chunks of ALIGNMENT bytes which are assigned to DMA threads
+ * round robin.  Columns are clamped and mirrored in whole chunks, so valid_bytes has
+ * to be a multiple of ALIGNMENT and ALIGNMENT should be the size of the data type for
+ * FILL_CLAMP and FILL_MIRROR.
+ */
+// Loads issued by each thread per step
+#define MASKED_LDS (BYTES_PER_THREAD/ALIGNMENT)
+
+#define MASKED_INIT(_tid,_threads)                                                                  \
+      dma_src_stride(src_stride),                                                                   \
+      dma_dst_stride(dst_stride),                                                                   \
+      dma_walk(_tid, _threads, CudaDMAMeta::row_chunks(elmt_size_in_bytes, ALIGNMENT), num_elements)
+
+#define MASKED_STATIC_ASSERTS                                                                       \
+    STATIC_ASSERT((ALIGNMENT == 4) || (ALIGNMENT == 8) || (ALIGNMENT == 16));                       \
+    STATIC_ASSERT((BYTES_PER_THREAD/ALIGNMENT) > 0);                                                \
+    STATIC_ASSERT((BYTES_PER_THREAD%ALIGNMENT) == 0)
+
+// Only whole chunks of the last valid element are loaded and
+// a bitmask only has room for the first 64 elements
+#ifdef DEBUG_CUDADMA
+#define MASKED_CHECK_XFER(VALID_BYTES,ELMT_MASK)                                                    \
+    if (((VALID_BYTES % ALIGNMENT) != 0) ||                                                         \
+        ((ELMT_MASK != ~0ULL) && (dma_walk.total_units > 64*dma_walk.row_chunks)))                  \
+      assert(false);
+#else
+#define MASKED_CHECK_XFER(VALID_BYTES,ELMT_MASK)
+#endif
+
+#define MASKED_TRANSFER_IMPL                                                                        \
+  typedef typename CudaDMAMeta::VectorType<ALIGNMENT>::type MaskedType;                             \
+  /* Map an index onto the valid range [0,limit), false if it has no source */                      \
+  static __device__ __forceinline__ bool fill_index(int &index, const int limit)                    \
+  {                                                                                                 \
+    if (index < limit)                                                                              \
+      return true;                                                                                  \
+    if ((FILL == FILL_ZERO) || (limit == 0))                                                        \
+      return false;                                                                                 \
+    if (FILL == FILL_CLAMP)                                                                         \
+      index = limit - 1;                                                                            \
+    else                                                                                            \
+      index = (index < 2*limit) ? (2*limit - 1 - index) : 0;                                        \
+    return true;                                                                                    \
+  }                                                                                                 \
+  template<bool DMA_GLOBAL_LOAD, int DMA_LOAD_QUAL>                                                 \
+  __device__ __forceinline__ void load_step(const char *RESTRICT src_ptr,                           \
+                                            CudaDMAMeta::TileCursor cursor)                         \
+  {                                                                                                 \
+    for (int i = 0; i < MASKED_LDS; i++)                                                            \
+    {                                                                                               \
+      if (dma_walk.valid(cursor))                                                                   \
+      {                                                                                             \
+        int src_row = cursor.row;                                                                   \
+        int src_col = cursor.col;                                                                   \
+        const bool enabled = (cursor.row >= 64) || ((dma_elmt_mask >> cursor.row) & 1);             \
+        if (enabled && fill_index(src_row, dma_valid_elmts) && fill_index(src_col, dma_valid_chunks))\
+        {                                                                                           \
+          const char *ptr = src_ptr + src_row*dma_src_stride + src_col*ALIGNMENT;                   \
+          bulk_buffer[i] = ptx_cudaDMA_load<MaskedType,DMA_GLOBAL_LOAD,DMA_LOAD_QUAL>(              \
+                                                                        (const MaskedType*)ptr);    \
+        }                                                                                           \
+        else                                                                                        \
+          bulk_buffer[i] = MaskedType();                                                            \
+      }                                                                                             \
+      dma_walk.advance(cursor);                                                                     \
+    }                                                                                               \
+  }                                                                                                 \
+  template<int DMA_STORE_QUAL>                                                                      \
+  __device__ __forceinline__ void store_step(char *RESTRICT dst_ptr,                                \
+                                             CudaDMAMeta::TileCursor &cursor)                       \
+  {                                                                                                 \
+    for (int i = 0; i < MASKED_LDS; i++)                                                            \
+    {                                                                                               \
+      if (dma_walk.valid(cursor))                                                                   \
+      {                                                                                             \
+        char *ptr = dst_ptr + cursor.row*dma_dst_stride + cursor.col*ALIGNMENT;                     \
+        ptx_cudaDMA_store<MaskedType,DMA_STORE_QUAL>(bulk_buffer[i], (MaskedType*)ptr);             \
+      }                                                                                             \
+      dma_walk.advance(cursor);                                                                     \
+    }                                                                                               \
+  }                                                                                                 \
+  template<bool DMA_GLOBAL_LOAD, int DMA_LOAD_QUAL>                                                 \
+  __device__ __forceinline__ void execute_start_xfer(const void *RESTRICT src_ptr,                  \
+                                                     const int valid_elmts, const int valid_bytes,  \
+                                                     const unsigned long long elmt_mask)            \
+  {                                                                                                 \
+    dma_src_ptr = (const char*)src_ptr;                                                             \
+    dma_valid_elmts = valid_elmts;                                                                  \
+    MASKED_CHECK_XFER(valid_bytes,elmt_mask)                                                        \
+    dma_valid_chunks = valid_bytes/ALIGNMENT;                                                       \
+    dma_elmt_mask = elmt_mask;                                                                      \
+    load_step<DMA_GLOBAL_LOAD,DMA_LOAD_QUAL>(dma_src_ptr, dma_walk.start());                        \
+  }                                                                                                 \
+  TILE_WAIT_XFER_IMPL                                                                               \
+private:                                                                                            \
+  const int dma_src_stride;                                                                         \
+  const int dma_dst_stride;                                                                         \
+  const CudaDMAMeta::TileWalk<> dma_walk;                                                           \
+  const char *dma_src_ptr;                                                                          \
+  int dma_valid_elmts;                                                                              \
+  int dma_valid_chunks;                                                                             \
+  unsigned long long dma_elmt_mask;                                                                 \
+  MaskedType bulk_buffer[MASKED_LDS];
+
+#define MASKED_START_XFER_IMPL(GLOBAL_LOAD,LOAD_QUAL,STORE_QUAL)                                    \
+  execute_start_xfer<GLOBAL_LOAD,LOAD_QUAL>(src_ptr, valid_elmts, valid_bytes, elmt_mask);
+
+#define MASKED_WAIT_XFER_IMPL(GLOBAL_LOAD,LOAD_QUAL,STORE_QUAL)                                     \
+  execute_wait_xfer<GLOBAL_LOAD,LOAD_QUAL,STORE_QUAL>(dst_ptr);
+
+#define WARP_SPECIALIZED_UNQUALIFIED_METHODS                                                        \
+  __device__ __forceinline__ void execute_dma(const void *RESTRICT src_ptr, void *RESTRICT dst_ptr, \
+                        const int valid_elmts, const int valid_bytes,                               \
+                        const unsigned long long elmt_mask = ~0ULL)                                 \
+  {                                                                                                 \
+    start_xfer_async(src_ptr, valid_elmts, valid_bytes, elmt_mask);                                 \
+    wait_xfer_finish(dst_ptr);                                                                      \
+  }                                                                                                 \
+  __device__ __forceinline__ void start_xfer_async(const void *RESTRICT src_ptr,                    \
+                                                   const int valid_elmts, const int valid_bytes,    \
+                                                   const unsigned long long elmt_mask = ~0ULL)      \
+  {                                                                                                 \
+    MASKED_START_XFER_IMPL(false,LOAD_CACHE_ALL,STORE_WRITE_BACK)                                   \
+  }                                                                                                 \
+  __device__ __forceinline__ void wait_xfer_finish(void *RESTRICT dst_ptr)                          \
+  {                                                                                                 \
+    CudaDMA::wait_for_dma_start();                                                                  \
+    MASKED_WAIT_XFER_IMPL(false,LOAD_CACHE_ALL,STORE_WRITE_BACK)                                    \
+    CudaDMA::finish_async_dma();                                                                    \
+  }                                                                                                 \
+  __device__ __forceinline__ void prefetch(const void *RESTRICT src_ptr,                            \
+                                           const int valid_elmts, const int valid_bytes,            \
+                                           const unsigned long long elmt_mask = ~0ULL) const        \
+  {                                                                                                 \
+    prefetch<false>(src_ptr, valid_elmts, valid_bytes, elmt_mask);                                  \
+  }
+
+#define WARP_SPECIALIZED_QUALIFIED_METHODS                                                          \
+  template<bool DMA_GLOBAL_LOAD>                                                                    \
+  __device__ __forceinline__ void execute_dma(const void *RESTRICT src_ptr, void *RESTRICT dst_ptr, \
+                        const int valid_elmts, const int valid_bytes,                               \
+                        const unsigned long long elmt_mask = ~0ULL)                                 \
+  {                                                                                                 \
+    start_xfer_async<DMA_GLOBAL_LOAD>(src_ptr, valid_elmts, valid_bytes, elmt_mask);                \
+    wait_xfer_finish<DMA_GLOBAL_LOAD>(dst_ptr);                                                     \
+  }                                                                                                 \
+  template<bool DMA_GLOBAL_LOAD>                                                                    \
+  __device__ __forceinline__ void start_xfer_async(const void *RESTRICT src_ptr,                    \
+                                                   const int valid_elmts, const int valid_bytes,    \
+                                                   const unsigned long long elmt_mask = ~0ULL)      \
+  {                                                                                                 \
+    MASKED_START_XFER_IMPL(DMA_GLOBAL_LOAD,LOAD_CACHE_ALL,STORE_WRITE_BACK)                         \
+  }                                                                                                 \
+  template<bool DMA_GLOBAL_LOAD>                                                                    \
+  __device__ __forceinline__ void wait_xfer_finish(void *RESTRICT dst_ptr)                          \
+  {                                                                                                 \
+    CudaDMA::wait_for_dma_start();                                                                  \
+    MASKED_WAIT_XFER_IMPL(DMA_GLOBAL_LOAD,LOAD_CACHE_ALL,STORE_WRITE_BACK)                          \
+    CudaDMA::finish_async_dma();                                                                    \
+  }                                                                                                 \
+  template<bool DMA_GLOBAL_LOAD, int DMA_LOAD_QUAL, int DMA_STORE_QUAL>                             \
+  __device__ __forceinline__ void execute_dma(const void *RESTRICT src_ptr, void *RESTRICT dst_ptr, \
+                        const int valid_elmts, const int valid_bytes,                               \
+                        const unsigned long long elmt_mask = ~0ULL)                                 \
+  {                                                                                                 \
+    start_xfer_async<DMA_GLOBAL_LOAD,DMA_LOAD_QUAL,DMA_STORE_QUAL>(src_ptr, valid_elmts, valid_bytes,\
+                                                                   elmt_mask);                      \
+    wait_xfer_finish<DMA_GLOBAL_LOAD,DMA_LOAD_QUAL,DMA_STORE_QUAL>(dst_ptr);                        \
+  }                                                                                                 \
+  template<bool DMA_GLOBAL_LOAD, int DMA_LOAD_QUAL, int DMA_STORE_QUAL>                             \
+  __device__ __forceinline__ void start_xfer_async(const void *RESTRICT src_ptr,                    \
+                                                   const int valid_elmts, const int valid_bytes,    \
+                                                   const unsigned long long elmt_mask = ~0ULL)      \
+  {                                                                                                 \
+    MASKED_START_XFER_IMPL(DMA_GLOBAL_LOAD,DMA_LOAD_QUAL,DMA_STORE_QUAL)                            \
+  }                                                                                                 \
+  template<bool DMA_GLOBAL_LOAD, int DMA_LOAD_QUAL, int DMA_STORE_QUAL>                             \
+  __device__ __forceinline__ void wait_xfer_finish(void *RESTRICT dst_ptr)                          \
+  {                                                                                                 \
+    CudaDMA::wait_for_dma_start();                                                                  \
+    MASKED_WAIT_XFER_IMPL(DMA_GLOBAL_LOAD,DMA_LOAD_QUAL,DMA_STORE_QUAL)                             \
+    CudaDMA::finish_async_dma();                                                                    \
+  }                                                                                                 \
+  template<bool DMA_GLOBAL_LOAD>                                                                    \
+  __device__ __forceinline__ void prefetch(const void *RESTRICT src_ptr,                            \
+                                           const int valid_elmts, const int valid_bytes,            \
+                                           const unsigned long long elmt_mask = ~0ULL) const        \
+  {                                                                                                 \
+    /* Walk the transfer on a copy so that a transfer in flight is untouched */                     \
+    CudaDMAMeta::copy_of(*this).template prefetch_xfer<DMA_GLOBAL_LOAD>(src_ptr, valid_elmts,       \
+                                                                      valid_bytes, elmt_mask);      \
+  }                                                                                                 \
+private:                                                                                            \
+  template<bool DMA_GLOBAL_LOAD>                                                                    \
+  __device__ __forceinline__ void prefetch_xfer(const void *RESTRICT src_ptr,                       \
+                                                const int valid_elmts, const int valid_bytes,       \
+                                                const unsigned long long elmt_mask)                 \
+  {                                                                                                 \
+    void *const dst_ptr = NULL;                                                                     \
+    {                                                                                               \
+      MASKED_START_XFER_IMPL(DMA_GLOBAL_LOAD,LOAD_PREFETCH_L2,CUDADMA_STORE_DISCARD)                \
+    }                                                                                               \
+    {                                                                                               \
+      MASKED_WAIT_XFER_IMPL(DMA_GLOBAL_LOAD,LOAD_PREFETCH_L2,CUDADMA_STORE_DISCARD)                 \
+    }                                                                                               \
+  }
+
+#define NON_WARP_SPECIALIZED_UNQUALIFIED_METHODS                                                    \
+  __device__ __forceinline__ void execute_dma(const void *RESTRICT src_ptr, void *RESTRICT dst_ptr, \
+                        const int valid_elmts, const int valid_bytes,                               \
+                        const unsigned long long elmt_mask = ~0ULL)                                 \
+  {                                                                                                 \
+    start_xfer_async(src_ptr, valid_elmts, valid_bytes, elmt_mask);                                 \
+    wait_xfer_finish(dst_ptr);                                                                      \
+  }                                                                                                 \
+  __device__ __forceinline__ void start_xfer_async(const void *RESTRICT src_ptr,                    \
+                                                   const int valid_elmts, const int valid_bytes,    \
+                                                   const unsigned long long elmt_mask = ~0ULL)      \
+  {                                                                                                 \
+    MASKED_START_XFER_IMPL(false,LOAD_CACHE_ALL,STORE_WRITE_BACK)                                   \
+  }                                                                                                 \
+  __device__ __forceinline__ void wait_xfer_finish(void *RESTRICT dst_ptr)                          \
+  {                                                                                                 \
+    MASKED_WAIT_XFER_IMPL(false,LOAD_CACHE_ALL,STORE_WRITE_BACK)                                    \
+  }                                                                                                 \
+  __device__ __forceinline__ void prefetch(const void *RESTRICT src_ptr,                            \
+                                           const int valid_elmts, const int valid_bytes,            \
+                                           const unsigned long long elmt_mask = ~0ULL) const        \
+  {                                                                                                 \
+    prefetch<false>(src_ptr, valid_elmts, valid_bytes, elmt_mask);                                  \
+  }
+
+#define NON_WARP_SPECIALIZED_QUALIFIED_METHODS                                                      \
+  template<bool DMA_GLOBAL_LOAD>                                                                    \
+  __device__ __forceinline__ void execute_dma(const void *RESTRICT src_ptr, void *RESTRICT dst_ptr, \
+                        const int valid_elmts, const int valid_bytes,                               \
+                        const unsigned long long elmt_mask = ~0ULL)                                 \
+  {                                                                                                 \
+    start_xfer_async<DMA_GLOBAL_LOAD>(src_ptr, valid_elmts, valid_bytes, elmt_mask);                \
+    wait_xfer_finish<DMA_GLOBAL_LOAD>(dst_ptr);                                                     \
+  }                                                                                                 \
+  template<bool DMA_GLOBAL_LOAD>                                                                    \
+  __device__ __forceinline__ void start_xfer_async(const void *RESTRICT src_ptr,                    \
+                                                   const int valid_elmts, const int valid_bytes,    \
+                                                   const unsigned long long elmt_mask = ~0ULL)      \
+  {                                                                                                 \
+    MASKED_START_XFER_IMPL(DMA_GLOBAL_LOAD,LOAD_CACHE_ALL,STORE_WRITE_BACK)                         \
+  }                                                                                                 \
+  template<bool DMA_GLOBAL_LOAD>                                                                    \
+  __device__ __forceinline__ void wait_xfer_finish(void *RESTRICT dst_ptr)                          \
+  {                                                                                                 \
+    MASKED_WAIT_XFER_IMPL(DMA_GLOBAL_LOAD,LOAD_CACHE_ALL,STORE_WRITE_BACK)                          \
+  }                                                                                                 \
+  template<bool DMA_GLOBAL_LOAD, int DMA_LOAD_QUAL, int DMA_STORE_QUAL>                             \
+  __device__ __forceinline__ void execute_dma(const void *RESTRICT src_ptr, void *RESTRICT dst_ptr, \
+                        const int valid_elmts, const int valid_bytes,                               \
+                        const unsigned long long elmt_mask = ~0ULL)                                 \
+  {                                                                                                 \
+    start_xfer_async<DMA_GLOBAL_LOAD,DMA_LOAD_QUAL,DMA_STORE_QUAL>(src_ptr, valid_elmts, valid_bytes,\
+                                                                   elmt_mask);                      \
+    wait_xfer_finish<DMA_GLOBAL_LOAD,DMA_LOAD_QUAL,DMA_STORE_QUAL>(dst_ptr);                        \
+  }                                                                                                 \
+  template<bool DMA_GLOBAL_LOAD, int DMA_LOAD_QUAL, int DMA_STORE_QUAL>                             \
+  __device__ __forceinline__ void start_xfer_async(const void *RESTRICT src_ptr,                    \
+                                                   const int valid_elmts, const int valid_bytes,    \
+                                                   const unsigned long long elmt_mask = ~0ULL)      \
+  {                                                                                                 \
+    MASKED_START_XFER_IMPL(DMA_GLOBAL_LOAD,DMA_LOAD_QUAL,DMA_STORE_QUAL)                            \
+  }                                                                                                 \
+  template<bool DMA_GLOBAL_LOAD, int DMA_LOAD_QUAL, int DMA_STORE_QUAL>                             \
+  __device__ __forceinline__ void wait_xfer_finish(void *RESTRICT dst_ptr)                          \
+  {                                                                                                 \
+    MASKED_WAIT_XFER_IMPL(DMA_GLOBAL_LOAD,DMA_LOAD_QUAL,DMA_STORE_QUAL)                             \
+  }                                                                                                 \
+  template<bool DMA_GLOBAL_LOAD>                                                                    \
+  __device__ __forceinline__ void prefetch(const void *RESTRICT src_ptr,                            \
+                                           const int valid_elmts, const int valid_bytes,            \
+                                           const unsigned long long elmt_mask = ~0ULL) const        \
+  {                                                                                                 \
+    /* Walk the transfer on a copy so that a transfer in flight is untouched */                     \
+    CudaDMAMeta::copy_of(*this).template prefetch_xfer<DMA_GLOBAL_LOAD>(src_ptr, valid_elmts,       \
+                                                                      valid_bytes, elmt_mask);      \
+  }                                                                                                 \
+private:                                                                                            \
+  template<bool DMA_GLOBAL_LOAD>                                                                    \
+  __device__ __forceinline__ void prefetch_xfer(const void *RESTRICT src_ptr,                       \
+                                                const int valid_elmts, const int valid_bytes,       \
+                                                const unsigned long long elmt_mask)                 \
+  {                                                                                                 \
+    void *const dst_ptr = NULL;                                                                     \
+    {                                                                                               \
+      MASKED_START_XFER_IMPL(DMA_GLOBAL_LOAD,LOAD_PREFETCH_L2,CUDADMA_STORE_DISCARD)                \
+    }                                                                                               \
+    {                                                                                               \
+      MASKED_WAIT_XFER_IMPL(DMA_GLOBAL_LOAD,LOAD_PREFETCH_L2,CUDADMA_STORE_DISCARD)                 \
+    }                                                                                               \
+  }
+
+template<bool DO_SYNC=false, int ALIGNMENT=0, int BYTES_PER_THREAD=4*ALIGNMENT, int FILL=FILL_ZERO>
+class CudaDMAStridedMasked : public CudaDMA {
+public:
+  __device__ CudaDMAStridedMasked(const int dmaID,
+                                  const int num_dma_threads,
+                                  const int num_compute_threads,
+                                  const int dma_threadIdx_start,
+                                  const int elmt_size_in_bytes,
+                                  const int num_elements,
+                                  const int src_stride,
+                                  const int dst_stride)
+    : CudaDMA(dmaID, num_dma_threads, num_compute_threads, dma_threadIdx_start),
+      MASKED_INIT(CUDADMA_DMA_TID, num_dma_threads)
+  {
+    MASKED_STATIC_ASSERTS;
+  }
+public:
+  WARP_SPECIALIZED_UNQUALIFIED_METHODS
+  WARP_SPECIALIZED_QUALIFIED_METHODS
+private:
+  MASKED_TRANSFER_IMPL
+};
+
+template<int ALIGNMENT, int BYTES_PER_THREAD, int FILL>
+class CudaDMAStridedMasked<false,ALIGNMENT,BYTES_PER_THREAD,FILL> : public CudaDMA {
+public:
+  __device__ CudaDMAStridedMasked(const int elmt_size_in_bytes,
+                                  const int num_elements,
+                                  const int src_stride,
+                                  const int dst_stride)
+    : CudaDMA(0, blockDim.x, blockDim.x, 0),
+      MASKED_INIT(threadIdx.x, blockDim.x)
+  {
+    MASKED_STATIC_ASSERTS;
+  }
+public:
+  NON_WARP_SPECIALIZED_UNQUALIFIED_METHODS
+  NON_WARP_SPECIALIZED_QUALIFIED_METHODS
+private:
+  MASKED_TRANSFER_IMPL
+};
+
+#undef MASKED_LDS
+#undef MASKED_INIT
+#undef MASKED_STATIC_ASSERTS
+#undef MASKED_CHECK_XFER
+#undef MASKED_TRANSFER_IMPL
+#undef MASKED_START_XFER_IMPL
+#undef MASKED_WAIT_XFER_IMPL
+#undef WARP_SPECIALIZED_UNQUALIFIED_METHODS
+#undef WARP_SPECIALIZED_QUALIFIED_METHODS
+#undef NON_WARP_SPECIALIZED_UNQUALIFIED_METHODS
+#undef NON_WARP_SPECIALIZED_QUALIFIED_METHODS
+////////////////////////  End of CudaDMAStridedMasked ///////////////////////////////////////////////
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+// CudaDMAPipeline
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+namespace CudaDMAMeta {
+  /********************************************/
+  // IgnoreArg
+  // Swallows a constructor argument that is
+  // passed to the end of a pipeline
+  /********************************************/
+  struct IgnoreArg {
+    template<typename T>
+    __device__ __forceinline__ IgnoreArg(const T &) { }
+  };
+};
+
+/**
+ * CudaDMAPipeline runs a loop of transfers through STAGES instances of a warp-specialized
+ * pattern and STAGES shared memory buffers.  Iteration i of the loop is assigned to stage
+ * i%STAGES, which has its own DMA instance (and so its own pair of barriers) and its own
+ * buffer.  The DMA threads keep the loads of up to STAGES iterations in flight while the
+ * compute threads work on the oldest one, so moving from double buffering to three or four
+ * stages is a change of the STAGES parameter rather than a rewrite of the kernel.
+ * STAGES - the number of DMA instances and buffers
+ * DMA_TYPE - a warp-specialized pattern with a start_xfer_async(src_ptr) method
+ * STAGE_BYTES - the size of the buffer of each stage
+ *
+ * Stage s is constructed as DMA_TYPE(dmaID+s, args...) where args are the remaining
+ * arguments (up to 8) given to the pipeline constructor, so every stage uses the same DMA
+ * threads.  The stages use dmaIDs dmaID through dmaID+STAGES-1, which can be allocated
+ * with CudaDMABarriers<>::Allocate<num_dma_ids>.  The shared memory must hold shared_bytes
+ * bytes and every buffer starts at a multiple of 16 bytes from its start.
+ * The DMA threads call execute_dma with the source of the first iteration and the distance
+ * in bytes between the sources of two iterations.  The compute threads call execute_compute
+ * with a functor that is invoked as compute(buffer, iteration) for every iteration in order.
+ * The stages are unrolled at compile time so the DMA instances stay in registers.
+ */
+#define PIPELINE_UNWRAP(...) __VA_ARGS__
+// Construct the stage with its dmaID and the remaining arguments of the pipeline
+#define PIPELINE_CONSTRUCTOR(TYPES,PARAMS,ARGS)                                                     \
+  template<PIPELINE_UNWRAP TYPES>                                                                   \
+  __device__ CudaDMAPipeline(void *shared_buffer, const int dmaID, PIPELINE_UNWRAP PARAMS)          \
+    : dma_stage(dmaID, PIPELINE_UNWRAP ARGS),                                                       \
+      dma_next((char*)shared_buffer + stage_stride, dmaID+1, PIPELINE_UNWRAP ARGS),                 \
+      dma_buffer((char*)shared_buffer)                                                              \
+  {                                                                                                 \
+    STATIC_ASSERT(STAGES > 0);                                                                      \
+  }
+
+template<int STAGES, typename DMA_TYPE, int STAGE_BYTES, int STAGE=0>
+class CudaDMAPipeline {
+public:
+  // Distance between the buffers of two stages
+  static const int stage_stride = (STAGE_BYTES+15) & ~15;
+  // Shared memory needed by the buffers of all the stages
+  static const int shared_bytes = STAGES*stage_stride;
+  // Consecutive dmaIDs used by the stages (see CudaDMABarriers)
+  static const int num_dma_ids = STAGES;
+public:
+  PIPELINE_CONSTRUCTOR((typename A0),
+                       (const A0 &a0),
+                       (a0))
+  PIPELINE_CONSTRUCTOR((typename A0, typename A1),
+                       (const A0 &a0, const A1 &a1),
+                       (a0, a1))
+  PIPELINE_CONSTRUCTOR((typename A0, typename A1, typename A2),
+                       (const A0 &a0, const A1 &a1, const A2 &a2),
+                       (a0, a1, a2))
+  PIPELINE_CONSTRUCTOR((typename A0, typename A1, typename A2, typename A3),
+                       (const A0 &a0, const A1 &a1, const A2 &a2, const A3 &a3),
+                       (a0, a1, a2, a3))
+  PIPELINE_CONSTRUCTOR((typename A0, typename A1, typename A2, typename A3, typename A4),
+                       (const A0 &a0, const A1 &a1, const A2 &a2, const A3 &a3, const A4 &a4),
+                       (a0, a1, a2, a3, a4))
+  PIPELINE_CONSTRUCTOR((typename A0, typename A1, typename A2, typename A3, typename A4,
+                        typename A5),
+                       (const A0 &a0, const A1 &a1, const A2 &a2, const A3 &a3, const A4 &a4,
+                        const A5 &a5),
+                       (a0, a1, a2, a3, a4, a5))
+  PIPELINE_CONSTRUCTOR((typename A0, typename A1, typename A2, typename A3, typename A4,
+                        typename A5, typename A6),
+                       (const A0 &a0, const A1 &a1, const A2 &a2, const A3 &a3, const A4 &a4,
+                        const A5 &a5, const A6 &a6),
+                       (a0, a1, a2, a3, a4, a5, a6))
+  PIPELINE_CONSTRUCTOR((typename A0, typename A1, typename A2, typename A3, typename A4,
+                        typename A5, typename A6, typename A7),
+                       (const A0 &a0, const A1 &a1, const A2 &a2, const A3 &a3, const A4 &a4,
+                        const A5 &a5, const A6 &a6, const A7 &a7),
+                       (a0, a1, a2, a3, a4, a5, a6, a7))
+public:
+  __device__ __forceinline__
+  bool owns_this_thread(void) const { return dma_stage.owns_this_thread(); }
+public:
+  // DMA threads
+  __device__ __forceinline__ void execute_dma(const void *RESTRICT src_ptr, const int src_stride,
+                                              const int iterations)
+  {
+    execute_dma<false,LOAD_CACHE_ALL,STORE_WRITE_BACK>(src_ptr, src_stride, iterations);
+  }
+  template<bool DMA_GLOBAL_LOAD>
+  __device__ __forceinline__ void execute_dma(const void *RESTRICT src_ptr, const int src_stride,
+                                              const int iterations)
+  {
+    execute_dma<DMA_GLOBAL_LOAD,LOAD_CACHE_ALL,STORE_WRITE_BACK>(src_ptr, src_stride, iterations);
+  }
+  template<bool DMA_GLOBAL_LOAD, int DMA_LOAD_QUAL, int DMA_STORE_QUAL>
+  __device__ __forceinline__ void execute_dma(const void *RESTRICT src_ptr, const int src_stride,
+                                              const int iterations)
+  {
+    // Prologue: start the loads of the first iteration of every stage
+    start_stages<DMA_GLOBAL_LOAD,DMA_LOAD_QUAL,DMA_STORE_QUAL>((const char*)src_ptr, src_stride,
+                                                               iterations);
+    // Steady state and epilogue: finish each iteration and start the one
+    // that will use the same stage next, until there are none left.  The
+    // stages advance their sources in 64 bits so large volumes don't overflow.
+    const long long round_stride = (long long)STAGES*src_stride;
+    for (int round = 0; round < iterations; round += STAGES)
+      finish_stages<DMA_GLOBAL_LOAD,DMA_LOAD_QUAL,DMA_STORE_QUAL>(round_stride, round, iterations);
+  }
+public:
+  // Compute threads
+  template<typename COMPUTE>
+  __device__ __forceinline__ void execute_compute(COMPUTE &compute, const int iterations)
+  {
+    release_stages(iterations);
+    for (int round = 0; round < iterations; round += STAGES)
+      compute_stages(compute, round, iterations);
+  }
+private:
+  template<int,typename,int,int> friend class CudaDMAPipeline;
+  template<bool DMA_GLOBAL_LOAD, int DMA_LOAD_QUAL, int DMA_STORE_QUAL>
+  // src_ptr is the source of the first iteration of this stage
+  __device__ __forceinline__ void start_stages(const char *src_ptr, const int src_stride,
+                                               const int iterations)
+  {
+    dma_src_ptr = src_ptr;
+    if (STAGE < iterations)
+      dma_stage.template start_xfer_async<DMA_GLOBAL_LOAD,DMA_LOAD_QUAL,DMA_STORE_QUAL>(
+                                                                                  dma_src_ptr);
+    dma_next.template start_stages<DMA_GLOBAL_LOAD,DMA_LOAD_QUAL,DMA_STORE_QUAL>(
+                                                      src_ptr + src_stride, src_stride, iterations);
+  }
+  template<bool DMA_GLOBAL_LOAD, int DMA_LOAD_QUAL, int DMA_STORE_QUAL>
+  __device__ __forceinline__ void finish_stages(const long long round_stride,
+                                                const int round, const int iterations)
+  {
+    const int iteration = round + STAGE;
+    if (iteration < iterations)
+    {
+      dma_stage.template wait_xfer_finish<DMA_GLOBAL_LOAD,DMA_LOAD_QUAL,DMA_STORE_QUAL>(dma_buffer);
+      if ((iteration + STAGES) < iterations)
+      {
+        dma_src_ptr += round_stride;
+        dma_stage.template start_xfer_async<DMA_GLOBAL_LOAD,DMA_LOAD_QUAL,DMA_STORE_QUAL>(
+                                                                                  dma_src_ptr);
+      }
+    }
+    dma_next.template finish_stages<DMA_GLOBAL_LOAD,DMA_LOAD_QUAL,DMA_STORE_QUAL>(round_stride,
+                                                                                  round, iterations);
+  }
+  __device__ __forceinline__ void release_stages(const int iterations)
+  {
+    if (STAGE < iterations)
+      dma_stage.start_async_dma();
+    dma_next.release_stages(iterations);
+  }
+  template<typename COMPUTE>
+  __device__ __forceinline__ void compute_stages(COMPUTE &compute, const int round,
+                                                 const int iterations)
+  {
+    const int iteration = round + STAGE;
+    if (iteration < iterations)
+    {
+      dma_stage.wait_for_dma_finish();
+      compute((void*)dma_buffer, iteration);
+      // Hand the buffer back unless the stage is done
+      if ((iteration + STAGES) < iterations)
+        dma_stage.start_async_dma();
+    }
+    dma_next.compute_stages(compute, round, iterations);
+  }
+private:
+  DMA_TYPE dma_stage;
+  CudaDMAPipeline<STAGES,DMA_TYPE,STAGE_BYTES,STAGE+1> dma_next;
+  char *const dma_buffer;
+  // Source of the iteration of this stage in flight
+  const char *dma_src_ptr;
+};
+
+// The end of the stages
+template<int STAGES, typename DMA_TYPE, int STAGE_BYTES>
+class CudaDMAPipeline<STAGES,DMA_TYPE,STAGE_BYTES,STAGES> {
+public:
+  __device__ CudaDMAPipeline(void *, const int,
+                             const CudaDMAMeta::IgnoreArg & = 0, const CudaDMAMeta::IgnoreArg & = 0,
+                             const CudaDMAMeta::IgnoreArg & = 0, const CudaDMAMeta::IgnoreArg & = 0,
+                             const CudaDMAMeta::IgnoreArg & = 0, const CudaDMAMeta::IgnoreArg & = 0,
+                             const CudaDMAMeta::IgnoreArg & = 0, const CudaDMAMeta::IgnoreArg & = 0)
+  {
+  }
+private:
+  template<int,typename,int,int> friend class CudaDMAPipeline;
+  template<bool DMA_GLOBAL_LOAD, int DMA_LOAD_QUAL, int DMA_STORE_QUAL>
+  __device__ __forceinline__ void start_stages(const char *, const int, const int) { }
+  template<bool DMA_GLOBAL_LOAD, int DMA_LOAD_QUAL, int DMA_STORE_QUAL>
+  __device__ __forceinline__ void finish_stages(const long long, const int, const int) { }
+  __device__ __forceinline__ void release_stages(const int) { }
+  template<typename COMPUTE>
+  __device__ __forceinline__ void compute_stages(COMPUTE &, const int, const int) { }
+};
+
+#undef PIPELINE_UNWRAP
+#undef PIPELINE_CONSTRUCTOR
+////////////////////////  End of CudaDMAPipeline ////////////////////////////////////////////////////
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+// CudaDMATwoPhase
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * CudaDMATwoPhase splits the transfers of a pattern into a begin_xfer_async phase, which
+ * issues the global loads into the registers of a Handle, and a commit_xfer_async phase,
+ * which waits for the compute threads to release the buffer and writes the registers of
+ * the Handle into shared memory.  Unlike start_xfer_async and wait_xfer_finish, which
+ * keep the loads in the pattern instance and so allow one transfer in flight per
+ * instance, every Handle holds the loads of its own transfer.  The DMA threads can then
+ * begin the next transfer (or the next two) before the current one is committed, while
+ * all of the transfers share the dmaID and the shared buffer of a single instance.
+ * DMA_TYPE - CudaDMASequential or CudaDMAIndirect (or any pattern with the same
+ *            start_xfer_async and wait_xfer_finish methods)
+ *
+ * A Handle is a copy of the pattern instance, so it costs the registers of the loads of
+ * one transfer (BYTES_PER_THREAD for a fully templated pattern) and nothing else once the
+ * copy is inlined.  Handles must be committed in the order that the compute threads
+ * expect the transfers, since every commit waits on the same pair of barriers.  The
+ * compute threads use start_async_dma and wait_for_dma_finish as usual, once per commit.
+ *
+ *   CudaDMATwoPhase<CudaDMAIndirect<true,true,16,BYTES,ELMT_SIZE,DMA_THREADS,NUM_ELMTS> >
+ *     two_phase(CudaDMAIndirect<...>(1, NUM_COMPUTE_THREADS, NUM_COMPUTE_THREADS));
+ *   typename ...::Handle h0(two_phase), h1(two_phase);
+ *   two_phase.begin_xfer_async(h0, index0, src);
+ *   two_phase.begin_xfer_async(h1, index1, src);
+ *   two_phase.commit_xfer_async(h0, buffer);
+ *   two_phase.begin_xfer_async(h0, index2, src);
+ *   two_phase.commit_xfer_async(h1, buffer);
+ *   ...
+ */
+template<typename DMA_TYPE>
+class CudaDMATwoPhase {
+public:
+  // The loads of one transfer held in registers between begin and commit
+  class Handle {
+  public:
+    __device__ Handle(const CudaDMATwoPhase &two_phase)
+      : transfer(two_phase.dma) { }
+  private:
+    friend class CudaDMATwoPhase;
+    DMA_TYPE transfer;
+  };
+public:
+  __device__ CudaDMATwoPhase(const DMA_TYPE &instance)
+    : dma(instance) { }
+public:
+  __device__ __forceinline__
+  bool owns_this_thread(void) const { return dma.owns_this_thread(); }
+  // Compute threads
+  __device__ __forceinline__ void start_async_dma(void) { dma.start_async_dma(); }
+  __device__ __forceinline__ void wait_for_dma_finish(void) { dma.wait_for_dma_finish(); }
+public:
+  // CudaDMASequential (and the other patterns with a single source)
+  __device__ __forceinline__ void begin_xfer_async(Handle &handle, const void *RESTRICT src_ptr)
+  {
+    handle.transfer.start_xfer_async(src_ptr);
+  }
+  template<bool DMA_GLOBAL_LOAD>
+  __device__ __forceinline__ void begin_xfer_async(Handle &handle, const void *RESTRICT src_ptr)
+  {
+    handle.transfer.template start_xfer_async<DMA_GLOBAL_LOAD>(src_ptr);
+  }
+  template<bool DMA_GLOBAL_LOAD, int DMA_LOAD_QUAL, int DMA_STORE_QUAL>
+  __device__ __forceinline__ void begin_xfer_async(Handle &handle, const void *RESTRICT src_ptr)
+  {
+    handle.transfer.template start_xfer_async<DMA_GLOBAL_LOAD,DMA_LOAD_QUAL,DMA_STORE_QUAL>(src_ptr);
+  }
+public:
+  // CudaDMAIndirect
+  template<typename INDEX_TYPE>
+  __device__ __forceinline__ void begin_xfer_async(Handle &handle,
+                                                   const INDEX_TYPE *RESTRICT index_ptr,
+                                                   const void *RESTRICT src_ptr)
+  {
+    handle.transfer.start_xfer_async(index_ptr, src_ptr);
+  }
+  template<bool DMA_GLOBAL_LOAD, typename INDEX_TYPE>
+  __device__ __forceinline__ void begin_xfer_async(Handle &handle,
+                                                   const INDEX_TYPE *RESTRICT index_ptr,
+                                                   const void *RESTRICT src_ptr)
+  {
+    handle.transfer.template start_xfer_async<DMA_GLOBAL_LOAD>(index_ptr, src_ptr);
+  }
+  template<bool DMA_GLOBAL_LOAD, int DMA_LOAD_QUAL, int DMA_STORE_QUAL, typename INDEX_TYPE>
+  __device__ __forceinline__ void begin_xfer_async(Handle &handle,
+                                                   const INDEX_TYPE *RESTRICT index_ptr,
+                                                   const void *RESTRICT src_ptr)
+  {
+    handle.transfer.template start_xfer_async<DMA_GLOBAL_LOAD,DMA_LOAD_QUAL,DMA_STORE_QUAL>(
+                                                                              index_ptr, src_ptr);
+  }
+public:
+  __device__ __forceinline__ void commit_xfer_async(Handle &handle, void *RESTRICT dst_ptr)
+  {
+    handle.transfer.wait_xfer_finish(dst_ptr);
+  }
+  template<bool DMA_GLOBAL_LOAD>
+  __device__ __forceinline__ void commit_xfer_async(Handle &handle, void *RESTRICT dst_ptr)
+  {
+    handle.transfer.template wait_xfer_finish<DMA_GLOBAL_LOAD>(dst_ptr);
+  }
+  template<bool DMA_GLOBAL_LOAD, int DMA_LOAD_QUAL, int DMA_STORE_QUAL>
+  __device__ __forceinline__ void commit_xfer_async(Handle &handle, void *RESTRICT dst_ptr)
+  {
+    handle.transfer.template wait_xfer_finish<DMA_GLOBAL_LOAD,DMA_LOAD_QUAL,DMA_STORE_QUAL>(dst_ptr);
+  }
+private:
+  DMA_TYPE dma;
+};
+
+////////////////////////  End of CudaDMATwoPhase ////////////////////////////////////////////////////
+
 #undef WARP_SIZE
 #undef WARP_MASK
 #undef CUDADMA_DMA_TID
@@ -14852,6 +19787,7 @@ private:
 #undef GUARD_ZERO
 #undef GUARD_UNDERFLOW
 #undef GUARD_OVERFLOW
+#undef TILE_WAIT_XFER_IMPL
 
 // EOF
 
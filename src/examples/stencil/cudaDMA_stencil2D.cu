@@ -18,8 +18,10 @@
 #include <cstdlib>
 #include <cassert>
 
+#ifdef __CUDACC__
 #include "cuda.h"
 #include "cuda_runtime.h"
+#endif
 
 // Number of samples to take on each experiment
 #define NUM_SAMPLES 20
@@ -30,6 +32,7 @@
 #include "warp_specialized_single_buffer.h"
 #include "warp_specialized_double_buffer.h"
 #include "warp_specialized_manual_buffer.h"
+#include "warp_specialized_pipeline.h"
 #include "non_warp_specialized_single_buffer.h"
 #include "non_warp_specialized_double_buffer.h"
 
@@ -54,7 +57,8 @@ enum KernelID {
   WARP_SPECIALIZED_MANUAL_BUFFER = 2,
   NON_WARP_SPECIALIZED_SINGLE_BUFFER = 3,
   NON_WARP_SPECIALIZED_DOUBLE_BUFFER = 4,
-  NUM_KERNELS = 5,
+  WARP_SPECIALIZED_PIPELINE = 5,
+  NUM_KERNELS = 6,
 };
 
 int main(int argc, char **argv)
@@ -72,6 +76,7 @@ int main(int argc, char **argv)
     fprintf(stdout,"RADIUS: %d\n", PARAM_RADIUS);
     fprintf(stdout,"DMA_WARPS: %d\n", PARAM_DMA_WARPS);
     fprintf(stdout,"BYTES PER THREAD: %d\n", PARAM_BYTES_PER_THREAD);
+    fprintf(stdout,"PIPELINE STAGES: %d\n", PARAM_PIPELINE_STAGES);
     fprintf(stdout,"\n");
   }
   // A nice trick for improving performance on Kepler if your elements
@@ -121,10 +126,10 @@ int main(int argc, char **argv)
           unsigned total_warps = (PARAM_TILE_X*PARAM_TILE_Y/32) + PARAM_DMA_WARPS;
           for (unsigned int i = 0; i < NUM_SAMPLES; i++)
           {
-            stencil_2D_warp_specialized_single_buffer
+            CUDADMA_LAUNCH(num_ctas, total_warps*32, 0, timing_stream,
+              stencil_2D_warp_specialized_single_buffer
               <PARAM_ALIGNMENT, PARAM_BYTES_PER_THREAD, PARAM_TILE_X, 
-                PARAM_TILE_Y, PARAM_RADIUS, PARAM_DMA_WARPS*32>
-              <<<num_ctas, total_warps*32, 0, timing_stream>>>
+                PARAM_TILE_Y, PARAM_RADIUS, PARAM_DMA_WARPS*32>)
               (src_buffer_d, dst_buffer_d, offset, row_stride, slice_stride, PARAM_DIM_Z);
           }
           break;
@@ -136,10 +141,10 @@ int main(int argc, char **argv)
           assert((PARAM_DIM_Z%2) == 0);
           for (unsigned int i = 0; i < NUM_SAMPLES; i++)
           {
-            stencil_2D_warp_specialized_double_buffer
+            CUDADMA_LAUNCH(num_ctas, total_warps*32, 0, timing_stream,
+              stencil_2D_warp_specialized_double_buffer
               <PARAM_ALIGNMENT, PARAM_BYTES_PER_THREAD, PARAM_TILE_X,
-               PARAM_TILE_Y, PARAM_RADIUS, PARAM_DMA_WARPS*32>
-              <<<num_ctas, total_warps*32, 0, timing_stream>>>
+               PARAM_TILE_Y, PARAM_RADIUS, PARAM_DMA_WARPS*32>)
               (src_buffer_d, dst_buffer_d, offset, row_stride, slice_stride, PARAM_DIM_Z);
           }
           break;
@@ -151,10 +156,10 @@ int main(int argc, char **argv)
           assert((PARAM_DIM_Z%2) == 0);
           for (unsigned int i = 0; i < NUM_SAMPLES; i++)
           {
-            stencil_2D_warp_specialized_manual_buffer
+            CUDADMA_LAUNCH(num_ctas, total_warps*32, 0, timing_stream,
+              stencil_2D_warp_specialized_manual_buffer
               <PARAM_ALIGNMENT, PARAM_BYTES_PER_THREAD, PARAM_TILE_X,
-               PARAM_TILE_Y, PARAM_RADIUS, PARAM_DMA_WARPS*32>
-              <<<num_ctas, total_warps*32, 0, timing_stream>>>
+               PARAM_TILE_Y, PARAM_RADIUS, PARAM_DMA_WARPS*32>)
               (src_buffer_d, dst_buffer_d, offset, row_stride, slice_stride, PARAM_DIM_Z);
           }
           break;
@@ -164,10 +169,10 @@ int main(int argc, char **argv)
           unsigned total_warps = (PARAM_TILE_X*PARAM_TILE_Y/32);
           for (unsigned int i = 0; i < NUM_SAMPLES; i++)
           {
-            stencil_2D_non_warp_specialized_single_buffer
+            CUDADMA_LAUNCH(num_ctas, total_warps*32, 0, timing_stream,
+              stencil_2D_non_warp_specialized_single_buffer
               <PARAM_ALIGNMENT, PARAM_BYTES_PER_THREAD, PARAM_TILE_X,
-               PARAM_TILE_Y, PARAM_RADIUS>
-              <<<num_ctas, total_warps*32, 0, timing_stream>>>
+               PARAM_TILE_Y, PARAM_RADIUS>)
               (src_buffer_d, dst_buffer_d, offset, row_stride, slice_stride, PARAM_DIM_Z);
           }
           break;
@@ -179,10 +184,23 @@ int main(int argc, char **argv)
           assert((PARAM_DIM_Z%2) == 0);
           for (unsigned int i = 0; i < NUM_SAMPLES; i++)
           {
-            stencil_2D_non_warp_specialized_double_buffer
+            CUDADMA_LAUNCH(num_ctas, total_warps*32, 0, timing_stream,
+              stencil_2D_non_warp_specialized_double_buffer
               <PARAM_ALIGNMENT, PARAM_BYTES_PER_THREAD, PARAM_TILE_X,
-               PARAM_TILE_Y, PARAM_RADIUS>
-              <<<num_ctas, total_warps*32, 0, timing_stream>>>
+               PARAM_TILE_Y, PARAM_RADIUS>)
+              (src_buffer_d, dst_buffer_d, offset, row_stride, slice_stride, PARAM_DIM_Z);
+          }
+          break;
+        }
+      case WARP_SPECIALIZED_PIPELINE:
+        {
+          unsigned total_warps = (PARAM_TILE_X*PARAM_TILE_Y/32) + PARAM_DMA_WARPS;
+          for (unsigned int i = 0; i < NUM_SAMPLES; i++)
+          {
+            CUDADMA_LAUNCH(num_ctas, total_warps*32, 0, timing_stream,
+              stencil_2D_warp_specialized_pipeline
+              <PARAM_ALIGNMENT, PARAM_BYTES_PER_THREAD, PARAM_TILE_X,
+               PARAM_TILE_Y, PARAM_RADIUS, PARAM_DMA_WARPS*32, PARAM_PIPELINE_STAGES>)
               (src_buffer_d, dst_buffer_d, offset, row_stride, slice_stride, PARAM_DIM_Z);
           }
           break;
@@ -210,6 +228,9 @@ int main(int argc, char **argv)
       case NON_WARP_SPECIALIZED_DOUBLE_BUFFER:
         fprintf(stdout,"  RESULTS for Non Warp Specialized Double Buffer\n");
         break;
+      case WARP_SPECIALIZED_PIPELINE:
+        fprintf(stdout,"  RESULTS for Warp Specialized %d Stage Pipeline\n", PARAM_PIPELINE_STAGES);
+        break;
       default:
         // Should never get here
         assert(false);
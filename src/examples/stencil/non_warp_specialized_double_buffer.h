@@ -50,16 +50,16 @@ void stencil_2D_non_warp_specialized_double_buffer(const float2 *src_buffer, flo
   float2 *dst_ptr = dst_buffer + block_offset + ty*row_stride + tx;
 
   // Launch the first set of LDGs
-  dma_ld0.start_xfer_async<true>(src_ptr);
+  dma_ld0.template start_xfer_async<true>(src_ptr);
   src_ptr += slice_stride;
   // Launch the second set of LDGs
-  dma_ld1.start_xfer_async<true>(src_ptr);
+  dma_ld1.template start_xfer_async<true>(src_ptr);
   src_ptr += slice_stride;
   for (int iz = 0; iz < (z_steps-2); iz+=2)
   {
     // Wait for the first tranfer to finish
-    dma_ld0.wait_xfer_finish<true>(buffer0); // texture barrier
-    dma_ld0.start_xfer_async<true>(src_ptr); // launch more LDGs
+    dma_ld0.template wait_xfer_finish<true>(buffer0); // texture barrier
+    dma_ld0.template start_xfer_async<true>(src_ptr); // launch more LDGs
     src_ptr += slice_stride;
     // Wait for buffer to be full
     __syncthreads();
@@ -69,8 +69,8 @@ void stencil_2D_non_warp_specialized_double_buffer(const float2 *src_buffer, flo
     dst_ptr += slice_stride;
 
     // Now do the second iteration
-    dma_ld1.wait_xfer_finish<true>(buffer1); // texture barrier
-    dma_ld1.start_xfer_async<true>(src_ptr);
+    dma_ld1.template wait_xfer_finish<true>(buffer1); // texture barrier
+    dma_ld1.template start_xfer_async<true>(src_ptr);
     src_ptr += slice_stride;
     // Wait for the barrier to be full
     __syncthreads();
@@ -79,12 +79,12 @@ void stencil_2D_non_warp_specialized_double_buffer(const float2 *src_buffer, flo
     dst_ptr += slice_stride;
   }
   // Loop cleanup
-  dma_ld0.wait_xfer_finish<true>(buffer0);
+  dma_ld0.template wait_xfer_finish<true>(buffer0);
   __syncthreads();
   perform_stencil<TILE_X,TILE_Y,RADIUS>(buffer0, tx, ty, dst_ptr);
   // Need extra synchronization here if you only want to use one shared memory buffer
   dst_ptr += slice_stride;
-  dma_ld1.wait_xfer_finish<true>(buffer1);
+  dma_ld1.template wait_xfer_finish<true>(buffer1);
   __syncthreads();
   perform_stencil<TILE_X,TILE_Y,RADIUS>(buffer1, tx, ty, dst_ptr);
 }
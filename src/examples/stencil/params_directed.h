@@ -22,4 +22,5 @@
 #define PARAM_RADIUS      4
 #define PARAM_DMA_WARPS   1
 #define PARAM_BYTES_PER_THREAD  (12*16) 
+#define PARAM_PIPELINE_STAGES   3
 
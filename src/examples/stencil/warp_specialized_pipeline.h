@@ -0,0 +1,77 @@
+/*
+ *  Copyright 2013 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#ifndef __WARP_SPECIALIZED_PIPELINE__
+#define __WARP_SPECIALIZED_PIPELINE__
+
+#include "../../../include/cudaDMAv2.h"
+
+// The stencil function to be performed
+#include "stencil_math.h"
+
+// Performs the stencil on every slice that the pipeline hands out
+template<int TILE_X, int TILE_Y, int RADIUS>
+struct StencilStage {
+  float2 *dst_ptr;
+  int slice_stride;
+  unsigned tx, ty;
+  __device__ __forceinline__ void operator()(void *buffer, int iz)
+  {
+    perform_stencil<TILE_X,TILE_Y,RADIUS>((const float2*)buffer, tx, ty, dst_ptr + iz*slice_stride);
+  }
+};
+
+template<int ALIGNMENT, int BYTES_PER_THREAD, int TILE_X, int TILE_Y, int RADIUS, int DMA_THREADS_PER_LD,
+         int STAGES>
+__global__
+void stencil_2D_warp_specialized_pipeline(const float2 *src_buffer, float2 *dst_buffer, const int offset,
+                                          const int row_stride, const int slice_stride, const int z_steps)
+{
+  // Same transfer as the manual buffer version, but with STAGES
+  // instances and buffers that share the same set of DMA threads
+  typedef CudaDMAStrided<true,ALIGNMENT,BYTES_PER_THREAD,
+                (TILE_X+2*RADIUS)*sizeof(float2), DMA_THREADS_PER_LD, (TILE_Y+2*RADIUS)> DMA;
+  typedef CudaDMAPipeline<STAGES,DMA,(TILE_Y+2*RADIUS)*(TILE_X+2*RADIUS)*sizeof(float2)> Pipeline;
+  // Keep the stages off barrier 0 which __syncthreads uses
+  typedef CudaDMABarriers<>::Allocate<Pipeline::num_dma_ids> Stages;
+
+  __shared__ float4 buffers[Pipeline::shared_bytes/sizeof(float4)];
+
+  Pipeline pipeline(buffers, Stages::dmaID, (TILE_X*TILE_Y), (TILE_X*TILE_Y),
+                    row_stride*sizeof(float2), (TILE_X+2*RADIUS)*sizeof(float2));
+
+  const unsigned block_offset = offset + blockIdx.x*TILE_X + blockIdx.y*TILE_Y*row_stride;
+
+  if (pipeline.owns_this_thread())
+  {
+    // DMA threads
+    const float2 *src_ptr = src_buffer + block_offset - (RADIUS*row_stride + RADIUS);
+    pipeline.template execute_dma<true>(src_ptr, slice_stride*sizeof(float2), z_steps);
+  }
+  else
+  {
+    // Compute threads
+    StencilStage<TILE_X,TILE_Y,RADIUS> stage;
+    stage.tx = threadIdx.x % TILE_X;
+    stage.ty = threadIdx.x / TILE_X;
+    stage.dst_ptr = dst_buffer + block_offset + stage.ty*row_stride + stage.tx;
+    stage.slice_stride = slice_stride;
+    pipeline.execute_compute(stage, z_steps);
+  }
+}
+
+#endif // __WARP_SPECIALIZED_PIPELINE__
+
@@ -0,0 +1,295 @@
+/*
+ *  Copyright 2013 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/* Software DMA project
+*
+* Host code.
+*/
+
+// includes, system
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <assert.h>
+#include <math.h>
+
+#ifdef __CUDACC__
+#include "cuda.h"
+#include "cuda_runtime.h"
+#endif
+
+#include "cudaDMAv2.h"
+
+#define WARP_SIZE 32
+
+#define CUDA_SAFE_CALL(x)					\
+	{							\
+		cudaError_t err = (x);				\
+		if (err != cudaSuccess)				\
+		{						\
+			printf("Cuda error: %s\n", cudaGetErrorString(err));	\
+			exit(false);				\
+		}						\
+	}
+
+template<int ALIGNMENT, int BYTES_PER_THREAD, int RADIUS>
+__global__ void __launch_bounds__(1024,1)
+special_xfer_box( float *idata, float *odata, int src_offset, int dst_offset, int dimx, int dimy, int dimz,
+                  int src_row_pitch, int src_slice_pitch, int dst_row_pitch, int dst_slice_pitch/*bytes*/,
+                  int num_compute_threads, int num_dma_threads, int buffer_size, const bool single, const bool qualified)
+{
+  CUDADMA_EXTERN_SHARED(float, buffer);
+
+  CudaDMABox<true,ALIGNMENT,BYTES_PER_THREAD,sizeof(float),RADIUS>
+    dma0 (1, num_dma_threads, num_compute_threads,
+             num_compute_threads, dimx*sizeof(float), dimy, dimz,
+             src_row_pitch, src_slice_pitch, dst_row_pitch, dst_slice_pitch);
+
+  if (dma0.owns_this_thread())
+  {
+    float *base_ptr = &(idata[src_offset]);
+    if (single)
+    {
+      if (qualified)
+        dma0.template execute_dma<true,LOAD_CACHE_GLOBAL,STORE_CACHE_GLOBAL>(base_ptr, &(buffer[dst_offset]));
+      else
+        dma0.execute_dma(base_ptr, &(buffer[dst_offset]));
+    }
+    else
+    {
+      if (qualified)
+      {
+        dma0.template start_xfer_async<true,LOAD_CACHE_GLOBAL,STORE_CACHE_STREAMING>(base_ptr);
+        dma0.template wait_xfer_finish<true,LOAD_CACHE_GLOBAL,STORE_CACHE_STREAMING>(&(buffer[dst_offset]));
+      }
+      else
+      {
+        dma0.start_xfer_async(base_ptr);
+        dma0.wait_xfer_finish(&(buffer[dst_offset]));
+      }
+    }
+  }
+  else
+  {
+    for (int index = threadIdx.x; index < buffer_size; index += num_compute_threads)
+      buffer[index] = 0.0f;
+    dma0.start_async_dma();
+    dma0.wait_for_dma_finish();
+    for (int index = threadIdx.x; index < buffer_size; index += num_compute_threads)
+      odata[index] = buffer[index];
+  }
+}
+
+template<int ALIGNMENT, int BYTES_PER_THREAD, int RADIUS>
+__global__ void __launch_bounds__(1024,1)
+nonspec_xfer_box( float *idata, float *odata, int src_offset, int dst_offset, int dimx, int dimy, int dimz,
+                  int src_row_pitch, int src_slice_pitch, int dst_row_pitch, int dst_slice_pitch/*bytes*/,
+                  int buffer_size, const bool single, const bool qualified)
+{
+  CUDADMA_EXTERN_SHARED(float, buffer);
+
+  CudaDMABox<false,ALIGNMENT,BYTES_PER_THREAD,sizeof(float),RADIUS>
+    dma0 (dimx*sizeof(float), dimy, dimz,
+          src_row_pitch, src_slice_pitch, dst_row_pitch, dst_slice_pitch);
+
+  for (int index = threadIdx.x; index < buffer_size; index += blockDim.x)
+    buffer[index] = 0.0f;
+  __syncthreads();
+  // Perform the transfer
+  float *base_ptr = &(idata[src_offset]);
+  if (single)
+  {
+    if (qualified)
+      dma0.template execute_dma<true,LOAD_CACHE_LAST_USE,STORE_CACHE_GLOBAL>(base_ptr, &(buffer[dst_offset]));
+    else
+      dma0.execute_dma(base_ptr, &(buffer[dst_offset]));
+  }
+  else
+  {
+    if (qualified)
+    {
+      dma0.template start_xfer_async<true,LOAD_CACHE_LAST_USE,STORE_CACHE_STREAMING>(base_ptr);
+      dma0.template wait_xfer_finish<true,LOAD_CACHE_LAST_USE,STORE_CACHE_STREAMING>(&(buffer[dst_offset]));
+    }
+    else
+    {
+      dma0.start_xfer_async(base_ptr);
+      dma0.wait_xfer_finish(&(buffer[dst_offset]));
+    }
+  }
+  __syncthreads();
+  for (int index = threadIdx.x; index < buffer_size; index += blockDim.x)
+    odata[index] = buffer[index];
+}
+
+// Round a number of floats up to a multiple of the alignment
+template<int ALIGNMENT>
+__host__ int align_floats(int floats)
+{
+  const int step = ALIGNMENT/sizeof(float);
+  return ((floats + step - 1)/step)*step;
+}
+
+template<bool SPECIALIZED, int ALIGNMENT, int BYTES_PER_THREAD, int RADIUS>
+__host__ bool run_experiment(int dimx, int dimy, int dimz, int dma_threads, bool single, bool qualified)
+{
+  // The box is cut out of a larger volume with padded rows and slices
+  // and is stored in shared memory with its own padding
+  const int src_row = align_floats<ALIGNMENT>(dimx + 2*RADIUS) + 2*ALIGNMENT/sizeof(float);
+  const int src_slice = (dimy + 2*RADIUS + 3)*src_row;
+  const int dst_row = align_floats<ALIGNMENT>(dimx + 2*RADIUS);
+  const int dst_slice = (dimy + 2*RADIUS)*dst_row + ALIGNMENT/sizeof(float);
+  // The box origin has to be aligned, so shift it with a leading pad
+  const int src_offset = align_floats<ALIGNMENT>(RADIUS*(src_slice + src_row + 1));
+  const int dst_offset = align_floats<ALIGNMENT>(RADIUS*(dst_slice + dst_row + 1));
+  const int input_size = src_offset + (dimz+RADIUS+1)*src_slice;
+  const int buffer_size = dst_offset + (dimz+RADIUS)*dst_slice;
+  if ((buffer_size*sizeof(float)) > 49152)
+  {
+    fprintf(stdout," - PASS!\n");
+    fflush(stdout);
+    return true;
+  }
+
+  float *h_idata = (float*)malloc(input_size*sizeof(float));
+  for (int i=0; i<input_size; i++)
+    h_idata[i] = float(i+1);
+  float *d_idata;
+  CUDA_SAFE_CALL( cudaMalloc( (void**)&d_idata, input_size*sizeof(float)));
+  CUDA_SAFE_CALL( cudaMemcpy( d_idata, h_idata, input_size*sizeof(float), cudaMemcpyHostToDevice));
+
+  float *h_odata = (float*)malloc(buffer_size*sizeof(float));
+  for (int i=0; i<buffer_size; i++)
+    h_odata[i] = 0.0f;
+  float *d_odata;
+  CUDA_SAFE_CALL( cudaMalloc( (void**)&d_odata, buffer_size*sizeof(float)));
+  CUDA_SAFE_CALL( cudaMemcpy( d_odata, h_odata, buffer_size*sizeof(float), cudaMemcpyHostToDevice));
+
+  const int num_compute_threads = WARP_SIZE;
+  const int total_threads = (SPECIALIZED ? (num_compute_threads + dma_threads) : dma_threads);
+  if (SPECIALIZED)
+  {
+    CUDADMA_LAUNCH(1,total_threads,buffer_size*sizeof(float),0,special_xfer_box<ALIGNMENT,BYTES_PER_THREAD,RADIUS>)
+      (d_idata, d_odata, src_offset, dst_offset, dimx, dimy, dimz,
+       src_row*sizeof(float), src_slice*sizeof(float), dst_row*sizeof(float), dst_slice*sizeof(float),
+       num_compute_threads, dma_threads, buffer_size, single, qualified);
+  }
+  else
+  {
+    CUDADMA_LAUNCH(1,total_threads,buffer_size*sizeof(float),0,nonspec_xfer_box<ALIGNMENT,BYTES_PER_THREAD,RADIUS>)
+      (d_idata, d_odata, src_offset, dst_offset, dimx, dimy, dimz,
+       src_row*sizeof(float), src_slice*sizeof(float), dst_row*sizeof(float), dst_slice*sizeof(float),
+       buffer_size, single, qualified);
+  }
+  CUDA_SAFE_CALL( cudaGetLastError());
+  CUDA_SAFE_CALL( cudaThreadSynchronize());
+
+  CUDA_SAFE_CALL( cudaMemcpy (h_odata, d_odata, buffer_size*sizeof(float), cudaMemcpyDeviceToHost));
+
+  // Every cell of the box and its halo has to be copied and the padding
+  // around it left untouched, (0,0,0) is the box origin
+  int copied = 0;
+  bool pass = true;
+  for (int z = -RADIUS; (z < (dimz+RADIUS)) && pass; z++)
+  {
+    for (int y = -RADIUS; (y < (dimy+RADIUS)) && pass; y++)
+    {
+      for (int x = -RADIUS; x < (dimx+RADIUS); x++)
+      {
+        const float expected = h_idata[src_offset + z*src_slice + y*src_row + x];
+        const float received = h_odata[dst_offset + z*dst_slice + y*dst_row + x];
+        if (expected != received)
+        {
+          fprintf(stderr,"Experiment: %dx%dx%d box, radius %d, %d alignment, %d bytes per thread, %d DMA warps, ",
+                  dimx, dimy, dimz, RADIUS, ALIGNMENT, BYTES_PER_THREAD, dma_threads/WARP_SIZE);
+          fprintf(stderr,"cell (%d,%d,%d) was expecting %f but received %f\n", x, y, z, expected, received);
+          pass = false;
+          break;
+        }
+        copied++;
+      }
+    }
+  }
+  for (int i = 0; (i < buffer_size) && pass; i++)
+  {
+    if (h_odata[i] != 0.0f)
+      copied--;
+  }
+  if (pass && (copied != 0))
+  {
+    fprintf(stderr,"Experiment: %dx%dx%d box, radius %d, %d alignment, %d bytes per thread, %d DMA warps, "
+                   "%d cells written outside of the box\n", dimx, dimy, dimz, RADIUS, ALIGNMENT,
+                   BYTES_PER_THREAD, dma_threads/WARP_SIZE, -copied);
+    pass = false;
+  }
+  fprintf(stdout," - %s\n",(pass?"PASS!":"FAIL!"));
+  fflush(stdout);
+
+  CUDA_SAFE_CALL( cudaFree(d_idata));
+  CUDA_SAFE_CALL( cudaFree(d_odata));
+  free(h_idata);
+  free(h_odata);
+
+  return pass;
+}
+
+// Run the single/two-phase and unqualified/qualified variants of a configuration
+template<bool SPECIALIZED, int ALIGNMENT, int BYTES_PER_THREAD, int RADIUS>
+__host__ bool run_all(int dimx, int dimy, int dimz, int dma_threads)
+{
+  for (int phases = 1; phases <= 2; phases++)
+  {
+    for (int qualified = 0; qualified < 2; qualified++)
+    {
+      fprintf(stdout,"  %s ALIGNMENT-%2d BYTES_PER_THREAD-%3d RADIUS-%d DIM-%3dx%-3dx%-3d DMA_WARPS-%2d %s-phase %s",
+              (SPECIALIZED ? "Warp-Specialized    " : "Non-Warp-Specialized"), ALIGNMENT, BYTES_PER_THREAD,
+              RADIUS, dimx, dimy, dimz, dma_threads/WARP_SIZE, (phases == 1 ? "single" : "two"),
+              (qualified ? "qualified  " : "unqualified"));
+      if (!run_experiment<SPECIALIZED,ALIGNMENT,BYTES_PER_THREAD,RADIUS>(dimx, dimy, dimz, dma_threads,
+                                                                         (phases == 1), (qualified != 0)))
+        return false;
+    }
+  }
+  return true;
+}
+
+#define RUN(SPECIALIZED,ALIGNMENT,BYTES_PER_THREAD,RADIUS,DIMX,DIMY,DIMZ,DMA_THREADS)                 \
+  if (!run_all<SPECIALIZED,ALIGNMENT,BYTES_PER_THREAD,RADIUS>(DIMX,DIMY,DIMZ,DMA_THREADS))            \
+    return false;
+
+__host__
+int main()
+{
+  fprintf(stdout,"Running all experiments for CudaDMABox\n");
+  // Plain boxes
+  RUN(true, 16, 64,0, 32,  8, 4,128)
+  RUN(false,16, 64,0, 32,  8, 4,128)
+  RUN(true,  4, 16,0, 13,  5, 3, 64)
+  // Boxes with a halo, as for 7-point and 27-point stencils
+  RUN(true, 16, 64,1, 16, 16, 2, 64)
+  RUN(false,16, 64,1, 16, 16, 2, 96)
+  RUN(true, 16, 32,2, 32,  8, 4,128)
+  RUN(true,  8, 32,4, 16,  6, 3, 64)
+  RUN(false, 4, 16,3, 12,  7, 2, 64)
+  // Many steps per thread
+  RUN(true,  4,  4,1, 24, 12, 6, 32)
+  RUN(false, 8,  8,2, 10,  4, 5, 32)
+  // More threads than chunks in the box
+  RUN(true, 16, 16,0,  4,  2, 1,256)
+  RUN(false, 4, 16,1,  1,  1, 1,128)
+  fprintf(stdout,"All experiments passed\n");
+  return true;
+}
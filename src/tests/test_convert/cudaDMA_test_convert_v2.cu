@@ -0,0 +1,307 @@
+/*
+ *  Copyright 2013 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/* Software DMA project
+*
+* Host code.
+*/
+
+// includes, system
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <assert.h>
+#include <math.h>
+
+#ifdef __CUDACC__
+#include "cuda.h"
+#include "cuda_runtime.h"
+#endif
+
+#include "cudaDMAv2.h"
+
+#define WARP_SIZE 32
+
+#define CUDA_SAFE_CALL(x)					\
+	{							\
+		cudaError_t err = (x);				\
+		if (err != cudaSuccess)				\
+		{						\
+			printf("Cuda error: %s\n", cudaGetErrorString(err));	\
+			exit(false);				\
+		}						\
+	}
+
+// Convert rows of SRC_TYPE elements in global memory into shared memory,
+// then copy the converted shared memory back out to global memory
+template<typename SRC_TYPE, typename DST_TYPE, int ALIGNMENT, int BYTES_PER_THREAD, int DMA_THREADS>
+__global__ void __launch_bounds__(1024,1)
+special_xfer_convert( char *idata, char *odata, int row_elmts, int num_rows, int src_pitch, int dst_pitch,
+                      float scale, float zero_point, int num_compute_threads, const bool single)
+{
+  CUDADMA_EXTERN_SHARED(float4, buffer);
+
+  CudaDMAConvert<true,ALIGNMENT,BYTES_PER_THREAD,SRC_TYPE,DST_TYPE>
+    dma0 (1, DMA_THREADS, num_compute_threads, num_compute_threads, row_elmts, num_rows,
+          src_pitch, dst_pitch, scale, zero_point);
+
+  if (dma0.owns_this_thread())
+  {
+    if (single)
+      dma0.execute_dma(idata, buffer);
+    else
+    {
+      dma0.start_xfer_async(idata);
+      dma0.wait_xfer_finish(buffer);
+    }
+  }
+  else
+  {
+    dma0.start_async_dma();
+    dma0.wait_for_dma_finish();
+    const char *smem = (const char*)buffer;
+    for (int i = threadIdx.x; i < (num_rows*dst_pitch); i += num_compute_threads)
+      odata[i] = smem[i];
+  }
+}
+
+template<typename SRC_TYPE, typename DST_TYPE, int ALIGNMENT, int BYTES_PER_THREAD, int DMA_THREADS>
+__global__ void __launch_bounds__(1024,1)
+nonspec_xfer_convert( char *idata, char *odata, int row_elmts, int num_rows, int src_pitch, int dst_pitch,
+                      float scale, float zero_point, const bool single)
+{
+  CUDADMA_EXTERN_SHARED(float4, buffer);
+
+  CudaDMAConvert<false,ALIGNMENT,BYTES_PER_THREAD,SRC_TYPE,DST_TYPE>
+    dma0 (row_elmts, num_rows, src_pitch, dst_pitch, scale, zero_point);
+
+  if (single)
+    dma0.execute_dma(idata, buffer);
+  else
+  {
+    dma0.start_xfer_async(idata);
+    dma0.wait_xfer_finish(buffer);
+  }
+  __syncthreads();
+  const char *smem = (const char*)buffer;
+  for (int i = threadIdx.x; i < (num_rows*dst_pitch); i += blockDim.x)
+    odata[i] = smem[i];
+}
+
+// Host encoding and decoding of the element types, the test only
+// uses values that are exact in all of the floating point types
+template<typename T>
+struct HostType;
+
+template<>
+struct HostType<float> {
+  static const char* name(void) { return "float"; }
+  static float encode(float x, float, float) { return x; }
+  static float decode(float x, float, float) { return x; }
+};
+
+template<>
+struct HostType<CudaDMAHalf> {
+  static const char* name(void) { return "half"; }
+  static CudaDMAHalf encode(float x, float, float)
+  {
+    CudaDMAHalf result;
+    result.bits = (x < 0.0f) ? 0x8000 : 0;
+    if (x != 0.0f)
+    {
+      int exponent;
+      const float mantissa = frexpf(fabsf(x), &exponent);
+      result.bits |= ((exponent + 14) << 10) | (int(mantissa * 2048.0f) - 1024);
+    }
+    return result;
+  }
+  static float decode(CudaDMAHalf x, float, float)
+  {
+    const int exponent = (x.bits >> 10) & 0x1f;
+    const float value = ldexpf(float((x.bits & 0x3ff) | 0x400), exponent - 25);
+    return ((x.bits & 0x7fff) == 0) ? 0.0f : ((x.bits & 0x8000) ? -value : value);
+  }
+};
+
+template<>
+struct HostType<CudaDMABFloat16> {
+  static const char* name(void) { return "bf16"; }
+  static CudaDMABFloat16 encode(float x, float, float)
+  {
+    unsigned bits;
+    memcpy(&bits, &x, sizeof(float));
+    CudaDMABFloat16 result;
+    result.bits = (unsigned short)(bits >> 16);
+    return result;
+  }
+  static float decode(CudaDMABFloat16 x, float, float)
+  {
+    const unsigned bits = unsigned(x.bits) << 16;
+    float result;
+    memcpy(&result, &bits, sizeof(float));
+    return result;
+  }
+};
+
+template<typename T, int LOWEST, int HIGHEST>
+struct HostQuantized {
+  static T encode(float x, float scale, float zero)
+  {
+    const int q = int(rintf(x / scale + zero));
+    return T((q < LOWEST) ? LOWEST : (q > HIGHEST) ? HIGHEST : q);
+  }
+  static float decode(T x, float scale, float zero) { return (float(x) - zero) * scale; }
+};
+
+template<>
+struct HostType<signed char> : public HostQuantized<signed char,-128,127> {
+  static const char* name(void) { return "s8"; }
+};
+
+template<>
+struct HostType<unsigned char> : public HostQuantized<unsigned char,0,255> {
+  static const char* name(void) { return "u8"; }
+};
+
+template<bool SPECIALIZED, typename SRC_TYPE, typename DST_TYPE, int ALIGNMENT, int BYTES_PER_THREAD,
+         int DMA_THREADS>
+__host__ bool run_experiment(int row_elmts, int num_rows, float scale, float zero_point, bool single)
+{
+  // Pad every row so that the rows are not contiguous
+  const int src_pitch = row_elmts*sizeof(SRC_TYPE) + 16;
+  const int dst_pitch = row_elmts*sizeof(DST_TYPE) + 16;
+  const int src_size = num_rows*src_pitch;
+  const int dst_size = num_rows*dst_pitch;
+
+  char *h_idata = (char*)malloc(src_size);
+  char *h_odata = (char*)malloc(dst_size);
+  char *h_expected = (char*)malloc(dst_size);
+  memset(h_idata, 0, src_size);
+  memset(h_expected, 0, dst_size);
+  for (int r = 0; r < num_rows; r++)
+  {
+    SRC_TYPE *src = (SRC_TYPE*)(h_idata + r*src_pitch);
+    DST_TYPE *dst = (DST_TYPE*)(h_expected + r*dst_pitch);
+    for (int c = 0; c < row_elmts; c++)
+    {
+      // Multiples of a quarter, some of which saturate 8-bit integers
+      const float value = float((rand() % 401) - 200) * 0.25f;
+      src[c] = HostType<SRC_TYPE>::encode(value, scale, zero_point);
+      dst[c] = HostType<DST_TYPE>::encode(HostType<SRC_TYPE>::decode(src[c], scale, zero_point),
+                                          scale, zero_point);
+    }
+  }
+
+  char *d_idata, *d_odata;
+  CUDA_SAFE_CALL( cudaMalloc( (void**)&d_idata, src_size));
+  CUDA_SAFE_CALL( cudaMemcpy( d_idata, h_idata, src_size, cudaMemcpyHostToDevice));
+  CUDA_SAFE_CALL( cudaMalloc( (void**)&d_odata, dst_size));
+  CUDA_SAFE_CALL( cudaMemset( d_odata, 0, dst_size));
+
+  const int num_compute_threads = WARP_SIZE;
+  const int shared_bytes = (dst_size + 15) & ~15;
+  if (SPECIALIZED)
+  {
+    CUDADMA_LAUNCH(1,num_compute_threads+DMA_THREADS,shared_bytes,0,
+        special_xfer_convert<SRC_TYPE,DST_TYPE,ALIGNMENT,BYTES_PER_THREAD,DMA_THREADS>)
+      (d_idata, d_odata, row_elmts, num_rows, src_pitch, dst_pitch, scale, zero_point,
+       num_compute_threads, single);
+  }
+  else
+  {
+    CUDADMA_LAUNCH(1,DMA_THREADS,shared_bytes,0,
+        nonspec_xfer_convert<SRC_TYPE,DST_TYPE,ALIGNMENT,BYTES_PER_THREAD,DMA_THREADS>)
+      (d_idata, d_odata, row_elmts, num_rows, src_pitch, dst_pitch, scale, zero_point, single);
+  }
+  CUDA_SAFE_CALL( cudaGetLastError());
+  CUDA_SAFE_CALL( cudaThreadSynchronize());
+
+  CUDA_SAFE_CALL( cudaMemcpy (h_odata, d_odata, dst_size, cudaMemcpyDeviceToHost));
+
+  bool pass = true;
+  for (int r = 0; (r < num_rows) && pass; r++)
+  {
+    for (int c = 0; c < row_elmts; c++)
+    {
+      const int offset = r*dst_pitch + c*sizeof(DST_TYPE);
+      if (memcmp(h_odata + offset, h_expected + offset, sizeof(DST_TYPE)) != 0)
+      {
+        fprintf(stderr,"Experiment: %s to %s, %d rows of %d elements, %d alignment, %d DMA warps, "
+                "element (%d,%d) is wrong\n", HostType<SRC_TYPE>::name(), HostType<DST_TYPE>::name(),
+                num_rows, row_elmts, ALIGNMENT, DMA_THREADS/WARP_SIZE, r, c);
+        pass = false;
+        break;
+      }
+    }
+  }
+  fprintf(stdout," - %s\n",(pass?"PASS!":"FAIL!"));
+  fflush(stdout);
+
+  CUDA_SAFE_CALL( cudaFree(d_idata));
+  CUDA_SAFE_CALL( cudaFree(d_odata));
+  free(h_idata);
+  free(h_odata);
+  free(h_expected);
+
+  return pass;
+}
+
+// Run the single and two-phase variants of a configuration
+template<bool SPECIALIZED, typename SRC_TYPE, typename DST_TYPE, int ALIGNMENT, int BYTES_PER_THREAD,
+         int DMA_THREADS>
+__host__ bool run_all(int row_elmts, int num_rows, float scale, float zero_point)
+{
+  for (int phases = 1; phases <= 2; phases++)
+  {
+    fprintf(stdout,"  %s %-5s to %-5s ALIGNMENT-%2d BYTES_PER_THREAD-%3d ROW_ELMTS-%3d ROWS-%3d "
+            "DMA_WARPS-%2d %s-phase", (SPECIALIZED ? "Warp-Specialized    " : "Non-Warp-Specialized"),
+            HostType<SRC_TYPE>::name(), HostType<DST_TYPE>::name(), ALIGNMENT, BYTES_PER_THREAD,
+            row_elmts, num_rows, DMA_THREADS/WARP_SIZE, (phases == 1 ? "single" : "two"));
+    if (!run_experiment<SPECIALIZED,SRC_TYPE,DST_TYPE,ALIGNMENT,BYTES_PER_THREAD,DMA_THREADS>(
+                        row_elmts, num_rows, scale, zero_point, (phases == 1)))
+      return false;
+  }
+  return true;
+}
+
+#define RUN(SPECIALIZED,SRC_TYPE,DST_TYPE,ALIGNMENT,BYTES_PER_THREAD,DMA_THREADS,ROW_ELMTS,ROWS,SCALE,ZERO) \
+  if (!run_all<SPECIALIZED,SRC_TYPE,DST_TYPE,ALIGNMENT,BYTES_PER_THREAD,DMA_THREADS>(                 \
+               ROW_ELMTS,ROWS,SCALE,ZERO))                                                            \
+    return false;
+
+__host__
+int main()
+{
+  srand(23);
+  fprintf(stdout,"Running all experiments for converting transfers\n");
+  // Widening into shared memory
+  RUN(true, CudaDMAHalf,    float,16, 64, 64,128, 8,1.0f,0.0f)
+  RUN(false,CudaDMAHalf,    float, 4,  8, 96, 70, 5,1.0f,0.0f)
+  RUN(true, CudaDMABFloat16,float, 8, 32, 32, 64,12,1.0f,0.0f)
+  RUN(false,CudaDMABFloat16,float,16, 16,128,256, 1,1.0f,0.0f)
+  RUN(true, signed char,    float,16, 64, 64, 96, 6,0.25f,3.0f)
+  RUN(false,signed char,    float, 4, 16, 64, 44, 9,0.5f,-2.0f)
+  RUN(true, unsigned char,  float, 8,  8, 96,200, 3,0.25f,128.0f)
+  // Narrowing on the way back
+  RUN(true, float,CudaDMAHalf,    16,128, 64,128, 4,1.0f,0.0f)
+  RUN(false,float,CudaDMABFloat16, 8, 16, 96, 60, 7,1.0f,0.0f)
+  RUN(true, float,signed char,    16, 64, 32, 64,10,0.25f,3.0f)
+  RUN(false,float,unsigned char,   4, 32,128, 36, 5,0.5f,100.0f)
+  // Between the 16-bit types
+  RUN(true, CudaDMAHalf,CudaDMABFloat16, 8, 16, 64, 80, 3,1.0f,0.0f)
+  fprintf(stdout,"All experiments passed\n");
+  return true;
+}
@@ -0,0 +1,297 @@
+/*
+ *  Copyright 2010 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/* Software DMA project
+*
+* Host code.
+*/
+
+// includes, system
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <assert.h>
+#include <math.h>
+
+#ifdef __CUDACC__
+#include "cuda.h"
+#include "cuda_runtime.h"
+#endif
+
+#include "cudaDMAv2.h"
+
+#define WARP_SIZE 32
+
+#define CUDA_SAFE_CALL(x)					\
+	{							\
+		cudaError_t err = (x);				\
+		if (err != cudaSuccess)				\
+		{						\
+			printf("Cuda error: %s\n", cudaGetErrorString(err));	\
+			exit(false);				\
+		}						\
+	}
+
+// The tile is already in the shared buffer so the compute threads fill
+// its interior with a marker that the halo transfer must not overwrite
+#define INTERIOR -1.0f
+
+template<int ALIGNMENT, int BYTES_PER_THREAD, int RADIUS, bool CORNERS>
+__global__ void __launch_bounds__(1024,1)
+special_xfer_halo( float *idata, float *odata, int src_offset, int dst_offset, int dimx, int dimy,
+                   int src_pitch/*bytes*/, int dst_pitch/*bytes*/, int num_compute_threads, int num_dma_threads,
+                   int buffer_size, const bool single, const bool qualified)
+{
+  CUDADMA_EXTERN_SHARED(float, buffer);
+
+  CudaDMAHalo<true,ALIGNMENT,BYTES_PER_THREAD,sizeof(float),RADIUS,CORNERS>
+    dma0 (1, num_dma_threads, num_compute_threads,
+             num_compute_threads, dimx*sizeof(float), dimy,
+             src_pitch, dst_pitch);
+
+  if (dma0.owns_this_thread())
+  {
+    float *base_ptr = &(idata[src_offset]);
+    if (single)
+    {
+      if (qualified)
+        dma0.template execute_dma<true,LOAD_CACHE_GLOBAL,STORE_CACHE_GLOBAL>(base_ptr, &(buffer[dst_offset]));
+      else
+        dma0.execute_dma(base_ptr, &(buffer[dst_offset]));
+    }
+    else
+    {
+      if (qualified)
+      {
+        dma0.template start_xfer_async<true,LOAD_CACHE_GLOBAL,STORE_CACHE_STREAMING>(base_ptr);
+        dma0.template wait_xfer_finish<true,LOAD_CACHE_GLOBAL,STORE_CACHE_STREAMING>(&(buffer[dst_offset]));
+      }
+      else
+      {
+        dma0.start_xfer_async(base_ptr);
+        dma0.wait_xfer_finish(&(buffer[dst_offset]));
+      }
+    }
+  }
+  else
+  {
+    const int dst_row = dst_pitch/sizeof(float);
+    for (int index = threadIdx.x; index < buffer_size; index += num_compute_threads)
+    {
+      const int row = (index - dst_offset + RADIUS*dst_row)/dst_row - RADIUS;
+      const int col = (index - dst_offset + RADIUS*dst_row)%dst_row;
+      const bool interior = (index >= dst_offset) && (row < dimy) && (col < dimx);
+      buffer[index] = (interior ? INTERIOR : 0.0f);
+    }
+    dma0.start_async_dma();
+    dma0.wait_for_dma_finish();
+    for (int index = threadIdx.x; index < buffer_size; index += num_compute_threads)
+      odata[index] = buffer[index];
+  }
+}
+
+template<int ALIGNMENT, int BYTES_PER_THREAD, int RADIUS, bool CORNERS>
+__global__ void __launch_bounds__(1024,1)
+nonspec_xfer_halo( float *idata, float *odata, int src_offset, int dst_offset, int dimx, int dimy,
+                   int src_pitch/*bytes*/, int dst_pitch/*bytes*/, int buffer_size,
+                   const bool single, const bool qualified)
+{
+  CUDADMA_EXTERN_SHARED(float, buffer);
+
+  CudaDMAHalo<false,ALIGNMENT,BYTES_PER_THREAD,sizeof(float),RADIUS,CORNERS>
+    dma0 (dimx*sizeof(float), dimy, src_pitch, dst_pitch);
+
+  const int dst_row = dst_pitch/sizeof(float);
+  for (int index = threadIdx.x; index < buffer_size; index += blockDim.x)
+  {
+    const int row = (index - dst_offset + RADIUS*dst_row)/dst_row - RADIUS;
+    const int col = (index - dst_offset + RADIUS*dst_row)%dst_row;
+    const bool interior = (index >= dst_offset) && (row < dimy) && (col < dimx);
+    buffer[index] = (interior ? INTERIOR : 0.0f);
+  }
+  __syncthreads();
+  // Perform the transfer
+  float *base_ptr = &(idata[src_offset]);
+  if (single)
+  {
+    if (qualified)
+      dma0.template execute_dma<true,LOAD_CACHE_LAST_USE,STORE_CACHE_GLOBAL>(base_ptr, &(buffer[dst_offset]));
+    else
+      dma0.execute_dma(base_ptr, &(buffer[dst_offset]));
+  }
+  else
+  {
+    if (qualified)
+    {
+      dma0.template start_xfer_async<true,LOAD_CACHE_LAST_USE,STORE_CACHE_STREAMING>(base_ptr);
+      dma0.template wait_xfer_finish<true,LOAD_CACHE_LAST_USE,STORE_CACHE_STREAMING>(&(buffer[dst_offset]));
+    }
+    else
+    {
+      dma0.start_xfer_async(base_ptr);
+      dma0.wait_xfer_finish(&(buffer[dst_offset]));
+    }
+  }
+  __syncthreads();
+  for (int index = threadIdx.x; index < buffer_size; index += blockDim.x)
+    odata[index] = buffer[index];
+}
+
+// Round a number of floats up to a multiple of the alignment
+template<int ALIGNMENT>
+__host__ int align_floats(int floats)
+{
+  const int step = ALIGNMENT/sizeof(float);
+  return ((floats + step - 1)/step)*step;
+}
+
+template<bool SPECIALIZED, int ALIGNMENT, int BYTES_PER_THREAD, int RADIUS, bool CORNERS>
+__host__ bool run_experiment(int dimx, int dimy, int dma_threads, bool single, bool qualified)
+{
+  // Rows of the tile are padded differently in global and shared memory
+  const int src_row = align_floats<ALIGNMENT>(dimx + 2*RADIUS) + ALIGNMENT/sizeof(float);
+  const int dst_row = align_floats<ALIGNMENT>(dimx + 2*RADIUS);
+  // The tile origin has to be aligned, so shift it with a leading pad
+  const int src_offset = align_floats<ALIGNMENT>(RADIUS*src_row + RADIUS);
+  const int dst_offset = align_floats<ALIGNMENT>(RADIUS*dst_row + RADIUS);
+  const int input_size = src_offset + (dimy+RADIUS)*src_row;
+  const int buffer_size = dst_offset + (dimy+RADIUS)*dst_row;
+  if ((buffer_size*sizeof(float)) > 49152)
+  {
+    fprintf(stdout," - PASS!\n");
+    fflush(stdout);
+    return true;
+  }
+
+  float *h_idata = (float*)malloc(input_size*sizeof(float));
+  for (int i=0; i<input_size; i++)
+    h_idata[i] = float(i+1);
+  float *d_idata;
+  CUDA_SAFE_CALL( cudaMalloc( (void**)&d_idata, input_size*sizeof(float)));
+  CUDA_SAFE_CALL( cudaMemcpy( d_idata, h_idata, input_size*sizeof(float), cudaMemcpyHostToDevice));
+
+  float *h_odata = (float*)malloc(buffer_size*sizeof(float));
+  for (int i=0; i<buffer_size; i++)
+    h_odata[i] = 0.0f;
+  float *d_odata;
+  CUDA_SAFE_CALL( cudaMalloc( (void**)&d_odata, buffer_size*sizeof(float)));
+  CUDA_SAFE_CALL( cudaMemcpy( d_odata, h_odata, buffer_size*sizeof(float), cudaMemcpyHostToDevice));
+
+  const int num_compute_threads = WARP_SIZE;
+  const int total_threads = (SPECIALIZED ? (num_compute_threads + dma_threads) : dma_threads);
+  if (SPECIALIZED)
+  {
+    CUDADMA_LAUNCH(1,total_threads,buffer_size*sizeof(float),0,special_xfer_halo<ALIGNMENT,BYTES_PER_THREAD,RADIUS,CORNERS>)
+      (d_idata, d_odata, src_offset, dst_offset, dimx, dimy, src_row*sizeof(float), dst_row*sizeof(float),
+       num_compute_threads, dma_threads, buffer_size, single, qualified);
+  }
+  else
+  {
+    CUDADMA_LAUNCH(1,total_threads,buffer_size*sizeof(float),0,nonspec_xfer_halo<ALIGNMENT,BYTES_PER_THREAD,RADIUS,CORNERS>)
+      (d_idata, d_odata, src_offset, dst_offset, dimx, dimy, src_row*sizeof(float), dst_row*sizeof(float),
+       buffer_size, single, qualified);
+  }
+  CUDA_SAFE_CALL( cudaGetLastError());
+  CUDA_SAFE_CALL( cudaThreadSynchronize());
+
+  CUDA_SAFE_CALL( cudaMemcpy (h_odata, d_odata, buffer_size*sizeof(float), cudaMemcpyDeviceToHost));
+
+  // Check every cell of the ring and around it, (0,0) is the tile origin
+  bool pass = true;
+  for (int row = -RADIUS; (row < (dimy+RADIUS)) && pass; row++)
+  {
+    for (int col = -RADIUS; col < (dimx+RADIUS); col++)
+    {
+      const bool in_rows = (row >= 0) && (row < dimy);
+      const bool in_cols = (col >= 0) && (col < dimx);
+      float expected;
+      if (in_rows && in_cols)
+        expected = INTERIOR;
+      else if (in_rows || in_cols || CORNERS)
+        expected = h_idata[src_offset + row*src_row + col];
+      else
+        expected = 0.0f;
+      const float received = h_odata[dst_offset + row*dst_row + col];
+      if (expected != received)
+      {
+        fprintf(stderr,"Experiment: %dx%d tile, radius %d, corners %d, %d alignment, %d bytes per thread, %d DMA warps, ",
+                dimx, dimy, RADIUS, CORNERS, ALIGNMENT, BYTES_PER_THREAD, dma_threads/WARP_SIZE);
+        fprintf(stderr,"cell (%d,%d) was expecting %f but received %f\n", row, col, expected, received);
+        pass = false;
+        break;
+      }
+    }
+  }
+  fprintf(stdout," - %s\n",(pass?"PASS!":"FAIL!"));
+  fflush(stdout);
+
+  CUDA_SAFE_CALL( cudaFree(d_idata));
+  CUDA_SAFE_CALL( cudaFree(d_odata));
+  free(h_idata);
+  free(h_odata);
+
+  return pass;
+}
+
+// Run the single/two-phase and unqualified/qualified variants of a configuration
+template<bool SPECIALIZED, int ALIGNMENT, int BYTES_PER_THREAD, int RADIUS, bool CORNERS>
+__host__ bool run_all(int dimx, int dimy, int dma_threads)
+{
+  for (int phases = 1; phases <= 2; phases++)
+  {
+    for (int qualified = 0; qualified < 2; qualified++)
+    {
+      fprintf(stdout,"  %s ALIGNMENT-%2d BYTES_PER_THREAD-%3d RADIUS-%d CORNERS-%d DIM-%3dx%-3d DMA_WARPS-%2d %s-phase %s",
+              (SPECIALIZED ? "Warp-Specialized    " : "Non-Warp-Specialized"), ALIGNMENT, BYTES_PER_THREAD,
+              RADIUS, CORNERS, dimx, dimy, dma_threads/WARP_SIZE, (phases == 1 ? "single" : "two"),
+              (qualified ? "qualified  " : "unqualified"));
+      if (!run_experiment<SPECIALIZED,ALIGNMENT,BYTES_PER_THREAD,RADIUS,CORNERS>(dimx, dimy, dma_threads,
+                                                                                (phases == 1), (qualified != 0)))
+        return false;
+    }
+  }
+  return true;
+}
+
+#define RUN(SPECIALIZED,ALIGNMENT,BYTES_PER_THREAD,RADIUS,CORNERS,DIMX,DIMY,DMA_THREADS)              \
+  if (!run_all<SPECIALIZED,ALIGNMENT,BYTES_PER_THREAD,RADIUS,CORNERS>(DIMX,DIMY,DMA_THREADS))         \
+    return false;
+
+__host__
+int main()
+{
+  fprintf(stdout,"Running all experiments for CudaDMAHalo\n");
+  // Whole ring in a single step
+  RUN(true, 16, 64,1,false, 32, 32, 64)
+  RUN(true, 16, 64,1,true,  32, 32, 64)
+  RUN(false,16, 64,1,false, 32, 32,128)
+  RUN(false,16, 64,1,true,  32, 32,128)
+  // Wider rings and side loads
+  RUN(true, 16, 32,2,false, 64, 16, 64)
+  RUN(true,  8, 32,2,true,  64, 16, 32)
+  RUN(true, 16, 64,4,true,  48, 24, 64)
+  RUN(false,16, 64,4,false, 48, 24, 96)
+  RUN(false, 4, 16,3,true,  36, 20, 64)
+  // Many steps per thread
+  RUN(true,  4,  4,1,false, 96, 64, 32)
+  RUN(true,  8,  8,2,true, 128, 40, 32)
+  RUN(false, 4,  4,1,true,  20,100, 32)
+  // More threads than chunks in the ring
+  RUN(true, 16, 16,1,false,  4,  2,256)
+  RUN(false, 8, 16,2,true,   2,  3,128)
+  fprintf(stdout,"All experiments passed\n");
+  return true;
+}
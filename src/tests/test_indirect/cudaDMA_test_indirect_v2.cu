@@ -27,8 +27,10 @@
 #include <math.h>
 #include <set>
 
+#ifdef __CUDACC__
 #include "cuda.h"
 #include "cuda_runtime.h"
+#endif
 
 #include "cudaDMAv2.h"
 
@@ -57,7 +59,7 @@ __global__ void __launch_bounds__(1024,1)
 special_xfer_four( float *idata, float *odata, int *offsets, 
                    int num_compute_threads, int buffer_size, const bool single, const bool qualified)
 {
-  extern __shared__ float buffer[];
+  CUDADMA_EXTERN_SHARED(float, buffer);
 
   CudaDMAIndirect<true,true,ALIGNMENT,BYTES_PER_THREAD,BYTES_PER_ELMT,DMA_THREADS,NUM_ELMTS>
     dma0 (1, num_compute_threads,
@@ -123,7 +125,7 @@ __global__ void __launch_bounds__(1024,1)
 special_xfer_three( float *idata, float *odata, int *offsets, 
                     int num_compute_threads, int num_elmts, int buffer_size, const bool single, const bool qualified)
 {
-  extern __shared__ float buffer[];
+  CUDADMA_EXTERN_SHARED(float, buffer);
 
   CudaDMAIndirect<true,true,ALIGNMENT,BYTES_PER_THREAD,BYTES_PER_ELMT,DMA_THREADS>
     dma0 (1, num_compute_threads,
@@ -189,7 +191,7 @@ __global__ void __launch_bounds__(1024,1)
 special_xfer_two( float *idata, float *odata, int *offsets,  
                   int num_compute_threads, int num_dma_threads, int num_elmts, int buffer_size, const bool single, const bool qualified)
 {
-  extern __shared__ float buffer[];
+  CUDADMA_EXTERN_SHARED(float, buffer);
 
   CudaDMAIndirect<true,true,ALIGNMENT,BYTES_PER_THREAD,BYTES_PER_ELMT>
     dma0 (1, num_dma_threads, num_compute_threads,
@@ -255,7 +257,7 @@ special_xfer_one( float *idata, float *odata, int *offsets,
                   int num_compute_threads, int num_dma_threads, int bytes_per_elmt, int num_elmts,  
                   int buffer_size, const bool single, const bool qualified)
 {
-  extern __shared__ float buffer[];
+  CUDADMA_EXTERN_SHARED(float, buffer);
 
   CudaDMAIndirect<true,true,ALIGNMENT,BYTES_PER_THREAD>
     dma0 (1, num_dma_threads, num_compute_threads,
@@ -321,7 +323,7 @@ __global__ void __launch_bounds__(1024,1)
 nonspec_xfer_four( float *idata, float *odata, int *offsets, 
                    int buffer_size, const bool single, const bool qualified)
 {
-  extern __shared__ float buffer[];
+  CUDADMA_EXTERN_SHARED(float, buffer);
 
   CudaDMAIndirect<true,false,ALIGNMENT,BYTES_PER_THREAD,BYTES_PER_ELMT,DMA_THREADS,NUM_ELMTS>
     dma0;
@@ -377,7 +379,7 @@ __global__ void __launch_bounds__(1024,1)
 nonspec_xfer_three( float *idata, float *odata, int *offsets, int num_elmts,
                     int buffer_size, const bool single, const bool qualified)
 {
-  extern __shared__ float buffer[];
+  CUDADMA_EXTERN_SHARED(float, buffer);
 
   CudaDMAIndirect<true,false,ALIGNMENT,BYTES_PER_THREAD,BYTES_PER_ELMT,DMA_THREADS>
     dma0(num_elmts);
@@ -432,7 +434,7 @@ __global__ void __launch_bounds__(1024,1)
 nonspec_xfer_two( float *idata, float *odata, int *offsets, int num_elmts,
                   int buffer_size, const bool single, const bool qualified)
 {
-  extern __shared__ float buffer[];
+  CUDADMA_EXTERN_SHARED(float, buffer);
 
   CudaDMAIndirect<true,false,ALIGNMENT,BYTES_PER_THREAD,BYTES_PER_ELMT>
     dma0(num_elmts);
@@ -487,7 +489,7 @@ __global__ void __launch_bounds__(1024,1)
 nonspec_xfer_one( float *idata, float *odata, int *offsets, int bytes_per_elmt, int num_elmts,
                   int buffer_size, const bool single, const bool qualified)
 {
-  extern __shared__ float buffer[];
+  CUDADMA_EXTERN_SHARED(float, buffer);
 
   CudaDMAIndirect<true,false,ALIGNMENT,BYTES_PER_THREAD>
     dma0(bytes_per_elmt, num_elmts);
@@ -590,60 +592,52 @@ __host__ bool run_experiment(bool single, bool qualified, int num_templates)
 	case 1:
                 if (SPECIALIZED)
                 {
-                  special_xfer_one<ALIGNMENT,ALIGN_OFFSET,BYTES_PER_THREAD>
-                    <<<1,total_threads,shared_buffer_size*sizeof(float),0>>>
+                  CUDADMA_LAUNCH(1,total_threads,shared_buffer_size*sizeof(float),0,special_xfer_one<ALIGNMENT,ALIGN_OFFSET,BYTES_PER_THREAD>)
                     (d_idata, d_odata, d_offsets, num_compute_warps*WARP_SIZE, DMA_THREADS,
                       BYTES_PER_ELMT, NUM_ELMTS, shared_buffer_size, single, qualified); 
                 }
                 else
                 {
-                  nonspec_xfer_one<ALIGNMENT,ALIGN_OFFSET,BYTES_PER_THREAD>
-                    <<<1,total_threads,shared_buffer_size*sizeof(float),0>>>
+                  CUDADMA_LAUNCH(1,total_threads,shared_buffer_size*sizeof(float),0,nonspec_xfer_one<ALIGNMENT,ALIGN_OFFSET,BYTES_PER_THREAD>)
                     (d_idata, d_odata, d_offsets, BYTES_PER_ELMT, NUM_ELMTS, shared_buffer_size,single,qualified);
                 }
 		break;	
 	case 2:
                 if (SPECIALIZED)
                 {
-                  special_xfer_two<ALIGNMENT,ALIGN_OFFSET,BYTES_PER_THREAD,BYTES_PER_ELMT>
-                    <<<1,total_threads,shared_buffer_size*sizeof(float),0>>>
+                  CUDADMA_LAUNCH(1,total_threads,shared_buffer_size*sizeof(float),0,special_xfer_two<ALIGNMENT,ALIGN_OFFSET,BYTES_PER_THREAD,BYTES_PER_ELMT>)
                     (d_idata, d_odata, d_offsets, num_compute_warps*WARP_SIZE, DMA_THREADS,
                      NUM_ELMTS, shared_buffer_size, single, qualified);
                 }
                 else
                 {
-                  nonspec_xfer_two<ALIGNMENT,ALIGN_OFFSET,BYTES_PER_THREAD,BYTES_PER_ELMT>
-                    <<<1,total_threads,shared_buffer_size*sizeof(float),0>>>
+                  CUDADMA_LAUNCH(1,total_threads,shared_buffer_size*sizeof(float),0,nonspec_xfer_two<ALIGNMENT,ALIGN_OFFSET,BYTES_PER_THREAD,BYTES_PER_ELMT>)
                     (d_idata, d_odata, d_offsets, NUM_ELMTS, shared_buffer_size, single, qualified);
                 }
 		break;
 	case 3:
                 if (SPECIALIZED)
                 {
-                  special_xfer_three<ALIGNMENT,ALIGN_OFFSET,BYTES_PER_THREAD,BYTES_PER_ELMT,DMA_THREADS>
-                    <<<1,total_threads,shared_buffer_size*sizeof(float),0>>>
+                  CUDADMA_LAUNCH(1,total_threads,shared_buffer_size*sizeof(float),0,special_xfer_three<ALIGNMENT,ALIGN_OFFSET,BYTES_PER_THREAD,BYTES_PER_ELMT,DMA_THREADS>)
                     (d_idata, d_odata, d_offsets, num_compute_warps*WARP_SIZE,
                      NUM_ELMTS, shared_buffer_size, single, qualified);
                 }
                 else
                 {
-                  nonspec_xfer_three<ALIGNMENT,ALIGN_OFFSET,BYTES_PER_THREAD,BYTES_PER_ELMT,DMA_THREADS>
-                    <<<1,total_threads,shared_buffer_size*sizeof(float),0>>>
+                  CUDADMA_LAUNCH(1,total_threads,shared_buffer_size*sizeof(float),0,nonspec_xfer_three<ALIGNMENT,ALIGN_OFFSET,BYTES_PER_THREAD,BYTES_PER_ELMT,DMA_THREADS>)
                     (d_idata, d_odata, d_offsets, NUM_ELMTS, shared_buffer_size, single, qualified);
                 }
 		break;
 	case 4:
                 if (SPECIALIZED)
                 {
-                  special_xfer_four<ALIGNMENT,ALIGN_OFFSET,BYTES_PER_THREAD,BYTES_PER_ELMT,DMA_THREADS,NUM_ELMTS>
-                    <<<1,total_threads,shared_buffer_size*sizeof(float),0>>>
+                  CUDADMA_LAUNCH(1,total_threads,shared_buffer_size*sizeof(float),0,special_xfer_four<ALIGNMENT,ALIGN_OFFSET,BYTES_PER_THREAD,BYTES_PER_ELMT,DMA_THREADS,NUM_ELMTS>)
                     (d_idata, d_odata, d_offsets, num_compute_warps*WARP_SIZE,
                      shared_buffer_size, single, qualified);
                 }
                 else
                 {
-                  nonspec_xfer_four<ALIGNMENT,ALIGN_OFFSET,BYTES_PER_THREAD,BYTES_PER_ELMT,DMA_THREADS,NUM_ELMTS>
-                    <<<1,total_threads,shared_buffer_size*sizeof(float),0>>>
+                  CUDADMA_LAUNCH(1,total_threads,shared_buffer_size*sizeof(float),0,nonspec_xfer_four<ALIGNMENT,ALIGN_OFFSET,BYTES_PER_THREAD,BYTES_PER_ELMT,DMA_THREADS,NUM_ELMTS>)
                     (d_idata, d_odata, d_offsets, shared_buffer_size, single, qualified);
                 }
 		break;
@@ -704,6 +698,24 @@ __host__ bool run_experiment(bool single, bool qualified, int num_templates)
 	return pass;
 }
 
+// Run the fully templated instances of a configuration in every phase and qualification
+template<bool SPECIALIZED, int ALIGNMENT, int ALIGN_OFFSET, int BYTES_PER_THREAD, int BYTES_PER_ELMT, int DMA_THREADS, int NUM_ELMTS>
+__host__ bool run_fully_templated(void)
+{
+  for (int phases = 1; phases <= 2; phases++)
+  {
+    for (int qualified = 0; qualified < 2; qualified++)
+    {
+      fprintf(stdout,"    %s %s %s Templates-4", (SPECIALIZED ? "Warp-Specialized    " : "Non-Warp-Specialized"),
+              (phases == 1 ? "Single-Phase" : "Two-Phase   "), (qualified ? "Qualified  " : "Unqualified"));
+      if (!run_experiment<SPECIALIZED,ALIGNMENT,ALIGN_OFFSET,BYTES_PER_THREAD,BYTES_PER_ELMT,DMA_THREADS,NUM_ELMTS>(
+                                                                  (phases == 1), (qualified != 0), 4))
+        return false;
+    }
+  }
+  return true;
+}
+
 __host__
 int main()
 {
@@ -879,5 +891,19 @@ int main()
 
   free(h_offsets);
 
+  // A fixed configuration whose elements take several steps of the DMA threads,
+  // so the fully templated instances pipeline the steps of every element.  The
+  // elements are gathered out of order with a gap between them.
+  assert((CudaDMAIndirectPlan<true,16,32,8000,32,3>::pipelined_steps));
+  int big_offsets[3] = { 4, 0, 2 };
+  h_offsets = big_offsets;
+  max_index = 5*8000/sizeof(float);
+  fprintf(stdout,"Running pipelined experiments for ALIGNMENT-16 OFFSET-0 BYTES_PER_THREAD- 32 ELMT_SIZE- 8000 NUM_ELMTS-    3 DMA_WARPS- 1\n");
+  result = run_fully_templated<true,16,0,32,8000,32,3>();
+  if (!result) return result;
+  result = run_fully_templated<false,16,0,32,8000,32,3>();
+  if (!result) return result;
+  fflush(stdout);
+
   return result;
 }
@@ -0,0 +1,285 @@
+/*
+ *  Copyright 2013 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/* Software DMA project
+*
+* Host code.
+*/
+
+// includes, system
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <assert.h>
+#include <math.h>
+
+#ifdef __CUDACC__
+#include "cuda.h"
+#include "cuda_runtime.h"
+#endif
+
+#include "cudaDMAv2.h"
+
+#define WARP_SIZE 32
+
+#define CUDA_SAFE_CALL(x)					\
+	{							\
+		cudaError_t err = (x);				\
+		if (err != cudaSuccess)				\
+		{						\
+			printf("Cuda error: %s\n", cudaGetErrorString(err));	\
+			exit(false);				\
+		}						\
+	}
+
+// Gathers read the indexed elements of a table in global memory and pack
+// them into shared memory, scatters read packed elements from global memory
+// and store them at the indexed positions of a table in shared memory
+template<typename INDEX_TYPE, bool GATHER, int ALIGNMENT, int BYTES_PER_THREAD, int BYTES_PER_ELMT,
+         int DMA_THREADS, int NUM_ELMTS>
+__global__ void __launch_bounds__(1024,1)
+special_xfer_index( float *idata, float *odata, INDEX_TYPE *indices, int num_compute_threads,
+                    int buffer_size, const bool single, const bool qualified)
+{
+  CUDADMA_EXTERN_SHARED(float, buffer);
+
+  CudaDMAIndirect<GATHER,true,ALIGNMENT,BYTES_PER_THREAD,BYTES_PER_ELMT,DMA_THREADS,NUM_ELMTS,INDEX_TYPE>
+    dma0 (1, num_compute_threads, num_compute_threads);
+
+  if (dma0.owns_this_thread())
+  {
+    if (single)
+    {
+      if (qualified)
+        dma0.template execute_dma<true,LOAD_CACHE_GLOBAL,STORE_CACHE_GLOBAL>(indices, idata, buffer);
+      else
+        dma0.execute_dma(indices, idata, buffer);
+    }
+    else
+    {
+      if (qualified)
+      {
+        dma0.template start_xfer_async<true,LOAD_CACHE_GLOBAL,STORE_CACHE_STREAMING>(indices, idata);
+        dma0.template wait_xfer_finish<true,LOAD_CACHE_GLOBAL,STORE_CACHE_STREAMING>(buffer);
+      }
+      else
+      {
+        dma0.start_xfer_async(indices, idata);
+        dma0.wait_xfer_finish(buffer);
+      }
+    }
+  }
+  else
+  {
+    for (int index = threadIdx.x; index < buffer_size; index += num_compute_threads)
+      buffer[index] = 0.0f;
+    dma0.start_async_dma();
+    dma0.wait_for_dma_finish();
+    for (int index = threadIdx.x; index < buffer_size; index += num_compute_threads)
+      odata[index] = buffer[index];
+  }
+}
+
+template<typename INDEX_TYPE, bool GATHER, int ALIGNMENT, int BYTES_PER_THREAD, int BYTES_PER_ELMT,
+         int DMA_THREADS, int NUM_ELMTS>
+__global__ void __launch_bounds__(1024,1)
+nonspec_xfer_index( float *idata, float *odata, INDEX_TYPE *indices, int buffer_size,
+                    const bool single, const bool qualified)
+{
+  CUDADMA_EXTERN_SHARED(float, buffer);
+
+  CudaDMAIndirect<GATHER,false,ALIGNMENT,BYTES_PER_THREAD,BYTES_PER_ELMT,0,0,INDEX_TYPE> dma0 (NUM_ELMTS);
+
+  for (int index = threadIdx.x; index < buffer_size; index += blockDim.x)
+    buffer[index] = 0.0f;
+  __syncthreads();
+  // Perform the transfer
+  if (single)
+  {
+    if (qualified)
+      dma0.template execute_dma<true,LOAD_CACHE_LAST_USE,STORE_CACHE_GLOBAL>(indices, idata, buffer);
+    else
+      dma0.execute_dma(indices, idata, buffer);
+  }
+  else
+  {
+    if (qualified)
+    {
+      dma0.template start_xfer_async<true,LOAD_CACHE_LAST_USE,STORE_CACHE_STREAMING>(indices, idata);
+      dma0.template wait_xfer_finish<true,LOAD_CACHE_LAST_USE,STORE_CACHE_STREAMING>(buffer);
+    }
+    else
+    {
+      dma0.start_xfer_async(indices, idata);
+      dma0.wait_xfer_finish(buffer);
+    }
+  }
+  __syncthreads();
+  for (int index = threadIdx.x; index < buffer_size; index += blockDim.x)
+    odata[index] = buffer[index];
+}
+
+template<bool SPECIALIZED, typename INDEX_TYPE, bool GATHER, int ALIGNMENT, int BYTES_PER_THREAD,
+         int BYTES_PER_ELMT, int DMA_THREADS, int NUM_ELMTS>
+__host__ bool run_experiment(int table_elmts, bool single, bool qualified)
+{
+  const int elmt_floats = BYTES_PER_ELMT/sizeof(float);
+  // Pick distinct table elements so scatters never overlap
+  int *table_order = (int*)malloc(table_elmts*sizeof(int));
+  for (int i = 0; i < table_elmts; i++)
+    table_order[i] = i;
+  INDEX_TYPE *h_indices = (INDEX_TYPE*)malloc(NUM_ELMTS*sizeof(INDEX_TYPE));
+  for (int i = 0; i < NUM_ELMTS; i++)
+  {
+    const int j = i + (rand() % (table_elmts - i));
+    const int tmp = table_order[i];
+    table_order[i] = table_order[j];
+    table_order[j] = tmp;
+    h_indices[i] = INDEX_TYPE(table_order[i]);
+  }
+  free(table_order);
+
+  const int packed_size = NUM_ELMTS*elmt_floats;
+  const int table_size = table_elmts*elmt_floats;
+  const int input_size = (GATHER ? table_size : packed_size);
+  const int buffer_size = (GATHER ? packed_size : table_size);
+
+  float *h_idata = (float*)malloc(input_size*sizeof(float));
+  for (int i=0; i<input_size; i++)
+    h_idata[i] = float(i+1);
+  float *d_idata;
+  CUDA_SAFE_CALL( cudaMalloc( (void**)&d_idata, input_size*sizeof(float)));
+  CUDA_SAFE_CALL( cudaMemcpy( d_idata, h_idata, input_size*sizeof(float), cudaMemcpyHostToDevice));
+  INDEX_TYPE *d_indices;
+  CUDA_SAFE_CALL( cudaMalloc( (void**)&d_indices, NUM_ELMTS*sizeof(INDEX_TYPE)));
+  CUDA_SAFE_CALL( cudaMemcpy( d_indices, h_indices, NUM_ELMTS*sizeof(INDEX_TYPE), cudaMemcpyHostToDevice));
+
+  float *h_odata = (float*)malloc(buffer_size*sizeof(float));
+  for (int i=0; i<buffer_size; i++)
+    h_odata[i] = 0.0f;
+  float *d_odata;
+  CUDA_SAFE_CALL( cudaMalloc( (void**)&d_odata, buffer_size*sizeof(float)));
+  CUDA_SAFE_CALL( cudaMemcpy( d_odata, h_odata, buffer_size*sizeof(float), cudaMemcpyHostToDevice));
+
+  const int num_compute_threads = WARP_SIZE;
+  if (SPECIALIZED)
+  {
+    CUDADMA_LAUNCH(1,num_compute_threads+DMA_THREADS,buffer_size*sizeof(float),0,
+        special_xfer_index<INDEX_TYPE,GATHER,ALIGNMENT,BYTES_PER_THREAD,BYTES_PER_ELMT,DMA_THREADS,NUM_ELMTS>)
+      (d_idata, d_odata, d_indices, num_compute_threads, buffer_size, single, qualified);
+  }
+  else
+  {
+    CUDADMA_LAUNCH(1,DMA_THREADS,buffer_size*sizeof(float),0,
+        nonspec_xfer_index<INDEX_TYPE,GATHER,ALIGNMENT,BYTES_PER_THREAD,BYTES_PER_ELMT,DMA_THREADS,NUM_ELMTS>)
+      (d_idata, d_odata, d_indices, buffer_size, single, qualified);
+  }
+  CUDA_SAFE_CALL( cudaGetLastError());
+  CUDA_SAFE_CALL( cudaThreadSynchronize());
+
+  CUDA_SAFE_CALL( cudaMemcpy (h_odata, d_odata, buffer_size*sizeof(float), cudaMemcpyDeviceToHost));
+
+  // Every element has to be moved and nothing else written
+  int copied = 0;
+  bool pass = true;
+  for (int i = 0; (i < NUM_ELMTS) && pass; i++)
+  {
+    for (int j = 0; j < elmt_floats; j++)
+    {
+      const int packed = i*elmt_floats + j;
+      const int indexed = int(h_indices[i])*elmt_floats + j;
+      const float expected = h_idata[GATHER ? indexed : packed];
+      const float received = h_odata[GATHER ? packed : indexed];
+      if (expected != received)
+      {
+        fprintf(stderr,"Experiment: %s of %d elements of %d bytes with %d byte indices, %d alignment, "
+                "%d bytes per thread, %d DMA warps, element %d float %d was expecting %f but received %f\n",
+                (GATHER ? "gather" : "scatter"), NUM_ELMTS, BYTES_PER_ELMT, int(sizeof(INDEX_TYPE)),
+                ALIGNMENT, BYTES_PER_THREAD, DMA_THREADS/WARP_SIZE, i, j, expected, received);
+        pass = false;
+        break;
+      }
+      copied++;
+    }
+  }
+  for (int i = 0; (i < buffer_size) && pass; i++)
+  {
+    if (h_odata[i] != 0.0f)
+      copied--;
+  }
+  if (pass && (copied != 0))
+  {
+    fprintf(stderr,"Experiment: %s of %d elements of %d bytes with %d byte indices, "
+            "%d floats written outside of the elements\n", (GATHER ? "gather" : "scatter"),
+            NUM_ELMTS, BYTES_PER_ELMT, int(sizeof(INDEX_TYPE)), -copied);
+    pass = false;
+  }
+  fprintf(stdout," - %s\n",(pass?"PASS!":"FAIL!"));
+  fflush(stdout);
+
+  CUDA_SAFE_CALL( cudaFree(d_idata));
+  CUDA_SAFE_CALL( cudaFree(d_odata));
+  CUDA_SAFE_CALL( cudaFree(d_indices));
+  free(h_idata);
+  free(h_odata);
+  free(h_indices);
+
+  return pass;
+}
+
+// Run the single/two-phase and unqualified/qualified variants of a configuration
+template<bool SPECIALIZED, typename INDEX_TYPE, bool GATHER, int ALIGNMENT, int BYTES_PER_THREAD,
+         int BYTES_PER_ELMT, int DMA_THREADS, int NUM_ELMTS>
+__host__ bool run_all(const char *index_name, int table_elmts)
+{
+  for (int phases = 1; phases <= 2; phases++)
+  {
+    for (int qualified = 0; qualified < 2; qualified++)
+    {
+      fprintf(stdout,"  %s %-7s INDEX-%-14s ALIGNMENT-%2d BYTES_PER_THREAD-%3d BYTES_PER_ELMT-%3d ELMTS-%3d "
+              "DMA_WARPS-%2d %s-phase %s", (SPECIALIZED ? "Warp-Specialized    " : "Non-Warp-Specialized"),
+              (GATHER ? "gather" : "scatter"), index_name, ALIGNMENT, BYTES_PER_THREAD, BYTES_PER_ELMT,
+              NUM_ELMTS, DMA_THREADS/WARP_SIZE, (phases == 1 ? "single" : "two"),
+              (qualified ? "qualified  " : "unqualified"));
+      if (!run_experiment<SPECIALIZED,INDEX_TYPE,GATHER,ALIGNMENT,BYTES_PER_THREAD,BYTES_PER_ELMT,
+                          DMA_THREADS,NUM_ELMTS>(table_elmts, (phases == 1), (qualified != 0)))
+        return false;
+    }
+  }
+  return true;
+}
+
+#define RUN(SPECIALIZED,INDEX_TYPE,GATHER,ALIGNMENT,BYTES_PER_THREAD,BYTES_PER_ELMT,DMA_THREADS,NUM_ELMTS,TABLE) \
+  if (!run_all<SPECIALIZED,INDEX_TYPE,GATHER,ALIGNMENT,BYTES_PER_THREAD,BYTES_PER_ELMT,                \
+               DMA_THREADS,NUM_ELMTS>(#INDEX_TYPE,TABLE))                                             \
+    return false;
+
+__host__
+int main()
+{
+  srand(13);
+  fprintf(stdout,"Running all experiments for CudaDMAIndirect index types\n");
+  RUN(true, unsigned short,true, 16, 64, 64,128, 64,  512)
+  RUN(false,unsigned short,false,16, 64, 32,128, 48,  300)
+  RUN(true, int,           false, 8, 32, 24, 64, 40,  100)
+  RUN(false,int,           true,  4, 16, 12, 96, 77,  200)
+  RUN(true, unsigned int,  true,  4, 16,  4, 64,100, 1000)
+  RUN(false,unsigned int,  false, 8, 32, 16, 64, 30,  250)
+  RUN(true, long long,     false,16, 64,128,128, 20,   60)
+  RUN(false,long long,     true, 16, 32, 48, 96, 33,  400)
+  fprintf(stdout,"All experiments passed\n");
+  return true;
+}
@@ -0,0 +1,302 @@
+/*
+ *  Copyright 2013 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/* Software DMA project
+*
+* Host code.
+*/
+
+// includes, system
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <assert.h>
+#include <math.h>
+
+#ifdef __CUDACC__
+#include "cuda.h"
+#include "cuda_runtime.h"
+#endif
+
+#include "cudaDMAv2.h"
+
+#define WARP_SIZE 32
+
+#define CUDA_SAFE_CALL(x)					\
+	{							\
+		cudaError_t err = (x);				\
+		if (err != cudaSuccess)				\
+		{						\
+			printf("Cuda error: %s\n", cudaGetErrorString(err));	\
+			exit(false);				\
+		}						\
+	}
+
+// Gathers read the indexed elements from idata and pack them into shared
+// memory, scatters read packed elements from idata and store them at the
+// indexed positions of shared memory
+template<bool GATHER, int ALIGNMENT, int BYTES_PER_THREAD, int BYTES_PER_ELMT>
+__global__ void __launch_bounds__(1024,1)
+special_xfer_runs( float *idata, float *odata, CudaDMAIndirectRun *runs, int num_runs, int num_elmts,
+                   int num_compute_threads, int num_dma_threads, int buffer_size,
+                   const bool single, const bool qualified)
+{
+  CUDADMA_EXTERN_SHARED(float, buffer);
+
+  CudaDMAIndirectRuns<GATHER,true,ALIGNMENT,BYTES_PER_THREAD,BYTES_PER_ELMT>
+    dma0 (1, num_dma_threads, num_compute_threads, num_compute_threads, num_elmts);
+
+  if (dma0.owns_this_thread())
+  {
+    if (single)
+    {
+      if (qualified)
+        dma0.template execute_dma<true,LOAD_CACHE_GLOBAL,STORE_CACHE_GLOBAL>(runs, num_runs, idata, buffer);
+      else
+        dma0.execute_dma(runs, num_runs, idata, buffer);
+    }
+    else
+    {
+      if (qualified)
+      {
+        dma0.template start_xfer_async<true,LOAD_CACHE_GLOBAL,STORE_CACHE_STREAMING>(runs, num_runs, idata);
+        dma0.template wait_xfer_finish<true,LOAD_CACHE_GLOBAL,STORE_CACHE_STREAMING>(buffer);
+      }
+      else
+      {
+        dma0.start_xfer_async(runs, num_runs, idata);
+        dma0.wait_xfer_finish(buffer);
+      }
+    }
+  }
+  else
+  {
+    for (int index = threadIdx.x; index < buffer_size; index += num_compute_threads)
+      buffer[index] = 0.0f;
+    dma0.start_async_dma();
+    dma0.wait_for_dma_finish();
+    for (int index = threadIdx.x; index < buffer_size; index += num_compute_threads)
+      odata[index] = buffer[index];
+  }
+}
+
+template<bool GATHER, int ALIGNMENT, int BYTES_PER_THREAD, int BYTES_PER_ELMT>
+__global__ void __launch_bounds__(1024,1)
+nonspec_xfer_runs( float *idata, float *odata, CudaDMAIndirectRun *runs, int num_runs, int num_elmts,
+                   int buffer_size, const bool single, const bool qualified)
+{
+  CUDADMA_EXTERN_SHARED(float, buffer);
+
+  CudaDMAIndirectRuns<GATHER,false,ALIGNMENT,BYTES_PER_THREAD,BYTES_PER_ELMT> dma0 (num_elmts);
+
+  for (int index = threadIdx.x; index < buffer_size; index += blockDim.x)
+    buffer[index] = 0.0f;
+  __syncthreads();
+  // Perform the transfer
+  if (single)
+  {
+    if (qualified)
+      dma0.template execute_dma<true,LOAD_CACHE_LAST_USE,STORE_CACHE_GLOBAL>(runs, num_runs, idata, buffer);
+    else
+      dma0.execute_dma(runs, num_runs, idata, buffer);
+  }
+  else
+  {
+    if (qualified)
+    {
+      dma0.template start_xfer_async<true,LOAD_CACHE_LAST_USE,STORE_CACHE_STREAMING>(runs, num_runs, idata);
+      dma0.template wait_xfer_finish<true,LOAD_CACHE_LAST_USE,STORE_CACHE_STREAMING>(buffer);
+    }
+    else
+    {
+      dma0.start_xfer_async(runs, num_runs, idata);
+      dma0.wait_xfer_finish(buffer);
+    }
+  }
+  __syncthreads();
+  for (int index = threadIdx.x; index < buffer_size; index += blockDim.x)
+    odata[index] = buffer[index];
+}
+
+// Build a sorted index list made of runs of up to max_run consecutive
+// indices separated by gaps of up to max_gap indices
+__host__ int make_indices(int *indices, int num_elmts, int max_run, int max_gap)
+{
+  int next = rand() % (max_gap+1);
+  int i = 0;
+  while (i < num_elmts)
+  {
+    const int run = 1 + (rand() % max_run);
+    for (int j = 0; (j < run) && (i < num_elmts); j++, i++)
+      indices[i] = next++;
+    next += 1 + (rand() % max_gap);
+  }
+  return next;
+}
+
+template<bool SPECIALIZED, bool GATHER, int ALIGNMENT, int BYTES_PER_THREAD, int BYTES_PER_ELMT>
+__host__ bool run_experiment(int num_elmts, int max_run, int max_gap, int dma_threads,
+                             bool single, bool qualified)
+{
+  const int elmt_floats = BYTES_PER_ELMT/sizeof(float);
+  int *h_indices = (int*)malloc(num_elmts*sizeof(int));
+  const int index_range = make_indices(h_indices, num_elmts, max_run, max_gap);
+  CudaDMAIndirectRun *h_runs = (CudaDMAIndirectRun*)malloc(num_elmts*sizeof(CudaDMAIndirectRun));
+  const int num_runs = cudaDMA_build_indirect_runs(h_indices, num_elmts, h_runs);
+
+  const int packed_size = num_elmts*elmt_floats;
+  const int indexed_size = index_range*elmt_floats;
+  const int input_size = (GATHER ? indexed_size : packed_size);
+  const int buffer_size = (GATHER ? packed_size : indexed_size);
+  if ((buffer_size*sizeof(float)) > 49152)
+  {
+    fprintf(stdout," - PASS!\n");
+    fflush(stdout);
+    free(h_indices);
+    free(h_runs);
+    return true;
+  }
+
+  float *h_idata = (float*)malloc(input_size*sizeof(float));
+  for (int i=0; i<input_size; i++)
+    h_idata[i] = float(i+1);
+  float *d_idata;
+  CUDA_SAFE_CALL( cudaMalloc( (void**)&d_idata, input_size*sizeof(float)));
+  CUDA_SAFE_CALL( cudaMemcpy( d_idata, h_idata, input_size*sizeof(float), cudaMemcpyHostToDevice));
+  CudaDMAIndirectRun *d_runs;
+  CUDA_SAFE_CALL( cudaMalloc( (void**)&d_runs, num_runs*sizeof(CudaDMAIndirectRun)));
+  CUDA_SAFE_CALL( cudaMemcpy( d_runs, h_runs, num_runs*sizeof(CudaDMAIndirectRun), cudaMemcpyHostToDevice));
+
+  float *h_odata = (float*)malloc(buffer_size*sizeof(float));
+  for (int i=0; i<buffer_size; i++)
+    h_odata[i] = 0.0f;
+  float *d_odata;
+  CUDA_SAFE_CALL( cudaMalloc( (void**)&d_odata, buffer_size*sizeof(float)));
+  CUDA_SAFE_CALL( cudaMemcpy( d_odata, h_odata, buffer_size*sizeof(float), cudaMemcpyHostToDevice));
+
+  const int num_compute_threads = WARP_SIZE;
+  const int total_threads = (SPECIALIZED ? (num_compute_threads + dma_threads) : dma_threads);
+  if (SPECIALIZED)
+  {
+    CUDADMA_LAUNCH(1,total_threads,buffer_size*sizeof(float),0,special_xfer_runs<GATHER,ALIGNMENT,BYTES_PER_THREAD,BYTES_PER_ELMT>)
+      (d_idata, d_odata, d_runs, num_runs, num_elmts, num_compute_threads, dma_threads, buffer_size, single, qualified);
+  }
+  else
+  {
+    CUDADMA_LAUNCH(1,total_threads,buffer_size*sizeof(float),0,nonspec_xfer_runs<GATHER,ALIGNMENT,BYTES_PER_THREAD,BYTES_PER_ELMT>)
+      (d_idata, d_odata, d_runs, num_runs, num_elmts, buffer_size, single, qualified);
+  }
+  CUDA_SAFE_CALL( cudaGetLastError());
+  CUDA_SAFE_CALL( cudaThreadSynchronize());
+
+  CUDA_SAFE_CALL( cudaMemcpy (h_odata, d_odata, buffer_size*sizeof(float), cudaMemcpyDeviceToHost));
+
+  // Every element has to be moved and nothing else written
+  int copied = 0;
+  bool pass = true;
+  for (int i = 0; (i < num_elmts) && pass; i++)
+  {
+    for (int j = 0; j < elmt_floats; j++)
+    {
+      const int packed = i*elmt_floats + j;
+      const int indexed = h_indices[i]*elmt_floats + j;
+      const float expected = h_idata[GATHER ? indexed : packed];
+      const float received = h_odata[GATHER ? packed : indexed];
+      if (expected != received)
+      {
+        fprintf(stderr,"Experiment: %s of %d elements of %d bytes in %d runs, %d alignment, %d bytes per thread, "
+                "%d DMA warps, element %d float %d was expecting %f but received %f\n",
+                (GATHER ? "gather" : "scatter"), num_elmts, BYTES_PER_ELMT, num_runs, ALIGNMENT,
+                BYTES_PER_THREAD, dma_threads/WARP_SIZE, i, j, expected, received);
+        pass = false;
+        break;
+      }
+      copied++;
+    }
+  }
+  for (int i = 0; (i < buffer_size) && pass; i++)
+  {
+    if (h_odata[i] != 0.0f)
+      copied--;
+  }
+  if (pass && (copied != 0))
+  {
+    fprintf(stderr,"Experiment: %s of %d elements of %d bytes, %d floats written outside of the elements\n",
+            (GATHER ? "gather" : "scatter"), num_elmts, BYTES_PER_ELMT, -copied);
+    pass = false;
+  }
+  fprintf(stdout," - %s\n",(pass?"PASS!":"FAIL!"));
+  fflush(stdout);
+
+  CUDA_SAFE_CALL( cudaFree(d_idata));
+  CUDA_SAFE_CALL( cudaFree(d_odata));
+  CUDA_SAFE_CALL( cudaFree(d_runs));
+  free(h_idata);
+  free(h_odata);
+  free(h_indices);
+  free(h_runs);
+
+  return pass;
+}
+
+// Run the single/two-phase and unqualified/qualified variants of a configuration
+template<bool SPECIALIZED, bool GATHER, int ALIGNMENT, int BYTES_PER_THREAD, int BYTES_PER_ELMT>
+__host__ bool run_all(int num_elmts, int max_run, int max_gap, int dma_threads)
+{
+  for (int phases = 1; phases <= 2; phases++)
+  {
+    for (int qualified = 0; qualified < 2; qualified++)
+    {
+      fprintf(stdout,"  %s %-7s ALIGNMENT-%2d BYTES_PER_THREAD-%3d BYTES_PER_ELMT-%3d ELMTS-%4d MAX_RUN-%3d "
+              "DMA_WARPS-%2d %s-phase %s", (SPECIALIZED ? "Warp-Specialized    " : "Non-Warp-Specialized"),
+              (GATHER ? "gather" : "scatter"), ALIGNMENT, BYTES_PER_THREAD, BYTES_PER_ELMT, num_elmts,
+              max_run, dma_threads/WARP_SIZE, (phases == 1 ? "single" : "two"),
+              (qualified ? "qualified  " : "unqualified"));
+      if (!run_experiment<SPECIALIZED,GATHER,ALIGNMENT,BYTES_PER_THREAD,BYTES_PER_ELMT>(num_elmts,
+                          max_run, max_gap, dma_threads, (phases == 1), (qualified != 0)))
+        return false;
+    }
+  }
+  return true;
+}
+
+#define RUN(SPECIALIZED,GATHER,ALIGNMENT,BYTES_PER_THREAD,BYTES_PER_ELMT,ELMTS,MAX_RUN,MAX_GAP,DMA_THREADS) \
+  if (!run_all<SPECIALIZED,GATHER,ALIGNMENT,BYTES_PER_THREAD,BYTES_PER_ELMT>(ELMTS,MAX_RUN,MAX_GAP,DMA_THREADS)) \
+    return false;
+
+__host__
+int main()
+{
+  srand(11);
+  fprintf(stdout,"Running all experiments for CudaDMAIndirectRuns\n");
+  // Long runs, e.g. sorted embedding IDs
+  RUN(true, true, 16, 64, 16,1024,64, 8,128)
+  RUN(false,true, 16, 64, 16,1024,64, 8,128)
+  RUN(true, false,16, 64, 16, 512,64, 8,128)
+  RUN(false,false,16, 64, 16, 512,64, 8, 96)
+  // Large elements spanning several chunks
+  RUN(true, true, 16, 32, 48, 200,16, 4, 64)
+  RUN(false,false, 8, 32, 40, 100,16, 4, 64)
+  // Small elements and short runs
+  RUN(true, true,  4, 16,  4,1000, 4, 3, 64)
+  RUN(false,true,  4,  4,  4, 777, 2, 5, 32)
+  RUN(true, false, 4,  8,  8, 600, 3, 2, 96)
+  // Single element runs and more threads than chunks
+  RUN(true, true,  8, 16,  8,  64, 1, 1,256)
+  RUN(false,false,16, 16, 16,  20, 5, 9,128)
+  fprintf(stdout,"All experiments passed\n");
+  return true;
+}
@@ -0,0 +1,118 @@
+/*
+ *  Copyright 2013 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/* Software DMA project
+*
+* Checks the rankings of the analytical model in cudaDMAModel.h.
+*/
+
+// includes, system
+#include <stdlib.h>
+#include <stdio.h>
+
+#include "cudaDMAModel.h"
+
+// The best candidate has to use the widest alignment that the search
+// space allows, whether the transfer is bound by latency or bandwidth
+static bool check_best_alignment(CudaDMAModel::Pattern pattern, const char *name,
+                                 int bytes_per_elmt, int num_elmts, int max_alignment, int ctas)
+{
+  CudaDMAModel::SearchSpace space;
+  space.max_alignment = max_alignment;
+  CudaDMAModel::Machine machine;
+  std::vector<CudaDMAModel::Candidate> candidates =
+    CudaDMAModel::search(pattern, bytes_per_elmt, num_elmts, space, machine, ctas);
+  if (candidates.empty())
+  {
+    fprintf(stdout,"Experiment: %s ELMT_SIZE-%d NUM_ELMTS-%d MAX_ALIGNMENT-%d CTAS-%d Result: NO CANDIDATES\n",
+            name, bytes_per_elmt, num_elmts, max_alignment, ctas);
+    return false;
+  }
+  const CudaDMAModel::Candidate &best = candidates[0];
+  // Nothing ranked below the best may waste less bandwidth
+  bool result = (best.diag.alignment == max_alignment);
+  for (unsigned idx = 1; idx < candidates.size(); idx++)
+    if (candidates[idx].estimate.efficiency() > (best.estimate.efficiency() + 1e-3))
+      result = false;
+  fprintf(stdout,"Experiment: %s ELMT_SIZE-%d NUM_ELMTS-%d MAX_ALIGNMENT-%d CTAS-%d Best: ALIGNMENT-%d"
+                 " BYTES_PER_THREAD-%d DMA_THREADS-%d Result: %s\n",
+          name, bytes_per_elmt, num_elmts, max_alignment, ctas, best.diag.alignment,
+          best.diag.bytes_per_thread, best.diag.dma_threads, (result ? "SUCCESS" : "FAILURE"));
+  return result;
+}
+
+// Loads beyond what the SM can keep in flight cost another latency, so
+// among otherwise equal configurations fewer, wider loads have to win
+static bool check_loads_in_flight(void)
+{
+  CudaDMAModel::Machine machine;
+  machine.max_loads_in_flight = 256;
+  const CudaDMADiagnosis narrow = CudaDMASequential<>::analyze(4, 16, 4096, 256, true);
+  const CudaDMADiagnosis wide = CudaDMASequential<>::analyze(16, 16, 4096, 256, true);
+  const CudaDMAModel::Estimate narrow_estimate = CudaDMAModel::estimate(narrow, machine);
+  const CudaDMAModel::Estimate wide_estimate = CudaDMAModel::estimate(wide, machine);
+  const bool result = (narrow_estimate.outstanding_loads == 4*wide_estimate.outstanding_loads) &&
+                      (narrow_estimate.cycles > (wide_estimate.cycles + 2*machine.latency));
+  fprintf(stdout,"Experiment: loads in flight NARROW-%.0f cycles WIDE-%.0f cycles Result: %s\n",
+          narrow_estimate.cycles, wide_estimate.cycles, (result ? "SUCCESS" : "FAILURE"));
+  return result;
+}
+
+// A pipelined transfer keeps the loads of the next step in flight while the
+// current one streams, so once its steps are bound by bandwidth it has to
+// hide nearly all of their latency
+static bool check_pipelined_steps(void)
+{
+  CudaDMAModel::Machine machine;
+  const int ctas = 16;
+  const CudaDMADiagnosis pipelined = CudaDMAStrided<>::analyze(16, 32, 8000, 32, 3, true);
+  CudaDMADiagnosis serial = pipelined;
+  serial.pipelined_steps = false;
+  const CudaDMAModel::Estimate pipelined_estimate = CudaDMAModel::estimate(pipelined, machine, ctas);
+  const CudaDMAModel::Estimate serial_estimate = CudaDMAModel::estimate(serial, machine, ctas);
+  const bool result = pipelined.pipelined_steps && (pipelined.total_steps > 2) &&
+                      (pipelined_estimate.cycles < (serial_estimate.cycles -
+                                                    (pipelined.total_steps-2)*machine.latency));
+  fprintf(stdout,"Experiment: pipelined steps PIPELINED-%.0f cycles SERIAL-%.0f cycles Result: %s\n",
+          pipelined_estimate.cycles, serial_estimate.cycles, (result ? "SUCCESS" : "FAILURE"));
+  return result;
+}
+
+#define RUN(PATTERN,NAME,ELMT_SIZE,NUM_ELMTS,MAX_ALIGNMENT,CTAS)                         \
+  if (!check_best_alignment(CudaDMAModel::PATTERN,NAME,ELMT_SIZE,NUM_ELMTS,MAX_ALIGNMENT,CTAS)) \
+    return false;
+
+int main()
+{
+  fprintf(stdout,"Running all experiments for the cost model\n");
+  // Latency bound transfers
+  RUN(SEQUENTIAL_PATTERN,"sequential",4096,1,16,1)
+  RUN(SEQUENTIAL_PATTERN,"sequential",1024,1,16,1)
+  RUN(SEQUENTIAL_PATTERN,"sequential",4096,1, 8,1)
+  RUN(STRIDED_PATTERN,   "strided",    512,16,16,1)
+  RUN(STRIDED_PATTERN,   "strided",     96, 8,16,1)
+  RUN(INDIRECT_PATTERN,  "indirect",   256,32,16,1)
+  // Bandwidth bound transfers
+  RUN(SEQUENTIAL_PATTERN,"sequential",65536,1,16,8)
+  RUN(STRIDED_PATTERN,   "strided",   2048,32,16,4)
+  RUN(INDIRECT_PATTERN,  "indirect",  1024,32, 8,4)
+  if (!check_loads_in_flight())
+    return false;
+  if (!check_pipelined_steps())
+    return false;
+  fprintf(stdout,"All experiments passed\n");
+  return true;
+}
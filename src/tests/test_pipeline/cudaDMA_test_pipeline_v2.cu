@@ -0,0 +1,228 @@
+/*
+ *  Copyright 2013 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/* Software DMA project
+*
+* Host code.
+*/
+
+// includes, system
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <assert.h>
+#include <math.h>
+
+#ifdef __CUDACC__
+#include "cuda.h"
+#include "cuda_runtime.h"
+#endif
+
+#include "cudaDMAv2.h"
+
+#define WARP_SIZE 32
+
+#define CUDA_SAFE_CALL(x)					\
+	{							\
+		cudaError_t err = (x);				\
+		if (err != cudaSuccess)				\
+		{						\
+			printf("Cuda error: %s\n", cudaGetErrorString(err));	\
+			exit(false);				\
+		}						\
+	}
+
+// Compute threads copy every tile that arrives in shared memory out to
+// its slot of the output, in the order of the iterations
+struct CopyTile {
+  float *odata;
+  int tile_floats;
+  int num_compute_threads;
+  int iterations_seen;
+  __device__ void operator()(void *buffer, int iteration)
+  {
+    const float *tile = (const float*)buffer;
+    for (int i = threadIdx.x; i < tile_floats; i += num_compute_threads)
+      odata[iteration*tile_floats + i] = tile[i];
+    // Iterations have to be handed out in order
+    if (iteration != iterations_seen)
+      odata[iteration*tile_floats] = -1.0f;
+    iterations_seen++;
+  }
+};
+
+template<int STAGES, int ALIGNMENT, int BYTES_PER_THREAD, int BYTES_PER_ELMT, int DMA_THREADS>
+__global__ void __launch_bounds__(1024,1)
+pipeline_sequential( float *idata, float *odata, int iterations, int src_stride, int num_compute_threads)
+{
+  CUDADMA_EXTERN_SHARED(float4, buffer);
+
+  typedef CudaDMASequential<true,ALIGNMENT,BYTES_PER_THREAD,BYTES_PER_ELMT,DMA_THREADS> DMA;
+  typedef CudaDMAPipeline<STAGES,DMA,BYTES_PER_ELMT> Pipeline;
+  typedef CudaDMABarriers<>::Allocate<Pipeline::num_dma_ids> Stages;
+  Pipeline pipeline(buffer, Stages::dmaID, num_compute_threads, num_compute_threads);
+
+  if (pipeline.owns_this_thread())
+    pipeline.execute_dma(idata, src_stride, iterations);
+  else
+  {
+    CopyTile copy = { odata, int(BYTES_PER_ELMT/sizeof(float)), num_compute_threads, 0 };
+    pipeline.execute_compute(copy, iterations);
+  }
+}
+
+template<int STAGES, int ALIGNMENT, int BYTES_PER_THREAD, int BYTES_PER_ELMT, int DMA_THREADS, int NUM_ELMTS>
+__global__ void __launch_bounds__(1024,1)
+pipeline_strided( float *idata, float *odata, int iterations, int src_stride, int elmt_stride,
+                  int num_compute_threads)
+{
+  CUDADMA_EXTERN_SHARED(float4, buffer);
+
+  typedef CudaDMAStrided<true,ALIGNMENT,BYTES_PER_THREAD,BYTES_PER_ELMT,DMA_THREADS,NUM_ELMTS> DMA;
+  typedef CudaDMAPipeline<STAGES,DMA,NUM_ELMTS*BYTES_PER_ELMT> Pipeline;
+  // Leave barrier 2 to the compute threads
+  typedef CudaDMABarriers<>::Reserve<1> ComputeBarrier;
+  typedef ComputeBarrier::Next::Allocate<Pipeline::num_dma_ids> Stages;
+  Pipeline pipeline(buffer, Stages::dmaID, num_compute_threads, num_compute_threads, elmt_stride,
+                    BYTES_PER_ELMT);
+
+  if (pipeline.owns_this_thread())
+    pipeline.template execute_dma<true,LOAD_CACHE_GLOBAL,STORE_WRITE_BACK>(idata, src_stride, iterations);
+  else
+  {
+    CopyTile copy = { odata, int(NUM_ELMTS*BYTES_PER_ELMT/sizeof(float)), num_compute_threads, 0 };
+    pipeline.execute_compute(copy, iterations);
+    // Named barrier over only the compute threads
+    ptx_cudaDMA_barrier_blocking(ComputeBarrier::barrier, num_compute_threads);
+  }
+}
+
+// A sequential transfer is a strided transfer of a single element
+template<bool STRIDED, int STAGES, int ALIGNMENT, int BYTES_PER_THREAD, int BYTES_PER_ELMT, int DMA_THREADS,
+         int NUM_ELMTS>
+__host__ bool run_experiment(int iterations)
+{
+  // Pad the elements and the iterations so the tiles are not contiguous
+  const int elmt_stride = STRIDED ? (BYTES_PER_ELMT + ALIGNMENT) : BYTES_PER_ELMT;
+  const int src_stride = NUM_ELMTS*elmt_stride + 2*ALIGNMENT;
+  const int elmt_floats = BYTES_PER_ELMT/sizeof(float);
+  const int tile_floats = NUM_ELMTS*elmt_floats;
+  const int input_size = iterations*src_stride/sizeof(float);
+  const int output_size = iterations*tile_floats;
+
+  float *h_idata = (float*)malloc(input_size*sizeof(float));
+  for (int i = 0; i < input_size; i++)
+    h_idata[i] = float(i);
+  float *h_odata = (float*)malloc(output_size*sizeof(float));
+
+  float *d_idata, *d_odata;
+  CUDA_SAFE_CALL( cudaMalloc( (void**)&d_idata, input_size*sizeof(float)));
+  CUDA_SAFE_CALL( cudaMemcpy( d_idata, h_idata, input_size*sizeof(float), cudaMemcpyHostToDevice));
+  CUDA_SAFE_CALL( cudaMalloc( (void**)&d_odata, output_size*sizeof(float)));
+  CUDA_SAFE_CALL( cudaMemset( d_odata, 0, output_size*sizeof(float)));
+
+  const int num_compute_threads = 2*WARP_SIZE;
+  if (STRIDED)
+  {
+    typedef CudaDMAPipeline<STAGES,CudaDMAStrided<true,ALIGNMENT,BYTES_PER_THREAD,BYTES_PER_ELMT,
+                            DMA_THREADS,NUM_ELMTS>,NUM_ELMTS*BYTES_PER_ELMT> Pipeline;
+    CUDADMA_LAUNCH(1,num_compute_threads+DMA_THREADS,Pipeline::shared_bytes,0,
+        pipeline_strided<STAGES,ALIGNMENT,BYTES_PER_THREAD,BYTES_PER_ELMT,DMA_THREADS,NUM_ELMTS>)
+      (d_idata, d_odata, iterations, src_stride, elmt_stride, num_compute_threads);
+  }
+  else
+  {
+    typedef CudaDMAPipeline<STAGES,CudaDMASequential<true,ALIGNMENT,BYTES_PER_THREAD,BYTES_PER_ELMT,
+                            DMA_THREADS>,BYTES_PER_ELMT> Pipeline;
+    CUDADMA_LAUNCH(1,num_compute_threads+DMA_THREADS,Pipeline::shared_bytes,0,
+        pipeline_sequential<STAGES,ALIGNMENT,BYTES_PER_THREAD,BYTES_PER_ELMT,DMA_THREADS>)
+      (d_idata, d_odata, iterations, src_stride, num_compute_threads);
+  }
+  CUDA_SAFE_CALL( cudaGetLastError());
+  CUDA_SAFE_CALL( cudaThreadSynchronize());
+
+  CUDA_SAFE_CALL( cudaMemcpy (h_odata, d_odata, output_size*sizeof(float), cudaMemcpyDeviceToHost));
+
+  bool pass = true;
+  for (int it = 0; (it < iterations) && pass; it++)
+  {
+    for (int e = 0; (e < NUM_ELMTS) && pass; e++)
+    {
+      for (int i = 0; i < elmt_floats; i++)
+      {
+        const float expected = h_idata[(it*src_stride + e*elmt_stride)/sizeof(float) + i];
+        const float actual = h_odata[it*tile_floats + e*elmt_floats + i];
+        if (actual != expected)
+        {
+          fprintf(stderr,"Experiment: %d stages, %d iterations, %d alignment, %d DMA warps, "
+                  "iteration %d element %d float %d is %f not %f\n", STAGES, iterations, ALIGNMENT,
+                  DMA_THREADS/WARP_SIZE, it, e, i, actual, expected);
+          pass = false;
+          break;
+        }
+      }
+    }
+  }
+  fprintf(stdout," - %s\n",(pass?"PASS!":"FAIL!"));
+  fflush(stdout);
+
+  CUDA_SAFE_CALL( cudaFree(d_idata));
+  CUDA_SAFE_CALL( cudaFree(d_odata));
+  free(h_idata);
+  free(h_odata);
+
+  return pass;
+}
+
+// Run a configuration with fewer iterations than stages, a multiple
+// of the stages and a number of iterations that is not a multiple
+template<bool STRIDED, int STAGES, int ALIGNMENT, int BYTES_PER_THREAD, int BYTES_PER_ELMT, int DMA_THREADS,
+         int NUM_ELMTS>
+__host__ bool run_all(void)
+{
+  const int iterations[] = { 1, STAGES-1, 4*STAGES, 5*STAGES+1 };
+  for (int i = 0; i < 4; i++)
+  {
+    if (iterations[i] < 1)
+      continue;
+    fprintf(stdout,"  %s STAGES-%d ALIGNMENT-%2d BYTES_PER_THREAD-%3d BYTES_PER_ELMT-%4d ELMTS-%3d "
+            "DMA_WARPS-%2d ITERATIONS-%3d", (STRIDED ? "Strided   " : "Sequential"), STAGES, ALIGNMENT,
+            BYTES_PER_THREAD, BYTES_PER_ELMT, NUM_ELMTS, DMA_THREADS/WARP_SIZE, iterations[i]);
+    if (!run_experiment<STRIDED,STAGES,ALIGNMENT,BYTES_PER_THREAD,BYTES_PER_ELMT,DMA_THREADS,NUM_ELMTS>(
+                        iterations[i]))
+      return false;
+  }
+  return true;
+}
+
+#define RUN(STRIDED,STAGES,ALIGNMENT,BYTES_PER_THREAD,BYTES_PER_ELMT,DMA_THREADS,NUM_ELMTS)         \
+  if (!run_all<STRIDED,STAGES,ALIGNMENT,BYTES_PER_THREAD,BYTES_PER_ELMT,DMA_THREADS,NUM_ELMTS>())   \
+    return false;
+
+__host__
+int main()
+{
+  fprintf(stdout,"Running all experiments for pipelines\n");
+  RUN(false,1,16, 64,2048, 64, 1)
+  RUN(false,2,16, 32,4096, 64, 1)
+  RUN(false,3, 8, 16, 768, 96, 1)
+  RUN(false,4, 4, 16, 516, 32, 1)
+  RUN(true, 2,16, 64, 128, 64,16)
+  RUN(true, 3, 8, 32,  96, 64,20)
+  RUN(true, 4,16, 32, 256,128, 8)
+  fprintf(stdout,"All experiments passed\n");
+  return true;
+}
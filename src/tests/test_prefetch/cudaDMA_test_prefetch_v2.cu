@@ -0,0 +1,754 @@
+/*
+ *  Copyright 2013 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/* Software DMA project
+*
+* Host code.
+*/
+
+// includes, system
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <assert.h>
+#include <math.h>
+
+#ifdef __CUDACC__
+#include "cuda.h"
+#include "cuda_runtime.h"
+#endif
+
+#include "cudaDMAv2.h"
+
+#ifdef CUDADMA_HOST_BACKEND
+#include <set>
+#include <mutex>
+#include <utility>
+#endif
+
+#define WARP_SIZE 32
+
+#define CUDA_SAFE_CALL(x)					\
+	{							\
+		cudaError_t err = (x);				\
+		if (err != cudaSuccess)				\
+		{						\
+			printf("Cuda error: %s\n", cudaGetErrorString(err));	\
+			exit(false);				\
+		}						\
+	}
+
+// Written to the whole buffer before every transfer so that
+// anything a prefetch stored to shared memory shows up
+#define SENTINEL (-12345.0f)
+
+enum {
+  PLAIN,           // start and wait only
+  PREFETCH_AROUND, // prefetch another source before the start and while the loads are in flight
+  PREFETCH_ONLY,   // prefetch without starting a transfer
+};
+
+#ifdef CUDADMA_HOST_BACKEND
+// The host backend traces every access of a launch, so the prefetches can
+// be checked against the loads (for scatters the stores) of the transfer
+typedef std::set<std::pair<const char*,size_t> > AccessSet;
+
+struct TracedAccesses {
+  AccessSet loads;
+  AccessSet stores;
+  AccessSet prefetches;
+  std::mutex lock;
+};
+
+static TracedAccesses traced;
+
+static void record_access(CudaDMAHost::TraceKind kind, const void *ptr, size_t bytes)
+{
+  std::lock_guard<std::mutex> guard(traced.lock);
+  AccessSet &accesses = (kind == CudaDMAHost::TRACE_LOAD) ? traced.loads :
+                        (kind == CudaDMAHost::TRACE_STORE) ? traced.stores : traced.prefetches;
+  accesses.insert(std::make_pair(static_cast<const char*>(ptr), bytes));
+}
+
+static void start_tracing(void)
+{
+  traced.loads.clear();
+  traced.stores.clear();
+  traced.prefetches.clear();
+  CudaDMAHost::trace_hook() = &record_access;
+}
+
+static void stop_tracing(void)
+{
+  CudaDMAHost::trace_hook() = NULL;
+}
+
+// The prefetches have to cover exactly the accesses of the transfer,
+// moved by shift bytes when they are for another source or destination
+static bool check_prefetches(const char *name, const char *mode, const AccessSet &expected,
+                             long shift)
+{
+  AccessSet moved;
+  for (AccessSet::const_iterator it = expected.begin(); it != expected.end(); it++)
+    moved.insert(std::make_pair(it->first + shift, it->second));
+  if (!expected.empty() && (traced.prefetches == moved))
+    return true;
+  fprintf(stderr,"Experiment: %s %s, %d prefetches do not match the %d accesses of the transfer\n",
+          name, mode, int(traced.prefetches.size()), int(expected.size()));
+  return false;
+}
+#endif
+
+// Each case describes a transfer: the floats of the source it reads
+// and of the buffer it writes, where the origins of both sit, and how
+// to construct, start and prefetch it.  Sources that are gathered take
+// their indexes (or runs) from aux.
+struct SequentialCase {
+  typedef CudaDMASequential<true,16,32,5200,64> DMA;
+  static const int src_floats = 1300, src_offset = 0, buffer_floats = 1300, dst_offset = 0;
+  static const int aux_ints = 0;
+  static const char *name(void) { return "Sequential   "; }
+  __host__ static void fill_aux(int *) { }
+  __device__ static DMA make(int num_compute_threads)
+  {
+    return DMA(1, num_compute_threads, num_compute_threads);
+  }
+  __device__ static void start(DMA &dma, const float *src, const int *)
+  {
+    dma.start_xfer_async(src);
+  }
+  template<bool QUALIFIED>
+  __device__ static void prefetch(const DMA &dma, const float *src, const int *)
+  {
+    if (QUALIFIED)
+      dma.template prefetch<true>(src);
+    else
+      dma.prefetch(src);
+  }
+};
+
+struct StridedCase {
+  typedef CudaDMAStrided<true,8,32,264,64,12> DMA;
+  static const int src_floats = 12*68, src_offset = 0, buffer_floats = 12*66, dst_offset = 0;
+  static const int aux_ints = 0;
+  static const char *name(void) { return "Strided      "; }
+  __host__ static void fill_aux(int *) { }
+  __device__ static DMA make(int num_compute_threads)
+  {
+    return DMA(1, num_compute_threads, num_compute_threads, 68*sizeof(float), 66*sizeof(float));
+  }
+  __device__ static void start(DMA &dma, const float *src, const int *)
+  {
+    dma.start_xfer_async(src);
+  }
+  template<bool QUALIFIED>
+  __device__ static void prefetch(const DMA &dma, const float *src, const int *)
+  {
+    if (QUALIFIED)
+      dma.template prefetch<true>(src);
+    else
+      dma.prefetch(src);
+  }
+};
+
+// 16 elements of 32 floats gathered from a pool of 24
+struct IndirectCase {
+  typedef CudaDMAIndirect<true,true,16,64,128,64,16> DMA;
+  static const int src_floats = 24*32, src_offset = 0, buffer_floats = 16*32, dst_offset = 0;
+  static const int aux_ints = 16;
+  static const char *name(void) { return "Indirect     "; }
+  __host__ static void fill_aux(int *aux)
+  {
+    for (int i = 0; i < aux_ints; i++)
+      aux[i] = (5*i + 2) % 24;
+  }
+  __device__ static DMA make(int num_compute_threads)
+  {
+    return DMA(1, num_compute_threads, num_compute_threads);
+  }
+  __device__ static void start(DMA &dma, const float *src, const int *aux)
+  {
+    dma.start_xfer_async(aux, src);
+  }
+  template<bool QUALIFIED>
+  __device__ static void prefetch(const DMA &dma, const float *src, const int *aux)
+  {
+    if (QUALIFIED)
+      dma.template prefetch<true>(aux, src);
+    else
+      dma.prefetch(aux, src);
+  }
+};
+
+// A 20x12 tile with a radius 1 halo and its corners
+struct HaloCase {
+  typedef CudaDMAHalo<true,4,16,4,1,true> DMA;
+  static const int src_floats = 24 + 13*23, src_offset = 24, buffer_floats = 23 + 13*22, dst_offset = 23;
+  static const int aux_ints = 0;
+  static const char *name(void) { return "Halo         "; }
+  __host__ static void fill_aux(int *) { }
+  __device__ static DMA make(int num_compute_threads)
+  {
+    return DMA(1, 64, num_compute_threads, num_compute_threads, 20*sizeof(float), 12,
+               23*sizeof(float), 22*sizeof(float));
+  }
+  __device__ static void start(DMA &dma, const float *src, const int *)
+  {
+    dma.start_xfer_async(src);
+  }
+  template<bool QUALIFIED>
+  __device__ static void prefetch(const DMA &dma, const float *src, const int *)
+  {
+    if (QUALIFIED)
+      dma.template prefetch<true>(src);
+    else
+      dma.prefetch(src);
+  }
+};
+
+// An 8x6x3 box with a radius 1 halo
+struct BoxCase {
+  typedef CudaDMABox<true,4,16,4,1> DMA;
+  static const int src_floats = 145 + 5*132, src_offset = 145, buffer_floats = 92 + 4*81, dst_offset = 92;
+  static const int aux_ints = 0;
+  static const char *name(void) { return "Box          "; }
+  __host__ static void fill_aux(int *) { }
+  __device__ static DMA make(int num_compute_threads)
+  {
+    return DMA(1, 64, num_compute_threads, num_compute_threads, 8*sizeof(float), 6, 3,
+               12*sizeof(float), 132*sizeof(float), 10*sizeof(float), 81*sizeof(float));
+  }
+  __device__ static void start(DMA &dma, const float *src, const int *)
+  {
+    dma.start_xfer_async(src);
+  }
+  template<bool QUALIFIED>
+  __device__ static void prefetch(const DMA &dma, const float *src, const int *)
+  {
+    if (QUALIFIED)
+      dma.template prefetch<true>(src);
+    else
+      dma.prefetch(src);
+  }
+};
+
+// 3x4 rows of 16 floats cut out of a padded tensor
+struct TensorCase {
+  typedef CudaDMATensor<true,4,16,3,64,64> DMA;
+  static const int src_floats = 380, src_offset = 0, buffer_floats = 192, dst_offset = 0;
+  static const int aux_ints = 0;
+  static const char *name(void) { return "Tensor       "; }
+  __host__ static void fill_aux(int *) { }
+  __device__ static DMA make(int num_compute_threads)
+  {
+    const int extents[2] = { 3, 4 };
+    const int src_strides[2] = { 19*sizeof(float), 76*sizeof(float) };
+    const int dst_strides[2] = { 16*sizeof(float), 48*sizeof(float) };
+    return DMA(1, num_compute_threads, num_compute_threads, extents, src_strides, dst_strides);
+  }
+  __device__ static void start(DMA &dma, const float *src, const int *)
+  {
+    dma.start_xfer_async(src);
+  }
+  template<bool QUALIFIED>
+  __device__ static void prefetch(const DMA &dma, const float *src, const int *)
+  {
+    if (QUALIFIED)
+      dma.template prefetch<true>(src);
+    else
+      dma.prefetch(src);
+  }
+};
+
+// 12 rows of 20 floats written out as 20 columns
+struct TransposeCase {
+  typedef CudaDMATranspose<true,4,16,4> DMA;
+  static const int src_floats = 12*24, src_offset = 0, buffer_floats = 20*13, dst_offset = 0;
+  static const int aux_ints = 0;
+  static const char *name(void) { return "Transpose    "; }
+  __host__ static void fill_aux(int *) { }
+  __device__ static DMA make(int num_compute_threads)
+  {
+    return DMA(1, 64, num_compute_threads, num_compute_threads, 20*sizeof(float), 12,
+               24*sizeof(float), 13*sizeof(float));
+  }
+  __device__ static void start(DMA &dma, const float *src, const int *)
+  {
+    dma.start_xfer_async(src);
+  }
+  template<bool QUALIFIED>
+  __device__ static void prefetch(const DMA &dma, const float *src, const int *)
+  {
+    if (QUALIFIED)
+      dma.template prefetch<true>(src);
+    else
+      dma.prefetch(src);
+  }
+};
+
+// 16 elements of 8 floats gathered as three runs from a pool of 40
+struct IndirectRunsCase {
+  typedef CudaDMAIndirectRuns<true,true,4,16,32> DMA;
+  static const int src_floats = 40*8, src_offset = 0, buffer_floats = 16*8, dst_offset = 0;
+  static const int aux_ints = 16*sizeof(CudaDMAIndirectRun)/sizeof(int);
+  static const int num_runs = 3;
+  static const char *name(void) { return "IndirectRuns "; }
+  __host__ static void fill_aux(int *aux)
+  {
+    const int index[16] = { 0, 1, 2, 3, 10, 11, 12, 13, 14, 15, 20, 21, 22, 23, 24, 25 };
+    cudaDMA_build_indirect_runs(index, 16, (CudaDMAIndirectRun*)aux);
+  }
+  __device__ static DMA make(int num_compute_threads)
+  {
+    return DMA(1, 64, num_compute_threads, num_compute_threads, 16);
+  }
+  __device__ static void start(DMA &dma, const float *src, const int *aux)
+  {
+    dma.start_xfer_async((const CudaDMAIndirectRun*)aux, num_runs, src);
+  }
+  template<bool QUALIFIED>
+  __device__ static void prefetch(const DMA &dma, const float *src, const int *aux)
+  {
+    if (QUALIFIED)
+      dma.template prefetch<true>((const CudaDMAIndirectRun*)aux, num_runs, src);
+    else
+      dma.prefetch((const CudaDMAIndirectRun*)aux, num_runs, src);
+  }
+};
+
+// 6 rows of 40 halves widened to floats
+struct ConvertCase {
+  typedef CudaDMAConvert<true,4,16,CudaDMAHalf,float> DMA;
+  static const int src_floats = 6*24, src_offset = 0, buffer_floats = 6*44, dst_offset = 0;
+  static const int aux_ints = 0;
+  static const char *name(void) { return "Convert      "; }
+  __host__ static void fill_aux(int *) { }
+  __device__ static DMA make(int num_compute_threads)
+  {
+    return DMA(1, 64, num_compute_threads, num_compute_threads, 40, 6,
+               24*sizeof(float), 44*sizeof(float));
+  }
+  __device__ static void start(DMA &dma, const float *src, const int *)
+  {
+    dma.start_xfer_async(src);
+  }
+  template<bool QUALIFIED>
+  __device__ static void prefetch(const DMA &dma, const float *src, const int *)
+  {
+    if (QUALIFIED)
+      dma.template prefetch<true>(src);
+    else
+      dma.prefetch(src);
+  }
+};
+
+// 10 elements of 12 floats of which only the first 7 and 10 floats
+// of the last valid one are loaded, the rest are filled with zeros
+struct StridedMaskedCase {
+  typedef CudaDMAStridedMasked<true,4,16,FILL_ZERO> DMA;
+  static const int src_floats = 10*14, src_offset = 0, buffer_floats = 10*12, dst_offset = 0;
+  static const int aux_ints = 0;
+  static const char *name(void) { return "StridedMasked"; }
+  __host__ static void fill_aux(int *) { }
+  __device__ static DMA make(int num_compute_threads)
+  {
+    return DMA(1, 64, num_compute_threads, num_compute_threads, 12*sizeof(float), 10,
+               14*sizeof(float), 12*sizeof(float));
+  }
+  __device__ static void start(DMA &dma, const float *src, const int *)
+  {
+    dma.start_xfer_async(src, 7, 10*sizeof(float));
+  }
+  template<bool QUALIFIED>
+  __device__ static void prefetch(const DMA &dma, const float *src, const int *)
+  {
+    if (QUALIFIED)
+      dma.template prefetch<true>(src, 7, 10*sizeof(float));
+    else
+      dma.prefetch(src, 7, 10*sizeof(float));
+  }
+};
+
+// Scatters prefetch the global destination they will write, so their cases
+// describe the floats of the tile in shared memory and of the destination
+// pool, and prefetch with a destination instead of a source
+
+// 16 elements of 32 floats scattered into a pool of 24
+struct IndirectScatterCase {
+  typedef CudaDMAIndirect<false,true,16,64,128,64,16> DMA;
+  static const int buffer_floats = 16*32, dst_floats = 24*32;
+  static const int aux_ints = 16;
+  static const char *name(void) { return "Scatter      "; }
+  __host__ static void fill_aux(int *aux)
+  {
+    for (int i = 0; i < aux_ints; i++)
+      aux[i] = (5*i + 2) % 24;
+  }
+  __device__ static DMA make(int num_compute_threads)
+  {
+    return DMA(1, num_compute_threads, num_compute_threads);
+  }
+  __device__ static void start(DMA &dma, const float *tile, const int *aux)
+  {
+    dma.start_xfer_async(aux, tile);
+  }
+  template<bool QUALIFIED>
+  __device__ static void prefetch(const DMA &dma, float *dst, const int *aux)
+  {
+    if (QUALIFIED)
+      dma.template prefetch<true>(aux, dst);
+    else
+      dma.prefetch(aux, dst);
+  }
+};
+
+// 16 elements of 8 floats scattered as three runs into a pool of 40
+struct IndirectRunsScatterCase {
+  typedef CudaDMAIndirectRuns<false,true,4,16,32> DMA;
+  static const int buffer_floats = 16*8, dst_floats = 40*8;
+  static const int aux_ints = 16*sizeof(CudaDMAIndirectRun)/sizeof(int);
+  static const int num_runs = 3;
+  static const char *name(void) { return "ScatterRuns  "; }
+  __host__ static void fill_aux(int *aux)
+  {
+    const int index[16] = { 0, 1, 2, 3, 10, 11, 12, 13, 14, 15, 20, 21, 22, 23, 24, 25 };
+    cudaDMA_build_indirect_runs(index, 16, (CudaDMAIndirectRun*)aux);
+  }
+  __device__ static DMA make(int num_compute_threads)
+  {
+    return DMA(1, 64, num_compute_threads, num_compute_threads, 16);
+  }
+  __device__ static void start(DMA &dma, const float *tile, const int *aux)
+  {
+    dma.start_xfer_async((const CudaDMAIndirectRun*)aux, num_runs, tile);
+  }
+  template<bool QUALIFIED>
+  __device__ static void prefetch(const DMA &dma, float *dst, const int *aux)
+  {
+    if (QUALIFIED)
+      dma.template prefetch<true>((const CudaDMAIndirectRun*)aux, num_runs, dst);
+    else
+      dma.prefetch((const CudaDMAIndirectRun*)aux, num_runs, dst);
+  }
+};
+
+template<typename CASE>
+__global__ void __launch_bounds__(1024,1)
+prefetch_kernel( const float *idata, const float *other, const int *aux, float *odata,
+                 int num_compute_threads, int mode)
+{
+  CUDADMA_EXTERN_SHARED(float4, buffer);
+  float *tile = (float*)buffer;
+
+  for (int i = threadIdx.x; i < CASE::buffer_floats; i += blockDim.x)
+    tile[i] = SENTINEL;
+  __syncthreads();
+
+  typename CASE::DMA dma = CASE::make(num_compute_threads);
+  if (dma.owns_this_thread())
+  {
+    if (mode == PREFETCH_ONLY)
+    {
+      CASE::template prefetch<false>(dma, idata + CASE::src_offset, aux);
+      CASE::template prefetch<true>(dma, idata + CASE::src_offset, aux);
+    }
+    else
+    {
+      if (mode == PREFETCH_AROUND)
+        CASE::template prefetch<false>(dma, other + CASE::src_offset, aux);
+      CASE::start(dma, idata + CASE::src_offset, aux);
+      // The loads of the transfer are in flight, the prefetch must not touch them
+      if (mode == PREFETCH_AROUND)
+        CASE::template prefetch<true>(dma, other + CASE::src_offset, aux);
+      dma.wait_xfer_finish(tile + CASE::dst_offset);
+    }
+  }
+  else if (mode != PREFETCH_ONLY)
+  {
+    dma.start_async_dma();
+    dma.wait_for_dma_finish();
+  }
+  __syncthreads();
+
+  for (int i = threadIdx.x; i < CASE::buffer_floats; i += blockDim.x)
+    odata[i] = tile[i];
+}
+
+template<typename CASE>
+__host__ void run_transfer(const float *d_idata, const int *d_aux, float *d_odata, float *h_odata,
+                           int mode)
+{
+  const int num_compute_threads = 2*WARP_SIZE;
+  const int other_offset = 4*((CASE::src_floats + 3)/4);
+  CUDA_SAFE_CALL( cudaMemset( d_odata, 0, CASE::buffer_floats*sizeof(float)));
+#ifdef CUDADMA_HOST_BACKEND
+  start_tracing();
+#endif
+  CUDADMA_LAUNCH(1,num_compute_threads+64,CASE::buffer_floats*sizeof(float),0,prefetch_kernel<CASE>)
+    (d_idata, d_idata + other_offset, d_aux, d_odata, num_compute_threads, mode);
+  CUDA_SAFE_CALL( cudaGetLastError());
+  CUDA_SAFE_CALL( cudaThreadSynchronize());
+#ifdef CUDADMA_HOST_BACKEND
+  stop_tracing();
+#endif
+  CUDA_SAFE_CALL( cudaMemcpy (h_odata, d_odata, CASE::buffer_floats*sizeof(float), cudaMemcpyDeviceToHost));
+}
+
+template<typename CASE>
+__global__ void __launch_bounds__(1024,1)
+scatter_prefetch_kernel( const float *idata, const int *aux, float *odata, float *other,
+                         int num_compute_threads, int mode)
+{
+  CUDADMA_EXTERN_SHARED(float4, buffer);
+  float *tile = (float*)buffer;
+
+  for (int i = threadIdx.x; i < CASE::buffer_floats; i += blockDim.x)
+    tile[i] = idata[i];
+  __syncthreads();
+
+  typename CASE::DMA dma = CASE::make(num_compute_threads);
+  if (dma.owns_this_thread())
+  {
+    if (mode == PREFETCH_ONLY)
+    {
+      CASE::template prefetch<false>(dma, odata, aux);
+      CASE::template prefetch<true>(dma, odata, aux);
+    }
+    else
+    {
+      if (mode == PREFETCH_AROUND)
+        CASE::template prefetch<false>(dma, other, aux);
+      CASE::start(dma, tile, aux);
+      if (mode == PREFETCH_AROUND)
+        CASE::template prefetch<true>(dma, other, aux);
+      dma.wait_xfer_finish(odata);
+    }
+  }
+  else if (mode != PREFETCH_ONLY)
+  {
+    dma.start_async_dma();
+    dma.wait_for_dma_finish();
+  }
+}
+
+// The destination pool of the scatter is followed by a different pool
+// of the same shape which is the one prefetched around it
+template<typename CASE>
+__host__ void run_scatter(const float *d_idata, const int *d_aux, float *d_odata,
+                          const float *h_sentinel, float *h_odata, int mode)
+{
+  const int num_compute_threads = 2*WARP_SIZE;
+  CUDA_SAFE_CALL( cudaMemcpy( d_odata, h_sentinel, 2*CASE::dst_floats*sizeof(float), cudaMemcpyHostToDevice));
+#ifdef CUDADMA_HOST_BACKEND
+  start_tracing();
+#endif
+  CUDADMA_LAUNCH(1,num_compute_threads+64,CASE::buffer_floats*sizeof(float),0,scatter_prefetch_kernel<CASE>)
+    (d_idata, d_aux, d_odata, d_odata + CASE::dst_floats, num_compute_threads, mode);
+  CUDA_SAFE_CALL( cudaGetLastError());
+  CUDA_SAFE_CALL( cudaThreadSynchronize());
+#ifdef CUDADMA_HOST_BACKEND
+  stop_tracing();
+#endif
+  CUDA_SAFE_CALL( cudaMemcpy (h_odata, d_odata, 2*CASE::dst_floats*sizeof(float), cudaMemcpyDeviceToHost));
+}
+
+template<typename CASE>
+__host__ bool run_scatter_experiment(void)
+{
+  const int output_size = 2*CASE::dst_floats;
+
+  float *h_idata = (float*)malloc(CASE::buffer_floats*sizeof(float));
+  for (int i = 0; i < CASE::buffer_floats; i++)
+    h_idata[i] = float(i);
+  int *h_aux = (int*)malloc(CASE::aux_ints*sizeof(int));
+  CASE::fill_aux(h_aux);
+  float *h_sentinel = (float*)malloc(output_size*sizeof(float));
+  for (int i = 0; i < output_size; i++)
+    h_sentinel[i] = SENTINEL;
+  float *h_plain = (float*)malloc(output_size*sizeof(float));
+  float *h_odata = (float*)malloc(output_size*sizeof(float));
+
+  float *d_idata, *d_odata;
+  int *d_aux;
+  CUDA_SAFE_CALL( cudaMalloc( (void**)&d_idata, CASE::buffer_floats*sizeof(float)));
+  CUDA_SAFE_CALL( cudaMemcpy( d_idata, h_idata, CASE::buffer_floats*sizeof(float), cudaMemcpyHostToDevice));
+  CUDA_SAFE_CALL( cudaMalloc( (void**)&d_aux, CASE::aux_ints*sizeof(int)));
+  CUDA_SAFE_CALL( cudaMemcpy( d_aux, h_aux, CASE::aux_ints*sizeof(int), cudaMemcpyHostToDevice));
+  CUDA_SAFE_CALL( cudaMalloc( (void**)&d_odata, output_size*sizeof(float)));
+
+  bool pass = true;
+  // A scatter with prefetches of the other pool around it writes the same
+  // data as one without, and neither writes the other pool
+  run_scatter<CASE>(d_idata, d_aux, d_odata, h_sentinel, h_plain, PLAIN);
+#ifdef CUDADMA_HOST_BACKEND
+  // Prefetches warm the lines the scatter stores to
+  const AccessSet stored = traced.stores;
+#endif
+  run_scatter<CASE>(d_idata, d_aux, d_odata, h_sentinel, h_odata, PREFETCH_AROUND);
+  for (int i = 0; (i < output_size) && pass; i++)
+  {
+    if (h_odata[i] != h_plain[i])
+    {
+      fprintf(stderr,"Experiment: %s prefetch around the transfer, float %d is %f not %f\n",
+              CASE::name(), i, h_odata[i], h_plain[i]);
+      pass = false;
+    }
+  }
+#ifdef CUDADMA_HOST_BACKEND
+  if (pass)
+    pass = check_prefetches(CASE::name(), "prefetch around the transfer", stored,
+                            long(CASE::dst_floats*sizeof(float)));
+#endif
+  // A prefetch on its own never writes the destination
+  run_scatter<CASE>(d_idata, d_aux, d_odata, h_sentinel, h_odata, PREFETCH_ONLY);
+  for (int i = 0; (i < output_size) && pass; i++)
+  {
+    if (h_odata[i] != SENTINEL)
+    {
+      fprintf(stderr,"Experiment: %s prefetch only, float %d is %f not untouched\n",
+              CASE::name(), i, h_odata[i]);
+      pass = false;
+    }
+  }
+#ifdef CUDADMA_HOST_BACKEND
+  if (pass)
+    pass = check_prefetches(CASE::name(), "prefetch only", stored, 0);
+#endif
+  fprintf(stdout," - %s\n",(pass?"PASS!":"FAIL!"));
+  fflush(stdout);
+
+  CUDA_SAFE_CALL( cudaFree(d_idata));
+  CUDA_SAFE_CALL( cudaFree(d_aux));
+  CUDA_SAFE_CALL( cudaFree(d_odata));
+  free(h_idata);
+  free(h_aux);
+  free(h_sentinel);
+  free(h_plain);
+  free(h_odata);
+
+  return pass;
+}
+
+// The source of the transfer is followed by a different source
+// of the same shape which is the one prefetched around it
+template<typename CASE>
+__host__ bool run_experiment(void)
+{
+  const int other_offset = 4*((CASE::src_floats + 3)/4);
+  const int input_size = 2*other_offset;
+  const int aux_size = (CASE::aux_ints > 0) ? CASE::aux_ints : 1;
+
+  float *h_idata = (float*)malloc(input_size*sizeof(float));
+  for (int i = 0; i < other_offset; i++)
+  {
+    h_idata[i] = float(i);
+    h_idata[other_offset + i] = -float(i+1);
+  }
+  // Cases without indexes still copy one word of aux to the device
+  int *h_aux = (int*)malloc(aux_size*sizeof(int));
+  memset(h_aux, 0, aux_size*sizeof(int));
+  CASE::fill_aux(h_aux);
+  float *h_plain = (float*)malloc(CASE::buffer_floats*sizeof(float));
+  float *h_odata = (float*)malloc(CASE::buffer_floats*sizeof(float));
+
+  float *d_idata, *d_odata;
+  int *d_aux;
+  CUDA_SAFE_CALL( cudaMalloc( (void**)&d_idata, input_size*sizeof(float)));
+  CUDA_SAFE_CALL( cudaMemcpy( d_idata, h_idata, input_size*sizeof(float), cudaMemcpyHostToDevice));
+  CUDA_SAFE_CALL( cudaMalloc( (void**)&d_aux, aux_size*sizeof(int)));
+  CUDA_SAFE_CALL( cudaMemcpy( d_aux, h_aux, aux_size*sizeof(int), cudaMemcpyHostToDevice));
+  CUDA_SAFE_CALL( cudaMalloc( (void**)&d_odata, CASE::buffer_floats*sizeof(float)));
+
+  bool pass = true;
+  // A transfer with prefetches around it moves the same data as one without
+  run_transfer<CASE>(d_idata, d_aux, d_odata, h_plain, PLAIN);
+#ifdef CUDADMA_HOST_BACKEND
+  // Prefetches warm the lines the transfer loads
+  const AccessSet loaded = traced.loads;
+#endif
+  run_transfer<CASE>(d_idata, d_aux, d_odata, h_odata, PREFETCH_AROUND);
+  for (int i = 0; (i < CASE::buffer_floats) && pass; i++)
+  {
+    if (h_odata[i] != h_plain[i])
+    {
+      fprintf(stderr,"Experiment: %s prefetch around the transfer, float %d is %f not %f\n",
+              CASE::name(), i, h_odata[i], h_plain[i]);
+      pass = false;
+    }
+  }
+#ifdef CUDADMA_HOST_BACKEND
+  if (pass)
+    pass = check_prefetches(CASE::name(), "prefetch around the transfer", loaded,
+                            long(other_offset*sizeof(float)));
+#endif
+  // A prefetch on its own never writes the buffer
+  run_transfer<CASE>(d_idata, d_aux, d_odata, h_odata, PREFETCH_ONLY);
+  for (int i = 0; (i < CASE::buffer_floats) && pass; i++)
+  {
+    if (h_odata[i] != SENTINEL)
+    {
+      fprintf(stderr,"Experiment: %s prefetch only, float %d is %f not untouched\n",
+              CASE::name(), i, h_odata[i]);
+      pass = false;
+    }
+  }
+#ifdef CUDADMA_HOST_BACKEND
+  if (pass)
+    pass = check_prefetches(CASE::name(), "prefetch only", loaded, 0);
+#endif
+  fprintf(stdout," - %s\n",(pass?"PASS!":"FAIL!"));
+  fflush(stdout);
+
+  CUDA_SAFE_CALL( cudaFree(d_idata));
+  CUDA_SAFE_CALL( cudaFree(d_aux));
+  CUDA_SAFE_CALL( cudaFree(d_odata));
+  free(h_idata);
+  free(h_aux);
+  free(h_plain);
+  free(h_odata);
+
+  return pass;
+}
+
+#define RUN(CASE)                                                                                   \
+  fprintf(stdout,"  %s", CASE::name());                                                             \
+  if (!run_experiment<CASE>())                                                                      \
+    return false;
+
+#define RUN_SCATTER(CASE)                                                                           \
+  fprintf(stdout,"  %s", CASE::name());                                                             \
+  if (!run_scatter_experiment<CASE>())                                                              \
+    return false;
+
+__host__
+int main()
+{
+  fprintf(stdout,"Running all experiments for prefetching\n");
+  RUN(SequentialCase)
+  RUN(StridedCase)
+  RUN(IndirectCase)
+  RUN(HaloCase)
+  RUN(BoxCase)
+  RUN(TensorCase)
+  RUN(TransposeCase)
+  RUN(IndirectRunsCase)
+  RUN(ConvertCase)
+  RUN(StridedMaskedCase)
+  RUN_SCATTER(IndirectScatterCase)
+  RUN_SCATTER(IndirectRunsScatterCase)
+  fprintf(stdout,"All experiments passed\n");
+  return true;
+}
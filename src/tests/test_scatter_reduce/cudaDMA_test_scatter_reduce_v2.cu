@@ -0,0 +1,246 @@
+/*
+ *  Copyright 2013 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/* Software DMA project
+*
+* Host code.
+*/
+
+// includes, system
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <assert.h>
+#include <math.h>
+
+#ifdef __CUDACC__
+#include "cuda.h"
+#include "cuda_runtime.h"
+#endif
+
+#include "cudaDMAv2.h"
+
+#define WARP_SIZE 32
+
+#define CUDA_SAFE_CALL(x)					\
+	{							\
+		cudaError_t err = (x);				\
+		if (err != cudaSuccess)				\
+		{						\
+			printf("Cuda error: %s\n", cudaGetErrorString(err));	\
+			exit(false);				\
+		}						\
+	}
+
+// Scatter packed elements from idata into a table in global memory with
+// an atomic reduction, the index list contains duplicates
+template<int REDUCE_QUAL, int ALIGNMENT, int BYTES_PER_THREAD, int BYTES_PER_ELMT, int DMA_THREADS, int NUM_ELMTS>
+__global__ void __launch_bounds__(1024,1)
+special_xfer_reduce( float *idata, float *table, int *indices, int num_compute_threads, const bool single)
+{
+  CudaDMAIndirect<false,true,ALIGNMENT,BYTES_PER_THREAD,BYTES_PER_ELMT,DMA_THREADS,NUM_ELMTS>
+    dma0 (1, num_compute_threads, num_compute_threads);
+
+  if (dma0.owns_this_thread())
+  {
+    if (single)
+      dma0.template execute_dma<true,LOAD_CACHE_GLOBAL,REDUCE_QUAL>(indices, idata, table);
+    else
+    {
+      dma0.template start_xfer_async<true,LOAD_CACHE_GLOBAL,REDUCE_QUAL>(indices, idata);
+      dma0.template wait_xfer_finish<true,LOAD_CACHE_GLOBAL,REDUCE_QUAL>(table);
+    }
+  }
+  else
+  {
+    dma0.start_async_dma();
+    dma0.wait_for_dma_finish();
+  }
+}
+
+template<int REDUCE_QUAL, int ALIGNMENT, int BYTES_PER_THREAD, int BYTES_PER_ELMT, int DMA_THREADS, int NUM_ELMTS>
+__global__ void __launch_bounds__(1024,1)
+nonspec_xfer_reduce( float *idata, float *table, int *indices, const bool single)
+{
+  CudaDMAIndirect<false,false,ALIGNMENT,BYTES_PER_THREAD,BYTES_PER_ELMT> dma0 (NUM_ELMTS);
+
+  if (single)
+    dma0.template execute_dma<true,LOAD_CACHE_LAST_USE,REDUCE_QUAL>(indices, idata, table);
+  else
+  {
+    dma0.template start_xfer_async<true,LOAD_CACHE_LAST_USE,REDUCE_QUAL>(indices, idata);
+    dma0.template wait_xfer_finish<true,LOAD_CACHE_LAST_USE,REDUCE_QUAL>(table);
+  }
+}
+
+// The type of the values being reduced
+template<bool IS_INT>
+struct DataType { typedef float type; };
+
+template<>
+struct DataType<true> { typedef int type; };
+
+// Host version of the reductions
+template<int OP, bool IS_INT>
+__host__ float reduce(float a, float b)
+{
+  if (IS_INT)
+  {
+    int x, y;
+    memcpy(&x, &a, sizeof(int));
+    memcpy(&y, &b, sizeof(int));
+    const int r = (OP == REDUCE_ADD) ? (x + y) : (OP == REDUCE_MIN) ? ((x < y) ? x : y) : ((x > y) ? x : y);
+    float result;
+    memcpy(&result, &r, sizeof(int));
+    return result;
+  }
+  return ((OP == REDUCE_ADD) ? (a + b) : (OP == REDUCE_MIN) ? ((a < b) ? a : b) : ((a > b) ? a : b));
+}
+
+// Small integer values, so float sums are exact in any order
+template<bool IS_INT>
+__host__ float make_value(int value)
+{
+  if (IS_INT)
+  {
+    float result;
+    memcpy(&result, &value, sizeof(int));
+    return result;
+  }
+  return float(value);
+}
+
+template<bool SPECIALIZED, int OP, bool IS_INT, bool AGGREGATE, int ALIGNMENT, int BYTES_PER_THREAD,
+         int BYTES_PER_ELMT, int DMA_THREADS, int NUM_ELMTS>
+__host__ bool run_experiment(int table_elmts, bool single)
+{
+  const int REDUCE_QUAL = CudaDMAReduce<OP,typename DataType<IS_INT>::type,AGGREGATE>::qual;
+  const int elmt_floats = BYTES_PER_ELMT/sizeof(float);
+  int h_indices[NUM_ELMTS];
+  for (int i = 0; i < NUM_ELMTS; i++)
+    h_indices[i] = rand() % table_elmts;
+  const int input_size = NUM_ELMTS*elmt_floats;
+  const int table_size = table_elmts*elmt_floats;
+  float *h_idata = (float*)malloc(input_size*sizeof(float));
+  for (int i = 0; i < input_size; i++)
+    h_idata[i] = make_value<IS_INT>((rand() % 41) - 20);
+  float *h_table = (float*)malloc(table_size*sizeof(float));
+  float *h_expected = (float*)malloc(table_size*sizeof(float));
+  for (int i = 0; i < table_size; i++)
+    h_expected[i] = h_table[i] = make_value<IS_INT>(i % 5);
+  for (int i = 0; i < NUM_ELMTS; i++)
+    for (int j = 0; j < elmt_floats; j++)
+      h_expected[h_indices[i]*elmt_floats + j] =
+        reduce<OP,IS_INT>(h_expected[h_indices[i]*elmt_floats + j], h_idata[i*elmt_floats + j]);
+
+  float *d_idata, *d_table;
+  int *d_indices;
+  CUDA_SAFE_CALL( cudaMalloc( (void**)&d_idata, input_size*sizeof(float)));
+  CUDA_SAFE_CALL( cudaMemcpy( d_idata, h_idata, input_size*sizeof(float), cudaMemcpyHostToDevice));
+  CUDA_SAFE_CALL( cudaMalloc( (void**)&d_table, table_size*sizeof(float)));
+  CUDA_SAFE_CALL( cudaMemcpy( d_table, h_table, table_size*sizeof(float), cudaMemcpyHostToDevice));
+  CUDA_SAFE_CALL( cudaMalloc( (void**)&d_indices, NUM_ELMTS*sizeof(int)));
+  CUDA_SAFE_CALL( cudaMemcpy( d_indices, h_indices, NUM_ELMTS*sizeof(int), cudaMemcpyHostToDevice));
+
+  const int num_compute_threads = WARP_SIZE;
+  if (SPECIALIZED)
+  {
+    CUDADMA_LAUNCH(1,num_compute_threads+DMA_THREADS,0,0,
+        special_xfer_reduce<REDUCE_QUAL,ALIGNMENT,BYTES_PER_THREAD,BYTES_PER_ELMT,DMA_THREADS,NUM_ELMTS>)
+      (d_idata, d_table, d_indices, num_compute_threads, single);
+  }
+  else
+  {
+    CUDADMA_LAUNCH(1,DMA_THREADS,0,0,
+        nonspec_xfer_reduce<REDUCE_QUAL,ALIGNMENT,BYTES_PER_THREAD,BYTES_PER_ELMT,DMA_THREADS,NUM_ELMTS>)
+      (d_idata, d_table, d_indices, single);
+  }
+  CUDA_SAFE_CALL( cudaGetLastError());
+  CUDA_SAFE_CALL( cudaThreadSynchronize());
+
+  CUDA_SAFE_CALL( cudaMemcpy (h_table, d_table, table_size*sizeof(float), cudaMemcpyDeviceToHost));
+
+  bool pass = true;
+  for (int i = 0; i < table_size; i++)
+  {
+    if (memcmp(&h_table[i], &h_expected[i], sizeof(float)) != 0)
+    {
+      fprintf(stderr,"Experiment: op %d %s%s, %d elements of %d bytes into %d, %d alignment, %d DMA warps, "
+              "table value %d (element %d) is wrong\n", OP, (IS_INT ? "int" : "float"),
+              (AGGREGATE ? " aggregated" : ""), NUM_ELMTS, BYTES_PER_ELMT, table_elmts, ALIGNMENT,
+              DMA_THREADS/WARP_SIZE, i, i/elmt_floats);
+      pass = false;
+      break;
+    }
+  }
+  fprintf(stdout," - %s\n",(pass?"PASS!":"FAIL!"));
+  fflush(stdout);
+
+  CUDA_SAFE_CALL( cudaFree(d_idata));
+  CUDA_SAFE_CALL( cudaFree(d_table));
+  CUDA_SAFE_CALL( cudaFree(d_indices));
+  free(h_idata);
+  free(h_table);
+  free(h_expected);
+
+  return pass;
+}
+
+// Run the single and two-phase variants of a configuration
+template<bool SPECIALIZED, int OP, bool IS_INT, bool AGGREGATE, int ALIGNMENT, int BYTES_PER_THREAD,
+         int BYTES_PER_ELMT, int DMA_THREADS, int NUM_ELMTS>
+__host__ bool run_all(int table_elmts)
+{
+  const char *op_names[] = { "none", "add", "min", "max" };
+  for (int phases = 1; phases <= 2; phases++)
+  {
+    fprintf(stdout,"  %s %s-%-5s%s ALIGNMENT-%2d BYTES_PER_THREAD-%3d BYTES_PER_ELMT-%3d ELMTS-%3d TABLE-%3d "
+            "DMA_WARPS-%2d %s-phase", (SPECIALIZED ? "Warp-Specialized    " : "Non-Warp-Specialized"),
+            op_names[OP], (IS_INT ? "int" : "float"), (AGGREGATE ? " aggregated" : "           "),
+            ALIGNMENT, BYTES_PER_THREAD, BYTES_PER_ELMT, NUM_ELMTS, table_elmts, DMA_THREADS/WARP_SIZE,
+            (phases == 1 ? "single" : "two"));
+    if (!run_experiment<SPECIALIZED,OP,IS_INT,AGGREGATE,ALIGNMENT,BYTES_PER_THREAD,BYTES_PER_ELMT,
+                        DMA_THREADS,NUM_ELMTS>(table_elmts, (phases == 1)))
+      return false;
+  }
+  return true;
+}
+
+#define RUN(SPECIALIZED,OP,IS_INT,AGGREGATE,ALIGNMENT,BYTES_PER_THREAD,BYTES_PER_ELMT,DMA_THREADS,NUM_ELMTS,TABLE) \
+  if (!run_all<SPECIALIZED,OP,IS_INT,AGGREGATE,ALIGNMENT,BYTES_PER_THREAD,BYTES_PER_ELMT,             \
+               DMA_THREADS,NUM_ELMTS>(TABLE))                                                         \
+    return false;
+
+__host__
+int main()
+{
+  srand(19);
+  fprintf(stdout,"Running all experiments for reducing scatters\n");
+  // Gradient updates
+  RUN(true, REDUCE_ADD,false,false,16, 64, 64,128, 64, 16)
+  RUN(false,REDUCE_ADD,false,true, 16, 64, 32,128,100,  8)
+  RUN(true, REDUCE_ADD,false,true,  8, 32, 24, 64, 50, 20)
+  // Histograms
+  RUN(true, REDUCE_ADD,true, false, 4, 16,  4, 64,300, 10)
+  RUN(false,REDUCE_ADD,true, true,  4,  4,  4, 96,500,  3)
+  // Min and max
+  RUN(true, REDUCE_MIN,false,false,16, 32, 48, 96, 40, 12)
+  RUN(false,REDUCE_MAX,false,false, 8, 16,  8, 64,200, 30)
+  RUN(true, REDUCE_MIN,true, true,  4,  8, 12, 32, 77,  9)
+  RUN(false,REDUCE_MAX,true, false,16, 64, 16,128, 64,  4)
+  fprintf(stdout,"All experiments passed\n");
+  return true;
+}
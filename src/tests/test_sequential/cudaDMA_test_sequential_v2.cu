@@ -26,8 +26,10 @@
 #include <assert.h>
 #include <math.h>
 
+#ifdef __CUDACC__
 #include "cuda.h"
 #include "cuda_runtime.h"
+#endif
 
 #include "cudaDMAv2.h"
 
@@ -53,7 +55,7 @@ template<int ALIGNMENT, int ALIGN_OFFSET, int BYTES_PER_THREAD, int BYTES_PER_EL
 __global__ void __launch_bounds__(1024,1)
 special_xfer_three( float *idata, float *odata, int buffer_size, int num_compute_threads, const bool single, const bool qualified)
 {
-  extern __shared__ float buffer[];
+  CUDADMA_EXTERN_SHARED(float, buffer);
 
   CudaDMASequential<true,ALIGNMENT,BYTES_PER_THREAD,BYTES_PER_ELMT,DMA_THREADS>
     dma0 (1, num_compute_threads,
@@ -119,7 +121,7 @@ template<int ALIGNMENT, int ALIGN_OFFSET, int BYTES_PER_THREAD, int BYTES_PER_EL
 __global__ void __launch_bounds__(1024,1)
 special_xfer_two( float *idata, float *odata, int buffer_size, int num_compute_threads, int num_dma_threads, const bool single, const bool qualified)
 {
-  extern __shared__ float buffer[];
+  CUDADMA_EXTERN_SHARED(float, buffer);
 
   CudaDMASequential<true,ALIGNMENT,BYTES_PER_THREAD,BYTES_PER_ELMT>
     dma0 (1, num_dma_threads, num_compute_threads,
@@ -183,7 +185,7 @@ template<int ALIGNMENT, int ALIGN_OFFSET, int BYTES_PER_THREAD>
 __global__ void __launch_bounds__(1024,1)
 special_xfer_one( float *idata, float *odata, int buffer_size, int num_compute_threads, int num_dma_threads, int bytes_per_elmt, const bool single, const bool qualified)
 {
-  extern __shared__ float buffer[];
+  CUDADMA_EXTERN_SHARED(float, buffer);
 
   CudaDMASequential<true,ALIGNMENT,BYTES_PER_THREAD>
     dma0 (1, num_dma_threads, num_compute_threads,
@@ -247,7 +249,7 @@ template<int ALIGNMENT, int ALIGN_OFFSET, int BYTES_PER_THREAD, int BYTES_PER_EL
 __global__ void __launch_bounds__(1024,1)
 nonspec_xfer_three( float *idata, float *odata, int buffer_size, const bool single, const bool qualified)
 {
-  extern __shared__ float buffer[];
+  CUDADMA_EXTERN_SHARED(float, buffer);
 
   CudaDMASequential<false,ALIGNMENT,BYTES_PER_THREAD,BYTES_PER_ELMT,DMA_THREADS>
     dma0;
@@ -301,7 +303,7 @@ template<int ALIGNMENT, int ALIGN_OFFSET, int BYTES_PER_THREAD, int BYTES_PER_EL
 __global__ void __launch_bounds__(1024,1)
 nonspec_xfer_two( float *idata, float *odata, int buffer_size, const bool single, const bool qualified)
 {
-  extern __shared__ float buffer[];
+  CUDADMA_EXTERN_SHARED(float, buffer);
 
   CudaDMASequential<false,ALIGNMENT,BYTES_PER_THREAD,BYTES_PER_ELMT>
     dma0;
@@ -355,7 +357,7 @@ template<int ALIGNMENT, int ALIGN_OFFSET, int BYTES_PER_THREAD>
 __global__ void __launch_bounds__(1024,1)
 nonspec_xfer_one( float *idata, float *odata, int buffer_size, int bytes_per_elmt, const bool single, const bool qualified)
 {
-  extern __shared__ float buffer[];
+  CUDADMA_EXTERN_SHARED(float, buffer);
 
   CudaDMASequential<false,ALIGNMENT,BYTES_PER_THREAD>
     dma0(bytes_per_elmt);
@@ -445,14 +447,12 @@ __host__ bool run_experiment(bool single, bool qualified, int num_templates)
     {
     if (SPECIALIZED)
     {
-      special_xfer_three<ALIGNMENT,ALIGN_OFFSET,BYTES_PER_THREAD,BYTES_PER_ELMT,DMA_THREADS>
-        <<<1,total_threads,shared_buffer_size*sizeof(float),0>>>
+      CUDADMA_LAUNCH(1,total_threads,shared_buffer_size*sizeof(float),0,special_xfer_three<ALIGNMENT,ALIGN_OFFSET,BYTES_PER_THREAD,BYTES_PER_ELMT,DMA_THREADS>)
         (d_idata, d_odata, shared_buffer_size, num_compute_warps*WARP_SIZE,single,qualified);
     }
     else
     {
-      nonspec_xfer_three<ALIGNMENT,ALIGN_OFFSET,BYTES_PER_THREAD,BYTES_PER_ELMT,DMA_THREADS>
-        <<<1,total_threads,shared_buffer_size*sizeof(float),0>>>
+      CUDADMA_LAUNCH(1,total_threads,shared_buffer_size*sizeof(float),0,nonspec_xfer_three<ALIGNMENT,ALIGN_OFFSET,BYTES_PER_THREAD,BYTES_PER_ELMT,DMA_THREADS>)
         (d_idata, d_odata, shared_buffer_size,single,qualified);
     }
     break;
@@ -461,14 +461,12 @@ __host__ bool run_experiment(bool single, bool qualified, int num_templates)
     {
     if (SPECIALIZED)
     {
-      special_xfer_two<ALIGNMENT,ALIGN_OFFSET,BYTES_PER_THREAD,BYTES_PER_ELMT>
-        <<<1,total_threads,shared_buffer_size*sizeof(float),0>>>
+      CUDADMA_LAUNCH(1,total_threads,shared_buffer_size*sizeof(float),0,special_xfer_two<ALIGNMENT,ALIGN_OFFSET,BYTES_PER_THREAD,BYTES_PER_ELMT>)
         (d_idata, d_odata, shared_buffer_size, num_compute_warps*WARP_SIZE, DMA_THREADS,single,qualified);
     }
     else
     {
-      nonspec_xfer_two<ALIGNMENT,ALIGN_OFFSET,BYTES_PER_THREAD,BYTES_PER_ELMT>
-        <<<1,total_threads,shared_buffer_size*sizeof(float),0>>>
+      CUDADMA_LAUNCH(1,total_threads,shared_buffer_size*sizeof(float),0,nonspec_xfer_two<ALIGNMENT,ALIGN_OFFSET,BYTES_PER_THREAD,BYTES_PER_ELMT>)
         (d_idata, d_odata, shared_buffer_size,single,qualified);
     }
     break;
@@ -477,14 +475,12 @@ __host__ bool run_experiment(bool single, bool qualified, int num_templates)
     {
     if (SPECIALIZED)
     {
-      special_xfer_one<ALIGNMENT,ALIGN_OFFSET,BYTES_PER_THREAD>
-        <<<1,total_threads,shared_buffer_size*sizeof(float),0>>>
+      CUDADMA_LAUNCH(1,total_threads,shared_buffer_size*sizeof(float),0,special_xfer_one<ALIGNMENT,ALIGN_OFFSET,BYTES_PER_THREAD>)
         (d_idata, d_odata, shared_buffer_size, num_compute_warps*WARP_SIZE, DMA_THREADS, BYTES_PER_ELMT,single,qualified);
     }
     else
     {
-      nonspec_xfer_one<ALIGNMENT,ALIGN_OFFSET,BYTES_PER_THREAD>
-        <<<1,total_threads,shared_buffer_size*sizeof(float),0>>>
+      CUDADMA_LAUNCH(1,total_threads,shared_buffer_size*sizeof(float),0,nonspec_xfer_one<ALIGNMENT,ALIGN_OFFSET,BYTES_PER_THREAD>)
         (d_idata, d_odata, shared_buffer_size, BYTES_PER_ELMT,single,qualified);
     }
     break;
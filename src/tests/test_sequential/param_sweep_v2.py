@@ -21,6 +21,11 @@ def run_experiment(test_k20,alignment,offset,register_bytes,elem_size,dma_warps)
             subprocess.check_call(['make clean; make ts2_k20'],shell=True)
         except:
             assert False
+    elif test_k20 < 0:
+        try:
+            subprocess.check_call(['make clean; make ts2_host'],shell=True)
+        except:
+            assert False
     else:
         try:
             subprocess.check_call(['make clean; make ts2'],shell=True)
@@ -76,6 +81,8 @@ def main():
         test_k20 = int(sys.argv[1])
         if test_k20 > 0:
             print "Testing on K20"
+        elif test_k20 < 0:
+            print "Testing on the host"
     run_random_experiments(test_k20)
     #run_all_experiments(16,0)
     #run_all_experiments(8,0)
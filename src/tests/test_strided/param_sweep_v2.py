@@ -23,6 +23,11 @@ def run_experiment(test_k20,alignment,offset,register_bytes,elem_size,num_elmts,
             subprocess.check_call(['make clean; make ts2_k20'],shell=True)
         except:
             assert False
+    elif test_k20 < 0:
+        try:
+            subprocess.check_call(['make clean; make ts2_host'],shell=True)
+        except:
+            assert False
     else:
         try:
             subprocess.check_call(['make clean; make ts2'],shell=True)
@@ -79,6 +84,8 @@ def main():
         test_k20 = int(sys.argv[1])
         if test_k20 > 0:
             print "Testing on K20"
+        elif test_k20 < 0:
+            print "Testing on the host"
     run_random_experiments(test_k20)
     #run_all_experiments(16,0)
     #run_all_experiments(8,0)
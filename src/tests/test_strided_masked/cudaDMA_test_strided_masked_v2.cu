@@ -0,0 +1,257 @@
+/*
+ *  Copyright 2013 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/* Software DMA project
+*
+* Host code.
+*/
+
+// includes, system
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <assert.h>
+#include <math.h>
+
+#ifdef __CUDACC__
+#include "cuda.h"
+#include "cuda_runtime.h"
+#endif
+
+#include "cudaDMAv2.h"
+
+#define WARP_SIZE 32
+
+#define CUDA_SAFE_CALL(x)					\
+	{							\
+		cudaError_t err = (x);				\
+		if (err != cudaSuccess)				\
+		{						\
+			printf("Cuda error: %s\n", cudaGetErrorString(err));	\
+			exit(false);				\
+		}						\
+	}
+
+// Load a tile that hangs over the edge of the source into shared memory
+// and copy the tile back out to global memory
+template<int ALIGNMENT, int BYTES_PER_THREAD, int FILL, int DMA_THREADS>
+__global__ void __launch_bounds__(1024,1)
+special_xfer_masked( float *idata, float *odata, int elmt_size, int num_elmts, int src_stride,
+                     int dst_stride, int valid_elmts, int valid_bytes, unsigned long long mask,
+                     int num_compute_threads, const bool single)
+{
+  CUDADMA_EXTERN_SHARED(float, buffer);
+
+  CudaDMAStridedMasked<true,ALIGNMENT,BYTES_PER_THREAD,FILL>
+    dma0 (1, DMA_THREADS, num_compute_threads, num_compute_threads, elmt_size, num_elmts,
+          src_stride, dst_stride);
+
+  if (dma0.owns_this_thread())
+  {
+    if (single)
+      dma0.execute_dma(idata, buffer, valid_elmts, valid_bytes, mask);
+    else
+    {
+      dma0.start_xfer_async(idata, valid_elmts, valid_bytes, mask);
+      dma0.wait_xfer_finish(buffer);
+    }
+  }
+  else
+  {
+    dma0.start_async_dma();
+    dma0.wait_for_dma_finish();
+    for (int i = threadIdx.x; i < (num_elmts*dst_stride/int(sizeof(float))); i += num_compute_threads)
+      odata[i] = buffer[i];
+  }
+}
+
+template<int ALIGNMENT, int BYTES_PER_THREAD, int FILL, int DMA_THREADS>
+__global__ void __launch_bounds__(1024,1)
+nonspec_xfer_masked( float *idata, float *odata, int elmt_size, int num_elmts, int src_stride,
+                     int dst_stride, int valid_elmts, int valid_bytes, unsigned long long mask,
+                     const bool single)
+{
+  CUDADMA_EXTERN_SHARED(float, buffer);
+
+  CudaDMAStridedMasked<false,ALIGNMENT,BYTES_PER_THREAD,FILL>
+    dma0 (elmt_size, num_elmts, src_stride, dst_stride);
+
+  if (single)
+    dma0.template execute_dma<true,LOAD_CACHE_GLOBAL,STORE_WRITE_BACK>(idata, buffer, valid_elmts,
+                                                                       valid_bytes, mask);
+  else
+  {
+    dma0.template start_xfer_async<true,LOAD_CACHE_GLOBAL,STORE_WRITE_BACK>(idata, valid_elmts,
+                                                                            valid_bytes, mask);
+    dma0.template wait_xfer_finish<true,LOAD_CACHE_GLOBAL,STORE_WRITE_BACK>(buffer);
+  }
+  __syncthreads();
+  for (int i = threadIdx.x; i < (num_elmts*dst_stride/int(sizeof(float))); i += blockDim.x)
+    odata[i] = buffer[i];
+}
+
+// Host version of the fill modes, returns false if the slot is zero filled
+template<int FILL>
+__host__ bool host_fill(int &index, int limit)
+{
+  if (index < limit)
+    return true;
+  if ((FILL == FILL_ZERO) || (limit == 0))
+    return false;
+  if (FILL == FILL_CLAMP)
+    index = limit - 1;
+  else
+    index = (index < 2*limit) ? (2*limit - 1 - index) : 0;
+  return true;
+}
+
+template<bool SPECIALIZED, int ALIGNMENT, int BYTES_PER_THREAD, int FILL, int DMA_THREADS>
+__host__ bool run_experiment(int elmt_size, int num_elmts, int valid_elmts, int valid_bytes,
+                             bool use_mask, bool single)
+{
+  const int src_stride = elmt_size + 2*ALIGNMENT;
+  const int dst_stride = elmt_size + ALIGNMENT;
+  // Only the valid region of the source is allocated
+  const int src_size = ((valid_elmts > 0) ? valid_elmts : 1)*src_stride;
+  const int dst_size = num_elmts*dst_stride;
+  const int chunk_floats = ALIGNMENT/sizeof(float);
+
+  float *h_idata = (float*)malloc(src_size);
+  for (int i = 0; i < int(src_size/sizeof(float)); i++)
+    h_idata[i] = float(i + 1);
+  unsigned long long h_mask = ~0ULL;
+  if (use_mask)
+    for (int i = 0; i < 4; i++)
+      h_mask = (h_mask << 16) ^ (unsigned long long)(rand() & 0xffff);
+  float *h_expected = (float*)malloc(dst_size);
+  float *h_odata = (float*)malloc(dst_size);
+  memset(h_expected, 0, dst_size);
+  for (int r = 0; r < num_elmts; r++)
+  {
+    for (int c = 0; c < elmt_size/ALIGNMENT; c++)
+    {
+      int src_r = r;
+      int src_c = c;
+      const bool enabled = (r >= 64) || ((h_mask >> r) & 1);
+      if (enabled && host_fill<FILL>(src_r, valid_elmts) && host_fill<FILL>(src_c, valid_bytes/ALIGNMENT))
+        memcpy(h_expected + (r*dst_stride + c*ALIGNMENT)/sizeof(float),
+               h_idata + (src_r*src_stride + src_c*ALIGNMENT)/sizeof(float), ALIGNMENT);
+    }
+  }
+
+  float *d_idata, *d_odata;
+  CUDA_SAFE_CALL( cudaMalloc( (void**)&d_idata, src_size));
+  CUDA_SAFE_CALL( cudaMemcpy( d_idata, h_idata, src_size, cudaMemcpyHostToDevice));
+  CUDA_SAFE_CALL( cudaMalloc( (void**)&d_odata, dst_size));
+  CUDA_SAFE_CALL( cudaMemset( d_odata, 0, dst_size));
+
+  const int num_compute_threads = WARP_SIZE;
+  if (SPECIALIZED)
+  {
+    CUDADMA_LAUNCH(1,num_compute_threads+DMA_THREADS,dst_size,0,
+        special_xfer_masked<ALIGNMENT,BYTES_PER_THREAD,FILL,DMA_THREADS>)
+      (d_idata, d_odata, elmt_size, num_elmts, src_stride, dst_stride, valid_elmts, valid_bytes,
+       h_mask, num_compute_threads, single);
+  }
+  else
+  {
+    CUDADMA_LAUNCH(1,DMA_THREADS,dst_size,0,
+        nonspec_xfer_masked<ALIGNMENT,BYTES_PER_THREAD,FILL,DMA_THREADS>)
+      (d_idata, d_odata, elmt_size, num_elmts, src_stride, dst_stride, valid_elmts, valid_bytes,
+       h_mask, single);
+  }
+  CUDA_SAFE_CALL( cudaGetLastError());
+  CUDA_SAFE_CALL( cudaThreadSynchronize());
+
+  CUDA_SAFE_CALL( cudaMemcpy (h_odata, d_odata, dst_size, cudaMemcpyDeviceToHost));
+
+  bool pass = true;
+  for (int r = 0; (r < num_elmts) && pass; r++)
+  {
+    for (int i = 0; i < int(elmt_size/sizeof(float)); i++)
+    {
+      const int index = r*dst_stride/sizeof(float) + i;
+      if (h_odata[index] != h_expected[index])
+      {
+        fprintf(stderr,"Experiment: %d elements of %d bytes, %d valid elements of %d valid bytes, "
+                "fill %d, %d alignment, %d DMA warps, element %d float %d (chunk %d) is %f not %f\n",
+                num_elmts, elmt_size, valid_elmts, valid_bytes, FILL, ALIGNMENT, DMA_THREADS/WARP_SIZE,
+                r, i, i/chunk_floats, h_odata[index], h_expected[index]);
+        pass = false;
+        break;
+      }
+    }
+  }
+  fprintf(stdout," - %s\n",(pass?"PASS!":"FAIL!"));
+  fflush(stdout);
+
+  CUDA_SAFE_CALL( cudaFree(d_idata));
+  CUDA_SAFE_CALL( cudaFree(d_odata));
+  free(h_idata);
+  free(h_odata);
+  free(h_expected);
+
+  return pass;
+}
+
+// Run the single and two-phase variants of a configuration
+template<bool SPECIALIZED, int ALIGNMENT, int BYTES_PER_THREAD, int FILL, int DMA_THREADS>
+__host__ bool run_all(int elmt_size, int num_elmts, int valid_elmts, int valid_bytes, bool use_mask)
+{
+  const char *fill_names[] = { "zero", "clamp", "mirror" };
+  for (int phases = 1; phases <= 2; phases++)
+  {
+    fprintf(stdout,"  %s %-6s%s ALIGNMENT-%2d BYTES_PER_THREAD-%3d ELMT_SIZE-%4d ELMTS-%3d VALID-%3dx%4d "
+            "DMA_WARPS-%2d %s-phase", (SPECIALIZED ? "Warp-Specialized    " : "Non-Warp-Specialized"),
+            fill_names[FILL], (use_mask ? " masked" : "       "), ALIGNMENT, BYTES_PER_THREAD, elmt_size,
+            num_elmts, valid_elmts, valid_bytes, DMA_THREADS/WARP_SIZE, (phases == 1 ? "single" : "two"));
+    if (!run_experiment<SPECIALIZED,ALIGNMENT,BYTES_PER_THREAD,FILL,DMA_THREADS>(
+                        elmt_size, num_elmts, valid_elmts, valid_bytes, use_mask, (phases == 1)))
+      return false;
+  }
+  return true;
+}
+
+#define RUN(SPECIALIZED,ALIGNMENT,BYTES_PER_THREAD,FILL,DMA_THREADS,ELMT_SIZE,ELMTS,VALID_ELMTS,VALID_BYTES,MASK) \
+  if (!run_all<SPECIALIZED,ALIGNMENT,BYTES_PER_THREAD,FILL,DMA_THREADS>(                              \
+               ELMT_SIZE,ELMTS,VALID_ELMTS,VALID_BYTES,MASK))                                         \
+    return false;
+
+__host__
+int main()
+{
+  srand(29);
+  fprintf(stdout,"Running all experiments for masked strided transfers\n");
+  // Interior tiles
+  RUN(true, 16, 64,FILL_ZERO,  64,256, 32, 32,256,false)
+  RUN(false, 4, 16,FILL_ZERO,  96, 68, 20, 20, 68,false)
+  // Right and bottom edges
+  RUN(true, 16, 32,FILL_ZERO,  64,256, 32, 20,144,false)
+  RUN(false, 8, 16,FILL_ZERO, 128,128, 40,  7, 56,false)
+  RUN(true,  4,  8,FILL_CLAMP, 32, 72, 24, 17, 40,false)
+  RUN(false,16, 64,FILL_CLAMP, 64,512, 16,  3, 96,false)
+  RUN(true,  4, 16,FILL_MIRROR,64,128, 36, 30,100,false)
+  RUN(false, 8, 32,FILL_MIRROR,96, 64, 64, 20,  8,false)
+  // Tiles entirely outside of the source
+  RUN(true,  8, 16,FILL_CLAMP, 32, 64, 10,  0,  0,false)
+  RUN(false, 4,  8,FILL_MIRROR,64, 32, 12, 12,  0,false)
+  // Per element masks
+  RUN(true, 16, 32,FILL_ZERO,  64,128, 64, 64,128,true)
+  RUN(false, 4, 16,FILL_CLAMP, 96, 48, 50, 40, 24,true)
+  RUN(true,  8,  8,FILL_MIRROR,32, 40, 64, 60, 32,true)
+  fprintf(stdout,"All experiments passed\n");
+  return true;
+}
@@ -0,0 +1,305 @@
+/*
+ *  Copyright 2013 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/* Software DMA project
+*
+* Host code.
+*/
+
+// includes, system
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <assert.h>
+#include <math.h>
+
+#ifdef __CUDACC__
+#include "cuda.h"
+#include "cuda_runtime.h"
+#endif
+
+#include "cudaDMAv2.h"
+
+#define WARP_SIZE 32
+
+#define CUDA_SAFE_CALL(x)					\
+	{							\
+		cudaError_t err = (x);				\
+		if (err != cudaSuccess)				\
+		{						\
+			printf("Cuda error: %s\n", cudaGetErrorString(err));	\
+			exit(false);				\
+		}						\
+	}
+
+// Tiles of 32 rows of 32 floats without padding, 16 byte chunks of each
+// row are XOR-ed with the row index modulo 8
+#define TILE_ROWS 32
+#define TILE_COLS 32
+#define SRC_STRIDE 40
+typedef CudaDMASwizzle<3,4,7> Swizzle;
+
+enum Pattern {
+  SEQUENTIAL_PATTERN,
+  STRIDED_PATTERN,
+  INDIRECT_PATTERN,
+};
+
+// Copy the tile out of shared memory twice: logically through the
+// swizzle and physically as it is laid out in shared memory
+__device__ void copy_out(const float *tile, float *logical, float *physical, int first, int stride)
+{
+  for (int index = first; index < (TILE_ROWS*TILE_COLS); index += stride)
+  {
+    logical[index] = *Swizzle::apply(&tile[index]);
+    physical[index] = tile[index];
+  }
+}
+
+template<int PATTERN, int ALIGNMENT, int DMA_THREADS>
+__global__ void __launch_bounds__(1024,1)
+special_xfer_swizzle( float *idata, int *offsets, float *logical, float *physical,
+                      int num_compute_threads, const bool single)
+{
+  CUDADMA_EXTERN_SHARED(float, buffer);
+  const int STORE = Swizzle::Store<STORE_WRITE_BACK>::qual;
+
+  CudaDMASequential<true,ALIGNMENT,4*ALIGNMENT,TILE_ROWS*TILE_COLS*sizeof(float),DMA_THREADS>
+    dma_seq (1, num_compute_threads, num_compute_threads);
+  CudaDMAStrided<true,ALIGNMENT,4*ALIGNMENT,TILE_COLS*sizeof(float),DMA_THREADS,TILE_ROWS>
+    dma_str (2, num_compute_threads, num_compute_threads,
+             SRC_STRIDE*sizeof(float), TILE_COLS*sizeof(float));
+  CudaDMAIndirect<true,true,ALIGNMENT,4*ALIGNMENT,TILE_COLS*sizeof(float),DMA_THREADS,TILE_ROWS>
+    dma_ind (3, num_compute_threads, num_compute_threads);
+
+  if (int(threadIdx.x) >= num_compute_threads)
+  {
+    switch (PATTERN)
+    {
+      case SEQUENTIAL_PATTERN:
+        if (single)
+          dma_seq.template execute_dma<true,LOAD_CACHE_ALL,STORE>(idata, buffer);
+        else
+        {
+          dma_seq.template start_xfer_async<true,LOAD_CACHE_ALL,STORE>(idata);
+          dma_seq.template wait_xfer_finish<true,LOAD_CACHE_ALL,STORE>(buffer);
+        }
+        break;
+      case STRIDED_PATTERN:
+        if (single)
+          dma_str.template execute_dma<true,LOAD_CACHE_ALL,STORE>(idata, buffer);
+        else
+        {
+          dma_str.template start_xfer_async<true,LOAD_CACHE_ALL,STORE>(idata);
+          dma_str.template wait_xfer_finish<true,LOAD_CACHE_ALL,STORE>(buffer);
+        }
+        break;
+      case INDIRECT_PATTERN:
+        if (single)
+          dma_ind.template execute_dma<true,LOAD_CACHE_ALL,STORE>(offsets, idata, buffer);
+        else
+        {
+          dma_ind.template start_xfer_async<true,LOAD_CACHE_ALL,STORE>(offsets, idata);
+          dma_ind.template wait_xfer_finish<true,LOAD_CACHE_ALL,STORE>(buffer);
+        }
+        break;
+    }
+  }
+  else
+  {
+    switch (PATTERN)
+    {
+      case SEQUENTIAL_PATTERN:
+        dma_seq.start_async_dma();
+        dma_seq.wait_for_dma_finish();
+        break;
+      case STRIDED_PATTERN:
+        dma_str.start_async_dma();
+        dma_str.wait_for_dma_finish();
+        break;
+      case INDIRECT_PATTERN:
+        dma_ind.start_async_dma();
+        dma_ind.wait_for_dma_finish();
+        break;
+    }
+    copy_out(buffer, logical, physical, threadIdx.x, num_compute_threads);
+  }
+}
+
+template<int PATTERN, int ALIGNMENT, int DMA_THREADS>
+__global__ void __launch_bounds__(1024,1)
+nonspec_xfer_swizzle( float *idata, int *offsets, float *logical, float *physical, const bool single)
+{
+  CUDADMA_EXTERN_SHARED(float, buffer);
+  const int STORE = Swizzle::Store<STORE_CACHE_STREAMING>::qual;
+
+  CudaDMASequential<false,ALIGNMENT,4*ALIGNMENT,TILE_ROWS*TILE_COLS*sizeof(float),DMA_THREADS> dma_seq;
+  CudaDMAStrided<false,ALIGNMENT,4*ALIGNMENT,TILE_COLS*sizeof(float),DMA_THREADS,TILE_ROWS>
+    dma_str (SRC_STRIDE*sizeof(float), TILE_COLS*sizeof(float));
+  CudaDMAIndirect<true,false,ALIGNMENT,4*ALIGNMENT,TILE_COLS*sizeof(float),DMA_THREADS,TILE_ROWS> dma_ind;
+
+  switch (PATTERN)
+  {
+    case SEQUENTIAL_PATTERN:
+      if (single)
+        dma_seq.template execute_dma<true,LOAD_CACHE_ALL,STORE>(idata, buffer);
+      else
+      {
+        dma_seq.template start_xfer_async<true,LOAD_CACHE_ALL,STORE>(idata);
+        dma_seq.template wait_xfer_finish<true,LOAD_CACHE_ALL,STORE>(buffer);
+      }
+      break;
+    case STRIDED_PATTERN:
+      if (single)
+        dma_str.template execute_dma<true,LOAD_CACHE_ALL,STORE>(idata, buffer);
+      else
+      {
+        dma_str.template start_xfer_async<true,LOAD_CACHE_ALL,STORE>(idata);
+        dma_str.template wait_xfer_finish<true,LOAD_CACHE_ALL,STORE>(buffer);
+      }
+      break;
+    case INDIRECT_PATTERN:
+      if (single)
+        dma_ind.template execute_dma<true,LOAD_CACHE_ALL,STORE>(offsets, idata, buffer);
+      else
+      {
+        dma_ind.template start_xfer_async<true,LOAD_CACHE_ALL,STORE>(offsets, idata);
+        dma_ind.template wait_xfer_finish<true,LOAD_CACHE_ALL,STORE>(buffer);
+      }
+      break;
+  }
+  __syncthreads();
+  copy_out(buffer, logical, physical, threadIdx.x, blockDim.x);
+}
+
+template<bool SPECIALIZED, int PATTERN, int ALIGNMENT, int DMA_THREADS>
+__host__ bool run_experiment(bool single)
+{
+  const int tile_size = TILE_ROWS*TILE_COLS;
+  const int input_size = TILE_ROWS*SRC_STRIDE;
+  float *h_idata = (float*)malloc(input_size*sizeof(float));
+  for (int i=0; i<input_size; i++)
+    h_idata[i] = float(i+1);
+  // Gather the rows in reverse order
+  int h_offsets[TILE_ROWS];
+  for (int i=0; i<TILE_ROWS; i++)
+    h_offsets[i] = TILE_ROWS-1-i;
+  float *d_idata, *d_logical, *d_physical;
+  int *d_offsets;
+  CUDA_SAFE_CALL( cudaMalloc( (void**)&d_idata, input_size*sizeof(float)));
+  CUDA_SAFE_CALL( cudaMemcpy( d_idata, h_idata, input_size*sizeof(float), cudaMemcpyHostToDevice));
+  CUDA_SAFE_CALL( cudaMalloc( (void**)&d_offsets, TILE_ROWS*sizeof(int)));
+  CUDA_SAFE_CALL( cudaMemcpy( d_offsets, h_offsets, TILE_ROWS*sizeof(int), cudaMemcpyHostToDevice));
+  CUDA_SAFE_CALL( cudaMalloc( (void**)&d_logical, tile_size*sizeof(float)));
+  CUDA_SAFE_CALL( cudaMalloc( (void**)&d_physical, tile_size*sizeof(float)));
+
+  const int num_compute_threads = WARP_SIZE;
+  if (SPECIALIZED)
+  {
+    CUDADMA_LAUNCH(1,num_compute_threads+DMA_THREADS,tile_size*sizeof(float),0,special_xfer_swizzle<PATTERN,ALIGNMENT,DMA_THREADS>)
+      (d_idata, d_offsets, d_logical, d_physical, num_compute_threads, single);
+  }
+  else
+  {
+    CUDADMA_LAUNCH(1,DMA_THREADS,tile_size*sizeof(float),0,nonspec_xfer_swizzle<PATTERN,ALIGNMENT,DMA_THREADS>)
+      (d_idata, d_offsets, d_logical, d_physical, single);
+  }
+  CUDA_SAFE_CALL( cudaGetLastError());
+  CUDA_SAFE_CALL( cudaThreadSynchronize());
+
+  float *h_logical = (float*)malloc(tile_size*sizeof(float));
+  float *h_physical = (float*)malloc(tile_size*sizeof(float));
+  CUDA_SAFE_CALL( cudaMemcpy (h_logical, d_logical, tile_size*sizeof(float), cudaMemcpyDeviceToHost));
+  CUDA_SAFE_CALL( cudaMemcpy (h_physical, d_physical, tile_size*sizeof(float), cudaMemcpyDeviceToHost));
+
+  bool pass = true;
+  for (int r = 0; (r < TILE_ROWS) && pass; r++)
+  {
+    for (int c = 0; c < TILE_COLS; c++)
+    {
+      float expected;
+      switch (PATTERN)
+      {
+        case SEQUENTIAL_PATTERN:
+          expected = h_idata[r*TILE_COLS + c];
+          break;
+        case STRIDED_PATTERN:
+          expected = h_idata[r*SRC_STRIDE + c];
+          break;
+        default:
+          expected = h_idata[h_offsets[r]*TILE_COLS + c];
+          break;
+      }
+      // 4 floats per chunk, 8 chunks per row
+      const int swizzled = c ^ ((r%8)*4);
+      if ((h_logical[r*TILE_COLS + c] != expected) || (h_physical[r*TILE_COLS + swizzled] != expected))
+      {
+        fprintf(stderr,"Experiment: pattern %d, %d alignment, %d DMA warps, element (%d,%d) was expecting %f "
+                "but received %f logically and %f physically\n", PATTERN, ALIGNMENT, DMA_THREADS/WARP_SIZE,
+                r, c, expected, h_logical[r*TILE_COLS + c], h_physical[r*TILE_COLS + swizzled]);
+        pass = false;
+        break;
+      }
+    }
+  }
+  fprintf(stdout," - %s\n",(pass?"PASS!":"FAIL!"));
+  fflush(stdout);
+
+  CUDA_SAFE_CALL( cudaFree(d_idata));
+  CUDA_SAFE_CALL( cudaFree(d_offsets));
+  CUDA_SAFE_CALL( cudaFree(d_logical));
+  CUDA_SAFE_CALL( cudaFree(d_physical));
+  free(h_idata);
+  free(h_logical);
+  free(h_physical);
+  return pass;
+}
+
+template<bool SPECIALIZED, int PATTERN, int ALIGNMENT, int DMA_THREADS>
+__host__ bool run_all(void)
+{
+  const char *names[] = { "Sequential", "Strided", "Indirect" };
+  for (int phases = 1; phases <= 2; phases++)
+  {
+    fprintf(stdout,"  %s %-10s ALIGNMENT-%2d DMA_WARPS-%2d %s-phase",
+            (SPECIALIZED ? "Warp-Specialized    " : "Non-Warp-Specialized"), names[PATTERN],
+            ALIGNMENT, DMA_THREADS/WARP_SIZE, (phases == 1 ? "single" : "two"));
+    if (!run_experiment<SPECIALIZED,PATTERN,ALIGNMENT,DMA_THREADS>(phases == 1))
+      return false;
+  }
+  return true;
+}
+
+#define RUN(SPECIALIZED,PATTERN,ALIGNMENT,DMA_THREADS)                                              \
+  if (!run_all<SPECIALIZED,PATTERN,ALIGNMENT,DMA_THREADS>())                                        \
+    return false;
+
+__host__
+int main()
+{
+  fprintf(stdout,"Running all experiments for swizzled stores\n");
+  RUN(true, SEQUENTIAL_PATTERN,16,128)
+  RUN(true, STRIDED_PATTERN,   16,128)
+  RUN(true, INDIRECT_PATTERN,  16,128)
+  RUN(true, STRIDED_PATTERN,    8, 64)
+  RUN(true, INDIRECT_PATTERN,   4, 96)
+  RUN(false,SEQUENTIAL_PATTERN, 8,256)
+  RUN(false,STRIDED_PATTERN,   16, 96)
+  RUN(false,INDIRECT_PATTERN,  16,128)
+  RUN(false,STRIDED_PATTERN,    4, 64)
+  fprintf(stdout,"All experiments passed\n");
+  return true;
+}
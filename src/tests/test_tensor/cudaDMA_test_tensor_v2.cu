@@ -0,0 +1,389 @@
+/*
+ *  Copyright 2013 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/* Software DMA project
+*
+* Host code.
+*/
+
+// includes, system
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <assert.h>
+#include <math.h>
+
+#ifdef __CUDACC__
+#include "cuda.h"
+#include "cuda_runtime.h"
+#endif
+
+#include "cudaDMAv2.h"
+
+#define WARP_SIZE 32
+#define MAX_OUTER 4
+
+#define CUDA_SAFE_CALL(x)					\
+	{							\
+		cudaError_t err = (x);				\
+		if (err != cudaSuccess)				\
+		{						\
+			printf("Cuda error: %s\n", cudaGetErrorString(err));	\
+			exit(false);				\
+		}						\
+	}
+
+// Extents and byte strides of the outer dimensions of a tile,
+// passed by value so the kernels can hand them to the constructors
+struct Shape {
+  int extents[MAX_OUTER];
+  int src_strides[MAX_OUTER];
+  int dst_strides[MAX_OUTER];
+};
+
+template<typename DMA>
+__device__ void special_transfer(DMA &dma0, float *idata, float *odata, int src_offset,
+                                 int num_compute_threads, int buffer_size, const bool single, const bool qualified)
+{
+  CUDADMA_EXTERN_SHARED(float, buffer);
+  if (dma0.owns_this_thread())
+  {
+    float *base_ptr = &(idata[src_offset]);
+    if (single)
+    {
+      if (qualified)
+        dma0.template execute_dma<true,LOAD_CACHE_GLOBAL,STORE_CACHE_GLOBAL>(base_ptr, buffer);
+      else
+        dma0.execute_dma(base_ptr, buffer);
+    }
+    else
+    {
+      if (qualified)
+      {
+        dma0.template start_xfer_async<true,LOAD_CACHE_GLOBAL,STORE_CACHE_STREAMING>(base_ptr);
+        dma0.template wait_xfer_finish<true,LOAD_CACHE_GLOBAL,STORE_CACHE_STREAMING>(buffer);
+      }
+      else
+      {
+        dma0.start_xfer_async(base_ptr);
+        dma0.wait_xfer_finish(buffer);
+      }
+    }
+  }
+  else
+  {
+    for (int index = threadIdx.x; index < buffer_size; index += num_compute_threads)
+      buffer[index] = 0.0f;
+    dma0.start_async_dma();
+    dma0.wait_for_dma_finish();
+    for (int index = threadIdx.x; index < buffer_size; index += num_compute_threads)
+      odata[index] = buffer[index];
+  }
+}
+
+template<typename DMA>
+__device__ void nonspec_transfer(DMA &dma0, float *idata, float *odata, int src_offset,
+                                 int buffer_size, const bool single, const bool qualified)
+{
+  CUDADMA_EXTERN_SHARED(float, buffer);
+  for (int index = threadIdx.x; index < buffer_size; index += blockDim.x)
+    buffer[index] = 0.0f;
+  __syncthreads();
+  // Perform the transfer
+  float *base_ptr = &(idata[src_offset]);
+  if (single)
+  {
+    if (qualified)
+      dma0.template execute_dma<true,LOAD_CACHE_LAST_USE,STORE_CACHE_GLOBAL>(base_ptr, buffer);
+    else
+      dma0.execute_dma(base_ptr, buffer);
+  }
+  else
+  {
+    if (qualified)
+    {
+      dma0.template start_xfer_async<true,LOAD_CACHE_LAST_USE,STORE_CACHE_STREAMING>(base_ptr);
+      dma0.template wait_xfer_finish<true,LOAD_CACHE_LAST_USE,STORE_CACHE_STREAMING>(buffer);
+    }
+    else
+    {
+      dma0.start_xfer_async(base_ptr);
+      dma0.wait_xfer_finish(buffer);
+    }
+  }
+  __syncthreads();
+  for (int index = threadIdx.x; index < buffer_size; index += blockDim.x)
+    odata[index] = buffer[index];
+}
+
+template<int ALIGNMENT, int BYTES_PER_THREAD, int DIMS, int BYTES_PER_ROW, int DMA_THREADS>
+__global__ void __launch_bounds__(1024,1)
+special_xfer_three( float *idata, float *odata, int src_offset, Shape shape,
+                    int num_compute_threads, int buffer_size, const bool single, const bool qualified)
+{
+  CudaDMATensor<true,ALIGNMENT,BYTES_PER_THREAD,DIMS,BYTES_PER_ROW,DMA_THREADS>
+    dma0 (1, num_compute_threads, num_compute_threads,
+          shape.extents, shape.src_strides, shape.dst_strides);
+  special_transfer(dma0, idata, odata, src_offset, num_compute_threads, buffer_size, single, qualified);
+}
+
+template<int ALIGNMENT, int BYTES_PER_THREAD, int DIMS, int BYTES_PER_ROW>
+__global__ void __launch_bounds__(1024,1)
+special_xfer_two( float *idata, float *odata, int src_offset, Shape shape, int num_compute_threads,
+                  int num_dma_threads, int buffer_size, const bool single, const bool qualified)
+{
+  CudaDMATensor<true,ALIGNMENT,BYTES_PER_THREAD,DIMS,BYTES_PER_ROW>
+    dma0 (1, num_dma_threads, num_compute_threads, num_compute_threads,
+          shape.extents, shape.src_strides, shape.dst_strides);
+  special_transfer(dma0, idata, odata, src_offset, num_compute_threads, buffer_size, single, qualified);
+}
+
+template<int ALIGNMENT, int BYTES_PER_THREAD, int DIMS>
+__global__ void __launch_bounds__(1024,1)
+special_xfer_one( float *idata, float *odata, int src_offset, Shape shape, int num_compute_threads,
+                  int num_dma_threads, int bytes_per_row, int buffer_size, const bool single, const bool qualified)
+{
+  CudaDMATensor<true,ALIGNMENT,BYTES_PER_THREAD,DIMS>
+    dma0 (1, num_dma_threads, num_compute_threads, num_compute_threads, bytes_per_row,
+          shape.extents, shape.src_strides, shape.dst_strides);
+  special_transfer(dma0, idata, odata, src_offset, num_compute_threads, buffer_size, single, qualified);
+}
+
+template<int ALIGNMENT, int BYTES_PER_THREAD, int DIMS, int BYTES_PER_ROW, int DMA_THREADS>
+__global__ void __launch_bounds__(1024,1)
+nonspec_xfer_three( float *idata, float *odata, int src_offset, Shape shape,
+                    int buffer_size, const bool single, const bool qualified)
+{
+  CudaDMATensor<false,ALIGNMENT,BYTES_PER_THREAD,DIMS,BYTES_PER_ROW,DMA_THREADS>
+    dma0 (shape.extents, shape.src_strides, shape.dst_strides);
+  nonspec_transfer(dma0, idata, odata, src_offset, buffer_size, single, qualified);
+}
+
+template<int ALIGNMENT, int BYTES_PER_THREAD, int DIMS, int BYTES_PER_ROW>
+__global__ void __launch_bounds__(1024,1)
+nonspec_xfer_two( float *idata, float *odata, int src_offset, Shape shape,
+                  int buffer_size, const bool single, const bool qualified)
+{
+  CudaDMATensor<false,ALIGNMENT,BYTES_PER_THREAD,DIMS,BYTES_PER_ROW>
+    dma0 (shape.extents, shape.src_strides, shape.dst_strides);
+  nonspec_transfer(dma0, idata, odata, src_offset, buffer_size, single, qualified);
+}
+
+template<int ALIGNMENT, int BYTES_PER_THREAD, int DIMS>
+__global__ void __launch_bounds__(1024,1)
+nonspec_xfer_one( float *idata, float *odata, int src_offset, Shape shape, int bytes_per_row,
+                  int buffer_size, const bool single, const bool qualified)
+{
+  CudaDMATensor<false,ALIGNMENT,BYTES_PER_THREAD,DIMS>
+    dma0 (bytes_per_row, shape.extents, shape.src_strides, shape.dst_strides);
+  nonspec_transfer(dma0, idata, odata, src_offset, buffer_size, single, qualified);
+}
+
+// Round a number of floats up to a multiple of the alignment
+template<int ALIGNMENT>
+__host__ int align_floats(int floats)
+{
+  const int step = ALIGNMENT/sizeof(float);
+  return ((floats + step - 1)/step)*step;
+}
+
+// The tile is cut out of a larger tensor with padded dimensions and stored
+// in shared memory with its outer dimensions in the reverse order, so the
+// destination strides are not increasing
+template<bool SPECIALIZED, int ALIGNMENT, int BYTES_PER_THREAD, int DIMS, int BYTES_PER_ROW, int DMA_THREADS>
+__host__ bool run_experiment(const int *extents, int num_templates, bool single, bool qualified)
+{
+  const int outer = DIMS-1;
+  const int row_floats = BYTES_PER_ROW/sizeof(float);
+  Shape shape;
+  int src_size = align_floats<ALIGNMENT>(row_floats + 3);
+  int dst_size = row_floats;
+  int elmts = 1;
+  for (int d = 0; d < outer; d++)
+  {
+    shape.extents[d] = extents[d];
+    shape.src_strides[d] = src_size*sizeof(float);
+    src_size *= (extents[d] + 1);
+    elmts *= extents[d];
+  }
+  for (int d = outer-1; d >= 0; d--)
+  {
+    shape.dst_strides[d] = dst_size*sizeof(float);
+    dst_size *= extents[d];
+  }
+  const int src_offset = align_floats<ALIGNMENT>(7);
+  const int input_size = src_offset + src_size;
+  const int buffer_size = dst_size;
+  if ((buffer_size*sizeof(float)) > 49152)
+  {
+    fprintf(stdout," - PASS!\n");
+    fflush(stdout);
+    return true;
+  }
+
+  float *h_idata = (float*)malloc(input_size*sizeof(float));
+  for (int i=0; i<input_size; i++)
+    h_idata[i] = float(i+1);
+  float *d_idata;
+  CUDA_SAFE_CALL( cudaMalloc( (void**)&d_idata, input_size*sizeof(float)));
+  CUDA_SAFE_CALL( cudaMemcpy( d_idata, h_idata, input_size*sizeof(float), cudaMemcpyHostToDevice));
+
+  float *h_odata = (float*)malloc(buffer_size*sizeof(float));
+  for (int i=0; i<buffer_size; i++)
+    h_odata[i] = 0.0f;
+  float *d_odata;
+  CUDA_SAFE_CALL( cudaMalloc( (void**)&d_odata, buffer_size*sizeof(float)));
+  CUDA_SAFE_CALL( cudaMemcpy( d_odata, h_odata, buffer_size*sizeof(float), cudaMemcpyHostToDevice));
+
+  const int num_compute_threads = WARP_SIZE;
+  const int total_threads = (SPECIALIZED ? (num_compute_threads + DMA_THREADS) : DMA_THREADS);
+  const size_t shared = buffer_size*sizeof(float);
+  switch (num_templates)
+  {
+  case 1:
+    if (SPECIALIZED)
+    {
+      CUDADMA_LAUNCH(1,total_threads,shared,0,special_xfer_one<ALIGNMENT,BYTES_PER_THREAD,DIMS>)
+        (d_idata, d_odata, src_offset, shape, num_compute_threads, DMA_THREADS, BYTES_PER_ROW,
+         buffer_size, single, qualified);
+    }
+    else
+    {
+      CUDADMA_LAUNCH(1,total_threads,shared,0,nonspec_xfer_one<ALIGNMENT,BYTES_PER_THREAD,DIMS>)
+        (d_idata, d_odata, src_offset, shape, BYTES_PER_ROW, buffer_size, single, qualified);
+    }
+    break;
+  case 2:
+    if (SPECIALIZED)
+    {
+      CUDADMA_LAUNCH(1,total_threads,shared,0,special_xfer_two<ALIGNMENT,BYTES_PER_THREAD,DIMS,BYTES_PER_ROW>)
+        (d_idata, d_odata, src_offset, shape, num_compute_threads, DMA_THREADS, buffer_size, single, qualified);
+    }
+    else
+    {
+      CUDADMA_LAUNCH(1,total_threads,shared,0,nonspec_xfer_two<ALIGNMENT,BYTES_PER_THREAD,DIMS,BYTES_PER_ROW>)
+        (d_idata, d_odata, src_offset, shape, buffer_size, single, qualified);
+    }
+    break;
+  case 3:
+    if (SPECIALIZED)
+    {
+      CUDADMA_LAUNCH(1,total_threads,shared,0,special_xfer_three<ALIGNMENT,BYTES_PER_THREAD,DIMS,BYTES_PER_ROW,DMA_THREADS>)
+        (d_idata, d_odata, src_offset, shape, num_compute_threads, buffer_size, single, qualified);
+    }
+    else
+    {
+      CUDADMA_LAUNCH(1,total_threads,shared,0,nonspec_xfer_three<ALIGNMENT,BYTES_PER_THREAD,DIMS,BYTES_PER_ROW,DMA_THREADS>)
+        (d_idata, d_odata, src_offset, shape, buffer_size, single, qualified);
+    }
+    break;
+  default:
+    assert(false);
+    break;
+  }
+  CUDA_SAFE_CALL( cudaGetLastError());
+  CUDA_SAFE_CALL( cudaThreadSynchronize());
+
+  CUDA_SAFE_CALL( cudaMemcpy (h_odata, d_odata, buffer_size*sizeof(float), cudaMemcpyDeviceToHost));
+
+  // Walk every row of the tile, the destination is packed so every
+  // cell of the buffer has to be written exactly once
+  bool pass = true;
+  for (int e = 0; (e < elmts) && pass; e++)
+  {
+    int src = src_offset, dst = 0, rest = e;
+    for (int d = 0; d < outer; d++)
+    {
+      src += (rest%extents[d])*shape.src_strides[d]/sizeof(float);
+      dst += (rest%extents[d])*shape.dst_strides[d]/sizeof(float);
+      rest /= extents[d];
+    }
+    for (int i = 0; i < row_floats; i++)
+    {
+      if (h_idata[src+i] != h_odata[dst+i])
+      {
+        fprintf(stderr,"Experiment: %d dimensions, %d bytes per row, %d alignment, %d bytes per thread, %d DMA warps, %d templates, ",
+                DIMS, BYTES_PER_ROW, ALIGNMENT, BYTES_PER_THREAD, DMA_THREADS/WARP_SIZE, num_templates);
+        fprintf(stderr,"index %d of row %d was expecting %f but received %f\n", i, e, h_idata[src+i], h_odata[dst+i]);
+        pass = false;
+        break;
+      }
+    }
+  }
+  fprintf(stdout," - %s\n",(pass?"PASS!":"FAIL!"));
+  fflush(stdout);
+
+  CUDA_SAFE_CALL( cudaFree(d_idata));
+  CUDA_SAFE_CALL( cudaFree(d_odata));
+  free(h_idata);
+  free(h_odata);
+
+  return pass;
+}
+
+// Run every templating level and the single/two-phase and unqualified/qualified variants
+template<bool SPECIALIZED, int ALIGNMENT, int BYTES_PER_THREAD, int DIMS, int BYTES_PER_ROW, int DMA_THREADS>
+__host__ bool run_all(int e0, int e1 = 1, int e2 = 1, int e3 = 1)
+{
+  const int extents[MAX_OUTER] = { e0, e1, e2, e3 };
+  for (int num_templates = 1; num_templates <= 3; num_templates++)
+  {
+    for (int phases = 1; phases <= 2; phases++)
+    {
+      for (int qualified = 0; qualified < 2; qualified++)
+      {
+        fprintf(stdout,"  %s ALIGNMENT-%2d BYTES_PER_THREAD-%3d DIMS-%d BYTES_PER_ROW-%4d DMA_WARPS-%2d Templates-%d %s-phase %s",
+                (SPECIALIZED ? "Warp-Specialized    " : "Non-Warp-Specialized"), ALIGNMENT, BYTES_PER_THREAD,
+                DIMS, BYTES_PER_ROW, DMA_THREADS/WARP_SIZE, num_templates, (phases == 1 ? "single" : "two"),
+                (qualified ? "qualified  " : "unqualified"));
+        if (!run_experiment<SPECIALIZED,ALIGNMENT,BYTES_PER_THREAD,DIMS,BYTES_PER_ROW,DMA_THREADS>(extents,
+                                                      num_templates, (phases == 1), (qualified != 0)))
+          return false;
+      }
+    }
+  }
+  return true;
+}
+
+#define RUN(SPECIALIZED,ALIGNMENT,BYTES_PER_THREAD,DIMS,BYTES_PER_ROW,DMA_THREADS,...)                \
+  if (!run_all<SPECIALIZED,ALIGNMENT,BYTES_PER_THREAD,DIMS,BYTES_PER_ROW,DMA_THREADS>(__VA_ARGS__))  \
+    return false;
+
+__host__
+int main()
+{
+  fprintf(stdout,"Running all experiments for CudaDMATensor\n");
+  // Two dimensions, the same as CudaDMAStrided
+  RUN(true, 16, 64,2,128, 64, 24)
+  RUN(false, 8, 32,2, 40, 96, 17)
+  // Attention and convolution style 4-D tiles
+  RUN(true, 16, 64,4, 64,128, 4, 3, 5)
+  RUN(false,16, 64,4, 64,128, 4, 3, 5)
+  RUN(true,  4, 16,3, 12, 64, 7, 6)
+  RUN(false, 4, 16,3, 12, 64, 7, 6)
+  RUN(true,  8, 32,5, 16, 32, 3, 2, 4, 3)
+  RUN(false, 8, 32,5, 16, 96, 3, 2, 4, 3)
+  // Many steps per thread
+  RUN(true,  4,  4,4, 20, 32, 5, 4, 6)
+  // More threads than chunks in the tile
+  RUN(true, 16, 16,3, 32,256, 2, 2)
+  RUN(false, 4,  8,5,  4,128, 1, 2, 1, 3)
+  // Empty tiles move nothing
+  RUN(true, 16, 64,3, 64, 64, 4, 0)
+  RUN(false, 8, 32,4, 48, 96, 0, 3, 2)
+  fprintf(stdout,"All experiments passed\n");
+  return true;
+}
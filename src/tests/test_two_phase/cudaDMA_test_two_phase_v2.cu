@@ -0,0 +1,299 @@
+/*
+ *  Copyright 2013 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/* Software DMA project
+*
+* Host code.
+*/
+
+// includes, system
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <assert.h>
+#include <math.h>
+
+#ifdef __CUDACC__
+#include "cuda.h"
+#include "cuda_runtime.h"
+#endif
+
+#include "cudaDMAv2.h"
+
+#define WARP_SIZE 32
+
+#define CUDA_SAFE_CALL(x)                                                                           \
+	{                                                                                                  \
+		cudaError_t err = (x);                                                                            \
+		if (err != cudaSuccess)                                                                           \
+		{                                                                                                 \
+			printf("Cuda error: %s\n", cudaGetErrorString(err));                                             \
+			exit(false);                                                                                     \
+		}                                                                                                 \
+	}
+// Compute threads release the single buffer for every transfer
+// and copy it out to the slot of the transfer in the output
+template<typename TWO_PHASE>
+__device__ void copy_transfers(TWO_PHASE &two_phase, const float *buffer, float *odata,
+                               int tile_floats, int iterations, int num_compute_threads)
+{
+  for (int it = 0; it < iterations; it++)
+  {
+    two_phase.start_async_dma();
+    two_phase.wait_for_dma_finish();
+    for (int i = threadIdx.x; i < tile_floats; i += num_compute_threads)
+      odata[it*tile_floats + i] = buffer[i];
+  }
+}
+
+template<bool QUALIFIED, int ALIGNMENT, int BYTES_PER_THREAD, int BYTES_PER_ELMT, int DMA_THREADS>
+__global__ void __launch_bounds__(1024,1)
+two_phase_sequential( float *idata, float *odata, int iterations, int src_stride, int num_compute_threads)
+{
+  CUDADMA_EXTERN_SHARED(float4, buffer);
+
+  typedef CudaDMASequential<true,ALIGNMENT,BYTES_PER_THREAD,BYTES_PER_ELMT,DMA_THREADS> DMA;
+  typedef CudaDMATwoPhase<DMA> TwoPhase;
+  TwoPhase two_phase(DMA(1, num_compute_threads, num_compute_threads));
+
+  if (two_phase.owns_this_thread())
+  {
+    const char *src = (const char*)idata;
+    // Keep the loads of two transfers in flight
+    typename TwoPhase::Handle h0(two_phase), h1(two_phase);
+    if (QUALIFIED)
+    {
+      two_phase.template begin_xfer_async<true,LOAD_CACHE_GLOBAL,STORE_WRITE_BACK>(h0, src);
+      if (iterations > 1)
+        two_phase.template begin_xfer_async<true,LOAD_CACHE_GLOBAL,STORE_WRITE_BACK>(h1, src + src_stride);
+      for (int it = 0; it < iterations; it += 2)
+      {
+        two_phase.template commit_xfer_async<true,LOAD_CACHE_GLOBAL,STORE_WRITE_BACK>(h0, buffer);
+        if ((it+2) < iterations)
+          two_phase.template begin_xfer_async<true,LOAD_CACHE_GLOBAL,STORE_WRITE_BACK>(h0,
+                                                                        src + (it+2)*src_stride);
+        if ((it+1) < iterations)
+        {
+          two_phase.template commit_xfer_async<true,LOAD_CACHE_GLOBAL,STORE_WRITE_BACK>(h1, buffer);
+          if ((it+3) < iterations)
+            two_phase.template begin_xfer_async<true,LOAD_CACHE_GLOBAL,STORE_WRITE_BACK>(h1,
+                                                                        src + (it+3)*src_stride);
+        }
+      }
+    }
+    else
+    {
+      two_phase.begin_xfer_async(h0, src);
+      if (iterations > 1)
+        two_phase.begin_xfer_async(h1, src + src_stride);
+      for (int it = 0; it < iterations; it += 2)
+      {
+        two_phase.commit_xfer_async(h0, buffer);
+        if ((it+2) < iterations)
+          two_phase.begin_xfer_async(h0, src + (it+2)*src_stride);
+        if ((it+1) < iterations)
+        {
+          two_phase.commit_xfer_async(h1, buffer);
+          if ((it+3) < iterations)
+            two_phase.begin_xfer_async(h1, src + (it+3)*src_stride);
+        }
+      }
+    }
+  }
+  else
+    copy_transfers(two_phase, (const float*)buffer, odata, int(BYTES_PER_ELMT/sizeof(float)),
+                   iterations, num_compute_threads);
+}
+
+template<bool QUALIFIED, int ALIGNMENT, int BYTES_PER_THREAD, int BYTES_PER_ELMT, int DMA_THREADS,
+         int NUM_ELMTS>
+__global__ void __launch_bounds__(1024,1)
+two_phase_indirect( float *idata, float *odata, int *offsets, int iterations, int num_compute_threads)
+{
+  CUDADMA_EXTERN_SHARED(float4, buffer);
+
+  typedef CudaDMAIndirect<true,true,ALIGNMENT,BYTES_PER_THREAD,BYTES_PER_ELMT,DMA_THREADS,NUM_ELMTS> DMA;
+  typedef CudaDMATwoPhase<DMA> TwoPhase;
+  TwoPhase two_phase(DMA(1, num_compute_threads, num_compute_threads));
+
+  if (two_phase.owns_this_thread())
+  {
+    // Keep the gathers of two transfers in flight
+    typename TwoPhase::Handle h0(two_phase), h1(two_phase);
+    if (QUALIFIED)
+    {
+      two_phase.template begin_xfer_async<true,LOAD_CACHE_GLOBAL,STORE_WRITE_BACK>(h0, offsets, idata);
+      if (iterations > 1)
+        two_phase.template begin_xfer_async<true,LOAD_CACHE_GLOBAL,STORE_WRITE_BACK>(h1,
+                                                                  offsets + NUM_ELMTS, idata);
+      for (int it = 0; it < iterations; it += 2)
+      {
+        two_phase.template commit_xfer_async<true,LOAD_CACHE_GLOBAL,STORE_WRITE_BACK>(h0, buffer);
+        if ((it+2) < iterations)
+          two_phase.template begin_xfer_async<true,LOAD_CACHE_GLOBAL,STORE_WRITE_BACK>(h0,
+                                                          offsets + (it+2)*NUM_ELMTS, idata);
+        if ((it+1) < iterations)
+        {
+          two_phase.template commit_xfer_async<true,LOAD_CACHE_GLOBAL,STORE_WRITE_BACK>(h1, buffer);
+          if ((it+3) < iterations)
+            two_phase.template begin_xfer_async<true,LOAD_CACHE_GLOBAL,STORE_WRITE_BACK>(h1,
+                                                          offsets + (it+3)*NUM_ELMTS, idata);
+        }
+      }
+    }
+    else
+    {
+      two_phase.begin_xfer_async(h0, offsets, idata);
+      if (iterations > 1)
+        two_phase.begin_xfer_async(h1, offsets + NUM_ELMTS, idata);
+      for (int it = 0; it < iterations; it += 2)
+      {
+        two_phase.commit_xfer_async(h0, buffer);
+        if ((it+2) < iterations)
+          two_phase.begin_xfer_async(h0, offsets + (it+2)*NUM_ELMTS, idata);
+        if ((it+1) < iterations)
+        {
+          two_phase.commit_xfer_async(h1, buffer);
+          if ((it+3) < iterations)
+            two_phase.begin_xfer_async(h1, offsets + (it+3)*NUM_ELMTS, idata);
+        }
+      }
+    }
+  }
+  else
+    copy_transfers(two_phase, (const float*)buffer, odata, int(NUM_ELMTS*BYTES_PER_ELMT/sizeof(float)),
+                   iterations, num_compute_threads);
+}
+
+// A sequential transfer moves a single element of every iteration
+template<bool INDIRECT, bool QUALIFIED, int ALIGNMENT, int BYTES_PER_THREAD, int BYTES_PER_ELMT,
+         int DMA_THREADS, int NUM_ELMTS>
+__host__ bool run_experiment(int iterations)
+{
+  // Sequential sources are padded apart, indirect sources are
+  // gathered from a pool of elements in a scrambled order
+  const int src_stride = NUM_ELMTS*BYTES_PER_ELMT + 2*ALIGNMENT;
+  const int pool_elmts = 2*NUM_ELMTS + 3;
+  const int elmt_floats = BYTES_PER_ELMT/sizeof(float);
+  const int tile_floats = NUM_ELMTS*elmt_floats;
+  const int input_size = INDIRECT ? pool_elmts*elmt_floats : iterations*src_stride/sizeof(float);
+  const int output_size = iterations*tile_floats;
+
+  float *h_idata = (float*)malloc(input_size*sizeof(float));
+  for (int i = 0; i < input_size; i++)
+    h_idata[i] = float(i);
+  float *h_odata = (float*)malloc(output_size*sizeof(float));
+  int *h_offsets = (int*)malloc(iterations*NUM_ELMTS*sizeof(int));
+  for (int i = 0; i < iterations*NUM_ELMTS; i++)
+    h_offsets[i] = (7*i + 3) % pool_elmts;
+
+  float *d_idata, *d_odata;
+  int *d_offsets;
+  CUDA_SAFE_CALL( cudaMalloc( (void**)&d_idata, input_size*sizeof(float)));
+  CUDA_SAFE_CALL( cudaMemcpy( d_idata, h_idata, input_size*sizeof(float), cudaMemcpyHostToDevice));
+  CUDA_SAFE_CALL( cudaMalloc( (void**)&d_offsets, iterations*NUM_ELMTS*sizeof(int)));
+  CUDA_SAFE_CALL( cudaMemcpy( d_offsets, h_offsets, iterations*NUM_ELMTS*sizeof(int), cudaMemcpyHostToDevice));
+  CUDA_SAFE_CALL( cudaMalloc( (void**)&d_odata, output_size*sizeof(float)));
+  CUDA_SAFE_CALL( cudaMemset( d_odata, 0, output_size*sizeof(float)));
+
+  const int num_compute_threads = 2*WARP_SIZE;
+  if (INDIRECT)
+    CUDADMA_LAUNCH(1,num_compute_threads+DMA_THREADS,NUM_ELMTS*BYTES_PER_ELMT,0,
+        two_phase_indirect<QUALIFIED,ALIGNMENT,BYTES_PER_THREAD,BYTES_PER_ELMT,DMA_THREADS,NUM_ELMTS>)
+      (d_idata, d_odata, d_offsets, iterations, num_compute_threads);
+  else
+    CUDADMA_LAUNCH(1,num_compute_threads+DMA_THREADS,BYTES_PER_ELMT,0,
+        two_phase_sequential<QUALIFIED,ALIGNMENT,BYTES_PER_THREAD,BYTES_PER_ELMT,DMA_THREADS>)
+      (d_idata, d_odata, iterations, src_stride, num_compute_threads);
+  CUDA_SAFE_CALL( cudaGetLastError());
+  CUDA_SAFE_CALL( cudaThreadSynchronize());
+
+  CUDA_SAFE_CALL( cudaMemcpy (h_odata, d_odata, output_size*sizeof(float), cudaMemcpyDeviceToHost));
+
+  bool pass = true;
+  for (int it = 0; (it < iterations) && pass; it++)
+  {
+    for (int e = 0; (e < NUM_ELMTS) && pass; e++)
+    {
+      const int src_offset = INDIRECT ? h_offsets[it*NUM_ELMTS + e]*elmt_floats
+                                      : it*src_stride/sizeof(float);
+      for (int i = 0; i < elmt_floats; i++)
+      {
+        const float expected = h_idata[src_offset + i];
+        const float actual = h_odata[it*tile_floats + e*elmt_floats + i];
+        if (actual != expected)
+        {
+          fprintf(stderr,"Experiment: %d iterations, %d alignment, %d DMA warps, "
+                  "iteration %d element %d float %d is %f not %f\n", iterations, ALIGNMENT,
+                  DMA_THREADS/WARP_SIZE, it, e, i, actual, expected);
+          pass = false;
+          break;
+        }
+      }
+    }
+  }
+  fprintf(stdout," - %s\n",(pass?"PASS!":"FAIL!"));
+  fflush(stdout);
+
+  CUDA_SAFE_CALL( cudaFree(d_idata));
+  CUDA_SAFE_CALL( cudaFree(d_offsets));
+  CUDA_SAFE_CALL( cudaFree(d_odata));
+  free(h_idata);
+  free(h_offsets);
+  free(h_odata);
+
+  return pass;
+}
+
+// Run a single transfer, an even and an odd number of transfers
+// so that both handles are committed last at least once
+template<bool INDIRECT, bool QUALIFIED, int ALIGNMENT, int BYTES_PER_THREAD, int BYTES_PER_ELMT,
+         int DMA_THREADS, int NUM_ELMTS>
+__host__ bool run_all(void)
+{
+  const int iterations[] = { 1, 2, 6, 7 };
+  for (int i = 0; i < 4; i++)
+  {
+    fprintf(stdout,"  %s %s ALIGNMENT-%2d BYTES_PER_THREAD-%3d BYTES_PER_ELMT-%4d ELMTS-%3d "
+            "DMA_WARPS-%2d ITERATIONS-%d", (INDIRECT ? "Indirect  " : "Sequential"),
+            (QUALIFIED ? "qualified  " : "unqualified"), ALIGNMENT, BYTES_PER_THREAD, BYTES_PER_ELMT,
+            NUM_ELMTS, DMA_THREADS/WARP_SIZE, iterations[i]);
+    if (!run_experiment<INDIRECT,QUALIFIED,ALIGNMENT,BYTES_PER_THREAD,BYTES_PER_ELMT,DMA_THREADS,
+                        NUM_ELMTS>(iterations[i]))
+      return false;
+  }
+  return true;
+}
+
+#define RUN(INDIRECT,QUALIFIED,ALIGNMENT,BYTES_PER_THREAD,BYTES_PER_ELMT,DMA_THREADS,NUM_ELMTS)     \
+  if (!run_all<INDIRECT,QUALIFIED,ALIGNMENT,BYTES_PER_THREAD,BYTES_PER_ELMT,DMA_THREADS,NUM_ELMTS>())\
+    return false;
+
+__host__
+int main()
+{
+  fprintf(stdout,"Running all experiments for two phase transfers\n");
+  RUN(false,false,16, 64,2048, 64, 1)
+  RUN(false,true, 16, 32,4096, 64, 1)
+  RUN(false,false, 8, 16, 776, 96, 1)
+  RUN(false,true,  4, 16, 516, 32, 1)
+  RUN(true, false,16, 64, 128, 64,16)
+  RUN(true, true,  8, 32,  96, 64,20)
+  RUN(true, false, 4, 16,  20, 32,13)
+  RUN(true, true, 16, 32, 256,128, 8)
+  fprintf(stdout,"All experiments passed\n");
+  return true;
+}
@@ -0,0 +1,145 @@
+/*
+ *  Copyright 2013 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*
+ * Ranks ALIGNMENT/BYTES_PER_THREAD/DMA_THREADS choices for a transfer
+ * with the analytical model of cudaDMAModel.h, without compiling any of
+ * them.  Only the top few are worth building and timing on a GPU:
+ *
+ *   autotune sequential|strided|indirect -elmt_size N [options]
+ *     -num_elmts N             elements per transfer (strided/indirect, default 1)
+ *     -alignment N             alignment guaranteed for the pointers and strides (default 16)
+ *     -max_bytes_per_thread N  largest BYTES_PER_THREAD to consider (default 64)
+ *     -max_dma_threads N       largest DMA_THREADS to consider (default 512)
+ *     -ctas N                  CTAs per SM running the transfer at the same time (default 1)
+ *     -latency N               memory latency in cycles
+ *     -bandwidth N             memory bandwidth per SM in bytes per cycle
+ *     -loads_in_flight N       per thread loads an SM can have outstanding
+ *     -top N                   number of candidates to print (default 10)
+ *     -header                  print a params_directed.h for the best candidate instead
+ *     -offset N                PARAM_OFFSET of the header in floats (default 0)
+ *     -rand_seed N             PARAM_RAND_SEED of the header (indirect, default 0)
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "cudaDMAModel.h"
+
+static void usage(const char *prog)
+{
+  fprintf(stderr,"Usage: %s sequential|strided|indirect -elmt_size N [-num_elmts N] [-alignment N]"
+                 " [-max_bytes_per_thread N] [-max_dma_threads N] [-ctas N] [-latency N]"
+                 " [-bandwidth N] [-loads_in_flight N] [-top N] [-header] [-offset N]"
+                 " [-rand_seed N]\n", prog);
+  exit(1);
+}
+
+int main(int argc, char **argv)
+{
+  if (argc < 2)
+    usage(argv[0]);
+  CudaDMAModel::Pattern pattern;
+  if (!strcmp(argv[1],"sequential"))
+    pattern = CudaDMAModel::SEQUENTIAL_PATTERN;
+  else if (!strcmp(argv[1],"strided"))
+    pattern = CudaDMAModel::STRIDED_PATTERN;
+  else if (!strcmp(argv[1],"indirect"))
+    pattern = CudaDMAModel::INDIRECT_PATTERN;
+  else
+    usage(argv[0]);
+  CudaDMAModel::SearchSpace space;
+  CudaDMAModel::Machine machine;
+  int elmt_size = 0, num_elmts = 1, ctas = 1, top = 10;
+  int offset = 0, rand_seed = 0;
+  bool header = false;
+  for (int i = 2; i < argc; i++)
+  {
+    if (!strcmp(argv[i],"-header"))
+    {
+      header = true;
+      continue;
+    }
+    if ((i+1) == argc)
+      usage(argv[0]);
+    if (!strcmp(argv[i],"-elmt_size"))
+      elmt_size = atoi(argv[++i]);
+    else if (!strcmp(argv[i],"-num_elmts"))
+      num_elmts = atoi(argv[++i]);
+    else if (!strcmp(argv[i],"-alignment"))
+      space.max_alignment = atoi(argv[++i]);
+    else if (!strcmp(argv[i],"-max_bytes_per_thread"))
+      space.max_bytes_per_thread = atoi(argv[++i]);
+    else if (!strcmp(argv[i],"-max_dma_threads"))
+      space.max_dma_threads = atoi(argv[++i]);
+    else if (!strcmp(argv[i],"-ctas"))
+      ctas = atoi(argv[++i]);
+    else if (!strcmp(argv[i],"-latency"))
+      machine.latency = atof(argv[++i]);
+    else if (!strcmp(argv[i],"-bandwidth"))
+      machine.bandwidth = atof(argv[++i]);
+    else if (!strcmp(argv[i],"-loads_in_flight"))
+      machine.max_loads_in_flight = atoi(argv[++i]);
+    else if (!strcmp(argv[i],"-top"))
+      top = atoi(argv[++i]);
+    else if (!strcmp(argv[i],"-offset"))
+      offset = atoi(argv[++i]);
+    else if (!strcmp(argv[i],"-rand_seed"))
+      rand_seed = atoi(argv[++i]);
+    else
+      usage(argv[0]);
+  }
+  if ((elmt_size <= 0) || (num_elmts <= 0) || (ctas <= 0))
+    usage(argv[0]);
+  if (pattern == CudaDMAModel::SEQUENTIAL_PATTERN)
+    num_elmts = 1;
+
+  std::vector<CudaDMAModel::Candidate> candidates =
+    CudaDMAModel::search(pattern, elmt_size, num_elmts, space, machine, ctas);
+  if (candidates.empty())
+  {
+    fprintf(stderr,"No valid configurations, elements must be at least 4 bytes\n");
+    return 1;
+  }
+  if (header)
+  {
+    const CudaDMADiagnosis &best = candidates[0].diag;
+    fprintf(stdout,"#define PARAM_ALIGNMENT %d\n", best.alignment);
+    fprintf(stdout,"#define PARAM_OFFSET %d\n", offset);
+    fprintf(stdout,"#define PARAM_BYTES_PER_THREAD %d\n", best.bytes_per_thread);
+    fprintf(stdout,"#define PARAM_ELMT_SIZE %d\n", best.bytes_per_elmt);
+    if (pattern != CudaDMAModel::SEQUENTIAL_PATTERN)
+      fprintf(stdout,"#define PARAM_NUM_ELMTS %d\n", best.num_elmts);
+    fprintf(stdout,"#define PARAM_DMA_THREADS %d\n", best.dma_threads);
+    if (pattern == CudaDMAModel::INDIRECT_PATTERN)
+      fprintf(stdout,"#define PARAM_RAND_SEED %d\n", rand_seed);
+    return 0;
+  }
+  fprintf(stdout,"%4s %9s %16s %11s %10s %6s %11s %10s %10s %9s\n", "rank", "alignment",
+          "bytes_per_thread", "dma_threads", "case", "steps", "registers", "efficiency",
+          "bytes/clk", "verdict");
+  for (int i = 0; (i < top) && (i < int(candidates.size())); i++)
+  {
+    const CudaDMAModel::Candidate &c = candidates[i];
+    fprintf(stdout,"%4d %9d %16d %11d %10s %6d %11d %9.1f%% %10.2f %9s\n", i+1, c.diag.alignment,
+            c.diag.bytes_per_thread, c.diag.dma_threads, cudaDMA_transfer_case_name(c.diag.transfer_case),
+            c.diag.total_steps, c.diag.bulk_registers + c.diag.across_registers,
+            100.0*c.estimate.efficiency(), c.estimate.bandwidth,
+            (c.diag.optimized ? "OPTIMIZED" : "UN-OPT"));
+  }
+  return 0;
+}
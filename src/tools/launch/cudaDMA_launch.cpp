@@ -0,0 +1,149 @@
+/*
+ *  Copyright 2013 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*
+ * Plans the launch geometry of a warp-specialized kernel with the
+ * planner of cudaDMALaunch.h: thread layout, dmaIDs, shared memory and
+ * CTAs per SM.  Transfers are given in template parameter order and can
+ * be repeated, one entry per CudaDMA object of the kernel:
+ *
+ *   launch -compute_threads N [transfers] [options]
+ *     -sequential A,BPT,BPE,THREADS[,BUFFERS]
+ *     -strided A,BPT,BPE,THREADS,NUM_ELMTS[,BUFFERS[,DST_STRIDE]]
+ *     -indirect A,BPT,BPE,THREADS,NUM_ELMTS[,BUFFERS]
+ *     -shared_warps            buffers of a transfer share the same DMA warps
+ *     -registers N             registers per thread needed by the compute code
+ *     -shared N                shared memory bytes used besides the DMA buffers
+ *     -fermi                   plan for a compute capability 2.x GPU
+ *
+ * For example the double buffered strided sgemv kernel:
+ *
+ *   launch -compute_threads 128 -sequential 16,64,256,32,2 -strided 16,64,512,128,16,2
+ *
+ * The exit code is non-zero when the CTA cannot be launched.
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "cudaDMALaunch.h"
+
+static void usage(const char *prog)
+{
+  fprintf(stderr,"Usage: %s -compute_threads N [-sequential A,BPT,BPE,THREADS[,BUFFERS]]"
+                 " [-strided A,BPT,BPE,THREADS,NUM_ELMTS[,BUFFERS[,DST_STRIDE]]]"
+                 " [-indirect A,BPT,BPE,THREADS,NUM_ELMTS[,BUFFERS]] [-shared_warps]"
+                 " [-registers N] [-shared N] [-fermi]\n", prog);
+  exit(1);
+}
+
+// Parse a comma separated list of at least min_values and at most max_values integers
+static int parse_values(const char *arg, int *values, int min_values, int max_values)
+{
+  int count = 0;
+  const char *ptr = arg;
+  while ((*ptr != '\0') && (count < max_values))
+  {
+    char *end;
+    values[count++] = strtol(ptr, &end, 10);
+    if ((end == ptr) || ((*end != ',') && (*end != '\0')))
+      return -1;
+    ptr = (*end == ',') ? (end + 1) : end;
+  }
+  if ((*ptr != '\0') || (count < min_values))
+    return -1;
+  return count;
+}
+
+// Check the values of a transfer before analyzing it
+static void check_values(const int *values, const char *prog)
+{
+  const int alignment = values[0];
+  if ((alignment != 4) && (alignment != 8) && (alignment != 16))
+    usage(prog);
+  if ((values[1] <= 0) || ((values[1] % alignment) != 0) || (values[2] < alignment) ||
+      (values[3] <= 0) || (values[4] <= 0) || (values[5] <= 0))
+    usage(prog);
+}
+
+int main(int argc, char **argv)
+{
+  CudaDMALaunch::Device device;
+  std::vector<CudaDMALaunch::Transfer> transfers;
+  int compute_threads = 0, registers = 0, shared = 0;
+  bool shared_warps = false;
+  for (int i = 1; i < argc; i++)
+  {
+    if (!strcmp(argv[i],"-shared_warps"))
+    {
+      shared_warps = true;
+      continue;
+    }
+    if (!strcmp(argv[i],"-fermi"))
+    {
+      device.max_threads_per_sm = 1536;
+      device.max_ctas_per_sm = 8;
+      device.registers_per_sm = 32768;
+      device.max_registers_per_thread = 63;
+      continue;
+    }
+    if ((i+1) == argc)
+      usage(argv[0]);
+    int values[7] = { 0, 0, 0, 0, 0, 1, 0 };
+    if (!strcmp(argv[i],"-compute_threads"))
+      compute_threads = atoi(argv[++i]);
+    else if (!strcmp(argv[i],"-registers"))
+      registers = atoi(argv[++i]);
+    else if (!strcmp(argv[i],"-shared"))
+      shared = atoi(argv[++i]);
+    else if (!strcmp(argv[i],"-sequential"))
+    {
+      values[4] = 1; // BUFFERS
+      if (parse_values(argv[++i], values, 4, 5) < 0)
+        usage(argv[0]);
+      check_values(values, argv[0]);
+      transfers.push_back(CudaDMALaunch::sequential(values[0], values[1], values[2], values[3],
+                                                    values[4]));
+    }
+    else if (!strcmp(argv[i],"-strided"))
+    {
+      if (parse_values(argv[++i], values, 5, 7) < 0)
+        usage(argv[0]);
+      check_values(values, argv[0]);
+      transfers.push_back(CudaDMALaunch::strided(values[0], values[1], values[2], values[3],
+                                                 values[4], values[5], values[6]));
+    }
+    else if (!strcmp(argv[i],"-indirect"))
+    {
+      if (parse_values(argv[++i], values, 5, 6) < 0)
+        usage(argv[0]);
+      check_values(values, argv[0]);
+      transfers.push_back(CudaDMALaunch::indirect(values[0], values[1], values[2], values[3],
+                                                  values[4], values[5]));
+    }
+    else
+      usage(argv[0]);
+  }
+  if ((compute_threads <= 0) || transfers.empty())
+    usage(argv[0]);
+  for (unsigned t = 0; t < transfers.size(); t++)
+    transfers[t].shared_warps = shared_warps;
+
+  CudaDMALaunch::Plan plan = CudaDMALaunch::plan(compute_threads, transfers, device, registers, shared);
+  CudaDMALaunch::print_plan(plan, transfers);
+  return (plan.valid() ? 0 : 1);
+}
@@ -0,0 +1,190 @@
+/*
+ *  Copyright 2013 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*
+ * Prints the addresses every DMA lane of a CudaDMA instance accesses
+ * as CSV (see cudaDMATrace.h).  The template parameters are set by the
+ * Makefile, pointers, strides and indices are given on the command line:
+ *
+ *   trace sequential|strided|gather|scatter [options]
+ *     -src_offset N   byte offset of the source pointer from an aligned address
+ *     -dst_offset N   byte offset of the destination pointer from an aligned address
+ *     -src_stride N   bytes between source elements (strided and scatter,
+ *                     default BYTES_PER_ELMT)
+ *     -dst_stride N   bytes between destination elements (strided and gather,
+ *                     default BYTES_PER_ELMT)
+ *     -indices a,b,.. element indices (gather/scatter, default 0,1,..,NUM_ELMTS-1)
+ *     -coalescing ld|st  print the global memory coalescing of the loads or
+ *                        stores for each step (the steps analyze() reports)
+ *                        instead of the trace
+ *     -banks ld|st    print the shared memory bank conflicts of the loads or
+ *                     stores of each request instead of the trace, along with
+ *                     the smallest stride padding that removes most of them
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "cudaDMATrace.h"
+
+struct Options {
+  const char *pattern;
+  int src_offset, dst_offset;
+  int src_stride, dst_stride;
+  std::vector<int> indices;
+};
+
+static void usage(const char *prog)
+{
+  fprintf(stderr,"Usage: %s sequential|strided|gather|scatter [-src_offset N] [-dst_offset N]"
+                 " [-src_stride N] [-dst_stride N] [-indices a,b,...] [-coalescing ld|st]"
+                 " [-banks ld|st]\n", prog);
+  exit(1);
+}
+
+static std::vector<int> parse_indices(const char *list)
+{
+  std::vector<int> indices;
+  const char *ptr = list;
+  while (*ptr != '\0')
+  {
+    char *end;
+    indices.push_back(int(strtol(ptr, &end, 10)));
+    if ((end == ptr) || ((*end != ',') && (*end != '\0')))
+    {
+      fprintf(stderr,"Bad index list %s\n", list);
+      exit(1);
+    }
+    ptr = (*end == ',') ? end+1 : end;
+  }
+  return indices;
+}
+
+static const char* parse_kind(const char *kind, const char *prog)
+{
+  if (strcmp(kind,"ld") && strcmp(kind,"st"))
+    usage(prog);
+  return kind;
+}
+
+static std::vector<CudaDMATrace::Access> trace(const Options &opts)
+{
+  if (!strcmp(opts.pattern,"sequential"))
+    return CudaDMATrace::trace_sequential<PARAM_ALIGNMENT,PARAM_BYTES_PER_THREAD,
+                                          PARAM_ELMT_SIZE,PARAM_DMA_THREADS>(opts.src_offset, opts.dst_offset);
+  if (!strcmp(opts.pattern,"strided"))
+    return CudaDMATrace::trace_strided<PARAM_ALIGNMENT,PARAM_BYTES_PER_THREAD,PARAM_ELMT_SIZE,
+                                       PARAM_DMA_THREADS,PARAM_NUM_ELMTS>(opts.src_stride, opts.dst_stride,
+                                                                          opts.src_offset, opts.dst_offset);
+  if (!strcmp(opts.pattern,"gather"))
+    return CudaDMATrace::trace_indirect<true,PARAM_ALIGNMENT,PARAM_BYTES_PER_THREAD,PARAM_ELMT_SIZE,
+                                        PARAM_DMA_THREADS,PARAM_NUM_ELMTS>(opts.indices, opts.src_offset,
+                                                                           opts.dst_offset, opts.dst_stride);
+  if (!strcmp(opts.pattern,"scatter"))
+    return CudaDMATrace::trace_indirect<false,PARAM_ALIGNMENT,PARAM_BYTES_PER_THREAD,PARAM_ELMT_SIZE,
+                                        PARAM_DMA_THREADS,PARAM_NUM_ELMTS>(opts.indices, opts.src_offset,
+                                                                           opts.dst_offset, opts.src_stride);
+  fprintf(stderr,"Unknown pattern %s\n", opts.pattern);
+  exit(1);
+}
+
+// Try padding the stride of the shared memory side by multiples of the
+// alignment up to a full row of banks and report the cheapest choice
+static void suggest_padding(const Options &opts, bool loads, long wavefronts)
+{
+  const bool strided = !strcmp(opts.pattern,"strided");
+  int Options::*stride = NULL;
+  if ((strided || !strcmp(opts.pattern,"scatter")) && loads)
+    stride = &Options::src_stride;
+  else if ((strided || !strcmp(opts.pattern,"gather")) && !loads)
+    stride = &Options::dst_stride;
+  if (stride == NULL)
+  {
+    fprintf(stdout,"No stride to pad for the %s of a %s transfer\n", (loads ? "loads" : "stores"), opts.pattern);
+    return;
+  }
+  int best_pad = 0;
+  long best = wavefronts;
+  for (int pad = PARAM_ALIGNMENT; pad <= (CudaDMATrace::NUM_BANKS*CudaDMATrace::BANK_BYTES); pad += PARAM_ALIGNMENT)
+  {
+    Options padded = opts;
+    padded.*stride += pad;
+    const long result = CudaDMATrace::total_wavefronts(CudaDMATrace::bank_conflicts(trace(padded), loads));
+    if (result < best)
+    {
+      best = result;
+      best_pad = pad;
+    }
+  }
+  if (best_pad == 0)
+    fprintf(stdout,"Padding the stride of %d bytes does not reduce the %ld wavefronts\n",
+            opts.*stride, wavefronts);
+  else
+    fprintf(stdout,"Padding the stride by %d bytes to %d reduces the wavefronts from %ld to %ld\n",
+            best_pad, opts.*stride + best_pad, wavefronts, best);
+}
+
+int main(int argc, char **argv)
+{
+  if (argc < 2)
+    usage(argv[0]);
+  Options opts;
+  opts.pattern = argv[1];
+  opts.src_offset = 0;
+  opts.dst_offset = 0;
+  opts.src_stride = PARAM_ELMT_SIZE;
+  opts.dst_stride = PARAM_ELMT_SIZE;
+  for (int i = 0; i < PARAM_NUM_ELMTS; i++)
+    opts.indices.push_back(i);
+  const char *coalescing = NULL;
+  const char *banks = NULL;
+  for (int i = 2; i < argc; i++)
+  {
+    if ((i+1) == argc)
+      usage(argv[0]);
+    if (!strcmp(argv[i],"-src_offset"))
+      opts.src_offset = atoi(argv[++i]);
+    else if (!strcmp(argv[i],"-dst_offset"))
+      opts.dst_offset = atoi(argv[++i]);
+    else if (!strcmp(argv[i],"-src_stride"))
+      opts.src_stride = atoi(argv[++i]);
+    else if (!strcmp(argv[i],"-dst_stride"))
+      opts.dst_stride = atoi(argv[++i]);
+    else if (!strcmp(argv[i],"-indices"))
+      opts.indices = parse_indices(argv[++i]);
+    else if (!strcmp(argv[i],"-coalescing"))
+      coalescing = parse_kind(argv[++i], argv[0]);
+    else if (!strcmp(argv[i],"-banks"))
+      banks = parse_kind(argv[++i], argv[0]);
+    else
+      usage(argv[0]);
+  }
+
+  std::vector<CudaDMATrace::Access> accesses = trace(opts);
+  if (coalescing != NULL)
+    CudaDMATrace::print_coalescing(CudaDMATrace::coalescing(accesses, !strcmp(coalescing,"ld")));
+  if (banks != NULL)
+  {
+    const bool loads = !strcmp(banks,"ld");
+    std::vector<CudaDMATrace::BankConflict> conflicts = CudaDMATrace::bank_conflicts(accesses, loads);
+    CudaDMATrace::print_bank_conflicts(conflicts);
+    suggest_padding(opts, loads, CudaDMATrace::total_wavefronts(conflicts));
+  }
+  if ((coalescing == NULL) && (banks == NULL))
+    CudaDMATrace::print_csv(accesses);
+  return 0;
+}